@@ -209,6 +209,32 @@ struct BoundBox
     }
 };
 
+/// Transforms multiple bounding boxes.
+
+/// \param [in]  InBoxes     - Boxes to transform.
+/// \param [in]  Matrices    - Transform matrices, one per box.
+/// \param [in]  NumBoxes    - The number of boxes.
+/// \param [out] OutBoxes    - Transformed boxes. May be null if only the merged box is needed,
+///                            and may be the same array as InBoxes.
+/// \param [out] pMergedBox  - Optional box to merge the transformed boxes into. The box must be
+///                            initialized by the caller, for instance with the previous parent bounds
+///                            or with {+FLT_MAX, -FLT_MAX} to start from an empty box.
+///
+/// \remarks   The results are identical to those of BoundBox::Transform.
+///            When SIMD math is available, the boxes are transformed using vector instructions.
+void TransformBoundBoxes(const BoundBox* InBoxes,
+                         const float4x4* Matrices,
+                         size_t          NumBoxes,
+                         BoundBox*       OutBoxes,
+                         BoundBox*       pMergedBox = nullptr);
+
+/// Transforms multiple bounding boxes by the same matrix, see TransformBoundBoxes() above.
+void TransformBoundBoxes(const BoundBox* InBoxes,
+                         const float4x4& Matrix,
+                         size_t          NumBoxes,
+                         BoundBox*       OutBoxes,
+                         BoundBox*       pMergedBox = nullptr);
+
 enum class BoxVisibility
 {
     //  Bounding box is guaranteed to be outside of the view frustum
@@ -410,6 +436,94 @@ inline BoxVisibility GetBoxVisibility(const ViewFrustumExt& ViewFrustumExt,
     return BoxVisibility::Intersecting;
 }
 
+/// Bounding boxes stored in structure-of-arrays layout.
+/// Every array must contain at least as many elements as the number of boxes being processed.
+struct BoundBoxesSoA
+{
+    const float* MinX = nullptr;
+    const float* MinY = nullptr;
+    const float* MinZ = nullptr;
+    const float* MaxX = nullptr;
+    const float* MaxY = nullptr;
+    const float* MaxZ = nullptr;
+
+    /// Returns the boxes starting at the given index
+    BoundBoxesSoA Offset(size_t Idx) const
+    {
+        BoundBoxesSoA Boxes;
+        Boxes.MinX = MinX + Idx;
+        Boxes.MinY = MinY + Idx;
+        Boxes.MinZ = MinZ + Idx;
+        Boxes.MaxX = MaxX + Idx;
+        Boxes.MaxY = MaxY + Idx;
+        Boxes.MaxZ = MaxZ + Idx;
+        return Boxes;
+    }
+
+    BoundBox GetBox(size_t Idx) const
+    {
+        return BoundBox{
+            float3{MinX[Idx], MinY[Idx], MinZ[Idx]},
+            float3{MaxX[Idx], MaxY[Idx], MaxZ[Idx]} //
+        };
+    }
+};
+
+/// Tests visibility of multiple bounding boxes against the view frustum.
+
+/// \param [in]  Frustum          - View frustum.
+/// \param [in]  Boxes            - Bounding boxes in structure-of-arrays layout.
+/// \param [in]  NumBoxes         - The number of boxes to test.
+/// \param [out] VisibleMask      - Visibility bit mask that must contain at least (NumBoxes + 31) / 32 elements.
+///                                 Bit i % 32 of VisibleMask[i / 32] is set if the box i is not BoxVisibility::Invisible.
+/// \param [out] FullyVisibleMask - Optional bit mask with the same layout, where the bit is set
+///                                 if the box is BoxVisibility::FullyVisible.
+/// \param [in]  PlaneFlags       - Frustum planes to test the boxes against.
+///
+/// \remarks   The results are identical to those returned by GetBoxVisibility() for every box.
+///            The boxes are tested four at a time when SIMD math is available.
+///            Unused bits of the last mask element are set to zero.
+void GetBoxesVisibility(const ViewFrustum&   Frustum,
+                        const BoundBoxesSoA& Boxes,
+                        Uint32               NumBoxes,
+                        Uint32*              VisibleMask,
+                        Uint32*              FullyVisibleMask = nullptr,
+                        FRUSTUM_PLANE_FLAGS  PlaneFlags       = FRUSTUM_PLANE_FLAG_FULL_FRUSTUM);
+
+/// Tests visibility of multiple bounding boxes against the view frustum and writes
+/// the indices of the boxes that are not BoxVisibility::Invisible into VisibleIndices
+/// in ascending order. VisibleIndices must have space for NumBoxes elements.
+/// Returns the number of visible boxes.
+Uint32 GetVisibleBoxIndices(const ViewFrustum&   Frustum,
+                            const BoundBoxesSoA& Boxes,
+                            Uint32               NumBoxes,
+                            Uint32*              VisibleIndices,
+                            FRUSTUM_PLANE_FLAGS  PlaneFlags = FRUSTUM_PLANE_FLAG_FULL_FRUSTUM);
+
+/// Multithreaded version of GetBoxesVisibility().
+/// The boxes are split into NumThreads ranges that are multiples of 32 boxes, so that every thread
+/// writes its own mask elements. The calling thread processes the first range, the remaining
+/// ranges are processed by temporary worker threads.
+///
+/// \note  Starting a thread is expensive, so this function only pays off for large numbers of boxes.
+///        Applications that have their own thread pool should rather call GetBoxesVisibility()
+///        for 32-box aligned ranges using BoundBoxesSoA::Offset().
+void GetBoxesVisibilityMT(const ViewFrustum&   Frustum,
+                          const BoundBoxesSoA& Boxes,
+                          Uint32               NumBoxes,
+                          Uint32*              VisibleMask,
+                          Uint32*              FullyVisibleMask,
+                          Uint32               NumThreads,
+                          FRUSTUM_PLANE_FLAGS  PlaneFlags = FRUSTUM_PLANE_FLAG_FULL_FRUSTUM);
+
+/// Multithreaded version of GetVisibleBoxIndices().
+Uint32 GetVisibleBoxIndicesMT(const ViewFrustum&   Frustum,
+                              const BoundBoxesSoA& Boxes,
+                              Uint32               NumBoxes,
+                              Uint32*              VisibleIndices,
+                              Uint32               NumThreads,
+                              FRUSTUM_PLANE_FLAGS  PlaneFlags = FRUSTUM_PLANE_FLAG_FULL_FRUSTUM);
+
 inline float GetPointToBoxDistance(const BoundBox& BndBox, const float3& Pos)
 {
     VERIFY_EXPR(BndBox.Max.x >= BndBox.Min.x &&
@@ -619,6 +733,75 @@ inline float IntersectRayTriangle(const float3& V0,
     return t;
 }
 
+/// Intersects a ray with the triangle using the watertight algorithm by Woop, Benthin and Wald.
+
+/// The function follows the same conventions as IntersectRayTriangle(): it returns the
+/// distance along the ray to the intersection point, which is negative if the point is
+/// behind the ray origin, or +FLT_MAX if there is no intersection.
+/// Unlike Moller-Trumbore algorithm, the edges shared by adjacent triangles are tested
+/// consistently, so rays never slip through the cracks between them.
+float IntersectRayTriangleWatertight(const float3& V0,
+                                     const float3& V1,
+                                     const float3& V2,
+                                     const float3& RayOrigin,
+                                     const float3& RayDirection,
+                                     bool          CullBackFace = false);
+
+/// Four triangles in structure-of-arrays layout
+struct TrianglePacket4
+{
+    /// Vertex coordinates indexed as [Vertex][Axis][Triangle]
+    float V[3][3][4] = {};
+
+    void SetTriangle(Uint32 Idx, const float3& V0, const float3& V1, const float3& V2)
+    {
+        VERIFY_EXPR(Idx < 4);
+        for (Uint32 Axis = 0; Axis < 3; ++Axis)
+        {
+            V[0][Axis][Idx] = V0[Axis];
+            V[1][Axis][Idx] = V1[Axis];
+            V[2][Axis][Idx] = V2[Axis];
+        }
+    }
+};
+
+/// Four rays in structure-of-arrays layout
+struct RayPacket4
+{
+    /// Ray origins and directions indexed as [Axis][Ray]
+    float Origin[3][4]    = {};
+    float Direction[3][4] = {{1, 1, 1, 1}, {}, {}};
+
+    void SetRay(Uint32 Idx, const float3& RayOrigin, const float3& RayDirection)
+    {
+        VERIFY_EXPR(Idx < 4);
+        for (Uint32 Axis = 0; Axis < 3; ++Axis)
+        {
+            Origin[Axis][Idx]    = RayOrigin[Axis];
+            Direction[Axis][Idx] = RayDirection[Axis];
+        }
+    }
+};
+
+/// Intersects a ray with four triangles using the watertight algorithm and writes the distances
+/// to Distances. The results are identical to those of IntersectRayTriangleWatertight().
+/// When SIMD math is available, all four triangles are tested at once.
+void IntersectRayTriangles4(const float3&          RayOrigin,
+                            const float3&          RayDirection,
+                            const TrianglePacket4& Triangles,
+                            float                  Distances[4],
+                            bool                   CullBackFace = false);
+
+/// Intersects four rays with the triangle using the watertight algorithm and writes the distances
+/// to Distances. The results are identical to those of IntersectRayTriangleWatertight().
+/// When SIMD math is available, all four rays are tested at once.
+void IntersectRays4Triangle(const RayPacket4& Rays,
+                            const float3&     V0,
+                            const float3&     V1,
+                            const float3&     V2,
+                            float             Distances[4],
+                            bool              CullBackFace = false);
+
 
 /// Traces a 2D line through the square cell grid and enumerates all cells the line touches.
 
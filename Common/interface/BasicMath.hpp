@@ -52,6 +52,7 @@
 #include <algorithm>
 
 #include "HashUtils.hpp"
+#include "BasicMathSIMD.hpp"
 
 #ifdef _MSC_VER
 #    pragma warning(push)
@@ -1561,6 +1562,46 @@ template <class T> struct Matrix4x4
     }
 };
 
+#if DILIGENT_SIMD_MATH
+
+// SIMD specializations of the performance-critical float operations.
+// The results are the same as those of the scalar implementations except for the inverse,
+// which uses the different expansion and may differ in the last bits.
+
+template <>
+inline Matrix4x4<float> Matrix4x4<float>::Mul(const Matrix4x4<float>& m1, const Matrix4x4<float>& m2)
+{
+    Matrix4x4<float> mOut;
+    SIMD::MultiplyMatrices4x4(m1.Data(), m2.Data(), mOut.Data());
+    return mOut;
+}
+
+template <>
+inline Matrix4x4<float> Matrix4x4<float>::Transpose() const
+{
+    Matrix4x4<float> mOut;
+    SIMD::TransposeMatrix4x4(Data(), mOut.Data());
+    return mOut;
+}
+
+template <>
+inline Matrix4x4<float> Matrix4x4<float>::Inverse() const
+{
+    Matrix4x4<float> inv;
+    SIMD::InvertMatrix4x4(Data(), inv.Data());
+    return inv;
+}
+
+template <>
+inline Vector4<float> Vector4<float>::operator*(const Matrix4x4<float>& m) const
+{
+    Vector4<float> out;
+    SIMD::MultiplyVectorMatrix4(Data(), m.Data(), out.Data());
+    return out;
+}
+
+#endif
+
 // Template Vector Operations
 
 
@@ -1747,6 +1788,15 @@ Vector4<T> operator*(const Matrix4x4<T>& m, const Vector4<T>& v)
     return out;
 }
 
+#if DILIGENT_SIMD_MATH
+inline Vector4<float> operator*(const Matrix4x4<float>& m, const Vector4<float>& v)
+{
+    Vector4<float> out;
+    SIMD::MultiplyMatrixVector4(m.Data(), v.Data(), out.Data());
+    return out;
+}
+#endif
+
 template <class T>
 Vector3<T> operator*(const Matrix3x3<T>& m, Vector3<T>& v)
 {
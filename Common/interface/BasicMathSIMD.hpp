@@ -0,0 +1,308 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// SIMD implementations of the performance-critical float4 and float4x4 operations.
+/// The functions are used by BasicMath.hpp and operate on row-major matrices and row vectors
+/// stored as arrays of floats without any alignment requirements.
+///
+/// Define DILIGENT_DISABLE_SIMD_MATH to use the generic scalar implementations.
+
+#ifndef DILIGENT_DISABLE_SIMD_MATH
+#    if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#        define DILIGENT_SIMD_MATH_SSE2 1
+#    elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#        define DILIGENT_SIMD_MATH_NEON 1
+#    endif
+#endif
+
+#if DILIGENT_SIMD_MATH_SSE2
+#    include <emmintrin.h>
+#elif DILIGENT_SIMD_MATH_NEON
+#    include <arm_neon.h>
+#endif
+
+#if DILIGENT_SIMD_MATH_SSE2 || DILIGENT_SIMD_MATH_NEON
+#    define DILIGENT_SIMD_MATH 1
+#else
+#    define DILIGENT_SIMD_MATH 0
+#endif
+
+#if DILIGENT_SIMD_MATH
+
+#    include "../../Primitives/interface/BasicTypes.h"
+
+namespace Diligent
+{
+
+namespace SIMD
+{
+
+// clang-format off
+#if DILIGENT_SIMD_MATH_SSE2
+
+using Float4Reg = __m128;
+
+inline Float4Reg Load (const float* p)                 { return _mm_loadu_ps(p);    }
+inline void      Store(float* p, Float4Reg v)          { _mm_storeu_ps(p, v);       }
+inline Float4Reg Set  (float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+inline Float4Reg Splat(float s)                        { return _mm_set1_ps(s);     }
+inline Float4Reg Add  (Float4Reg a, Float4Reg b)       { return _mm_add_ps(a, b);   }
+inline Float4Reg Sub  (Float4Reg a, Float4Reg b)       { return _mm_sub_ps(a, b);   }
+inline Float4Reg Mul  (Float4Reg a, Float4Reg b)       { return _mm_mul_ps(a, b);   }
+inline Float4Reg Div  (Float4Reg a, Float4Reg b)       { return _mm_div_ps(a, b);   }
+// Same results as std::min(a, b) and std::max(a, b), including signed zeros and NaNs
+inline Float4Reg Min  (Float4Reg a, Float4Reg b)       { return _mm_min_ps(b, a);   }
+inline Float4Reg Max  (Float4Reg a, Float4Reg b)       { return _mm_max_ps(b, a);   }
+
+// (v[i], v[i], v[i], v[i])
+template <int i>
+inline Float4Reg SplatLane(Float4Reg v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(i, i, i, i)); }
+
+// (v[1], v[0], v[3], v[2])
+inline Float4Reg SwapPairs(Float4Reg v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)); }
+
+// (v[2], v[2], v[0], v[0])
+inline Float4Reg SplatLanes2200(Float4Reg v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 2, 2)); }
+
+inline void Transpose(Float4Reg& r0, Float4Reg& r1, Float4Reg& r2, Float4Reg& r3)
+{
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+}
+
+// Comparisons return all ones in the lanes where the condition is true, and zeros otherwise
+inline Float4Reg CmpLT(Float4Reg a, Float4Reg b) { return _mm_cmplt_ps(a, b); }
+inline Float4Reg CmpGT(Float4Reg a, Float4Reg b) { return _mm_cmpgt_ps(a, b); }
+inline Float4Reg CmpEQ(Float4Reg a, Float4Reg b) { return _mm_cmpeq_ps(a, b); }
+inline Float4Reg And  (Float4Reg a, Float4Reg b) { return _mm_and_ps(a, b);   }
+inline Float4Reg Or   (Float4Reg a, Float4Reg b) { return _mm_or_ps(a, b);    }
+
+// (Mask[i] ? a[i] : b[i]), where Mask is the result of a comparison
+inline Float4Reg Select(Float4Reg Mask, Float4Reg a, Float4Reg b) { return _mm_or_ps(_mm_and_ps(Mask, a), _mm_andnot_ps(Mask, b)); }
+
+// Returns the 4-bit mask made of the most significant bits of the lanes
+inline Uint32 MoveMask(Float4Reg v) { return static_cast<Uint32>(_mm_movemask_ps(v)); }
+
+#elif DILIGENT_SIMD_MATH_NEON
+
+using Float4Reg = float32x4_t;
+
+inline Float4Reg Load (const float* p)                 { return vld1q_f32(p);       }
+inline void      Store(float* p, Float4Reg v)          { vst1q_f32(p, v);           }
+inline Float4Reg Set  (float x, float y, float z, float w) { const float v[] = {x, y, z, w}; return vld1q_f32(v); }
+inline Float4Reg Splat(float s)                        { return vdupq_n_f32(s);     }
+inline Float4Reg Add  (Float4Reg a, Float4Reg b)       { return vaddq_f32(a, b);    }
+inline Float4Reg Sub  (Float4Reg a, Float4Reg b)       { return vsubq_f32(a, b);    }
+inline Float4Reg Mul  (Float4Reg a, Float4Reg b)       { return vmulq_f32(a, b);    }
+#    if defined(__aarch64__) || defined(_M_ARM64)
+inline Float4Reg Div  (Float4Reg a, Float4Reg b)       { return vdivq_f32(a, b);    }
+#    else
+// ARMv7 NEON has no division instruction, and the reciprocal estimate is not exact
+inline Float4Reg Div  (Float4Reg a, Float4Reg b)
+{
+    float A[4], B[4];
+    vst1q_f32(A, a);
+    vst1q_f32(B, b);
+    const float Res[] = {A[0] / B[0], A[1] / B[1], A[2] / B[2], A[3] / B[3]};
+    return vld1q_f32(Res);
+}
+#    endif
+inline Float4Reg Min  (Float4Reg a, Float4Reg b)       { return vbslq_f32(vcltq_f32(b, a), b, a); }
+inline Float4Reg Max  (Float4Reg a, Float4Reg b)       { return vbslq_f32(vcltq_f32(a, b), b, a); }
+
+template <int i>
+inline Float4Reg SplatLane(Float4Reg v) { return vdupq_n_f32(vgetq_lane_f32(v, i)); }
+
+inline Float4Reg SwapPairs(Float4Reg v) { return vrev64q_f32(v); }
+
+inline Float4Reg SplatLanes2200(Float4Reg v)
+{
+    return vcombine_f32(vdup_lane_f32(vget_high_f32(v), 0), vdup_lane_f32(vget_low_f32(v), 0));
+}
+
+inline void Transpose(Float4Reg& r0, Float4Reg& r1, Float4Reg& r2, Float4Reg& r3)
+{
+    const float32x4x2_t t01 = vtrnq_f32(r0, r1); // (r0[0], r1[0], r0[2], r1[2]), (r0[1], r1[1], r0[3], r1[3])
+    const float32x4x2_t t23 = vtrnq_f32(r2, r3); // (r2[0], r3[0], r2[2], r3[2]), (r2[1], r3[1], r2[3], r3[3])
+
+    r0 = vcombine_f32(vget_low_f32 (t01.val[0]), vget_low_f32 (t23.val[0]));
+    r1 = vcombine_f32(vget_low_f32 (t01.val[1]), vget_low_f32 (t23.val[1]));
+    r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+
+inline Float4Reg CmpLT(Float4Reg a, Float4Reg b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+inline Float4Reg CmpGT(Float4Reg a, Float4Reg b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+inline Float4Reg CmpEQ(Float4Reg a, Float4Reg b) { return vreinterpretq_f32_u32(vceqq_f32(a, b)); }
+inline Float4Reg And  (Float4Reg a, Float4Reg b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+inline Float4Reg Or   (Float4Reg a, Float4Reg b) { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+
+inline Float4Reg Select(Float4Reg Mask, Float4Reg a, Float4Reg b) { return vbslq_f32(vreinterpretq_u32_f32(Mask), a, b); }
+
+inline Uint32 MoveMask(Float4Reg v)
+{
+    const uint32x4_t Bits = vshrq_n_u32(vreinterpretq_u32_f32(v), 31);
+    return vgetq_lane_u32(Bits, 0) | (vgetq_lane_u32(Bits, 1) << 1) | (vgetq_lane_u32(Bits, 2) << 2) | (vgetq_lane_u32(Bits, 3) << 3);
+}
+
+#endif
+// clang-format on
+
+// Computes x * r0 + y * r1 + z * r2 + w * r3, where x, y, z, w are the components of v.
+// The terms are added in the same order as in the scalar implementation.
+inline Float4Reg LinearCombination(Float4Reg v, Float4Reg r0, Float4Reg r1, Float4Reg r2, Float4Reg r3)
+{
+    auto Res = Mul(SplatLane<0>(v), r0);
+    Res      = Add(Res, Mul(SplatLane<1>(v), r1));
+    Res      = Add(Res, Mul(SplatLane<2>(v), r2));
+    Res      = Add(Res, Mul(SplatLane<3>(v), r3));
+    return Res;
+}
+
+/// Computes the product of two row-major 4x4 matrices: Out = M1 * M2.
+/// Out may alias M1 or M2.
+inline void MultiplyMatrices4x4(const float* M1, const float* M2, float* Out)
+{
+    const auto b0 = Load(M2 + 0);
+    const auto b1 = Load(M2 + 4);
+    const auto b2 = Load(M2 + 8);
+    const auto b3 = Load(M2 + 12);
+
+    // Every row of the product is the linear combination of the rows of M2
+    const auto r0 = LinearCombination(Load(M1 + 0), b0, b1, b2, b3);
+    const auto r1 = LinearCombination(Load(M1 + 4), b0, b1, b2, b3);
+    const auto r2 = LinearCombination(Load(M1 + 8), b0, b1, b2, b3);
+    const auto r3 = LinearCombination(Load(M1 + 12), b0, b1, b2, b3);
+
+    Store(Out + 0, r0);
+    Store(Out + 4, r1);
+    Store(Out + 8, r2);
+    Store(Out + 12, r3);
+}
+
+/// Transposes a 4x4 matrix. Out may alias M.
+inline void TransposeMatrix4x4(const float* M, float* Out)
+{
+    auto r0 = Load(M + 0);
+    auto r1 = Load(M + 4);
+    auto r2 = Load(M + 8);
+    auto r3 = Load(M + 12);
+    Transpose(r0, r1, r2, r3);
+    Store(Out + 0, r0);
+    Store(Out + 4, r1);
+    Store(Out + 8, r2);
+    Store(Out + 12, r3);
+}
+
+/// Multiplies the row vector by the matrix: Out = V * M.
+inline void MultiplyVectorMatrix4(const float* V, const float* M, float* Out)
+{
+    Store(Out, LinearCombination(Load(V), Load(M + 0), Load(M + 4), Load(M + 8), Load(M + 12)));
+}
+
+/// Multiplies the matrix by the column vector: Out = M * V.
+inline void MultiplyMatrixVector4(const float* M, const float* V, float* Out)
+{
+    const auto v = Load(V);
+
+    // Products of the matrix rows and the vector; after the transposition,
+    // Pk contains k-th terms of all four dot products
+    auto P0 = Mul(Load(M + 0), v);
+    auto P1 = Mul(Load(M + 4), v);
+    auto P2 = Mul(Load(M + 8), v);
+    auto P3 = Mul(Load(M + 12), v);
+    Transpose(P0, P1, P2, P3);
+    Store(Out, Add(Add(Add(P0, P1), P2), P3));
+}
+
+/// Computes the inverse of a 4x4 matrix using the expansion by 2x2 minors
+/// and returns the determinant. If the matrix is singular, the result contains
+/// infinities or NaNs, same as in the scalar implementation.
+inline float InvertMatrix4x4(const float* M, float* Out)
+{
+    // Columns of the matrix: Ck = (a0k, a1k, a2k, a3k)
+    auto C0 = Load(M + 0);
+    auto C1 = Load(M + 4);
+    auto C2 = Load(M + 8);
+    auto C3 = Load(M + 12);
+    Transpose(C0, C1, C2, C3);
+
+    // For every pair of columns (i, j), computes the 2x2 minors of the first two
+    // rows (s) and of the last two rows (c), and returns (c, c, s, s):
+    //   s = a0i * a1j - a1i * a0j
+    //   c = a2i * a3j - a3i * a2j
+    auto Minors = [](Float4Reg Ci, Float4Reg Cj) {
+        const auto P = Mul(Ci, SwapPairs(Cj)); // (a0i*a1j, a1i*a0j, a2i*a3j, a3i*a2j)
+        return SplatLanes2200(Sub(P, SwapPairs(P)));
+    };
+    const auto SC0 = Minors(C0, C1);
+    const auto SC1 = Minors(C0, C2);
+    const auto SC2 = Minors(C0, C3);
+    const auto SC3 = Minors(C1, C2);
+    const auto SC4 = Minors(C1, C3);
+    const auto SC5 = Minors(C2, C3);
+
+    // Vk = (a1k, a0k, a3k, a2k)
+    const auto V0 = SwapPairs(C0);
+    const auto V1 = SwapPairs(C1);
+    const auto V2 = SwapPairs(C2);
+    const auto V3 = SwapPairs(C3);
+
+    const auto PosNeg = Set(+1.f, -1.f, +1.f, -1.f);
+    const auto NegPos = Set(-1.f, +1.f, -1.f, +1.f);
+
+    // Rows of the adjugate matrix
+    const auto B0 = Mul(Add(Sub(Mul(V1, SC5), Mul(V2, SC4)), Mul(V3, SC3)), PosNeg);
+    const auto B1 = Mul(Add(Sub(Mul(V0, SC5), Mul(V2, SC2)), Mul(V3, SC1)), NegPos);
+    const auto B2 = Mul(Add(Sub(Mul(V0, SC4), Mul(V1, SC2)), Mul(V3, SC0)), PosNeg);
+    const auto B3 = Mul(Add(Sub(Mul(V0, SC3), Mul(V1, SC1)), Mul(V2, SC0)), NegPos);
+
+    // The determinant is the dot product of the first row of the matrix
+    // and the first column of the adjugate matrix
+    float b[4][4];
+    Store(b[0], B0);
+    Store(b[1], B1);
+    Store(b[2], B2);
+    Store(b[3], B3);
+    const float Det = M[0] * b[0][0] + M[1] * b[1][0] + M[2] * b[2][0] + M[3] * b[3][0];
+
+    const auto InvDet = Splat(1.f / Det);
+    Store(Out + 0, Mul(B0, InvDet));
+    Store(Out + 4, Mul(B1, InvDet));
+    Store(Out + 8, Mul(B2, InvDet));
+    Store(Out + 12, Mul(B3, InvDet));
+
+    return Det;
+}
+
+} // namespace SIMD
+
+} // namespace Diligent
+
+#endif // DILIGENT_SIMD_MATH
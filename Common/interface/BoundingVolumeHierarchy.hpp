@@ -0,0 +1,309 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines Diligent::BoundingVolumeHierarchy class
+
+#include <vector>
+
+#include "../../Primitives/interface/BasicTypes.h"
+#include "../../Platforms/Basic/interface/DebugUtilities.hpp"
+#include "AdvancedMath.hpp"
+
+namespace Diligent
+{
+
+/// Bounding volume hierarchy of axis-aligned bounding boxes.
+
+/// The hierarchy is built over primitives identified by their indices and represented by
+/// their bounding boxes. It is stored as a flat array of 32-byte nodes, where the children of every
+/// inner node are located next to each other and after their parent, and the primitives of every node
+/// form a contiguous range. The bounding boxes of the primitives are kept in the same order as they are
+/// referenced by the leaves, so the queries never access the application data.
+///
+/// The hierarchy is built using binned surface area heuristic (SAH). Large subtrees may be built
+/// by multiple threads. The threads make the same splits as the single-threaded build, but the nodes
+/// are only stored in depth-first order by the latter: each subtree built by a separate thread is
+/// stored contiguously after the nodes of the upper levels. When the primitives move, the hierarchy
+/// can be refit without rebuilding.
+///
+/// The object is not thread-safe, but const queries may be performed by multiple threads simultaneously.
+class BoundingVolumeHierarchy
+{
+public:
+    static constexpr Uint32 InvalidIndex = ~0u;
+
+    struct Node
+    {
+        BoundBox Box;
+
+        /// For inner nodes, the index of the first child (the second child immediately follows it).
+        /// For leaves, the index of the first primitive in the hierarchy's primitive list.
+        Uint32 FirstChildOrPrim = 0;
+
+        /// The number of primitives in the leaf, zero for inner nodes
+        Uint32 NumPrims = 0;
+
+        bool IsLeaf() const { return NumPrims != 0; }
+    };
+
+    struct BuildAttribs
+    {
+        /// The maximum number of primitives in a leaf
+        Uint32 MaxLeafSize = 4;
+
+        /// The number of bins used to evaluate SAH, must be in [2, 32] range
+        Uint32 NumBins = 16;
+
+        /// The number of threads to build the hierarchy with, including the calling thread
+        Uint32 NumThreads = 1;
+    };
+
+    struct RayHit
+    {
+        Uint32 PrimId   = InvalidIndex;
+        float  Distance = FLT_MAX;
+
+        explicit operator bool() const { return PrimId != InvalidIndex; }
+    };
+
+    /// Builds the hierarchy for NumPrims primitives with the given bounding boxes.
+    /// Primitive ids returned by the queries are indices in the PrimBoxes array.
+    void Build(const BoundBox* PrimBoxes, Uint32 NumPrims, const BuildAttribs& Attribs);
+
+    void Build(const BoundBox* PrimBoxes, Uint32 NumPrims)
+    {
+        Build(PrimBoxes, NumPrims, BuildAttribs{});
+    }
+
+    /// Updates the bounding boxes of all primitives and the nodes without changing the topology.
+    /// PrimBoxes must contain as many boxes as were used to build the hierarchy.
+    void Refit(const BoundBox* PrimBoxes);
+
+    /// Updates the bounding boxes of the given primitives and the nodes that contain them.
+    /// PrimBoxes is indexed by primitive ids, only the boxes of the listed primitives are read.
+    void RefitPrimitives(const Uint32* PrimIds, Uint32 NumIds, const BoundBox* PrimBoxes);
+
+    void Clear();
+
+    /// Appends the ids of the primitives whose bounding boxes are not invisible to PrimIds.
+    /// Nodes fully inside a plane are not tested against that plane again, and all primitives of
+    /// fully visible nodes are reported without further tests.
+    void QueryFrustum(const ViewFrustum&   Frustum,
+                      std::vector<Uint32>& PrimIds,
+                      FRUSTUM_PLANE_FLAGS  PlaneFlags = FRUSTUM_PLANE_FLAG_FULL_FRUSTUM) const;
+
+    /// Appends the ids of the primitives whose bounding boxes overlap the given box to PrimIds.
+    void QueryBox(const BoundBox& Box, std::vector<Uint32>& PrimIds) const;
+
+    /// Finds the closest primitive whose bounding box is hit by the ray within MaxDistance.
+    /// If the ray origin is inside the box, the hit distance is zero.
+    RayHit QueryClosestHit(const float3& RayOrigin,
+                           const float3& RayDirection,
+                           float         MaxDistance = FLT_MAX) const
+    {
+        const float3 InvDir = GetInverseDirection(RayDirection);
+        return TraceClosestHit(RayOrigin, InvDir, MaxDistance,
+                               [&](Uint32 PrimIdx, float& Distance) //
+                               {
+                                   return IntersectRayBox(RayOrigin, InvDir, m_PrimBoxes[PrimIdx], Distance, Distance);
+                               });
+    }
+
+    /// Finds the closest primitive hit by the ray within MaxDistance using the application-defined
+    /// primitive intersection function:
+    ///
+    ///     bool IntersectPrim(Uint32 PrimId, float& Distance);
+    ///
+    /// On input, Distance is the distance to the closest hit found so far. The function should return
+    /// true and write the distance to the hit if the primitive is hit closer than that.
+    template <typename IntersectPrimType>
+    RayHit QueryClosestHit(const float3&     RayOrigin,
+                           const float3&     RayDirection,
+                           float             MaxDistance,
+                           IntersectPrimType IntersectPrim) const
+    {
+        return TraceClosestHit(RayOrigin, GetInverseDirection(RayDirection), MaxDistance,
+                               [&](Uint32 PrimIdx, float& Distance) //
+                               {
+                                   return IntersectPrim(m_PrimIds[PrimIdx], Distance);
+                               });
+    }
+
+    const std::vector<Node>& GetNodes() const { return m_Nodes; }
+
+    /// Returns primitive ids in the order they are referenced by the leaves
+    const std::vector<Uint32>& GetPrimIds() const { return m_PrimIds; }
+
+    Uint32 GetNumPrimitives() const { return static_cast<Uint32>(m_PrimIds.size()); }
+
+    /// Returns the number of levels in the hierarchy
+    Uint32 GetDepth() const { return m_Depth; }
+
+    /// Returns the bounding box of all primitives
+    const BoundBox& GetBounds() const
+    {
+        VERIFY(!m_Nodes.empty(), "The hierarchy is empty");
+        return m_Nodes[0].Box;
+    }
+
+    /// Intersects the ray defined by the origin and the inverse direction with the box.
+    /// Returns true if the box is hit at a distance that is less than MaxDistance, and writes the
+    /// distance to the hit, which is zero if the origin is inside the box, to EnterDist.
+    static bool IntersectRayBox(const float3&   RayOrigin,
+                                const float3&   InvDirection,
+                                const BoundBox& Box,
+                                float           MaxDistance,
+                                float&          EnterDist)
+    {
+        const float3 t0 = (Box.Min - RayOrigin) * InvDirection;
+        const float3 t1 = (Box.Max - RayOrigin) * InvDirection;
+
+        const float Enter = max3(std::min(t0.x, t1.x), std::min(t0.y, t1.y), std::min(t0.z, t1.z));
+        const float Exit  = min3(std::max(t0.x, t1.x), std::max(t0.y, t1.y), std::max(t0.z, t1.z));
+
+        EnterDist = std::max(Enter, 0.f);
+        return EnterDist <= Exit && EnterDist < MaxDistance;
+    }
+
+    static float3 GetInverseDirection(const float3& RayDirection)
+    {
+        VERIFY_EXPR(RayDirection != float3(0, 0, 0));
+        return float3{1.f / RayDirection.x, 1.f / RayDirection.y, 1.f / RayDirection.z};
+    }
+
+private:
+    // Limits the depth of SAH splits. Deeper subtrees are split in the middle, which
+    // keeps the total depth below MaxDepth for any number of primitives.
+    static constexpr Uint32 MaxSAHDepth = 24;
+    static constexpr Uint32 MaxDepth    = 64;
+
+    template <typename IntersectPrimType>
+    RayHit TraceClosestHit(const float3&     RayOrigin,
+                           const float3&     InvDirection,
+                           float             MaxDistance,
+                           IntersectPrimType IntersectPrim) const;
+
+    void FinalizeBuild(const BoundBox* PrimBoxes);
+    void UpdateNodeBox(Uint32 NodeIdx);
+
+    std::vector<Node>   m_Nodes;
+    std::vector<Uint32> m_PrimIds;
+    // Primitive boxes in the same order as m_PrimIds
+    std::vector<BoundBox> m_PrimBoxes;
+    // Parent of every node, InvalidIndex for the root
+    std::vector<Uint32> m_NodeParents;
+    // For every primitive id, the index of its leaf and its position in m_PrimIds
+    std::vector<Uint32> m_PrimLeaves;
+    std::vector<Uint32> m_PrimSlots;
+
+    Uint32 m_Depth = 0;
+};
+
+template <typename IntersectPrimType>
+BoundingVolumeHierarchy::RayHit BoundingVolumeHierarchy::TraceClosestHit(const float3&     RayOrigin,
+                                                                         const float3&     InvDirection,
+                                                                         float             MaxDistance,
+                                                                         IntersectPrimType IntersectPrim) const
+{
+    RayHit Hit;
+    Hit.Distance = MaxDistance;
+
+    float RootDist = 0;
+    if (m_Nodes.empty() || !IntersectRayBox(RayOrigin, InvDirection, m_Nodes[0].Box, Hit.Distance, RootDist))
+        return Hit;
+
+    struct StackEntry
+    {
+        Uint32 NodeIdx;
+        float  Distance;
+    };
+    StackEntry Stack[MaxDepth];
+    Uint32     StackSize = 0;
+
+    Uint32 NodeIdx = 0;
+    while (true)
+    {
+        const Node& CurrNode = m_Nodes[NodeIdx];
+        if (CurrNode.IsLeaf())
+        {
+            for (Uint32 i = CurrNode.FirstChildOrPrim; i < CurrNode.FirstChildOrPrim + CurrNode.NumPrims; ++i)
+            {
+                float Distance = Hit.Distance;
+                if (IntersectPrim(i, Distance) && Distance < Hit.Distance)
+                {
+                    Hit.PrimId   = m_PrimIds[i];
+                    Hit.Distance = Distance;
+                }
+            }
+        }
+        else
+        {
+            const Uint32 Child0 = CurrNode.FirstChildOrPrim;
+            const Uint32 Child1 = Child0 + 1;
+
+            float      Dist0 = 0, Dist1 = 0;
+            const bool Hit0 = IntersectRayBox(RayOrigin, InvDirection, m_Nodes[Child0].Box, Hit.Distance, Dist0);
+            const bool Hit1 = IntersectRayBox(RayOrigin, InvDirection, m_Nodes[Child1].Box, Hit.Distance, Dist1);
+            if (Hit0 && Hit1)
+            {
+                // Visit the closer child first
+                VERIFY(StackSize < MaxDepth, "Stack overflow: the hierarchy is too deep");
+                if (Dist0 <= Dist1)
+                {
+                    Stack[StackSize++] = {Child1, Dist1};
+                    NodeIdx            = Child0;
+                }
+                else
+                {
+                    Stack[StackSize++] = {Child0, Dist0};
+                    NodeIdx            = Child1;
+                }
+                continue;
+            }
+            else if (Hit0 || Hit1)
+            {
+                NodeIdx = Hit0 ? Child0 : Child1;
+                continue;
+            }
+        }
+
+        // Skip the nodes that are farther than the closest hit found so far
+        while (StackSize > 0 && Stack[StackSize - 1].Distance >= Hit.Distance)
+            --StackSize;
+        if (StackSize == 0)
+            break;
+
+        NodeIdx = Stack[--StackSize].NodeIdx;
+    }
+
+    return Hit;
+}
+
+} // namespace Diligent
@@ -30,15 +30,27 @@
 /// \file
 /// Defines Diligent::DefaultRawMemoryAllocator class
 
+#include <atomic>
+#include <vector>
+
 #include "../../Primitives/interface/MemoryAllocator.h"
+#include "../../Primitives/interface/DataBlob.h"
 
 namespace Diligent
 {
 
+/// Default raw memory allocator
+
+/// \remarks The allocator can optionally track allocations by their call site, which is identified
+///          by the debug description, file name and line number passed to Allocate(). Tracking is
+///          disabled by default and is enabled by EnableAllocationTracking(). Live allocations are
+///          kept in a sharded table, and per-site counters are updated atomically, so that tracking
+///          does not serialize threads on a single lock.
 class DefaultRawMemoryAllocator : public IMemoryAllocator
 {
 public:
     DefaultRawMemoryAllocator();
+    ~DefaultRawMemoryAllocator();
 
     /// Allocates block of memory
     virtual void* Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber) override;
@@ -48,11 +60,57 @@ public:
 
     static DefaultRawMemoryAllocator& GetAllocator();
 
+    /// Statistics of the allocations made from a single call site
+    struct AllocationSiteStats
+    {
+        const Char* Description = nullptr;
+        const char* FileName    = nullptr;
+        Int32       LineNumber  = 0;
+
+        /// The total size and the number of allocations that have not been released yet
+        size_t LiveBytes          = 0;
+        size_t NumLiveAllocations = 0;
+
+        /// The maximum value of LiveBytes
+        size_t PeakLiveBytes = 0;
+
+        /// The total number of allocations made from this site
+        Uint64 TotalAllocations = 0;
+    };
+
+    /// Enables or disables allocation tracking.
+
+    /// \remarks Only allocations made while tracking is enabled are tracked.
+    ///          Releases of tracked allocations are accounted for even after tracking is disabled.
+    void EnableAllocationTracking(bool Enable);
+
+    bool IsAllocationTrackingEnabled() const { return m_TrackingEnabled.load(std::memory_order_relaxed); }
+
+    /// Returns statistics of the call sites sorted by the live size in descending order.
+    /// Sites with equal live sizes are sorted by the peak live size, then by the number of allocations.
+    /// If MaxSites is not zero, only the top MaxSites sites are returned.
+    std::vector<AllocationSiteStats> GetAllocationSiteStats(size_t MaxSites = 0) const;
+
+    /// Logs the top NumSites call sites by the live size
+    void LogTopAllocationSites(size_t NumSites) const;
+
+    /// Writes the text report of the top MaxSites (all if zero) call sites into a new data blob.
+    /// Every line of the report describes one site: live bytes, live allocations, peak live bytes,
+    /// total allocations, file(line) and description separated by tabs.
+    void SnapshotAllocationSites(IDataBlob** ppSnapshot, size_t MaxSites = 0) const;
+
 private:
     DefaultRawMemoryAllocator(const DefaultRawMemoryAllocator&) = delete;
     DefaultRawMemoryAllocator(DefaultRawMemoryAllocator&&)      = delete;
     DefaultRawMemoryAllocator& operator=(const DefaultRawMemoryAllocator&) = delete;
     DefaultRawMemoryAllocator& operator=(DefaultRawMemoryAllocator&&) = delete;
+
+    class AllocationTracker;
+
+    // The tracker is created when tracking is enabled for the first time and
+    // lives as long as the allocator
+    std::atomic<AllocationTracker*> m_pTracker{nullptr};
+    std::atomic<bool>               m_TrackingEnabled{false};
 };
 
 } // namespace Diligent
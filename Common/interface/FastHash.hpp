@@ -0,0 +1,227 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Fast non-cryptographic hash functions for memory blocks and strings
+
+#include <cstring>
+#include <type_traits>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#    include <intrin.h>
+#endif
+
+#include "../../Primitives/interface/BasicTypes.h"
+#include "../../Platforms/Basic/interface/DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+// The hash functions are based on wyhash by Wang Yi (public domain, https://github.com/wangyi-fudan/wyhash).
+// They process 8 bytes per step using 64x64->128-bit multiplication and are much faster
+// than combining the hashes of individual values. The results depend on the byte order
+// of the platform and must not be stored.
+namespace FastHashInternal
+{
+
+// clang-format off
+static constexpr Uint64 Secret0 = 0xa0761d6478bd642full;
+static constexpr Uint64 Secret1 = 0xe7037ed1a0b428dbull;
+static constexpr Uint64 Secret2 = 0x8ebc6af09c88c6e3ull;
+static constexpr Uint64 Secret3 = 0x589965cc75374cc3ull;
+// clang-format on
+
+// Computes the 128-bit product of A and B and stores low 64 bits in A and high 64 bits in B
+inline void Multiply128(Uint64& A, Uint64& B)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = A;
+    r *= B;
+    A = static_cast<Uint64>(r);
+    B = static_cast<Uint64>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    A = _umul128(A, B, &B);
+#else
+    const Uint64 ha = A >> 32, hb = B >> 32, la = static_cast<Uint32>(A), lb = static_cast<Uint32>(B);
+
+    const Uint64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+
+    Uint64 c  = t < rl ? 1 : 0;
+    Uint64 lo = t + (rm1 << 32);
+    c += lo < t ? 1 : 0;
+    Uint64 hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+
+    A = lo;
+    B = hi;
+#endif
+}
+
+inline Uint64 Mix(Uint64 A, Uint64 B)
+{
+    Multiply128(A, B);
+    return A ^ B;
+}
+
+inline Uint64 Read8(const Uint8* p)
+{
+    Uint64 v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+inline Uint64 Read4(const Uint8* p)
+{
+    Uint32 v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+// Reads 1 to 3 bytes
+inline Uint64 Read3(const Uint8* p, size_t k)
+{
+    return (Uint64{p[0]} << 16) | (Uint64{p[k >> 1]} << 8) | p[k - 1];
+}
+
+// Mix(Secret0, Secret1), precomputed to shorten the dependency chain for the default seed
+static constexpr Uint64 DefaultSeed = 0x1ff5c2923a788d2cull;
+
+inline Uint64 InitSeed(Uint64 Seed)
+{
+    return Seed == 0 ? DefaultSeed : Seed ^ Mix(Seed ^ Secret0, Secret1);
+}
+
+// Hashes the last 0 to 16 bytes of the data
+inline Uint64 Finalize(const Uint8* p, size_t TailSize, Uint64 State, Uint64 TotalSize)
+{
+    VERIFY_EXPR(TailSize <= 16);
+    Uint64 a = 0, b = 0;
+    if (TailSize >= 4)
+    {
+        const size_t Offset = (TailSize >> 3) << 2;
+
+        a = (Read4(p) << 32) | Read4(p + Offset);
+        b = (Read4(p + TailSize - 4) << 32) | Read4(p + TailSize - 4 - Offset);
+    }
+    else if (TailSize > 0)
+    {
+        a = Read3(p, TailSize);
+    }
+    a ^= Secret1;
+    b ^= State;
+    Multiply128(a, b);
+    return Mix(a ^ Secret0 ^ TotalSize, b ^ Secret1);
+}
+
+// Hashes the remaining bytes after all 48-byte blocks have been processed.
+// If Size < 16, the 16 bytes before p must be readable.
+inline Uint64 HashTail(const Uint8* p, size_t Size, Uint64 Seed, Uint64 TotalSize)
+{
+    if (TotalSize <= 16)
+        return Finalize(p, Size, Seed, TotalSize);
+
+    while (Size > 16)
+    {
+        Seed = Mix(Read8(p) ^ Secret1, Read8(p + 8) ^ Seed);
+        Size -= 16;
+        p += 16;
+    }
+    // The last 16 bytes (which may overlap the previous block)
+    return Finalize(p + Size - 16, 16, Seed, TotalSize);
+}
+
+struct LaneSeeds
+{
+    Uint64 Seed0;
+    Uint64 Seed1;
+    Uint64 Seed2;
+};
+
+inline void ProcessBlock48(const Uint8* p, LaneSeeds& Seeds)
+{
+    Seeds.Seed0 = Mix(Read8(p) ^ Secret1, Read8(p + 8) ^ Seeds.Seed0);
+    Seeds.Seed1 = Mix(Read8(p + 16) ^ Secret2, Read8(p + 24) ^ Seeds.Seed1);
+    Seeds.Seed2 = Mix(Read8(p + 32) ^ Secret3, Read8(p + 40) ^ Seeds.Seed2);
+}
+
+} // namespace FastHashInternal
+
+/// Computes 64-bit hash of a memory block
+inline Uint64 ComputeFastHash(const void* pData, size_t Size, Uint64 Seed = 0)
+{
+    using namespace FastHashInternal;
+
+    const auto* p = static_cast<const Uint8*>(pData);
+
+    Seed = InitSeed(Seed);
+    if (Size <= 48)
+        return HashTail(p, Size, Seed, Size);
+
+    LaneSeeds Seeds{Seed, Seed, Seed};
+
+    size_t i = Size;
+    do
+    {
+        ProcessBlock48(p, Seeds);
+        p += 48;
+        i -= 48;
+    } while (i > 48);
+
+    return HashTail(p, i, Seeds.Seed0 ^ Seeds.Seed1 ^ Seeds.Seed2, Size);
+}
+
+/// Computes 64-bit hash of the binary representation of a trivially copyable object.
+
+/// \note The object must not contain uninitialized padding bytes.
+template <typename T>
+Uint64 ComputePODHash(const T& Val, Uint64 Seed = 0)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be hashed as raw memory");
+    static_assert(!std::is_pointer<T>::value, "Hashing a pointer value is likely a mistake. Use ComputeFastHash() to hash the data it points to");
+    return ComputeFastHash(&Val, sizeof(Val), Seed);
+}
+
+/// Computes 64-bit hash of a null-terminated string
+template <typename CharType>
+Uint64 ComputeFastStringHash(const CharType* Str, Uint64 Seed = 0)
+{
+    VERIFY_EXPR(Str != nullptr);
+    size_t Len = 0;
+    while (Str[Len] != 0)
+        ++Len;
+    return ComputeFastHash(Str, Len * sizeof(CharType), Seed);
+}
+
+template <>
+inline Uint64 ComputeFastStringHash<char>(const char* Str, Uint64 Seed)
+{
+    VERIFY_EXPR(Str != nullptr);
+    return ComputeFastHash(Str, strlen(Str), Seed);
+}
+
+} // namespace Diligent
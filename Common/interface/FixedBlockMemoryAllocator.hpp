@@ -53,10 +53,35 @@ inline void FillWithDebugPattern(void* ptr, Uint8 Pattern, size_t NumBytes)
 #endif
 
 /// Memory allocator that allocates memory in a fixed-size chunks
+
+/// \remarks When ThreadCacheSize is not zero, every thread that uses the allocator keeps
+///          a private cache (magazine) of up to ThreadCacheSize free blocks. Allocations and
+///          deallocations are served from the cache without taking any locks. The shared page
+///          pool is only accessed to refill an empty cache or to flush a full one, in both
+///          cases in batches of ThreadCacheSize/2 blocks.
+///
+///          When AlignedPages is true, every page is placed at an address aligned by the page size
+///          (rounded up to the power of two) and starts with a small header that contains the page index.
+///          The page that owns a block is then found by masking the block address, and no per-block
+///          address-to-page map is maintained except in debug builds, where it is used to detect double
+///          frees. The number of blocks in a page is adjusted to fill the aligned page. Aligned pages are
+///          allocated from raw memory in chunks that include up to one page of alignment overhead, and
+///          the first chunk is only allocated when the first block is requested.
+///
+///          When MaxNumBlocksInPage is greater than NumBlocksInPage, the first page contains NumBlocksInPage
+///          blocks, and every next page is twice as large as the previous one until it reaches
+///          MaxNumBlocksInPage blocks. This keeps the overhead small for allocators that are rarely used
+///          and reduces the number of pages for allocators that are used heavily. Page growth is not
+///          supported for aligned pages.
 class FixedBlockMemoryAllocator final : public IMemoryAllocator
 {
 public:
-    FixedBlockMemoryAllocator(IMemoryAllocator& RawMemoryAllocator, size_t BlockSize, Uint32 NumBlocksInPage);
+    FixedBlockMemoryAllocator(IMemoryAllocator& RawMemoryAllocator,
+                              size_t            BlockSize,
+                              Uint32            NumBlocksInPage,
+                              Uint32            ThreadCacheSize    = 0,
+                              bool              AlignedPages       = false,
+                              Uint32            MaxNumBlocksInPage = 0);
     ~FixedBlockMemoryAllocator();
 
     /// Allocates block of memory
@@ -65,6 +90,26 @@ public:
     /// Releases memory
     virtual void Free(void* Ptr) override final;
 
+    struct Statistics
+    {
+        /// The number of pages
+        size_t NumPages = 0;
+
+        /// The total number of blocks in all pages
+        size_t NumBlocks = 0;
+
+        /// The number of blocks taken from the pages. This includes free blocks held in thread caches.
+        size_t NumAllocatedBlocks = 0;
+
+        /// The memory reserved by all pages, in bytes
+        size_t ReservedSize = 0;
+    };
+
+    /// Returns the allocator statistics
+    Statistics GetStatistics();
+
+    size_t GetBlockSize() const { return m_BlockSize; }
+
 private:
     // clang-format off
     FixedBlockMemoryAllocator             (const FixedBlockMemoryAllocator&) = delete;
@@ -74,6 +119,17 @@ private:
     // clang-format on
 
     void CreateNewPage();
+    void AllocateAlignedPages();
+
+    // The methods below must be called with m_Mutex locked
+    void* AllocateFromPages();
+    void  FreeToPages(void* Ptr);
+
+    struct ThreadCache;
+    class ThreadCacheList;
+    ThreadCache* GetThreadCache();
+    void         RefillThreadCache(ThreadCache& Cache);
+    void         FlushThreadCache(ThreadCache& Cache, Uint32 NumBlocksToFlush);
 
     // Memory page class is based on the fixed-size memory pool described in "Fast Efficient Fixed-Size Memory Pool"
     // by Ben Kenwright
@@ -85,22 +141,30 @@ private:
         static constexpr Uint8 DeallocatedBlockMemPattern = 0xDE;
         static constexpr Uint8 InitializedBlockMemPattern = 0xCF;
 
-        MemoryPage(FixedBlockMemoryAllocator& OwnerAllocator) :
+        // If pPageStart is null, the page allocates its memory from the raw allocator.
+        // Otherwise, the memory is owned by the allocator (aligned pages).
+        MemoryPage(FixedBlockMemoryAllocator& OwnerAllocator, Uint32 NumBlocks, void* pPageStart = nullptr) :
             // clang-format off
-            m_NumFreeBlocks       {OwnerAllocator.m_NumBlocksInPage},
+            m_NumBlocks           {NumBlocks},
+            m_NumFreeBlocks       {NumBlocks},
             m_NumInitializedBlocks{0},
+            m_pPageStart          {pPageStart},
             m_pOwnerAllocator     {&OwnerAllocator}
         // clang-format on
         {
-            auto PageSize = OwnerAllocator.m_BlockSize * OwnerAllocator.m_NumBlocksInPage;
-            m_pPageStart  = reinterpret_cast<Uint8*>(
-                OwnerAllocator.m_RawMemoryAllocator.Allocate(PageSize, "FixedBlockMemoryAllocator page", __FILE__, __LINE__));
+            auto PageSize = OwnerAllocator.m_BlockSize * m_NumBlocks;
+            if (m_pPageStart == nullptr)
+            {
+                m_pPageStart = reinterpret_cast<Uint8*>(
+                    OwnerAllocator.m_RawMemoryAllocator.Allocate(PageSize, "FixedBlockMemoryAllocator page", __FILE__, __LINE__));
+            }
             m_pNextFreeBlock = m_pPageStart;
             FillWithDebugPattern(m_pPageStart, NewPageMemPattern, PageSize);
         }
 
         MemoryPage(MemoryPage&& Page) noexcept :
             // clang-format off
+            m_NumBlocks           {Page.m_NumBlocks           },
             m_NumFreeBlocks       {Page.m_NumFreeBlocks       },
             m_NumInitializedBlocks{Page.m_NumInitializedBlocks},
             m_pPageStart          {Page.m_pPageStart          },
@@ -108,6 +172,7 @@ private:
             m_pOwnerAllocator     {Page.m_pOwnerAllocator     }
         // clang-format on
         {
+            Page.m_NumBlocks            = 0;
             Page.m_NumFreeBlocks        = 0;
             Page.m_NumInitializedBlocks = 0;
             Page.m_pPageStart           = nullptr;
@@ -117,14 +182,14 @@ private:
 
         ~MemoryPage()
         {
-            if (m_pOwnerAllocator)
+            if (m_pOwnerAllocator && m_pOwnerAllocator->m_PageAlignment == 0)
                 m_pOwnerAllocator->m_RawMemoryAllocator.Free(m_pPageStart);
         }
 
         void* GetBlockStartAddress(Uint32 BlockIndex) const
         {
             VERIFY_EXPR(m_pOwnerAllocator != nullptr);
-            VERIFY(BlockIndex >= 0 && BlockIndex < m_pOwnerAllocator->m_NumBlocksInPage, "Invalid block index");
+            VERIFY(BlockIndex >= 0 && BlockIndex < m_NumBlocks, "Invalid block index");
             return reinterpret_cast<Uint8*>(m_pPageStart) + BlockIndex * m_pOwnerAllocator->m_BlockSize;
         }
 
@@ -134,7 +199,7 @@ private:
             size_t Delta = reinterpret_cast<const Uint8*>(pBlockAddr) - reinterpret_cast<Uint8*>(m_pPageStart);
             VERIFY(Delta % m_pOwnerAllocator->m_BlockSize == 0, "Invalid address");
             Uint32 BlockIndex = static_cast<Uint32>(Delta / m_pOwnerAllocator->m_BlockSize);
-            VERIFY(BlockIndex >= 0 && BlockIndex < m_pOwnerAllocator->m_NumBlocksInPage, "Invalid block index");
+            VERIFY(BlockIndex >= 0 && BlockIndex < m_NumBlocks, "Invalid block index");
         }
 #else
 #    define dbgVerifyAddress(...)
@@ -146,12 +211,12 @@ private:
 
             if (m_NumFreeBlocks == 0)
             {
-                VERIFY_EXPR(m_NumInitializedBlocks == m_pOwnerAllocator->m_NumBlocksInPage);
+                VERIFY_EXPR(m_NumInitializedBlocks == m_NumBlocks);
                 return nullptr;
             }
 
             // Initialize the next block
-            if (m_NumInitializedBlocks < m_pOwnerAllocator->m_NumBlocksInPage)
+            if (m_NumInitializedBlocks < m_NumBlocks)
             {
                 // Link next uninitialized block to the end of the list:
 
@@ -173,7 +238,7 @@ private:
                 FillWithDebugPattern(pUninitializedBlock, InitializedBlockMemPattern, m_pOwnerAllocator->m_BlockSize);
                 void** ppNextBlock = reinterpret_cast<void**>(pUninitializedBlock);
                 ++m_NumInitializedBlocks;
-                if (m_NumInitializedBlocks < m_pOwnerAllocator->m_NumBlocksInPage)
+                if (m_NumInitializedBlocks < m_NumBlocks)
                     *ppNextBlock = GetBlockStartAddress(m_NumInitializedBlocks);
                 else
                     *ppNextBlock = nullptr;
@@ -205,6 +270,8 @@ private:
             ++m_NumFreeBlocks;
         }
 
+        Uint32 GetNumBlocks() const { return m_NumBlocks; }
+
         bool HasSpace() const { return m_NumFreeBlocks > 0; }
         bool HasAllocations() const { return m_NumFreeBlocks < m_NumInitializedBlocks; }
 
@@ -213,6 +280,7 @@ private:
         MemoryPage& operator=(const MemoryPage) = delete;
         MemoryPage& operator=(MemoryPage&&) = delete;
 
+        Uint32                     m_NumBlocks            = 0;       // Num of blocks in the page
         Uint32                     m_NumFreeBlocks        = 0;       // Num of remaining blocks
         Uint32                     m_NumInitializedBlocks = 0;       // Num of initialized blocks
         void*                      m_pPageStart           = nullptr; // Beginning of memory pool
@@ -226,11 +294,31 @@ private:
     using AddrToPageIdMapElem = std::pair<void* const, size_t>;
     std::unordered_map<void*, size_t, std::hash<void*>, std::equal_to<void*>, STDAllocatorRawMem<AddrToPageIdMapElem>> m_AddrToPageId;
 
+    // Raw memory chunks that hold aligned pages, and aligned pages that have not been used yet
+    std::vector<void*, STDAllocatorRawMem<void*>> m_AlignedPageChunks;
+    std::vector<void*, STDAllocatorRawMem<void*>> m_SpareAlignedPages;
+
     std::mutex m_Mutex;
 
     IMemoryAllocator& m_RawMemoryAllocator;
     const size_t      m_BlockSize;
-    const Uint32      m_NumBlocksInPage;
+    const size_t      m_PageAlignment; // Zero if pages are not aligned
+    const Uint32      m_NumBlocksInPage; // The number of blocks in the first page
+    const Uint32      m_MaxNumBlocksInPage;
+    const Uint32      m_ThreadCacheSize;
+
+    // Protected by m_Mutex
+    Uint32 m_NextPageNumBlocks  = 0;
+    size_t m_TotalNumBlocks     = 0;
+    size_t m_NumAllocatedBlocks = 0;
+
+    // Unique allocator id used to identify the allocator in thread caches. Unlike the
+    // allocator address, the id is never reused after the allocator is destroyed.
+    const Uint64 m_AllocatorId;
+
+    // Intrusive list of thread caches attached to this allocator.
+    // Protected by the global thread cache registry mutex.
+    ThreadCache* m_pThreadCaches = nullptr;
 };
 
 IMemoryAllocator& GetRawAllocator();
@@ -259,6 +347,16 @@ public:
 #endif
         m_NumAllocationsInPage = NumAllocationsInPage;
     }
+    static void SetThreadCacheSize(Uint32 ThreadCacheSize)
+    {
+#ifdef DILIGENT_DEBUG
+        if (m_bPoolInitialized && m_ThreadCacheSize != ThreadCacheSize)
+        {
+            LOG_WARNING_MESSAGE("Setting pool thread cache size after the pool has been initialized has no effect");
+        }
+#endif
+        m_ThreadCacheSize = ThreadCacheSize;
+    }
     static ObjectPool& GetPool()
     {
         static ObjectPool ThePool;
@@ -294,10 +392,11 @@ public:
 
 private:
     static Uint32            m_NumAllocationsInPage;
+    static Uint32            m_ThreadCacheSize;
     static IMemoryAllocator* m_pRawAllocator;
 
     ObjectPool() :
-        m_FixedBlockAlloctor(m_pRawAllocator ? *m_pRawAllocator : GetRawAllocator(), sizeof(ObjectType), m_NumAllocationsInPage)
+        m_FixedBlockAlloctor(m_pRawAllocator ? *m_pRawAllocator : GetRawAllocator(), sizeof(ObjectType), m_NumAllocationsInPage, m_ThreadCacheSize)
     {}
 #ifdef DILIGENT_DEBUG
     static bool m_bPoolInitialized;
@@ -307,6 +406,9 @@ private:
 template <typename ObjectType>
 Uint32 ObjectPool<ObjectType>::m_NumAllocationsInPage = 64;
 
+template <typename ObjectType>
+Uint32 ObjectPool<ObjectType>::m_ThreadCacheSize = 0;
+
 template <typename ObjectType>
 IMemoryAllocator* ObjectPool<ObjectType>::m_pRawAllocator = nullptr;
 
@@ -317,6 +419,7 @@ bool ObjectPool<ObjectType>::m_bPoolInitialized = false;
 
 #define SET_POOL_RAW_ALLOCATOR(ObjectType, Allocator)        ObjectPool<ObjectType>::SetRawAllocator(Allocator)
 #define SET_POOL_PAGE_SIZE(ObjectType, NumAllocationsInPage) ObjectPool<ObjectType>::SetPageSize(NumAllocationsInPage)
+#define SET_POOL_THREAD_CACHE_SIZE(ObjectType, CacheSize)    ObjectPool<ObjectType>::SetThreadCacheSize(CacheSize)
 #define NEW_POOL_OBJECT(ObjectType, Desc, ...)               ObjectPool<ObjectType>::GetPool().NewObject(Desc, __FILE__, __LINE__, ##__VA_ARGS__)
 #define DESTROY_POOL_OBJECT(pObject)                         ObjectPool<std::remove_reference<decltype(*pObject)>::type>::GetPool().Destroy(pObject)
 
@@ -33,6 +33,7 @@
 
 #include "../../Primitives/interface/Errors.hpp"
 #include "../../Platforms/Basic/interface/DebugUtilities.hpp"
+#include "FastHash.hpp"
 
 #define LOG_HASH_CONFLICTS 1
 
@@ -66,11 +67,7 @@ struct CStringHash
 {
     size_t operator()(const CharType* str) const
     {
-        // http://www.cse.yorku.ca/~oz/hash.html
-        std::size_t Seed = 0;
-        while (size_t Ch = *(str++))
-            Seed = Seed * 65599 + Ch;
-        return Seed;
+        return static_cast<size_t>(ComputeFastStringHash(str));
     }
 };
 
@@ -117,6 +114,16 @@ public:
         }
     }
 
+    // Initializes the key with the precomputed string hash (e.g. the hash of the interned string),
+    // which must be equal to the hash computed by CStringHash. The string is not copied.
+    HashMapStringKey(const Char* Str, size_t PrecomputedHash) noexcept :
+        StrPtr{Str},
+        Hash{PrecomputedHash}
+    {
+        VERIFY(Str, "String pointer cannot be null");
+        VERIFY_EXPR(PrecomputedHash == 0 || PrecomputedHash == CStringHash<Char>{}(Str));
+    }
+
     explicit // Make this constructor explicit to avoid unintentional string copies
         HashMapStringKey(const String& Str) :
         StrPtr{nullptr},
@@ -129,7 +136,7 @@ public:
         // clang-format off
         StringBuff{std::move(Key.StringBuff)},
         StrPtr    {std::move(Key.StrPtr)},
-        Hash      {0}
+        Hash      {Key.Hash}
     // clang-format on
     {
         Key.StrPtr = nullptr;
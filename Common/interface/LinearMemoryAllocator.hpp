@@ -0,0 +1,117 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Declaration of Diligent::LinearMemoryAllocator class
+
+#include <vector>
+#include "../../Primitives/interface/MemoryAllocator.h"
+#include "STDAllocator.hpp"
+
+namespace Diligent
+{
+
+/// Resettable memory allocator that sub-allocates memory linearly from large pages
+
+/// \remarks The allocator is intended for short-living objects, for instance containers that are
+///          built and thrown away every frame. Allocation is a pointer bump, and Free() does nothing
+///          except rolling back the most recent allocation. The memory is reclaimed all at once by
+///          Reset(), at which point all objects allocated since the previous reset must have been released.
+///
+///          Pages are retained between resets. If the allocations made since the previous reset did not fit
+///          into a single page, Reset() replaces all pages with one page large enough to hold them, so that
+///          a steady per-frame workload is served from one contiguous page.
+///
+///          The allocator is not thread-safe. GetThreadAllocator() returns an instance that is private
+///          to the calling thread; every thread is responsible for resetting its own instance.
+class LinearMemoryAllocator final : public IMemoryAllocator
+{
+public:
+    LinearMemoryAllocator(IMemoryAllocator& RawMemoryAllocator, size_t PageSize);
+    ~LinearMemoryAllocator();
+
+    /// Allocates block of memory
+    virtual void* Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber) override final;
+
+    /// Releases memory. Only the most recent allocation is actually reclaimed.
+    virtual void Free(void* Ptr) override final;
+
+    /// Makes all memory available for new allocations
+    void Reset();
+
+    /// Returns all pages to the raw memory allocator
+    void ReleasePages();
+
+    /// Returns the total size of the memory allocated since the last reset.
+    /// The unused space at the end of the pages that did not fit the next allocation is not counted.
+    size_t GetUsedSize() const;
+
+    /// Returns the total size of all pages
+    size_t GetReservedSize() const { return m_ReservedSize; }
+
+    /// Returns the allocator private to the calling thread that uses the default
+    /// raw memory allocator
+    static LinearMemoryAllocator& GetThreadAllocator();
+
+    // clang-format off
+    LinearMemoryAllocator           (const LinearMemoryAllocator&) = delete;
+    LinearMemoryAllocator           (LinearMemoryAllocator&&)      = delete;
+    LinearMemoryAllocator& operator=(const LinearMemoryAllocator&) = delete;
+    LinearMemoryAllocator& operator=(LinearMemoryAllocator&&)      = delete;
+    // clang-format on
+
+private:
+    struct Page
+    {
+        void*  pRawMemory = nullptr;
+        Uint8* pData      = nullptr;
+        size_t Size       = 0;
+    };
+
+    void AddPage(size_t Size);
+
+    IMemoryAllocator& m_RawMemoryAllocator;
+    const size_t      m_PageSize;
+
+    std::vector<Page, STDAllocatorRawMem<Page>> m_Pages;
+
+    size_t m_CurrPage     = 0;
+    size_t m_CurrOffset   = 0;
+    size_t m_ReservedSize = 0;
+    void*  m_pLastAlloc   = nullptr;
+
+    // The total size of the allocations in the pages before the current one
+    size_t m_PrevPagesUsedSize = 0;
+
+#ifdef DILIGENT_DEBUG
+    size_t m_DbgNumAllocations = 0;
+#endif
+};
+
+} // namespace Diligent
@@ -27,12 +27,113 @@
 
 #pragma once
 
+#include <atomic>
+
+#include "../../Primitives/interface/BasicTypes.h"
 #include "../../Platforms/interface/Atomics.hpp"
 #include "../../Platforms/Basic/interface/DebugUtilities.hpp"
 
+#ifndef DILIGENT_USE_ADAPTIVE_LOCKS
+#    define DILIGENT_USE_ADAPTIVE_LOCKS 0
+#endif
+
 namespace ThreadingTools
 {
 
+// Spin-then-park lock. A contended thread first spins for a short while using the CPU
+// pause instruction and then goes to sleep until the lock is released (futex on Linux,
+// address-keyed condition variables on other platforms). Unlike the spin-yield LockHelper,
+// a thread waiting for a long-held lock does not burn CPU time.
+//
+// The lock word has three states: unlocked, locked, and locked with (possibly) sleeping waiters.
+// Unlock only issues a wake-up when the lock was contended, so the uncontended path is
+// a single atomic operation in both directions.
+class AdaptiveLockFlag
+{
+public:
+    AdaptiveLockFlag() noexcept {}
+
+    bool TryLock() noexcept
+    {
+        return TryLock(m_State);
+    }
+
+    void Lock(int SpinCount = DefaultSpinCount) noexcept
+    {
+        Lock(m_State, SpinCount);
+    }
+
+    void Unlock() noexcept
+    {
+        Unlock(m_State);
+    }
+
+    bool IsLocked() const noexcept
+    {
+        return m_State.load(std::memory_order_relaxed) != Unlocked;
+    }
+
+    static constexpr const int DefaultSpinCount = 128;
+
+    // Low-level protocol operating on the raw lock word. LockHelper uses it to
+    // implement LockFlag when DILIGENT_USE_ADAPTIVE_LOCKS is enabled.
+    static bool TryLock(std::atomic<Diligent::Uint32>& State) noexcept
+    {
+        Diligent::Uint32 Expected = Unlocked;
+        return State.compare_exchange_strong(Expected, Locked, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    static void Lock(std::atomic<Diligent::Uint32>& State, int SpinCount = DefaultSpinCount) noexcept
+    {
+        if (!TryLock(State))
+            LockContended(State, SpinCount);
+    }
+
+    // Note that the lock word may be destroyed by another thread as soon as the state is
+    // reset, so the wake-up must only use the address of the word and never dereference it.
+    static void Unlock(std::atomic<Diligent::Uint32>& State) noexcept
+    {
+        VERIFY(State.load(std::memory_order_relaxed) != Unlocked, "The lock is not locked");
+        if (State.exchange(Unlocked, std::memory_order_release) == Contended)
+            WakeOne(&State);
+    }
+
+    // Global contention counters of all adaptive locks. Counting is disabled by default
+    // and only affects the contended path.
+    struct ContentionStats
+    {
+        // Number of Lock() calls that did not acquire the lock immediately
+        Diligent::Uint64 NumContendedLocks = 0;
+
+        // Total number of spin iterations
+        Diligent::Uint64 NumSpins = 0;
+
+        // Number of times a thread went to sleep
+        Diligent::Uint64 NumParks = 0;
+    };
+    static void            EnableContentionStats(bool Enable) noexcept;
+    static ContentionStats GetContentionStats() noexcept;
+    static void            ResetContentionStats() noexcept;
+
+private:
+    enum : Diligent::Uint32
+    {
+        Unlocked  = 0,
+        Locked    = 1,
+        Contended = 2
+    };
+
+    static void LockContended(std::atomic<Diligent::Uint32>& State, int SpinCount) noexcept;
+    static void WakeOne(const void* pAddress) noexcept;
+
+    std::atomic<Diligent::Uint32> m_State{Unlocked};
+
+    // clang-format off
+    AdaptiveLockFlag           (const AdaptiveLockFlag&) = delete;
+    AdaptiveLockFlag& operator=(const AdaptiveLockFlag&) = delete;
+    // clang-format on
+};
+
 class LockFlag
 {
 public:
@@ -43,19 +144,20 @@ public:
     };
     LockFlag(Atomics::Long InitFlag = LOCK_FLAG_UNLOCKED) noexcept
     {
-        //m_Flag.store(InitFlag);
-        m_Flag = InitFlag;
+        m_Flag = static_cast<Diligent::Uint32>(InitFlag);
     }
 
-    operator Atomics::Long() const { return m_Flag; }
+    operator Atomics::Long() const { return m_Flag != LOCK_FLAG_UNLOCKED ? LOCK_FLAG_LOCKED : LOCK_FLAG_UNLOCKED; }
 
 private:
     friend class LockHelper;
-    Atomics::AtomicLong m_Flag;
+    std::atomic<Diligent::Uint32> m_Flag;
 };
 
 // Spinlock implementation. This kind of lock should be used in scenarios
 // where simultaneous access is uncommon but possible.
+// When DILIGENT_USE_ADAPTIVE_LOCKS is defined, the lock uses the spin-then-park
+// protocol of AdaptiveLockFlag instead of spinning and yielding.
 class LockHelper
 {
 public:
@@ -86,9 +188,12 @@ public:
 
     static bool UnsafeTryLock(LockFlag& LockFlag) noexcept
     {
-        return Atomics::AtomicCompareExchange(LockFlag.m_Flag,
-                                              static_cast<Atomics::Long>(LockFlag::LOCK_FLAG_LOCKED),
-                                              static_cast<Atomics::Long>(LockFlag::LOCK_FLAG_UNLOCKED)) == LockFlag::LOCK_FLAG_UNLOCKED;
+#if DILIGENT_USE_ADAPTIVE_LOCKS
+        return AdaptiveLockFlag::TryLock(LockFlag.m_Flag);
+#else
+        Diligent::Uint32 Expected = LockFlag::LOCK_FLAG_UNLOCKED;
+        return LockFlag.m_Flag.compare_exchange_strong(Expected, LockFlag::LOCK_FLAG_LOCKED);
+#endif
     }
 
     bool TryLock(LockFlag& LockFlag) noexcept
@@ -106,6 +211,9 @@ public:
 
     static void UnsafeLock(LockFlag& LockFlag, int SpinCountToYield = DefaultSpinCountToYield) noexcept
     {
+#if DILIGENT_USE_ADAPTIVE_LOCKS
+        AdaptiveLockFlag::Lock(LockFlag.m_Flag, SpinCountToYield);
+#else
         int SpinCount = 0;
         while (!UnsafeTryLock(LockFlag))
         {
@@ -116,27 +224,24 @@ public:
                 YieldThread();
             }
         }
+#endif
     }
 
     void Lock(LockFlag& LockFlag, int SpinCountToYield = DefaultSpinCountToYield) noexcept
     {
         VERIFY(m_pLockFlag == NULL, "Object already locked");
         // Wait for the flag to become unlocked and lock it
-        int SpinCount = 0;
-        while (!TryLock(LockFlag))
-        {
-            ++SpinCount;
-            if (SpinCount == SpinCountToYield)
-            {
-                SpinCount = 0;
-                YieldThread();
-            }
-        }
+        UnsafeLock(LockFlag, SpinCountToYield);
+        m_pLockFlag = &LockFlag;
     }
 
     static void UnsafeUnlock(LockFlag& LockFlag) noexcept
     {
+#if DILIGENT_USE_ADAPTIVE_LOCKS
+        AdaptiveLockFlag::Unlock(LockFlag.m_Flag);
+#else
         LockFlag.m_Flag = LockFlag::LOCK_FLAG_UNLOCKED;
+#endif
     }
 
     void Unlock() noexcept
@@ -157,4 +262,129 @@ private:
     // clang-format on
 };
 
+// Reader-writer spinlock. Any number of readers may hold the lock simultaneously, while
+// a writer has exclusive access. A waiting writer prevents new readers from acquiring
+// the lock, so that writers are not starved by a steady stream of readers.
+class SharedLockFlag
+{
+public:
+    SharedLockFlag() noexcept {}
+
+    bool TryLockShared() noexcept
+    {
+        auto State = m_State.load(std::memory_order_relaxed);
+        return (State & (WriterLockedBit | WriterWaitingBit)) == 0 &&
+            m_State.compare_exchange_weak(State, State + 1, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void LockShared() noexcept
+    {
+        int SpinCount = 0;
+        while (!TryLockShared())
+            Pause(SpinCount);
+    }
+
+    void UnlockShared() noexcept
+    {
+        VERIFY((m_State.load() & ReaderCountMask) != 0, "The lock is not held by a reader");
+        m_State.fetch_sub(1, std::memory_order_release);
+    }
+
+    bool TryLock() noexcept
+    {
+        auto State = m_State.load(std::memory_order_relaxed);
+        // Clear the waiting bit. If other writers are waiting, they will set it again.
+        return (State & (WriterLockedBit | ReaderCountMask)) == 0 &&
+            m_State.compare_exchange_weak(State, WriterLockedBit, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void Lock() noexcept
+    {
+        int SpinCount = 0;
+        while (!TryLock())
+        {
+            if ((m_State.load(std::memory_order_relaxed) & WriterWaitingBit) == 0)
+                m_State.fetch_or(WriterWaitingBit, std::memory_order_relaxed);
+            Pause(SpinCount);
+        }
+    }
+
+    void Unlock() noexcept
+    {
+        VERIFY((m_State.load() & WriterLockedBit) != 0, "The lock is not held by a writer");
+        m_State.fetch_and(~WriterLockedBit, std::memory_order_release);
+    }
+
+private:
+    static void Pause(int& SpinCount) noexcept
+    {
+        if (++SpinCount == LockHelper::DefaultSpinCountToYield)
+        {
+            SpinCount = 0;
+            YieldThread();
+        }
+    }
+
+    static void YieldThread() noexcept;
+
+    static constexpr Diligent::Uint32 WriterLockedBit  = 0x80000000u;
+    static constexpr Diligent::Uint32 WriterWaitingBit = 0x40000000u;
+    static constexpr Diligent::Uint32 ReaderCountMask  = 0x3FFFFFFFu;
+
+    std::atomic<Diligent::Uint32> m_State{0};
+
+    // clang-format off
+    SharedLockFlag           (const SharedLockFlag&) = delete;
+    SharedLockFlag& operator=(const SharedLockFlag&) = delete;
+    // clang-format on
+};
+
+// Holds the shared (reader) lock of a SharedLockFlag within a scope
+class SharedLockHelper
+{
+public:
+    explicit SharedLockHelper(SharedLockFlag& LockFlag) noexcept :
+        m_LockFlag{LockFlag}
+    {
+        m_LockFlag.LockShared();
+    }
+
+    ~SharedLockHelper()
+    {
+        m_LockFlag.UnlockShared();
+    }
+
+    // clang-format off
+    SharedLockHelper           (const SharedLockHelper&) = delete;
+    SharedLockHelper& operator=(const SharedLockHelper&) = delete;
+    // clang-format on
+
+private:
+    SharedLockFlag& m_LockFlag;
+};
+
+// Holds the exclusive (writer) lock of a SharedLockFlag within a scope
+class ExclusiveLockHelper
+{
+public:
+    explicit ExclusiveLockHelper(SharedLockFlag& LockFlag) noexcept :
+        m_LockFlag{LockFlag}
+    {
+        m_LockFlag.Lock();
+    }
+
+    ~ExclusiveLockHelper()
+    {
+        m_LockFlag.Unlock();
+    }
+
+    // clang-format off
+    ExclusiveLockHelper           (const ExclusiveLockHelper&) = delete;
+    ExclusiveLockHelper& operator=(const ExclusiveLockHelper&) = delete;
+    // clang-format on
+
+private:
+    SharedLockFlag& m_LockFlag;
+};
+
 } // namespace ThreadingTools
@@ -76,43 +76,21 @@ public:
 
     inline virtual ReferenceCounterValueType AddWeakRef() override final
     {
-        return Atomics::AtomicIncrement(m_lNumWeakReferences);
+        return Atomics::AtomicIncrement(m_lNumWeakReferences) & NumWeakRefsMask;
     }
 
     inline virtual ReferenceCounterValueType ReleaseWeakRef() override final
     {
-        // The method must be serialized!
-        ThreadingTools::LockHelper Lock(m_LockFlag);
-        // It is essentially important to check the number of weak references
-        // while holding the lock. Otherwise reference counters object
-        // may be destroyed twice if ReleaseStrongRef() is executed by other
-        // thread.
+        // While the object is alive, the weak reference counter is biased by ObjectWeakRef,
+        // so it can only reach zero after TryDestroyObject() has released that reference.
+        // The thread that brings the counter to zero is thus the only one that can see it,
+        // and no synchronization is required.
         auto NumWeakReferences = Atomics::AtomicDecrement(m_lNumWeakReferences);
         VERIFY(NumWeakReferences >= 0, "Inconsistent call to ReleaseWeakRef()");
 
-        // There are two special case when we must not destroy the ref counters object even
-        // when NumWeakReferences == 0 && m_lNumStrongReferences == 0 :
-        //
-        //             This thread             |    Another thread - ReleaseStrongRef()
-        //                                     |
-        // 1. Lock the object                  |
-        //                                     |
-        // 2. Decrement m_lNumWeakReferences,  |   1. Decrement m_lNumStrongReferences,
-        //    m_lNumWeakReferences==0          |      RefCount == 0
-        //                                     |
-        //                                     |   2. Start waiting for the lock to destroy
-        //                                     |      the object, m_ObjectState != ObjectState::Destroyed
-        // 3. Do not destroy reference         |
-        //    counters, unlock                 |
-        //                                     |   3. Acquire the lock,
-        //                                     |      destroy the object,
-        //                                     |      read m_lNumWeakReferences==0
-        //                                     |      destroy the reference counters
-        //
-
         // If an exception is thrown during the object construction and there is a weak pointer to the object itself,
-        // we may get to this point, but should not destroy the reference counters, because it will be destroyed by MakeNewRCObj
-        // Consider this example:
+        // the counter may reach zero before the object is attached. We must not destroy the reference counters
+        // in this case, because they will be destroyed by MakeNewRCObj:
         //
         //   A ==sp==> B ---wp---> A
         //
@@ -123,83 +101,66 @@ public:
         //       B.ctor()
         //        wp.ctor m_lNumWeakReferences==1
         //        throw
-        //        wp.dtor m_lNumWeakReferences==0, destroy this
+        //        wp.dtor m_lNumWeakReferences==0, m_ObjectState == ObjectState::NotInitialized
         //    }
         //    catch(...)
         //    {
-        //       Destory ref counters second time
+        //       Destory ref counters
         //    }
         //
-        if (NumWeakReferences == 0 && /*m_lNumStrongReferences == 0 &&*/ m_ObjectState == ObjectState::Destroyed)
+        if (NumWeakReferences == 0 && m_ObjectState.load() == ObjectState::Destroyed)
         {
             VERIFY_EXPR(m_lNumStrongReferences == 0);
             VERIFY(m_ObjectWrapperBuffer[0] == 0 && m_ObjectWrapperBuffer[1] == 0, "Object wrapper must be null");
-            // m_ObjectState is set to ObjectState::Destroyed under the lock. If the state is not Destroyed,
-            // ReleaseStrongRef() will take care of it.
-            // Access to Object wrapper and decrementing m_lNumWeakReferences is atomic. Since we acquired the lock,
-            // no other thread can access either of them.
-            // Access to m_lNumStrongReferences is NOT PROTECTED by lock.
-
             // There are no more references to the ref counters object and the object itself
             // is already destroyed.
-            // We can safely unlock it and destroy.
-            // If we do not unlock it, this->m_LockFlag will expire,
-            // which will cause Lock.~LockHelper() to crash.
-            Lock.Unlock();
             SelfDestroy();
         }
-        return NumWeakReferences;
+        return NumWeakReferences & NumWeakRefsMask;
     }
 
     inline virtual void GetObject(struct IObject** ppObject) override final
     {
-        if (m_ObjectState != ObjectState::Alive)
+        if (m_ObjectState.load() != ObjectState::Alive)
             return; // Early exit
 
-        // It is essential to INCREMENT REF COUNTER while HOLDING THE LOCK to make sure that
-        // StrongRefCnt > 1 guarantees that the object is alive.
-
-        // If other thread started deleting the object in ReleaseStrongRef(), then m_lNumStrongReferences==0
-        // We must make sure only one thread is allowed to increment the counter to guarantee that if StrongRefCnt > 1,
-        // there is at least one real strong reference left. Otherwise the following scenario may occur:
+        // Once the strong reference counter reaches zero, the object is destroyed by the thread that
+        // released the last reference, and the counter must never be incremented again. So we only
+        // increment the counter if it is not zero. This guarantees that the object stays alive
+        // while we hold the reference and that only one thread can ever execute TryDestroyObject().
         //
         //                                      m_lNumStrongReferences == 1
         //
-        //    Thread 1 - ReleaseStrongRef()    |     Thread 2 - GetObject()        |     Thread 3 - GetObject()
-        //                                     |                                   |
-        //  - Decrement m_lNumStrongReferences | -Increment m_lNumStrongReferences | -Increment m_lNumStrongReferences
-        //  - Read RefCount == 0               | -Read StrongRefCnt==1             | -Read StrongRefCnt==2
-        //    Destroy the object               |                                   | -Return reference to the soon
-        //                                     |                                   |  to expire object
+        //    Thread 1 - ReleaseStrongRef()    |     Thread 2 - GetObject()
+        //                                     |
+        //                                     |  - Read StrongRefCnt == 1
+        //  - Decrement m_lNumStrongReferences |
+        //  - Read RefCount == 0               |  - CAS 1 -> 2 fails, read StrongRefCnt == 0
+        //    Destroy the object               |  - Do not return the reference
         //
-        ThreadingTools::LockHelper Lock(m_LockFlag);
+        Atomics::Long StrongRefCnt = m_lNumStrongReferences;
+        for (;;)
+        {
+            // If the counter is zero, the object is either being destroyed or no strong
+            // references have been created yet.
+            if (StrongRefCnt <= 0)
+                return;
 
-        auto StrongRefCnt = Atomics::AtomicIncrement(m_lNumStrongReferences);
+            const auto OrigStrongRefCnt = Atomics::AtomicCompareExchange(m_lNumStrongReferences, StrongRefCnt + 1, StrongRefCnt);
+            if (OrigStrongRefCnt == StrongRefCnt)
+                break;
 
-        // Checking if m_ObjectState == ObjectState::Alive only is not reliable:
-        //
-        //           This thread                    |          Another thread
-        //                                          |
-        //   1. Acquire the lock                    |
-        //                                          |    1. Decrement m_lNumStrongReferences
-        //   2. Increment m_lNumStrongReferences    |    2. Test RefCount==0
-        //   3. Read StrongRefCnt == 1              |    3. Start destroying the object
-        //      m_ObjectState == ObjectState::Alive |
-        //   4. DO NOT return the reference to      |    4. Wait for the lock, m_ObjectState == ObjectState::Alive
-        //      the object                          |
-        //   5. Decrement m_lNumStrongReferences    |
-        //                                          |    5. Destroy the object
-
-        if (m_ObjectState == ObjectState::Alive && StrongRefCnt > 1)
-        {
-            VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
-            // QueryInterface() must not lock the object, or a deadlock happens.
-            // The only other two methods that lock the object are ReleaseStrongRef()
-            // and ReleaseWeakRef(), which are never called by QueryInterface()
-            auto* pWrapper = reinterpret_cast<ObjectWrapperBase*>(m_ObjectWrapperBuffer);
-            pWrapper->QueryInterface(IID_Unknown, ppObject);
+            StrongRefCnt = OrigStrongRefCnt;
         }
-        Atomics::AtomicDecrement(m_lNumStrongReferences);
+
+        VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
+        // QueryInterface() adds its own strong reference
+        auto* pWrapper = reinterpret_cast<ObjectWrapperBase*>(m_ObjectWrapperBuffer);
+        pWrapper->QueryInterface(IID_Unknown, ppObject);
+
+        // Release the temporary reference. If other strong references have been released in the meantime
+        // and QueryInterface() failed, this will destroy the object.
+        ReleaseStrongRef();
     }
 
     inline virtual ReferenceCounterValueType GetNumStrongRefs() const override final
@@ -209,7 +170,7 @@ public:
 
     inline virtual ReferenceCounterValueType GetNumWeakRefs() const override final
     {
-        return m_lNumWeakReferences;
+        return m_lNumWeakReferences & NumWeakRefsMask;
     }
 
 private:
@@ -271,185 +232,52 @@ private:
         VERIFY(m_ObjectState == ObjectState::NotInitialized, "Object has already been attached");
         static_assert(sizeof(ObjectWrapper<ObjectType, AllocatorType>) == sizeof(m_ObjectWrapperBuffer), "Unexpected object wrapper size");
         new (m_ObjectWrapperBuffer) ObjectWrapper<ObjectType, AllocatorType>(pObject, pAllocator);
+        // The object keeps the reference counters alive until it is destroyed
+        Atomics::AtomicAdd(m_lNumWeakReferences, ObjectWeakRef);
         m_ObjectState = ObjectState::Alive;
     }
 
     void TryDestroyObject()
     {
-        // Since RefCount==0, there are no more strong references and the only place
-        // where strong ref counter can be incremented is from GetObject().
-
-        // If several threads were allowed to get to this point, there would
-        // be serious risk that <this> had already been destroyed and m_LockFlag expired.
-        // Consider the following scenario:
-        //                                      |
-        //             This thread              |             Another thread
-        //                                      |
-        //                      m_lNumStrongReferences == 1
-        //                      m_lNumWeakReferences == 1
-        //                                      |
-        // 1. Decrement m_lNumStrongReferences  |
-        //    Read RefCount==0, no lock acquired|
-        //                                      |   1. Run GetObject()
-        //                                      |      - acquire the lock
-        //                                      |      - increment m_lNumStrongReferences
-        //                                      |      - release the lock
-        //                                      |
-        //                                      |   2. Run ReleaseWeakRef()
-        //                                      |      - decrement m_lNumWeakReferences
-        //                                      |
-        //                                      |   3. Run ReleaseStrongRef()
-        //                                      |      - decrement m_lNumStrongReferences
-        //                                      |      - read RefCount==0
-        //
-        //         Both threads will get to this point. The first one will destroy <this>
-        //         The second one will read expired m_LockFlag
-
-        //  IT IS CRUCIALLY IMPORTANT TO ASSURE THAT ONLY ONE THREAD WILL EVER
-        //  EXECUTE THIS CODE
-
-        // The sloution is to atomically increment strong ref counter in GetObject().
-        // There are two possible scenarios depending on who first increments the counter:
-
+        // Since RefCount==0, there are no more strong references. GetObject() never increments
+        // the counter from zero, so the counter will stay zero and this thread is the only one
+        // that will ever execute this code.
+        VERIFY(m_lNumStrongReferences == 0 && m_ObjectState == ObjectState::Alive,
+               "Strong reference counter is expected to be zero and the object is expected to be alive");
+        VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
 
-        //                                                     Scenario I
+        // The object may release the last weak reference to its own reference counters while it is
+        // being destroyed, so we copy the object wrapper:
         //
-        //             This thread              |      Another thread - GetObject()         |   One more thread - GetObject()
-        //                                      |                                           |
-        //                       m_lNumStrongReferences == 1                                |
-        //                                      |                                           |
-        //                                      |   1. Acquire the lock                     |
-        // 1. Decrement m_lNumStrongReferences  |                                           |   1. Wait for the lock
-        // 2. Read RefCount==0                  |   2. Increment m_lNumStrongReferences     |
-        // 3. Start destroying the object       |   3. Read StrongRefCnt == 1               |
-        // 4. Wait for the lock                 |   4. DO NOT return the reference          |
-        //                                      |      to the object                        |
-        //                                      |   5. Decrement m_lNumStrongReferences     |
-        // _  _  _  _  _  _  _  _  _  _  _  _  _|   6. Release the lock _  _  _  _  _  _  _ |_  _  _  _  _  _  _  _  _  _  _  _  _  _
-        //                                      |                                           |   2. Acquire the lock
-        //                                      |                                           |   3. Increment m_lNumStrongReferences
-        //                                      |                                           |   4. Read StrongRefCnt == 1
-        //                                      |                                           |   5. DO NOT return the reference
-        //                                      |                                           |      to the object
-        //                                      |                                           |   6. Decrement m_lNumStrongReferences
-        //  _  _  _  _  _  _  _  _  _  _  _  _  | _  _  _  _  _  _  _  _  _  _  _  _  _  _  | _ 7. Release the lock _  _  _  _  _  _
-        // 5. Acquire the lock                  |                                           |
-        //   - m_lNumStrongReferences==0        |                                           |
-        // 6. DESTROY the object                |                                           |
-        //                                      |                                           |
-
-        //  GetObject() MUST BE SERIALIZED for this to work properly!
-
-
-        //                                   Scenario II
+        //    A ==sp==> B ---wp---> A
         //
-        //             This thread              |      Another thread - GetObject()
-        //                                      |
-        //                       m_lNumStrongReferences == 1
-        //                                      |
-        //                                      |   1. Acquire the lock
-        //                                      |   2. Increment m_lNumStrongReferences
-        // 1. Decrement m_lNumStrongReferences  |
-        // 2. Read RefCount>0                   |
-        // 3. DO NOT destroy the object         |   3. Read StrongRefCnt > 1 (while m_lNumStrongReferences == 1)
-        //                                      |   4. Return the reference to the object
-        //                                      |       - Increment m_lNumStrongReferences
-        //                                      |   5. Decrement m_lNumStrongReferences
-
+        //    delete A{
+        //      A.~dtor(){
+        //          B.~dtor(){
+        //              wpA.ReleaseWeakRef()
+        //
+        size_t ObjectWrapperBufferCopy[ObjectWrapperBufferSize];
+        for (size_t i = 0; i < ObjectWrapperBufferSize; ++i)
+            ObjectWrapperBufferCopy[i] = m_ObjectWrapperBuffer[i];
 #ifdef DILIGENT_DEBUG
-        {
-            Atomics::Long NumStrongRefs = m_lNumStrongReferences;
-            VERIFY(NumStrongRefs == 0 || NumStrongRefs == 1, "Num strong references (", NumStrongRefs, ") is expected to be 0 or 1");
-        }
+        memset(m_ObjectWrapperBuffer, 0, sizeof(m_ObjectWrapperBuffer));
 #endif
+        auto* pWrapper = reinterpret_cast<ObjectWrapperBase*>(ObjectWrapperBufferCopy);
 
-        // Acquire the lock.
-        ThreadingTools::LockHelper Lock(m_LockFlag);
+        // Note that this is the only place where m_ObjectState is
+        // modified after the ref counters object has been created.
+        // The object is now detached from the reference counters and it is as if
+        // it was destroyed since no one can obtain access to it.
+        m_ObjectState.store(ObjectState::Destroyed);
 
-        // GetObject() first acquires the lock, and only then increments and
-        // decrements the ref counter. If it reads 1 after incremeting the counter,
-        // it does not return the reference to the object and decrements the counter.
-        // If we acquired the lock, GetObject() will not start until we are done
-        VERIFY_EXPR(m_lNumStrongReferences == 0 && m_ObjectState == ObjectState::Alive);
+        // Destroy referenced object. The reference counters are kept alive by the
+        // object's weak reference.
+        pWrapper->DestroyObject();
 
-        // Extra caution
-        if (m_lNumStrongReferences == 0 && m_ObjectState == ObjectState::Alive)
-        {
-            VERIFY(m_ObjectWrapperBuffer[0] != 0 && m_ObjectWrapperBuffer[1] != 0, "Object wrapper is not initialized");
-            // We cannot destroy the object while reference counters are locked as this will
-            // cause a deadlock in cases like this:
-            //
-            //    A ==sp==> B ---wp---> A
-            //
-            //    RefCounters_A.Lock();
-            //    delete A{
-            //      A.~dtor(){
-            //          B.~dtor(){
-            //              wpA.ReleaseWeakRef(){
-            //                  RefCounters_A.Lock(); // Deadlock
-            //
-
-            // So we copy the object wrapper and destroy the object after unlocking the
-            // reference counters
-            size_t ObjectWrapperBufferCopy[ObjectWrapperBufferSize];
-            for (size_t i = 0; i < ObjectWrapperBufferSize; ++i)
-                ObjectWrapperBufferCopy[i] = m_ObjectWrapperBuffer[i];
-#ifdef DILIGENT_DEBUG
-            memset(m_ObjectWrapperBuffer, 0, sizeof(m_ObjectWrapperBuffer));
-#endif
-            auto* pWrapper = reinterpret_cast<ObjectWrapperBase*>(ObjectWrapperBufferCopy);
-
-            // In a multithreaded environment, reference counters object may
-            // be destroyed at any time while m_pObject->~dtor() is running.
-            // NOTE: m_pObject may not be the only object referencing m_pRefCounters.
-            //       All objects that are owned by m_pObject will point to the same
-            //       reference counters object.
-
-            // Note that this is the only place where m_ObjectState is
-            // modified after the ref counters object has been created
-            m_ObjectState = ObjectState::Destroyed;
-            // The object is now detached from the reference counters and it is if
-            // it was destroyed since no one can obtain access to it.
-
-
-            // It is essentially important to check the number of weak references
-            // while the object is locked. Otherwise reference counters object
-            // may be destroyed twice if ReleaseWeakRef() is executed by other thread:
-            //
-            //             This thread             |    Another thread - ReleaseWeakRef()
-            //                                     |
-            // 1. Decrement m_lNumStrongReferences,|
-            //    m_lNumStrongReferences==0,       |
-            //    acquire the lock, destroy        |
-            //    the obj, release the lock        |
-            //    m_lNumWeakReferences == 1        |
-            //                                     |   1. Aacquire the lock,
-            //                                     |      decrement m_lNumWeakReferences,
-            //                                     |      m_lNumWeakReferences == 0,
-            //                                     |      m_ObjectState == ObjectState::Destroyed
-            //                                     |
-            // 2. Read m_lNumWeakReferences == 0   |
-            // 3. Destroy the ref counters obj     |   2. Destroy the ref counters obj
-            //
-            bool bDestroyThis = m_lNumWeakReferences == 0;
-            // ReleaseWeakRef() decrements m_lNumWeakReferences, and checks it for
-            // zero only after acquiring the lock. So if m_lNumWeakReferences==0, no
-            // weak reference-related code may be running
-
-
-            // We must explicitly unlock the object now to avoid deadlocks. Also,
-            // if this is deleted, this->m_LockFlag will expire, which will cause
-            // Lock.~LockHelper() to crash
-            Lock.Unlock();
-
-            // Destroy referenced object
-            pWrapper->DestroyObject();
-
-            // Note that <this> may be destroyed here already,
-            // see comments in ~ControlledObjectType()
-            if (bDestroyThis)
-                SelfDestroy();
-        }
+        // Release the object's weak reference. If there are no other weak references,
+        // this destroys the reference counters.
+        if (Atomics::AtomicAdd(m_lNumWeakReferences, -ObjectWeakRef) == 0)
+            SelfDestroy();
     }
 
     void SelfDestroy()
@@ -480,17 +308,20 @@ private:
     // which does have virtual destructor.
     static constexpr size_t ObjectWrapperBufferSize = sizeof(ObjectWrapper<IObjectStub, IMemoryAllocator>) / sizeof(size_t);
 
-    size_t                   m_ObjectWrapperBuffer[ObjectWrapperBufferSize];
-    Atomics::AtomicLong      m_lNumStrongReferences;
-    Atomics::AtomicLong      m_lNumWeakReferences;
-    ThreadingTools::LockFlag m_LockFlag;
+    // Weak reference held by the object while it is alive
+    static constexpr Atomics::Long ObjectWeakRef   = Atomics::Long{1} << 30;
+    static constexpr Atomics::Long NumWeakRefsMask = ObjectWeakRef - 1;
+
+    size_t              m_ObjectWrapperBuffer[ObjectWrapperBufferSize];
+    Atomics::AtomicLong m_lNumStrongReferences;
+    Atomics::AtomicLong m_lNumWeakReferences;
     enum class ObjectState : Int32
     {
         NotInitialized,
         Alive,
         Destroyed
     };
-    volatile ObjectState m_ObjectState = ObjectState::NotInitialized;
+    std::atomic<ObjectState> m_ObjectState{ObjectState::NotInitialized};
 };
 
 
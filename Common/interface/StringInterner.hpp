@@ -0,0 +1,137 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Defines Diligent::InternedString and Diligent::StringInterner classes
+
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+#include "../../Primitives/interface/BasicTypes.h"
+#include "../../Primitives/interface/MemoryAllocator.h"
+#include "StringPool.hpp"
+#include "HashUtils.hpp"
+
+namespace Diligent
+{
+
+/// Compact handle of a string interned by StringInterner.
+
+/// The handle holds the pointer to the interned copy of the string, its precomputed hash
+/// and a unique id. Handles produced by the same interner are equal if and only if
+/// the strings are equal, so they are compared as a single integer. The hash is the
+/// same as the one computed by CStringHash and HashMapStringKey, so the handle can be
+/// used to look up string-keyed hash maps without rehashing the string.
+class InternedString
+{
+public:
+    InternedString() noexcept {}
+
+    const Char* GetStr() const { return m_Str; }
+    size_t      GetHash() const { return m_Hash; }
+
+    /// Returns the id that is unique within the interner, starting from 1.
+    /// Ids are assigned sequentially and may be used to index dense arrays.
+    Uint32 GetId() const { return m_Id; }
+
+    explicit operator bool() const { return m_Str != nullptr; }
+
+    bool operator==(const InternedString& RHS) const { return m_Str == RHS.m_Str; }
+    bool operator!=(const InternedString& RHS) const { return m_Str != RHS.m_Str; }
+
+    struct Hasher
+    {
+        size_t operator()(const InternedString& Str) const
+        {
+            return Str.GetHash();
+        }
+    };
+
+private:
+    friend class StringInterner;
+
+    InternedString(const Char* Str, size_t Hash, Uint32 Id) noexcept :
+        m_Str{Str},
+        m_Hash{Hash},
+        m_Id{Id}
+    {}
+
+    const Char* m_Str  = nullptr;
+    size_t      m_Hash = 0;
+    Uint32      m_Id   = 0;
+};
+
+/// Thread-safe string interning service.
+
+/// Every distinct string is stored only once in the pages of a string pool and is
+/// never released until the interner is destroyed.
+/// Interning a string requires a hash map lookup under the lock, so the handles
+/// should be created once (e.g. when a material is loaded) and reused.
+class StringInterner
+{
+public:
+    explicit StringInterner(IMemoryAllocator& Allocator, size_t PageSize = 4096);
+    ~StringInterner();
+
+    // clang-format off
+    StringInterner           (const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+    // clang-format on
+
+    /// Returns the handle of the string, interning the string if necessary.
+    InternedString Intern(const Char* Str);
+
+    /// Returns the handle of the string if it has already been interned, and null handle otherwise.
+    InternedString Find(const Char* Str) const;
+
+    /// Returns the number of interned strings.
+    size_t GetNumStrings() const;
+
+    /// Returns the global interner that uses the default raw memory allocator.
+
+    /// \note  The global interner is defined in the Common library, so every module that
+    ///        statically links the library has its own instance. Handles from another module
+    ///        are still valid for look-ups that use the hash and the string, but must not be
+    ///        compared with the handles of this module.
+    static StringInterner& GetGlobal();
+
+private:
+    IMemoryAllocator& m_Allocator;
+    const size_t      m_PageSize;
+
+    mutable std::mutex m_Mtx;
+
+    std::vector<StringPool> m_Pages;
+
+    // Keys reference the strings in the pages
+    std::unordered_map<HashMapStringKey, InternedString, HashMapStringKey::Hasher> m_Strings;
+};
+
+} // namespace Diligent
@@ -30,7 +30,9 @@
 #include <mutex>
 #include <condition_variable>
 #include <atomic>
+#include <chrono>
 
+#include "../../Primitives/interface/BasicTypes.h"
 #include "../../Platforms/Basic/interface/DebugUtilities.hpp"
 
 namespace ThreadingTools
@@ -127,4 +129,115 @@ private:
     Signal& operator=(const Signal&) = delete;
 };
 
+// Lightweight signal with counting semantics. The signal holds a counter that is
+// incremented by Trigger(). Wait() blocks until the counter is non-zero without changing it
+// (manual-reset event semantics), while Acquire() blocks until the counter is non-zero and
+// decrements it (semaphore semantics). Both waits have timed versions.
+//
+// The signal state is a single atomic word, so Trigger() and satisfied waits never take
+// a mutex or make a system call. Triggering only wakes threads up if some thread
+// has actually gone to sleep.
+class CountingSignal
+{
+public:
+    CountingSignal(Diligent::Uint32 InitialCount = 0) noexcept :
+        m_State{InitialCount}
+    {
+        VERIFY((InitialCount & WaitersBit) == 0, "Initial count is too large");
+    }
+
+    // Adds Count to the signal counter and wakes up waiting threads
+    void Trigger(Diligent::Uint32 Count = 1) noexcept
+    {
+        VERIFY(Count != 0, "Count must not be zero");
+        auto State = m_State.load(std::memory_order_relaxed);
+        // Clear the waiters bit: woken threads that still need to wait will set it again
+        while (!m_State.compare_exchange_weak(State, (State & CountMask) + Count, std::memory_order_release, std::memory_order_relaxed))
+        {}
+        VERIFY((State & CountMask) + Count <= CountMask, "Signal counter overflow");
+        if (State & WaitersBit)
+            WakeWaiters();
+    }
+
+    // Waits until the signal is triggered. The counter is not changed.
+    void Wait() noexcept
+    {
+        if (!IsTriggered())
+            WaitSlow(false, -1);
+    }
+
+    // Waits until the signal is triggered or the timeout expires.
+    // Returns true if the signal has been triggered.
+    template <typename Rep, typename Period>
+    bool WaitFor(const std::chrono::duration<Rep, Period>& Timeout) noexcept
+    {
+        return IsTriggered() || WaitSlow(false, ToNanoseconds(Timeout));
+    }
+
+    // Decrements the counter if it is non-zero. Returns true if the counter has been decremented.
+    bool TryAcquire() noexcept
+    {
+        auto State = m_State.load(std::memory_order_relaxed);
+        while ((State & CountMask) != 0)
+        {
+            if (m_State.compare_exchange_weak(State, State - 1, std::memory_order_acquire, std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+    // Waits until the counter is non-zero and decrements it
+    void Acquire() noexcept
+    {
+        if (!TryAcquire())
+            WaitSlow(true, -1);
+    }
+
+    // Waits until the counter is non-zero and decrements it, or until the timeout expires.
+    // Returns true if the counter has been decremented.
+    template <typename Rep, typename Period>
+    bool AcquireFor(const std::chrono::duration<Rep, Period>& Timeout) noexcept
+    {
+        return TryAcquire() || WaitSlow(true, ToNanoseconds(Timeout));
+    }
+
+    // Sets the counter to zero
+    void Reset() noexcept
+    {
+        m_State.fetch_and(WaitersBit, std::memory_order_relaxed);
+    }
+
+    bool IsTriggered() const noexcept
+    {
+        return (m_State.load(std::memory_order_acquire) & CountMask) != 0;
+    }
+
+    Diligent::Uint32 GetCount() const noexcept
+    {
+        return m_State.load(std::memory_order_relaxed) & CountMask;
+    }
+
+private:
+    template <typename Rep, typename Period>
+    static Diligent::Int64 ToNanoseconds(const std::chrono::duration<Rep, Period>& Timeout) noexcept
+    {
+        const auto TimeoutNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Timeout).count();
+        return TimeoutNs > 0 ? static_cast<Diligent::Int64>(TimeoutNs) : 0;
+    }
+
+    // Waits for the signal with the negative timeout meaning infinite wait
+    bool WaitSlow(bool Acquire, Diligent::Int64 TimeoutNs) noexcept;
+    void WakeWaiters() noexcept;
+
+    static constexpr Diligent::Uint32 WaitersBit = 0x80000000u;
+    static constexpr Diligent::Uint32 CountMask  = 0x7FFFFFFFu;
+
+    std::atomic<Diligent::Uint32> m_State;
+
+    // clang-format off
+    CountingSignal           (const CountingSignal&) = delete;
+    CountingSignal& operator=(const CountingSignal&) = delete;
+    // clang-format on
+};
+
 } // namespace ThreadingTools
@@ -0,0 +1,638 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "AdvancedMath.hpp"
+
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "PlatformMisc.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Frustum planes preprocessed for batch box tests
+class BoxCullingPlanes
+{
+public:
+    BoxCullingPlanes(const ViewFrustum& Frustum, FRUSTUM_PLANE_FLAGS PlaneFlags, const BoundBoxesSoA& Boxes)
+    {
+        for (Uint32 plane_idx = 0; plane_idx < ViewFrustum::NUM_PLANES; ++plane_idx)
+        {
+            if ((PlaneFlags & (1 << plane_idx)) == 0)
+                continue;
+
+            const Plane3D& Plane  = Frustum.GetPlane(static_cast<ViewFrustum::PLANE_IDX>(plane_idx));
+            PlaneInfo&     Info   = m_Planes[m_NumPlanes++];
+            const float3&  Normal = Plane.Normal;
+
+            Info.Plane = Plane;
+            // Since the normal is the same for all boxes, the farthest and the nearest corners
+            // are selected per plane rather than per box (see GetBoxVisibilityAgainstPlane).
+            // clang-format off
+            Info.FarX  = (Normal.x > 0) ? Boxes.MaxX : Boxes.MinX;
+            Info.FarY  = (Normal.y > 0) ? Boxes.MaxY : Boxes.MinY;
+            Info.FarZ  = (Normal.z > 0) ? Boxes.MaxZ : Boxes.MinZ;
+            Info.NearX = (Normal.x > 0) ? Boxes.MinX : Boxes.MaxX;
+            Info.NearY = (Normal.y > 0) ? Boxes.MinY : Boxes.MaxY;
+            Info.NearZ = (Normal.z > 0) ? Boxes.MinZ : Boxes.MaxZ;
+            // clang-format on
+        }
+    }
+
+    // Computes visibility of up to 32 boxes starting at FirstBox.
+    // Returns the visibility bits and writes the full visibility bits to FullyVisibleBits.
+    Uint32 ComputeVisibilityBits(size_t FirstBox, Uint32 NumBoxes, Uint32& FullyVisibleBits) const
+    {
+        VERIFY_EXPR(NumBoxes <= 32);
+
+        Uint32 VisibleBits = 0;
+        FullyVisibleBits   = 0;
+
+        Uint32 i = 0;
+#if DILIGENT_SIMD_MATH
+        for (; i + 4 <= NumBoxes; i += 4)
+        {
+            Uint32 FullyVisible4 = 0;
+            Uint32 Visible4      = ComputeVisibility4(FirstBox + i, FullyVisible4);
+            VisibleBits |= Visible4 << i;
+            FullyVisibleBits |= FullyVisible4 << i;
+        }
+#endif
+        for (; i < NumBoxes; ++i)
+        {
+            bool FullyVisible = false;
+            if (ComputeVisibility(FirstBox + i, FullyVisible))
+            {
+                VisibleBits |= 1u << i;
+                if (FullyVisible)
+                    FullyVisibleBits |= 1u << i;
+            }
+        }
+
+        return VisibleBits;
+    }
+
+private:
+    // The arithmetic exactly follows GetBoxVisibilityAgainstPlane so that
+    // the results are bitwise consistent with GetBoxVisibility.
+    bool ComputeVisibility(size_t Idx, bool& FullyVisible) const
+    {
+        FullyVisible = true;
+        for (Uint32 p = 0; p < m_NumPlanes; ++p)
+        {
+            const PlaneInfo& Info   = m_Planes[p];
+            const float3&    Normal = Info.Plane.Normal;
+
+            float DMax = (Info.FarX[Idx] * Normal.x + Info.FarY[Idx] * Normal.y + Info.FarZ[Idx] * Normal.z) + Info.Plane.Distance;
+            if (DMax < 0)
+                return false;
+
+            float DMin = (Info.NearX[Idx] * Normal.x + Info.NearY[Idx] * Normal.y + Info.NearZ[Idx] * Normal.z) + Info.Plane.Distance;
+            if (!(DMin > 0))
+                FullyVisible = false;
+        }
+        return true;
+    }
+
+#if DILIGENT_SIMD_MATH
+    Uint32 ComputeVisibility4(size_t Idx, Uint32& FullyVisible4) const
+    {
+        using namespace SIMD;
+
+        const Float4Reg Zero    = Splat(0.f);
+        Float4Reg       Outside = Zero;                    // All bits are zero
+        Float4Reg       Inside  = CmpGT(Splat(1.f), Zero); // All bits are one
+        for (Uint32 p = 0; p < m_NumPlanes; ++p)
+        {
+            const PlaneInfo& Info = m_Planes[p];
+
+            const Float4Reg Nx = Splat(Info.Plane.Normal.x);
+            const Float4Reg Ny = Splat(Info.Plane.Normal.y);
+            const Float4Reg Nz = Splat(Info.Plane.Normal.z);
+            const Float4Reg D  = Splat(Info.Plane.Distance);
+
+            Float4Reg DMax = Add(Add(Add(Mul(Load(Info.FarX + Idx), Nx), Mul(Load(Info.FarY + Idx), Ny)), Mul(Load(Info.FarZ + Idx), Nz)), D);
+            Outside        = Or(Outside, CmpLT(DMax, Zero));
+            // Most boxes are typically culled, so stop as soon as all four boxes are outside
+            if (MoveMask(Outside) == 0x0Fu)
+                break;
+
+            Float4Reg DMin = Add(Add(Add(Mul(Load(Info.NearX + Idx), Nx), Mul(Load(Info.NearY + Idx), Ny)), Mul(Load(Info.NearZ + Idx), Nz)), D);
+            Inside         = And(Inside, CmpGT(DMin, Zero));
+        }
+
+        const Uint32 Visible4 = ~MoveMask(Outside) & 0x0Fu;
+        FullyVisible4         = MoveMask(Inside) & Visible4;
+        return Visible4;
+    }
+#endif
+
+    struct PlaneInfo
+    {
+        Plane3D Plane;
+
+        const float* FarX  = nullptr;
+        const float* FarY  = nullptr;
+        const float* FarZ  = nullptr;
+        const float* NearX = nullptr;
+        const float* NearY = nullptr;
+        const float* NearZ = nullptr;
+    };
+    PlaneInfo m_Planes[ViewFrustum::NUM_PLANES];
+    Uint32    m_NumPlanes = 0;
+};
+
+// Splits the boxes into at most NumThreads ranges whose sizes are multiples of 32 and runs
+// Func(FirstBox, NumBoxes, RangeIdx) for every range.
+// The first range is processed by the calling thread.
+template <typename FuncType>
+void ProcessBoxRangesMT(Uint32 NumBoxes, Uint32 NumThreads, FuncType Func)
+{
+    const Uint32 NumWords = (NumBoxes + 31) / 32;
+    if (NumWords == 0)
+        return;
+
+    const Uint32 NumRanges     = std::max(std::min(NumThreads, NumWords), 1u);
+    const Uint32 BoxesPerRange = (NumWords + NumRanges - 1) / NumRanges * 32;
+
+    std::vector<std::thread> Workers;
+    Workers.reserve(NumRanges - 1);
+    for (Uint32 r = 1; r * BoxesPerRange < NumBoxes; ++r)
+    {
+        const Uint32 FirstBox = r * BoxesPerRange;
+        const Uint32 Count    = std::min(BoxesPerRange, NumBoxes - FirstBox);
+        Workers.emplace_back(Func, FirstBox, Count, r);
+    }
+
+    Func(0u, std::min(BoxesPerRange, NumBoxes), 0u);
+
+    for (auto& Worker : Workers)
+        Worker.join();
+}
+
+#if DILIGENT_SIMD_MATH
+// Follows BoundBox::Transform operation by operation, so that the results are identical
+inline void TransformBoundBoxSIMD(const BoundBox& Box, const float4x4& m, SIMD::Float4Reg& NewMin, SIMD::Float4Reg& NewMax)
+{
+    using namespace SIMD;
+
+    NewMin = Load(m[3]);
+    NewMax = NewMin;
+
+    const Float4Reg Right = Load(m[0]);
+    Float4Reg       v0    = Mul(Right, Splat(Box.Min.x));
+    Float4Reg       v1    = Mul(Right, Splat(Box.Max.x));
+    NewMin                = Add(NewMin, Min(v0, v1));
+    NewMax                = Add(NewMax, Max(v0, v1));
+
+    const Float4Reg Up = Load(m[1]);
+    v0                 = Mul(Up, Splat(Box.Min.y));
+    v1                 = Mul(Up, Splat(Box.Max.y));
+    NewMin             = Add(NewMin, Min(v0, v1));
+    NewMax             = Add(NewMax, Max(v0, v1));
+
+    const Float4Reg Back = Load(m[2]);
+    v0                   = Mul(Back, Splat(Box.Min.z));
+    v1                   = Mul(Back, Splat(Box.Max.z));
+    NewMin               = Add(NewMin, Min(v0, v1));
+    NewMax               = Add(NewMax, Max(v0, v1));
+}
+
+inline BoundBox MakeBoundBox(SIMD::Float4Reg Min, SIMD::Float4Reg Max)
+{
+    float Data[8];
+    SIMD::Store(Data, Min);
+    SIMD::Store(Data + 4, Max);
+    return BoundBox{
+        float3{Data[0], Data[1], Data[2]},
+        float3{Data[4], Data[5], Data[6]} //
+    };
+}
+#endif
+
+template <typename MatrixSelectorType>
+void TransformBoundBoxesImpl(const BoundBox*    InBoxes,
+                             size_t             NumBoxes,
+                             BoundBox*          OutBoxes,
+                             BoundBox*          pMergedBox,
+                             MatrixSelectorType GetMatrix)
+{
+    VERIFY_EXPR(NumBoxes == 0 || InBoxes != nullptr);
+
+#if DILIGENT_SIMD_MATH
+    using namespace SIMD;
+
+    Float4Reg MergedMin = Splat(0.f);
+    Float4Reg MergedMax = Splat(0.f);
+    if (pMergedBox != nullptr)
+    {
+        MergedMin = Set(pMergedBox->Min.x, pMergedBox->Min.y, pMergedBox->Min.z, 0.f);
+        MergedMax = Set(pMergedBox->Max.x, pMergedBox->Max.y, pMergedBox->Max.z, 0.f);
+    }
+
+    for (size_t i = 0; i < NumBoxes; ++i)
+    {
+        Float4Reg NewMin, NewMax;
+        TransformBoundBoxSIMD(InBoxes[i], GetMatrix(i), NewMin, NewMax);
+        if (OutBoxes != nullptr)
+            OutBoxes[i] = MakeBoundBox(NewMin, NewMax);
+        MergedMin = Min(MergedMin, NewMin);
+        MergedMax = Max(MergedMax, NewMax);
+    }
+
+    if (pMergedBox != nullptr)
+        *pMergedBox = MakeBoundBox(MergedMin, MergedMax);
+#else
+    for (size_t i = 0; i < NumBoxes; ++i)
+    {
+        const BoundBox NewBox = InBoxes[i].Transform(GetMatrix(i));
+        if (OutBoxes != nullptr)
+            OutBoxes[i] = NewBox;
+        if (pMergedBox != nullptr)
+        {
+            pMergedBox->Min = std::min(pMergedBox->Min, NewBox.Min);
+            pMergedBox->Max = std::max(pMergedBox->Max, NewBox.Max);
+        }
+    }
+#endif
+}
+
+// Ray transformation of the watertight ray-triangle intersection algorithm: the axes are permuted so that
+// the ray direction is dominant along z, and the vertices are sheared so that the ray becomes the z axis.
+struct WatertightRay
+{
+    Uint32 kx = 0;
+    Uint32 ky = 0;
+    Uint32 kz = 0;
+
+    float Sx = 0;
+    float Sy = 0;
+    float Sz = 0;
+
+    explicit WatertightRay(const float3& Dir)
+    {
+        const float3 AbsDir = abs(Dir);
+
+        kz = AbsDir.x > AbsDir.y ? (AbsDir.x > AbsDir.z ? 0 : 2) : (AbsDir.y > AbsDir.z ? 1 : 2);
+        kx = kz == 2 ? 0 : kz + 1;
+        ky = kx == 2 ? 0 : kx + 1;
+        // Swap the axes to preserve the triangle winding
+        if (Dir[kz] < 0)
+            std::swap(kx, ky);
+
+        Sx = Dir[kx] / Dir[kz];
+        Sy = Dir[ky] / Dir[kz];
+        Sz = 1.f / Dir[kz];
+    }
+};
+
+#if DILIGENT_SIMD_MATH
+// Computes the distances to the intersections from the edge functions and the vertex z coordinates.
+// The operations exactly match those of IntersectRayTriangleWatertight().
+inline SIMD::Float4Reg ComputeWatertightDistances(SIMD::Float4Reg Ax, SIMD::Float4Reg Ay, SIMD::Float4Reg Az,
+                                                  SIMD::Float4Reg Bx, SIMD::Float4Reg By, SIMD::Float4Reg Bz,
+                                                  SIMD::Float4Reg Cx, SIMD::Float4Reg Cy, SIMD::Float4Reg Cz,
+                                                  bool CullBackFace)
+{
+    using namespace SIMD;
+
+    const Float4Reg U = Sub(Mul(Cx, By), Mul(Cy, Bx));
+    const Float4Reg V = Sub(Mul(Ax, Cy), Mul(Ay, Cx));
+    const Float4Reg W = Sub(Mul(Bx, Ay), Mul(By, Ax));
+
+    const Float4Reg Zero        = Splat(0.f);
+    const Float4Reg AnyNegative = Or(Or(CmpLT(U, Zero), CmpLT(V, Zero)), CmpLT(W, Zero));
+    const Float4Reg AnyPositive = Or(Or(CmpGT(U, Zero), CmpGT(V, Zero)), CmpGT(W, Zero));
+
+    const Float4Reg Det  = Add(Add(U, V), W);
+    Float4Reg       Miss = CullBackFace ? AnyNegative : And(AnyNegative, AnyPositive);
+    Miss                 = Or(Miss, CmpEQ(Det, Zero));
+
+    const Float4Reg T = Add(Add(Mul(U, Az), Mul(V, Bz)), Mul(W, Cz));
+    return Select(Miss, Splat(+FLT_MAX), Div(T, Det));
+}
+#endif
+
+} // namespace
+
+void GetBoxesVisibility(const ViewFrustum&   Frustum,
+                        const BoundBoxesSoA& Boxes,
+                        Uint32               NumBoxes,
+                        Uint32*              VisibleMask,
+                        Uint32*              FullyVisibleMask,
+                        FRUSTUM_PLANE_FLAGS  PlaneFlags)
+{
+    VERIFY_EXPR(NumBoxes == 0 || VisibleMask != nullptr);
+
+    const BoxCullingPlanes Planes{Frustum, PlaneFlags, Boxes};
+    for (Uint32 FirstBox = 0; FirstBox < NumBoxes; FirstBox += 32)
+    {
+        Uint32 FullyVisibleBits = 0;
+        VisibleMask[FirstBox / 32] = Planes.ComputeVisibilityBits(FirstBox, std::min(NumBoxes - FirstBox, 32u), FullyVisibleBits);
+        if (FullyVisibleMask != nullptr)
+            FullyVisibleMask[FirstBox / 32] = FullyVisibleBits;
+    }
+}
+
+Uint32 GetVisibleBoxIndices(const ViewFrustum&   Frustum,
+                            const BoundBoxesSoA& Boxes,
+                            Uint32               NumBoxes,
+                            Uint32*              VisibleIndices,
+                            FRUSTUM_PLANE_FLAGS  PlaneFlags)
+{
+    VERIFY_EXPR(NumBoxes == 0 || VisibleIndices != nullptr);
+
+    const BoxCullingPlanes Planes{Frustum, PlaneFlags, Boxes};
+
+    Uint32 NumVisible = 0;
+    for (Uint32 FirstBox = 0; FirstBox < NumBoxes; FirstBox += 32)
+    {
+        Uint32 FullyVisibleBits = 0;
+        Uint32 VisibleBits      = Planes.ComputeVisibilityBits(FirstBox, std::min(NumBoxes - FirstBox, 32u), FullyVisibleBits);
+        while (VisibleBits != 0)
+        {
+            VisibleIndices[NumVisible++] = FirstBox + PlatformMisc::GetLSB(VisibleBits);
+            VisibleBits &= VisibleBits - 1;
+        }
+    }
+
+    return NumVisible;
+}
+
+void GetBoxesVisibilityMT(const ViewFrustum&   Frustum,
+                          const BoundBoxesSoA& Boxes,
+                          Uint32               NumBoxes,
+                          Uint32*              VisibleMask,
+                          Uint32*              FullyVisibleMask,
+                          Uint32               NumThreads,
+                          FRUSTUM_PLANE_FLAGS  PlaneFlags)
+{
+    ProcessBoxRangesMT(NumBoxes, NumThreads,
+                       [&](Uint32 FirstBox, Uint32 Count, Uint32 /*RangeIdx*/) //
+                       {
+                           GetBoxesVisibility(Frustum, Boxes.Offset(FirstBox), Count,
+                                              VisibleMask + FirstBox / 32,
+                                              FullyVisibleMask != nullptr ? FullyVisibleMask + FirstBox / 32 : nullptr,
+                                              PlaneFlags);
+                       });
+}
+
+Uint32 GetVisibleBoxIndicesMT(const ViewFrustum&   Frustum,
+                              const BoundBoxesSoA& Boxes,
+                              Uint32               NumBoxes,
+                              Uint32*              VisibleIndices,
+                              Uint32               NumThreads,
+                              FRUSTUM_PLANE_FLAGS  PlaneFlags)
+{
+    // Every range first writes its indices to its own part of the output array, after which
+    // the parts are compacted
+    std::vector<Uint32> RangeFirstBox(std::max(NumThreads, 1u));
+    std::vector<Uint32> RangeNumVisible(std::max(NumThreads, 1u));
+    ProcessBoxRangesMT(NumBoxes, NumThreads,
+                       [&](Uint32 FirstBox, Uint32 Count, Uint32 RangeIdx) //
+                       {
+                           Uint32* RangeIndices = VisibleIndices + FirstBox;
+
+                           const Uint32 NumVisible = GetVisibleBoxIndices(Frustum, Boxes.Offset(FirstBox), Count, RangeIndices, PlaneFlags);
+                           for (Uint32 i = 0; i < NumVisible; ++i)
+                               RangeIndices[i] += FirstBox;
+
+                           RangeFirstBox[RangeIdx]   = FirstBox;
+                           RangeNumVisible[RangeIdx] = NumVisible;
+                       });
+
+    Uint32 NumVisible = RangeNumVisible[0];
+    for (size_t r = 1; r < RangeNumVisible.size(); ++r)
+    {
+        const Uint32* RangeIndices = VisibleIndices + RangeFirstBox[r];
+        // Destination never exceeds the source, so forward copy is safe
+        std::copy(RangeIndices, RangeIndices + RangeNumVisible[r], VisibleIndices + NumVisible);
+        NumVisible += RangeNumVisible[r];
+    }
+
+    return NumVisible;
+}
+
+void TransformBoundBoxes(const BoundBox* InBoxes,
+                         const float4x4* Matrices,
+                         size_t          NumBoxes,
+                         BoundBox*       OutBoxes,
+                         BoundBox*       pMergedBox)
+{
+    VERIFY_EXPR(NumBoxes == 0 || Matrices != nullptr);
+    TransformBoundBoxesImpl(InBoxes, NumBoxes, OutBoxes, pMergedBox,
+                            [Matrices](size_t i) -> const float4x4& { return Matrices[i]; });
+}
+
+void TransformBoundBoxes(const BoundBox* InBoxes,
+                         const float4x4& Matrix,
+                         size_t          NumBoxes,
+                         BoundBox*       OutBoxes,
+                         BoundBox*       pMergedBox)
+{
+    TransformBoundBoxesImpl(InBoxes, NumBoxes, OutBoxes, pMergedBox,
+                            [&Matrix](size_t) -> const float4x4& { return Matrix; });
+}
+
+float IntersectRayTriangleWatertight(const float3& V0,
+                                     const float3& V1,
+                                     const float3& V2,
+                                     const float3& RayOrigin,
+                                     const float3& RayDirection,
+                                     bool          CullBackFace)
+{
+    VERIFY_EXPR(RayDirection != float3(0, 0, 0));
+
+    const WatertightRay Ray{RayDirection};
+
+    const float3 A = V0 - RayOrigin;
+    const float3 B = V1 - RayOrigin;
+    const float3 C = V2 - RayOrigin;
+
+    // clang-format off
+    const float Ax = A[Ray.kx] - Ray.Sx * A[Ray.kz];
+    const float Ay = A[Ray.ky] - Ray.Sy * A[Ray.kz];
+    const float Bx = B[Ray.kx] - Ray.Sx * B[Ray.kz];
+    const float By = B[Ray.ky] - Ray.Sy * B[Ray.kz];
+    const float Cx = C[Ray.kx] - Ray.Sx * C[Ray.kz];
+    const float Cy = C[Ray.ky] - Ray.Sy * C[Ray.kz];
+    // clang-format on
+
+    // Scaled barycentric coordinates
+    const float U = Cx * By - Cy * Bx;
+    const float V = Ax * Cy - Ay * Cx;
+    const float W = Bx * Ay - By * Ax;
+
+    const bool AnyNegative = U < 0 || V < 0 || W < 0;
+    const bool AnyPositive = U > 0 || V > 0 || W > 0;
+    // Front faces (see IntersectRayTriangle) have non-negative barycentrics
+    if (CullBackFace ? AnyNegative : (AnyNegative && AnyPositive))
+        return +FLT_MAX;
+
+    const float Det = U + V + W;
+    if (Det == 0)
+        return +FLT_MAX;
+
+    const float Az = Ray.Sz * A[Ray.kz];
+    const float Bz = Ray.Sz * B[Ray.kz];
+    const float Cz = Ray.Sz * C[Ray.kz];
+    const float T  = U * Az + V * Bz + W * Cz;
+
+    return T / Det;
+}
+
+void IntersectRayTriangles4(const float3&          RayOrigin,
+                            const float3&          RayDirection,
+                            const TrianglePacket4& Triangles,
+                            float                  Distances[4],
+                            bool                   CullBackFace)
+{
+#if DILIGENT_SIMD_MATH
+    using namespace SIMD;
+
+    VERIFY_EXPR(RayDirection != float3(0, 0, 0));
+
+    const WatertightRay Ray{RayDirection};
+
+    const Float4Reg Sx = Splat(Ray.Sx);
+    const Float4Reg Sy = Splat(Ray.Sy);
+    const Float4Reg Sz = Splat(Ray.Sz);
+    const Float4Reg Ox = Splat(RayOrigin[Ray.kx]);
+    const Float4Reg Oy = Splat(RayOrigin[Ray.ky]);
+    const Float4Reg Oz = Splat(RayOrigin[Ray.kz]);
+
+    Float4Reg X[3], Y[3], Z[3];
+    for (Uint32 v = 0; v < 3; ++v)
+    {
+        const Float4Reg Vz = Sub(Load(Triangles.V[v][Ray.kz]), Oz);
+
+        X[v] = Sub(Sub(Load(Triangles.V[v][Ray.kx]), Ox), Mul(Sx, Vz));
+        Y[v] = Sub(Sub(Load(Triangles.V[v][Ray.ky]), Oy), Mul(Sy, Vz));
+        Z[v] = Mul(Sz, Vz);
+    }
+
+    Store(Distances, ComputeWatertightDistances(X[0], Y[0], Z[0], X[1], Y[1], Z[1], X[2], Y[2], Z[2], CullBackFace));
+#else
+    for (Uint32 i = 0; i < 4; ++i)
+    {
+        const float3 V0{Triangles.V[0][0][i], Triangles.V[0][1][i], Triangles.V[0][2][i]};
+        const float3 V1{Triangles.V[1][0][i], Triangles.V[1][1][i], Triangles.V[1][2][i]};
+        const float3 V2{Triangles.V[2][0][i], Triangles.V[2][1][i], Triangles.V[2][2][i]};
+        Distances[i] = IntersectRayTriangleWatertight(V0, V1, V2, RayOrigin, RayDirection, CullBackFace);
+    }
+#endif
+}
+
+void IntersectRays4Triangle(const RayPacket4& Rays,
+                            const float3&     V0,
+                            const float3&     V1,
+                            const float3&     V2,
+                            float             Distances[4],
+                            bool              CullBackFace)
+{
+#if DILIGENT_SIMD_MATH
+    using namespace SIMD;
+
+    const Float4Reg Zero = Splat(0.f);
+
+    // Every ray has its own axis permutation (see WatertightRay), which is applied by selecting the
+    // components. ZIsX and ZIsY are the masks of the rays dominant along x and y, respectively.
+    const Float4Reg Dir[] = {Load(Rays.Direction[0]), Load(Rays.Direction[1]), Load(Rays.Direction[2])};
+    const Float4Reg AbsX  = Max(Dir[0], Sub(Zero, Dir[0]));
+    const Float4Reg AbsY  = Max(Dir[1], Sub(Zero, Dir[1]));
+    const Float4Reg AbsZ  = Max(Dir[2], Sub(Zero, Dir[2]));
+
+    const Float4Reg XGreaterY = CmpGT(AbsX, AbsY);
+    const Float4Reg ZIsX      = And(XGreaterY, CmpGT(AbsX, AbsZ));
+    const Float4Reg ZIsY      = Select(XGreaterY, Zero, CmpGT(AbsY, AbsZ));
+
+    // Returns the components that become x, y and z after the permutation
+    struct Permutation
+    {
+        Float4Reg ZIsX;
+        Float4Reg ZIsY;
+        Float4Reg Swap;
+
+        void Apply(const Float4Reg c[3], Float4Reg& x, Float4Reg& y, Float4Reg& z) const
+        {
+            const Float4Reg NextX = Select(ZIsX, c[1], Select(ZIsY, c[2], c[0]));
+            const Float4Reg NextY = Select(ZIsX, c[2], Select(ZIsY, c[0], c[1]));
+
+            x = Select(Swap, NextY, NextX);
+            y = Select(Swap, NextX, NextY);
+            z = Select(ZIsX, c[0], Select(ZIsY, c[1], c[2]));
+        }
+    };
+    Permutation Perm{ZIsX, ZIsY, Zero};
+
+    Float4Reg Dx, Dy, Dz;
+    Perm.Apply(Dir, Dx, Dy, Dz);
+    Perm.Swap = CmpLT(Dz, Zero);
+    if (MoveMask(Perm.Swap) != 0)
+        Perm.Apply(Dir, Dx, Dy, Dz);
+
+    const Float4Reg Sx = Div(Dx, Dz);
+    const Float4Reg Sy = Div(Dy, Dz);
+    const Float4Reg Sz = Div(Splat(1.f), Dz);
+
+    const Float4Reg Origin[] = {Load(Rays.Origin[0]), Load(Rays.Origin[1]), Load(Rays.Origin[2])};
+    const float3*   Verts[]  = {&V0, &V1, &V2};
+
+    Float4Reg X[3], Y[3], Z[3];
+    for (Uint32 v = 0; v < 3; ++v)
+    {
+        const Float4Reg Rel[] = {
+            Sub(Splat(Verts[v]->x), Origin[0]),
+            Sub(Splat(Verts[v]->y), Origin[1]),
+            Sub(Splat(Verts[v]->z), Origin[2]) //
+        };
+
+        Float4Reg Vx, Vy, Vz;
+        Perm.Apply(Rel, Vx, Vy, Vz);
+
+        X[v] = Sub(Vx, Mul(Sx, Vz));
+        Y[v] = Sub(Vy, Mul(Sy, Vz));
+        Z[v] = Mul(Sz, Vz);
+    }
+
+    Store(Distances, ComputeWatertightDistances(X[0], Y[0], Z[0], X[1], Y[1], Z[1], X[2], Y[2], Z[2], CullBackFace));
+#else
+    for (Uint32 i = 0; i < 4; ++i)
+    {
+        const float3 Origin{Rays.Origin[0][i], Rays.Origin[1][i], Rays.Origin[2][i]};
+        const float3 Direction{Rays.Direction[0][i], Rays.Direction[1][i], Rays.Direction[2][i]};
+        Distances[i] = IntersectRayTriangleWatertight(V0, V1, V2, Origin, Direction, CullBackFace);
+    }
+#endif
+}
+
+} // namespace Diligent
@@ -0,0 +1,584 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "BoundingVolumeHierarchy.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
+
+namespace Diligent
+{
+
+namespace
+{
+
+BoundBox MakeEmptyBox()
+{
+    return BoundBox{
+        float3{+FLT_MAX, +FLT_MAX, +FLT_MAX},
+        float3{-FLT_MAX, -FLT_MAX, -FLT_MAX} //
+    };
+}
+
+void GrowBox(BoundBox& Box, const BoundBox& Other)
+{
+    Box.Min = std::min(Box.Min, Other.Min);
+    Box.Max = std::max(Box.Max, Other.Max);
+}
+
+void GrowBox(BoundBox& Box, const float3& Point)
+{
+    Box.Min = std::min(Box.Min, Point);
+    Box.Max = std::max(Box.Max, Point);
+}
+
+// Half of the box surface area, which is sufficient for the SAH cost comparisons
+float GetHalfArea(const BoundBox& Box)
+{
+    const float3 Size = Box.Max - Box.Min;
+    return Size.x * Size.y + Size.y * Size.z + Size.z * Size.x;
+}
+
+bool BoxesOverlap(const BoundBox& Box0, const BoundBox& Box1)
+{
+    // clang-format off
+    return Box0.Min.x <= Box1.Max.x && Box0.Max.x >= Box1.Min.x &&
+           Box0.Min.y <= Box1.Max.y && Box0.Max.y >= Box1.Min.y &&
+           Box0.Min.z <= Box1.Max.z && Box0.Max.z >= Box1.Min.z;
+    // clang-format on
+}
+
+using Node = BoundingVolumeHierarchy::Node;
+
+class BVHBuilder
+{
+public:
+    // Subtree that is built by a separate thread into its own node array
+    struct SubtreeTask
+    {
+        Uint32 NodeIdx = 0;
+        Uint32 Begin   = 0;
+        Uint32 End     = 0;
+        Uint32 Depth   = 0;
+
+        std::vector<Node> Nodes;
+    };
+
+    BVHBuilder(const BoundBox*                                PrimBoxes,
+               Uint32*                                        PrimIds,
+               Uint32                                         NumPrims,
+               const BoundingVolumeHierarchy::BuildAttribs& Attribs,
+               Uint32                                         MaxSAHDepth) :
+        // clang-format off
+        m_PrimBoxes  {PrimBoxes},
+        m_PrimIds    {PrimIds},
+        m_MaxLeafSize{std::max(Attribs.MaxLeafSize, 1u)},
+        m_NumBins    {std::min(std::max(Attribs.NumBins, 2u), MaxBins)},
+        m_MaxSAHDepth{MaxSAHDepth}
+    // clang-format on
+    {
+        VERIFY(Attribs.NumBins >= 2 && Attribs.NumBins <= MaxBins, "The number of bins (", Attribs.NumBins, ") must be in [2, ", MaxBins, "] range");
+
+        m_Centroids.resize(NumPrims);
+        for (Uint32 i = 0; i < NumPrims; ++i)
+            m_Centroids[i] = (PrimBoxes[i].Min + PrimBoxes[i].Max) * 0.5f;
+
+        if (Attribs.NumThreads > 1)
+        {
+            // Create about two tasks per thread to balance the load
+            while ((1u << m_TaskDepth) < Attribs.NumThreads * 2)
+                ++m_TaskDepth;
+        }
+    }
+
+    // Builds the subtree of node NodeIdx for the primitives in [Begin, End) range.
+    // If pTasks is not null, large subtrees at the task depth are not built, but added to the task list.
+    void BuildNode(std::vector<Node>& Nodes, Uint32 NodeIdx, Uint32 Begin, Uint32 End, Uint32 Depth, std::vector<SubtreeTask>* pTasks) const
+    {
+        BoundBox NodeBox     = MakeEmptyBox();
+        BoundBox CentroidBox = MakeEmptyBox();
+        for (Uint32 i = Begin; i < End; ++i)
+        {
+            const Uint32 PrimId = m_PrimIds[i];
+            GrowBox(NodeBox, m_PrimBoxes[PrimId]);
+            GrowBox(CentroidBox, m_Centroids[PrimId]);
+        }
+        Nodes[NodeIdx].Box = NodeBox;
+
+        if (pTasks != nullptr && Depth == m_TaskDepth && End - Begin >= MinPrimsPerTask)
+        {
+            SubtreeTask Task;
+            Task.NodeIdx = NodeIdx;
+            Task.Begin   = Begin;
+            Task.End     = End;
+            Task.Depth   = Depth;
+            pTasks->emplace_back(std::move(Task));
+            return;
+        }
+
+        const Uint32 Mid = SplitPrimitives(Begin, End, NodeBox, CentroidBox, Depth);
+        if (Mid == Begin)
+        {
+            Nodes[NodeIdx].FirstChildOrPrim = Begin;
+            Nodes[NodeIdx].NumPrims         = End - Begin;
+            return;
+        }
+
+        const Uint32 FirstChild = static_cast<Uint32>(Nodes.size());
+        Nodes.resize(Nodes.size() + 2);
+        Nodes[NodeIdx].FirstChildOrPrim = FirstChild;
+        Nodes[NodeIdx].NumPrims         = 0;
+
+        BuildNode(Nodes, FirstChild, Begin, Mid, Depth + 1, pTasks);
+        BuildNode(Nodes, FirstChild + 1, Mid, End, Depth + 1, pTasks);
+    }
+
+private:
+    // Partitions the primitives and returns the index of the first primitive of the second child,
+    // or Begin if the node should be a leaf.
+    Uint32 SplitPrimitives(Uint32 Begin, Uint32 End, const BoundBox& NodeBox, const BoundBox& CentroidBox, Uint32 Depth) const
+    {
+        const Uint32 NumPrims = End - Begin;
+        if (NumPrims <= 1)
+            return Begin;
+
+        const float3 CentroidExtent = CentroidBox.Max - CentroidBox.Min;
+
+        int LargestAxis = 0;
+        if (CentroidExtent.y > CentroidExtent[LargestAxis]) LargestAxis = 1;
+        if (CentroidExtent.z > CentroidExtent[LargestAxis]) LargestAxis = 2;
+
+        if (!(CentroidExtent[LargestAxis] > 0))
+        {
+            // All centroids coincide, so any split is as good as the other
+            return NumPrims <= m_MaxLeafSize ? Begin : Begin + NumPrims / 2;
+        }
+
+        if (Depth >= m_MaxSAHDepth)
+            return NumPrims <= m_MaxLeafSize ? Begin : SplitMedian(Begin, End, LargestAxis);
+
+        Uint32 BestAxis  = 0;
+        Uint32 BestSplit = 0;
+        float  BestCost  = FLT_MAX;
+        for (Uint32 Axis = 0; Axis < 3; ++Axis)
+        {
+            if (!(CentroidExtent[Axis] > 0))
+                continue;
+
+            const float Scale = static_cast<float>(m_NumBins) / CentroidExtent[Axis];
+            const float Min   = CentroidBox.Min[Axis];
+
+            BoundBox BinBoxes[MaxBins];
+            Uint32   BinCounts[MaxBins] = {};
+            for (Uint32 b = 0; b < m_NumBins; ++b)
+                BinBoxes[b] = MakeEmptyBox();
+
+            for (Uint32 i = Begin; i < End; ++i)
+            {
+                const Uint32 PrimId = m_PrimIds[i];
+                const Uint32 Bin    = GetBin(m_Centroids[PrimId][Axis], Min, Scale);
+                GrowBox(BinBoxes[Bin], m_PrimBoxes[PrimId]);
+                ++BinCounts[Bin];
+            }
+
+            // Cost of the right child when splitting before bin b
+            float    RightCosts[MaxBins] = {};
+            BoundBox RightBox            = MakeEmptyBox();
+            Uint32   RightCount          = 0;
+            for (Uint32 b = m_NumBins - 1; b > 0; --b)
+            {
+                GrowBox(RightBox, BinBoxes[b]);
+                RightCount += BinCounts[b];
+                RightCosts[b] = RightCount > 0 ? static_cast<float>(RightCount) * GetHalfArea(RightBox) : 0.f;
+            }
+
+            BoundBox LeftBox   = MakeEmptyBox();
+            Uint32   LeftCount = 0;
+            for (Uint32 b = 1; b < m_NumBins; ++b)
+            {
+                GrowBox(LeftBox, BinBoxes[b - 1]);
+                LeftCount += BinCounts[b - 1];
+                if (LeftCount == 0 || LeftCount == NumPrims)
+                    continue;
+
+                const float Cost = static_cast<float>(LeftCount) * GetHalfArea(LeftBox) + RightCosts[b];
+                if (Cost < BestCost)
+                {
+                    BestCost  = Cost;
+                    BestAxis  = Axis;
+                    BestSplit = b;
+                }
+            }
+        }
+
+        if (BestCost == FLT_MAX)
+        {
+            // All primitives fall into the same bin
+            return NumPrims <= m_MaxLeafSize ? Begin : SplitMedian(Begin, End, LargestAxis);
+        }
+
+        if (NumPrims <= m_MaxLeafSize)
+        {
+            // SAH with equal traversal and intersection costs:
+            // split cost = 1 + (AreaL * NumL + AreaR * NumR) / Area, leaf cost = NumPrims.
+            const float NodeArea = GetHalfArea(NodeBox);
+            if (NodeArea + BestCost >= static_cast<float>(NumPrims) * NodeArea)
+                return Begin;
+        }
+
+        const float   Scale = static_cast<float>(m_NumBins) / CentroidExtent[BestAxis];
+        const float   Min   = CentroidBox.Min[BestAxis];
+        const Uint32* Mid   = std::partition(m_PrimIds + Begin, m_PrimIds + End,
+                                           [&](Uint32 PrimId) //
+                                           {
+                                               return GetBin(m_Centroids[PrimId][BestAxis], Min, Scale) < BestSplit;
+                                           });
+        return static_cast<Uint32>(Mid - m_PrimIds);
+    }
+
+    Uint32 SplitMedian(Uint32 Begin, Uint32 End, int Axis) const
+    {
+        const Uint32 Mid = Begin + (End - Begin) / 2;
+        std::nth_element(m_PrimIds + Begin, m_PrimIds + Mid, m_PrimIds + End,
+                         [&](Uint32 PrimId0, Uint32 PrimId1) //
+                         {
+                             return m_Centroids[PrimId0][Axis] < m_Centroids[PrimId1][Axis];
+                         });
+        return Mid;
+    }
+
+    Uint32 GetBin(float Coord, float Min, float Scale) const
+    {
+        return std::min(static_cast<Uint32>((Coord - Min) * Scale), m_NumBins - 1);
+    }
+
+    static constexpr Uint32 MaxBins         = 32;
+    static constexpr Uint32 MinPrimsPerTask = 1024;
+
+    const BoundBox* const m_PrimBoxes;
+    Uint32* const         m_PrimIds;
+    const Uint32          m_MaxLeafSize;
+    const Uint32          m_NumBins;
+    const Uint32          m_MaxSAHDepth;
+
+    std::vector<float3> m_Centroids;
+
+    Uint32 m_TaskDepth = 0;
+};
+
+constexpr Uint32 BVHBuilder::MaxBins;
+constexpr Uint32 BVHBuilder::MinPrimsPerTask;
+
+} // namespace
+
+constexpr Uint32 BoundingVolumeHierarchy::InvalidIndex;
+constexpr Uint32 BoundingVolumeHierarchy::MaxSAHDepth;
+constexpr Uint32 BoundingVolumeHierarchy::MaxDepth;
+
+void BoundingVolumeHierarchy::Build(const BoundBox* PrimBoxes, Uint32 NumPrims, const BuildAttribs& Attribs)
+{
+    Clear();
+    if (NumPrims == 0)
+        return;
+
+    VERIFY_EXPR(PrimBoxes != nullptr);
+
+    m_PrimIds.resize(NumPrims);
+    std::iota(m_PrimIds.begin(), m_PrimIds.end(), 0u);
+
+    const BVHBuilder Builder{PrimBoxes, m_PrimIds.data(), NumPrims, Attribs, MaxSAHDepth};
+
+    // A binary tree with N leaves has 2N - 1 nodes
+    m_Nodes.reserve(size_t{NumPrims} * 2 - 1);
+    m_Nodes.resize(1);
+
+    std::vector<BVHBuilder::SubtreeTask> Tasks;
+    Builder.BuildNode(m_Nodes, 0, 0, NumPrims, 0, Attribs.NumThreads > 1 ? &Tasks : nullptr);
+
+    if (!Tasks.empty())
+    {
+        // Subtrees cover disjoint ranges of the primitive list and are built into separate node arrays
+        std::atomic<size_t> NextTask{0};
+
+        auto ProcessTasks = [&]() {
+            for (size_t t = NextTask.fetch_add(1); t < Tasks.size(); t = NextTask.fetch_add(1))
+            {
+                BVHBuilder::SubtreeTask& Task = Tasks[t];
+                Task.Nodes.resize(1);
+                Builder.BuildNode(Task.Nodes, 0, Task.Begin, Task.End, Task.Depth, nullptr);
+            }
+        };
+
+        std::vector<std::thread> Workers;
+        const size_t             NumWorkers = std::min(size_t{Attribs.NumThreads}, Tasks.size()) - 1;
+        Workers.reserve(NumWorkers);
+        for (size_t i = 0; i < NumWorkers; ++i)
+            Workers.emplace_back(ProcessTasks);
+        ProcessTasks();
+        for (auto& Worker : Workers)
+            Worker.join();
+
+        // The root of every subtree replaces its placeholder node, and the remaining nodes
+        // are appended to the end of the array
+        for (const BVHBuilder::SubtreeTask& Task : Tasks)
+        {
+            const Uint32 Offset = static_cast<Uint32>(m_Nodes.size()) - 1;
+            for (size_t i = 0; i < Task.Nodes.size(); ++i)
+            {
+                Node SubtreeNode = Task.Nodes[i];
+                if (!SubtreeNode.IsLeaf())
+                    SubtreeNode.FirstChildOrPrim += Offset;
+
+                if (i == 0)
+                    m_Nodes[Task.NodeIdx] = SubtreeNode;
+                else
+                    m_Nodes.push_back(SubtreeNode);
+            }
+        }
+    }
+
+    FinalizeBuild(PrimBoxes);
+}
+
+void BoundingVolumeHierarchy::FinalizeBuild(const BoundBox* PrimBoxes)
+{
+    const size_t NumPrims = m_PrimIds.size();
+    const size_t NumNodes = m_Nodes.size();
+
+    m_PrimBoxes.resize(NumPrims);
+    for (size_t i = 0; i < NumPrims; ++i)
+        m_PrimBoxes[i] = PrimBoxes[m_PrimIds[i]];
+
+    m_NodeParents.assign(NumNodes, InvalidIndex);
+    m_PrimLeaves.resize(NumPrims);
+    m_PrimSlots.resize(NumPrims);
+
+    // Children are always located after their parents
+    std::vector<Uint32> NodeDepths(NumNodes, 1);
+    m_Depth = 0;
+    for (Uint32 NodeIdx = 0; NodeIdx < NumNodes; ++NodeIdx)
+    {
+        const Node& CurrNode = m_Nodes[NodeIdx];
+        m_Depth              = std::max(m_Depth, NodeDepths[NodeIdx]);
+        if (CurrNode.IsLeaf())
+        {
+            for (Uint32 Slot = CurrNode.FirstChildOrPrim; Slot < CurrNode.FirstChildOrPrim + CurrNode.NumPrims; ++Slot)
+            {
+                m_PrimLeaves[m_PrimIds[Slot]] = NodeIdx;
+                m_PrimSlots[m_PrimIds[Slot]]  = Slot;
+            }
+        }
+        else
+        {
+            for (Uint32 Child = CurrNode.FirstChildOrPrim; Child < CurrNode.FirstChildOrPrim + 2; ++Child)
+            {
+                VERIFY_EXPR(Child > NodeIdx);
+                m_NodeParents[Child] = NodeIdx;
+                NodeDepths[Child]    = NodeDepths[NodeIdx] + 1;
+            }
+        }
+    }
+    VERIFY(m_Depth <= MaxDepth, "The hierarchy depth (", m_Depth, ") exceeds the maximum allowed depth (", MaxDepth, ")");
+}
+
+void BoundingVolumeHierarchy::Clear()
+{
+    m_Nodes.clear();
+    m_PrimIds.clear();
+    m_PrimBoxes.clear();
+    m_NodeParents.clear();
+    m_PrimLeaves.clear();
+    m_PrimSlots.clear();
+    m_Depth = 0;
+}
+
+void BoundingVolumeHierarchy::UpdateNodeBox(Uint32 NodeIdx)
+{
+    Node&    CurrNode = m_Nodes[NodeIdx];
+    BoundBox NewBox   = MakeEmptyBox();
+    if (CurrNode.IsLeaf())
+    {
+        for (Uint32 Slot = CurrNode.FirstChildOrPrim; Slot < CurrNode.FirstChildOrPrim + CurrNode.NumPrims; ++Slot)
+            GrowBox(NewBox, m_PrimBoxes[Slot]);
+    }
+    else
+    {
+        GrowBox(NewBox, m_Nodes[CurrNode.FirstChildOrPrim].Box);
+        GrowBox(NewBox, m_Nodes[CurrNode.FirstChildOrPrim + 1].Box);
+    }
+    CurrNode.Box = NewBox;
+}
+
+void BoundingVolumeHierarchy::Refit(const BoundBox* PrimBoxes)
+{
+    for (size_t Slot = 0; Slot < m_PrimIds.size(); ++Slot)
+        m_PrimBoxes[Slot] = PrimBoxes[m_PrimIds[Slot]];
+
+    // Children are always located after their parents, so the nodes are updated bottom-up
+    for (size_t NodeIdx = m_Nodes.size(); NodeIdx > 0; --NodeIdx)
+        UpdateNodeBox(static_cast<Uint32>(NodeIdx - 1));
+}
+
+void BoundingVolumeHierarchy::RefitPrimitives(const Uint32* PrimIds, Uint32 NumIds, const BoundBox* PrimBoxes)
+{
+    for (Uint32 i = 0; i < NumIds; ++i)
+    {
+        const Uint32 PrimId = PrimIds[i];
+        VERIFY(PrimId < m_PrimSlots.size(), "Primitive id (", PrimId, ") is out of range");
+        m_PrimBoxes[m_PrimSlots[PrimId]] = PrimBoxes[PrimId];
+    }
+
+    for (Uint32 i = 0; i < NumIds; ++i)
+    {
+        // After every walk, each node on the path is the union of its children's current boxes.
+        // If a node's box does not change, its ancestors are up to date as well.
+        for (Uint32 NodeIdx = m_PrimLeaves[PrimIds[i]]; NodeIdx != InvalidIndex; NodeIdx = m_NodeParents[NodeIdx])
+        {
+            const BoundBox OldBox = m_Nodes[NodeIdx].Box;
+            UpdateNodeBox(NodeIdx);
+            if (m_Nodes[NodeIdx].Box.Min == OldBox.Min && m_Nodes[NodeIdx].Box.Max == OldBox.Max)
+                break;
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::QueryFrustum(const ViewFrustum&   Frustum,
+                                           std::vector<Uint32>& PrimIds,
+                                           FRUSTUM_PLANE_FLAGS  PlaneFlags) const
+{
+    if (m_Nodes.empty())
+        return;
+
+    struct StackEntry
+    {
+        Uint32              NodeIdx;
+        FRUSTUM_PLANE_FLAGS PlaneFlags;
+    };
+    StackEntry Stack[MaxDepth + 1];
+    Uint32     StackSize = 0;
+
+    Stack[StackSize++] = {0, PlaneFlags};
+    while (StackSize > 0)
+    {
+        const StackEntry Entry    = Stack[--StackSize];
+        const Node&      CurrNode = m_Nodes[Entry.NodeIdx];
+
+        // Remove the planes the node is fully inside of, so that its children are not tested against them
+        FRUSTUM_PLANE_FLAGS RemainingPlanes = FRUSTUM_PLANE_FLAG_NONE;
+        bool                IsVisible       = true;
+        for (Uint32 plane_idx = 0; plane_idx < ViewFrustum::NUM_PLANES && IsVisible; ++plane_idx)
+        {
+            const FRUSTUM_PLANE_FLAGS PlaneFlag = static_cast<FRUSTUM_PLANE_FLAGS>(1u << plane_idx);
+            if ((Entry.PlaneFlags & PlaneFlag) == 0)
+                continue;
+
+            const Plane3D& Plane = Frustum.GetPlane(static_cast<ViewFrustum::PLANE_IDX>(plane_idx));
+            switch (GetBoxVisibilityAgainstPlane(Plane, CurrNode.Box))
+            {
+                case BoxVisibility::Invisible:
+                    IsVisible = false;
+                    break;
+
+                case BoxVisibility::Intersecting:
+                    RemainingPlanes |= PlaneFlag;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+        if (!IsVisible)
+            continue;
+
+        if (RemainingPlanes == FRUSTUM_PLANE_FLAG_NONE)
+        {
+            // The node is fully visible. Its primitives form a contiguous range that starts
+            // in the leftmost leaf and ends in the rightmost leaf.
+            Uint32 FirstNode = Entry.NodeIdx;
+            while (!m_Nodes[FirstNode].IsLeaf())
+                FirstNode = m_Nodes[FirstNode].FirstChildOrPrim;
+            Uint32 LastNode = Entry.NodeIdx;
+            while (!m_Nodes[LastNode].IsLeaf())
+                LastNode = m_Nodes[LastNode].FirstChildOrPrim + 1;
+
+            PrimIds.insert(PrimIds.end(),
+                           m_PrimIds.begin() + m_Nodes[FirstNode].FirstChildOrPrim,
+                           m_PrimIds.begin() + m_Nodes[LastNode].FirstChildOrPrim + m_Nodes[LastNode].NumPrims);
+        }
+        else if (CurrNode.IsLeaf())
+        {
+            for (Uint32 Slot = CurrNode.FirstChildOrPrim; Slot < CurrNode.FirstChildOrPrim + CurrNode.NumPrims; ++Slot)
+            {
+                if (GetBoxVisibility(Frustum, m_PrimBoxes[Slot], RemainingPlanes) != BoxVisibility::Invisible)
+                    PrimIds.push_back(m_PrimIds[Slot]);
+            }
+        }
+        else
+        {
+            VERIFY(StackSize + 2 <= _countof(Stack), "Stack overflow: the hierarchy is too deep");
+            // Push the second child first to visit the primitives in the list order
+            Stack[StackSize++] = {CurrNode.FirstChildOrPrim + 1, RemainingPlanes};
+            Stack[StackSize++] = {CurrNode.FirstChildOrPrim, RemainingPlanes};
+        }
+    }
+}
+
+void BoundingVolumeHierarchy::QueryBox(const BoundBox& Box, std::vector<Uint32>& PrimIds) const
+{
+    if (m_Nodes.empty())
+        return;
+
+    Uint32 Stack[MaxDepth + 1];
+    Uint32 StackSize = 0;
+
+    Stack[StackSize++] = 0;
+    while (StackSize > 0)
+    {
+        const Node& CurrNode = m_Nodes[Stack[--StackSize]];
+        if (!BoxesOverlap(CurrNode.Box, Box))
+            continue;
+
+        if (CurrNode.IsLeaf())
+        {
+            for (Uint32 Slot = CurrNode.FirstChildOrPrim; Slot < CurrNode.FirstChildOrPrim + CurrNode.NumPrims; ++Slot)
+            {
+                if (BoxesOverlap(m_PrimBoxes[Slot], Box))
+                    PrimIds.push_back(m_PrimIds[Slot]);
+            }
+        }
+        else
+        {
+            VERIFY(StackSize + 2 <= _countof(Stack), "Stack overflow: the hierarchy is too deep");
+            Stack[StackSize++] = CurrNode.FirstChildOrPrim + 1;
+            Stack[StackSize++] = CurrNode.FirstChildOrPrim;
+        }
+    }
+}
+
+} // namespace Diligent
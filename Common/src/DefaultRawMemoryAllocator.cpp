@@ -26,22 +26,187 @@
  */
 
 #include "pch.h"
+#include <mutex>
+#include <array>
+#include <unordered_map>
+#include <algorithm>
+#include <sstream>
+#include <tuple>
+
 #include "DefaultRawMemoryAllocator.hpp"
+#include "DataBlobImpl.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "HashUtils.hpp"
+#include "Errors.hpp"
 
 namespace Diligent
 {
 
+class DefaultRawMemoryAllocator::AllocationTracker
+{
+public:
+    void OnAllocate(void* Ptr, size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber)
+    {
+        auto& Site = GetSite(SiteKey{dbgDescription, dbgFileName, dbgLineNumber});
+
+        const auto LiveBytes = Site.LiveBytes.fetch_add(Size) + Size;
+        Site.NumLiveAllocations.fetch_add(1);
+        Site.TotalAllocations.fetch_add(1);
+
+        auto PeakLiveBytes = Site.PeakLiveBytes.load();
+        while (PeakLiveBytes < LiveBytes && !Site.PeakLiveBytes.compare_exchange_weak(PeakLiveBytes, LiveBytes))
+        {
+        }
+
+        auto&                       Shard = m_AllocationShards[GetPointerShardIndex(Ptr)];
+        std::lock_guard<std::mutex> Lock{Shard.Mtx};
+        Shard.Allocations.emplace(Ptr, LiveAllocation{&Site, Size});
+    }
+
+    void OnFree(void* Ptr)
+    {
+        LiveAllocation Allocation;
+        {
+            auto&                       Shard = m_AllocationShards[GetPointerShardIndex(Ptr)];
+            std::lock_guard<std::mutex> Lock{Shard.Mtx};
+
+            auto it = Shard.Allocations.find(Ptr);
+            if (it == Shard.Allocations.end())
+                return; // The allocation was made while tracking was disabled
+
+            Allocation = it->second;
+            Shard.Allocations.erase(it);
+        }
+
+        Allocation.pSite->LiveBytes.fetch_sub(Allocation.Size);
+        Allocation.pSite->NumLiveAllocations.fetch_sub(1);
+    }
+
+    void GetSiteStats(std::vector<AllocationSiteStats>& Stats) const
+    {
+        for (const auto& Shard : m_SiteShards)
+        {
+            std::lock_guard<std::mutex> Lock{Shard.Mtx};
+            for (const auto& it : Shard.Sites)
+            {
+                AllocationSiteStats SiteStats;
+                SiteStats.Description        = it.first.Description;
+                SiteStats.FileName           = it.first.FileName;
+                SiteStats.LineNumber         = it.first.LineNumber;
+                SiteStats.LiveBytes          = it.second.LiveBytes.load();
+                SiteStats.NumLiveAllocations = it.second.NumLiveAllocations.load();
+                SiteStats.PeakLiveBytes      = it.second.PeakLiveBytes.load();
+                SiteStats.TotalAllocations   = it.second.TotalAllocations.load();
+                Stats.emplace_back(SiteStats);
+            }
+        }
+    }
+
+private:
+    struct SiteKey
+    {
+        const Char* Description;
+        const char* FileName;
+        Int32       LineNumber;
+
+        bool operator==(const SiteKey& rhs) const
+        {
+            // Descriptions and file names are expected to be string literals,
+            // so comparing the pointers is sufficient
+            return Description == rhs.Description && FileName == rhs.FileName && LineNumber == rhs.LineNumber;
+        }
+
+        struct Hasher
+        {
+            size_t operator()(const SiteKey& Key) const
+            {
+                return ComputeHash(Key.Description, Key.FileName, Key.LineNumber);
+            }
+        };
+    };
+
+    struct SiteCounters
+    {
+        std::atomic<size_t> LiveBytes{0};
+        std::atomic<size_t> NumLiveAllocations{0};
+        std::atomic<size_t> PeakLiveBytes{0};
+        std::atomic<Uint64> TotalAllocations{0};
+    };
+
+    struct LiveAllocation
+    {
+        LiveAllocation() {}
+
+        // clang-format off
+        LiveAllocation(SiteCounters* _pSite, size_t _Size) :
+            pSite{_pSite},
+            Size {_Size }
+        {}
+        // clang-format on
+
+        SiteCounters* pSite = nullptr;
+        size_t        Size  = 0;
+    };
+
+    SiteCounters& GetSite(const SiteKey& Key)
+    {
+        auto& Shard = m_SiteShards[SiteKey::Hasher{}(Key) % NumShards];
+
+        std::lock_guard<std::mutex> Lock{Shard.Mtx};
+        // Map nodes are never moved, so the counters can be referenced after the lock is released
+        return Shard.Sites.emplace(std::piecewise_construct, std::forward_as_tuple(Key), std::forward_as_tuple()).first->second;
+    }
+
+    static size_t GetPointerShardIndex(const void* Ptr)
+    {
+        // Low bits of the address are zero because of the alignment
+        const auto Addr = reinterpret_cast<size_t>(Ptr) >> 4;
+        return (Addr ^ (Addr >> 7) ^ (Addr >> 13)) % NumShards;
+    }
+
+    static constexpr size_t NumShards = 64;
+
+    struct SiteShard
+    {
+        mutable std::mutex                                         Mtx;
+        std::unordered_map<SiteKey, SiteCounters, SiteKey::Hasher> Sites;
+    };
+    std::array<SiteShard, NumShards> m_SiteShards;
+
+    struct AllocationShard
+    {
+        std::mutex                                Mtx;
+        std::unordered_map<void*, LiveAllocation> Allocations;
+    };
+    std::array<AllocationShard, NumShards> m_AllocationShards;
+};
+
 DefaultRawMemoryAllocator::DefaultRawMemoryAllocator()
 {
 }
 
+DefaultRawMemoryAllocator::~DefaultRawMemoryAllocator()
+{
+    delete m_pTracker.exchange(nullptr);
+}
+
 void* DefaultRawMemoryAllocator::Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber)
 {
-    return new Uint8[Size];
+    auto* Ptr = new Uint8[Size];
+    if (m_TrackingEnabled.load(std::memory_order_acquire))
+    {
+        // The tracker is created before tracking is enabled
+        auto* pTracker = m_pTracker.load(std::memory_order_acquire);
+        VERIFY_EXPR(pTracker != nullptr);
+        pTracker->OnAllocate(Ptr, Size, dbgDescription, dbgFileName, dbgLineNumber);
+    }
+    return Ptr;
 }
 
 void DefaultRawMemoryAllocator::Free(void* Ptr)
 {
+    if (auto* pTracker = m_pTracker.load(std::memory_order_acquire))
+        pTracker->OnFree(Ptr);
     delete[] reinterpret_cast<Uint8*>(Ptr);
 }
 
@@ -51,4 +216,76 @@ DefaultRawMemoryAllocator& DefaultRawMemoryAllocator::GetAllocator()
     return Allocator;
 }
 
+void DefaultRawMemoryAllocator::EnableAllocationTracking(bool Enable)
+{
+    if (Enable && m_pTracker.load() == nullptr)
+    {
+        auto*              pNewTracker = new AllocationTracker;
+        AllocationTracker* pExpected   = nullptr;
+        if (!m_pTracker.compare_exchange_strong(pExpected, pNewTracker))
+            delete pNewTracker; // Another thread has created the tracker
+    }
+    m_TrackingEnabled.store(Enable);
+}
+
+std::vector<DefaultRawMemoryAllocator::AllocationSiteStats> DefaultRawMemoryAllocator::GetAllocationSiteStats(size_t MaxSites) const
+{
+    std::vector<AllocationSiteStats> Stats;
+    if (const auto* pTracker = m_pTracker.load())
+        pTracker->GetSiteStats(Stats);
+
+    std::sort(Stats.begin(), Stats.end(),
+              [](const AllocationSiteStats& Site0, const AllocationSiteStats& Site1) {
+                  // Sites are stored in hash maps keyed by string addresses, so
+                  // break ties to keep the order independent of the memory layout
+                  if (Site0.LiveBytes != Site1.LiveBytes)
+                      return Site0.LiveBytes > Site1.LiveBytes;
+                  if (Site0.PeakLiveBytes != Site1.PeakLiveBytes)
+                      return Site0.PeakLiveBytes > Site1.PeakLiveBytes;
+                  if (Site0.TotalAllocations != Site1.TotalAllocations)
+                      return Site0.TotalAllocations > Site1.TotalAllocations;
+                  return Site0.LineNumber < Site1.LineNumber;
+              });
+    if (MaxSites != 0 && Stats.size() > MaxSites)
+        Stats.resize(MaxSites);
+
+    return Stats;
+}
+
+static void WriteSiteStats(std::stringstream& ss, const DefaultRawMemoryAllocator::AllocationSiteStats& Site)
+{
+    ss << Site.LiveBytes << '\t' << Site.NumLiveAllocations << '\t' << Site.PeakLiveBytes << '\t' << Site.TotalAllocations << '\t'
+       << (Site.FileName != nullptr ? Site.FileName : "<unknown>") << '(' << Site.LineNumber << ")\t"
+       << (Site.Description != nullptr ? Site.Description : "") << '\n';
+}
+
+void DefaultRawMemoryAllocator::LogTopAllocationSites(size_t NumSites) const
+{
+    const auto Stats = GetAllocationSiteStats(NumSites);
+
+    std::stringstream ss;
+    ss << "Top " << Stats.size() << " allocation sites (live bytes, live allocations, peak live bytes, total allocations, site, description):\n";
+    for (const auto& Site : Stats)
+        WriteSiteStats(ss, Site);
+    LOG_INFO_MESSAGE(ss.str());
+}
+
+void DefaultRawMemoryAllocator::SnapshotAllocationSites(IDataBlob** ppSnapshot, size_t MaxSites) const
+{
+    DEV_CHECK_ERR(ppSnapshot != nullptr && *ppSnapshot == nullptr, "Snapshot pointer must not be null, and the object it points to must be null");
+
+    // Collect the statistics before creating the blob as the blob allocates memory
+    const auto Stats = GetAllocationSiteStats(MaxSites);
+
+    std::stringstream ss;
+    for (const auto& Site : Stats)
+        WriteSiteStats(ss, Site);
+    const auto Report = ss.str();
+
+    RefCntAutoPtr<DataBlobImpl> pSnapshot{MakeNewRCObj<DataBlobImpl>()(Report.length())};
+    if (!Report.empty())
+        memcpy(pSnapshot->GetDataPtr(), Report.data(), Report.length());
+    *ppSnapshot = pSnapshot.Detach();
+}
+
 } // namespace Diligent
@@ -27,6 +27,7 @@
 
 #include "pch.h"
 #include <algorithm>
+#include <atomic>
 #include "FixedBlockMemoryAllocator.hpp"
 #include "Align.hpp"
 
@@ -38,24 +39,219 @@ static size_t AdjustBlockSize(size_t BlockSize)
     return Align(std::max(BlockSize, size_t{1}), sizeof(void*));
 }
 
+// Every aligned page starts with the page index
+static constexpr size_t AlignedPageHeaderSize = sizeof(size_t);
+static_assert(AlignedPageHeaderSize % sizeof(void*) == 0, "Aligned page header size must be a multiple of the block alignment");
+
+// Maximum number of aligned pages allocated from the raw allocator at once
+static constexpr size_t MaxAlignedPagesPerChunk = 16;
+
+// Aligned pages find the owning page by masking the block address and do not need the
+// address-to-page map. Debug builds still keep it to detect double frees and foreign pointers.
+#ifdef DILIGENT_DEBUG
+static constexpr bool TrackAlignedPageBlocks = true;
+#else
+static constexpr bool TrackAlignedPageBlocks = false;
+#endif
+
+static size_t ComputePageAlignment(size_t BlockSize, Uint32 NumBlocksInPage)
+{
+    size_t PageAlignment = 1;
+    while (PageAlignment < BlockSize * NumBlocksInPage || PageAlignment < AlignedPageHeaderSize + BlockSize)
+        PageAlignment *= 2;
+    return PageAlignment;
+}
+
+// Protects the links between allocators and thread caches. Only locked when a thread cache
+// is created or released, never on the allocation fast path.
+static std::mutex& GetThreadCacheRegistryMutex()
+{
+    static std::mutex RegistryMtx;
+    return RegistryMtx;
+}
+
+static std::atomic<Uint64> NextAllocatorId{1};
+
+// Thread-private cache of free blocks for one allocator
+struct FixedBlockMemoryAllocator::ThreadCache
+{
+    ThreadCache(FixedBlockMemoryAllocator& Owner) :
+        // clang-format off
+        OwnerId{Owner.m_AllocatorId},
+        Blocks (Owner.m_ThreadCacheSize)
+    // clang-format on
+    {
+        // The registry mutex must be locked
+        pOwner = &Owner;
+        pNext  = Owner.m_pThreadCaches;
+        if (pNext != nullptr)
+            pNext->pPrev = this;
+        Owner.m_pThreadCaches = this;
+    }
+
+    // Must be called with the registry mutex locked
+    void Detach()
+    {
+        VERIFY_EXPR(pOwner != nullptr);
+        if (pPrev != nullptr)
+            pPrev->pNext = pNext;
+        else
+            pOwner->m_pThreadCaches = pNext;
+        if (pNext != nullptr)
+            pNext->pPrev = pPrev;
+        pOwner = nullptr;
+        pPrev  = nullptr;
+        pNext  = nullptr;
+    }
+
+    // Owner allocator and links in its cache list. The owner is reset to null when
+    // the allocator is destroyed. Protected by the registry mutex.
+    FixedBlockMemoryAllocator* pOwner = nullptr;
+    ThreadCache*               pPrev  = nullptr;
+    ThreadCache*               pNext  = nullptr;
+
+    const Uint64 OwnerId;
+
+    // Free blocks that belong to the owner allocator. Only accessed by the thread
+    // that owns the cache, or by the owner allocator when it is destroyed.
+    std::vector<void*> Blocks;
+    Uint32             NumBlocks = 0;
+};
+
+// All thread caches of a single thread. Blocks cached by the thread are returned
+// to their allocators when the thread exits.
+class FixedBlockMemoryAllocator::ThreadCacheList
+{
+public:
+    ThreadCacheList() {}
+
+    ~ThreadCacheList()
+    {
+        std::lock_guard<std::mutex> RegistryLock{GetThreadCacheRegistryMutex()};
+        for (auto& it : m_Caches)
+            Release(it.second);
+    }
+
+    ThreadCache* Find(Uint64 AllocatorId)
+    {
+        // Most threads work with a handful of allocators at a time, so check the small
+        // direct-mapped table first and fall back to the hash map.
+        auto*& pRecentCache = m_RecentCaches[AllocatorId % NumRecentCaches];
+        if (pRecentCache != nullptr && pRecentCache->OwnerId == AllocatorId)
+            return pRecentCache;
+
+        auto it = m_Caches.find(AllocatorId);
+        if (it == m_Caches.end())
+            return nullptr;
+
+        pRecentCache = it->second;
+        return pRecentCache;
+    }
+
+    ThreadCache* Create(FixedBlockMemoryAllocator& Allocator)
+    {
+        std::lock_guard<std::mutex> RegistryLock{GetThreadCacheRegistryMutex()};
+
+        // Remove caches of destroyed allocators. The list is only pruned when it has doubled
+        // in size since the last time, which keeps the cost amortized constant.
+        if (m_Caches.size() >= m_PruneThreshold)
+        {
+            for (auto it = m_Caches.begin(); it != m_Caches.end();)
+            {
+                if (it->second->pOwner == nullptr)
+                {
+                    auto*& pRecentCache = m_RecentCaches[it->first % NumRecentCaches];
+                    if (pRecentCache == it->second)
+                        pRecentCache = nullptr;
+                    Release(it->second);
+                    it = m_Caches.erase(it);
+                }
+                else
+                    ++it;
+            }
+            m_PruneThreshold = std::max(m_Caches.size() * 2, size_t{16});
+        }
+
+        auto* pCache = new ThreadCache{Allocator};
+        m_Caches.emplace(Allocator.m_AllocatorId, pCache);
+        m_RecentCaches[Allocator.m_AllocatorId % NumRecentCaches] = pCache;
+        return pCache;
+    }
+
+private:
+    // Must be called with the registry mutex locked
+    static void Release(ThreadCache* pCache)
+    {
+        if (auto* pOwner = pCache->pOwner)
+        {
+            pOwner->FlushThreadCache(*pCache, pCache->NumBlocks);
+            pCache->Detach();
+        }
+        delete pCache;
+    }
+
+    static constexpr size_t NumRecentCaches = 16;
+
+    ThreadCache* m_RecentCaches[NumRecentCaches] = {};
+
+    std::unordered_map<Uint64, ThreadCache*> m_Caches;
+
+    size_t m_PruneThreshold = 16;
+};
+
 FixedBlockMemoryAllocator::FixedBlockMemoryAllocator(IMemoryAllocator& RawMemoryAllocator,
                                                      size_t            BlockSize,
-                                                     Uint32            NumBlocksInPage) :
+                                                     Uint32            NumBlocksInPage,
+                                                     Uint32            ThreadCacheSize,
+                                                     bool              AlignedPages,
+                                                     Uint32            MaxNumBlocksInPage) :
     // clang-format off
     m_PagePool          (STD_ALLOCATOR_RAW_MEM(MemoryPage, RawMemoryAllocator, "Allocator for vector<MemoryPage>")),
     m_AvailablePages    (STD_ALLOCATOR_RAW_MEM(size_t, RawMemoryAllocator, "Allocator for unordered_set<size_t>") ),
     m_AddrToPageId      (STD_ALLOCATOR_RAW_MEM(AddrToPageIdMapElem, RawMemoryAllocator, "Allocator for unordered_map<void*, size_t>")),
+    m_AlignedPageChunks (STD_ALLOCATOR_RAW_MEM(void*, RawMemoryAllocator, "Allocator for vector<void*>")),
+    m_SpareAlignedPages (STD_ALLOCATOR_RAW_MEM(void*, RawMemoryAllocator, "Allocator for vector<void*>")),
     m_RawMemoryAllocator{RawMemoryAllocator        },
     m_BlockSize         {AdjustBlockSize(BlockSize)},
-    m_NumBlocksInPage   {NumBlocksInPage           }
+    m_PageAlignment     {AlignedPages ? ComputePageAlignment(m_BlockSize, NumBlocksInPage) : 0},
+    m_NumBlocksInPage   {AlignedPages ? static_cast<Uint32>((m_PageAlignment - AlignedPageHeaderSize) / m_BlockSize) : NumBlocksInPage},
+    m_MaxNumBlocksInPage{AlignedPages ? m_NumBlocksInPage : std::max(MaxNumBlocksInPage, m_NumBlocksInPage)},
+    m_ThreadCacheSize   {ThreadCacheSize           },
+    m_AllocatorId       {NextAllocatorId++         }
 // clang-format on
 {
-    // Allocate one page
-    CreateNewPage();
+    VERIFY_EXPR(m_NumBlocksInPage > 0);
+    DEV_CHECK_ERR(!AlignedPages || MaxNumBlocksInPage <= NumBlocksInPage, "Page growth is not supported for aligned pages");
+    m_NextPageNumBlocks = m_NumBlocksInPage;
+
+    if (m_ThreadCacheSize != 0)
+    {
+        // Make sure the registry mutex is constructed before this allocator and is thus
+        // destroyed after it when the allocator has static storage duration (e.g. ObjectPool).
+        GetThreadCacheRegistryMutex();
+    }
+
+    // Allocate one page. Aligned pages are allocated on first use as the first chunk
+    // is relatively large.
+    if (m_PageAlignment == 0)
+        CreateNewPage();
 }
 
 FixedBlockMemoryAllocator::~FixedBlockMemoryAllocator()
 {
+    if (m_ThreadCacheSize != 0)
+    {
+        // Return all blocks cached by threads. The caches themselves are owned by
+        // the threads and are released when the threads exit.
+        std::lock_guard<std::mutex> RegistryLock{GetThreadCacheRegistryMutex()};
+        while (m_pThreadCaches != nullptr)
+        {
+            auto& Cache = *m_pThreadCaches;
+            FlushThreadCache(Cache, Cache.NumBlocks);
+            Cache.Detach();
+        }
+    }
+
 #ifdef DILIGENT_DEBUG
     for (size_t p = 0; p < m_PagePool.size(); ++p)
     {
@@ -63,13 +259,69 @@ FixedBlockMemoryAllocator::~FixedBlockMemoryAllocator()
         VERIFY(m_AvailablePages.find(p) != m_AvailablePages.end(), "Memory page is not in the available page pool");
     }
 #endif
+
+    // Aligned pages do not own their memory
+    for (auto* pChunk : m_AlignedPageChunks)
+        m_RawMemoryAllocator.Free(pChunk);
 }
 
 void FixedBlockMemoryAllocator::CreateNewPage()
 {
-    m_PagePool.emplace_back(*this);
-    m_AvailablePages.insert(m_PagePool.size() - 1);
-    m_AddrToPageId.reserve(m_PagePool.size() * m_NumBlocksInPage);
+    if (m_PageAlignment != 0)
+    {
+        if (m_SpareAlignedPages.empty())
+            AllocateAlignedPages();
+
+        auto* pPageMem = reinterpret_cast<Uint8*>(m_SpareAlignedPages.back());
+        m_SpareAlignedPages.pop_back();
+        *reinterpret_cast<size_t*>(pPageMem) = m_PagePool.size();
+        m_PagePool.emplace_back(*this, m_NumBlocksInPage, pPageMem + AlignedPageHeaderSize);
+        m_AvailablePages.insert(m_PagePool.size() - 1);
+        m_TotalNumBlocks += m_NumBlocksInPage;
+    }
+    else
+    {
+        const auto NumBlocks = m_NextPageNumBlocks;
+        m_PagePool.emplace_back(*this, NumBlocks);
+        m_AvailablePages.insert(m_PagePool.size() - 1);
+        m_TotalNumBlocks += NumBlocks;
+        m_AddrToPageId.reserve(m_TotalNumBlocks);
+
+        // Grow pages geometrically
+        m_NextPageNumBlocks = static_cast<Uint32>(std::min(size_t{NumBlocks} * 2, size_t{m_MaxNumBlocksInPage}));
+    }
+}
+
+void FixedBlockMemoryAllocator::AllocateAlignedPages()
+{
+    // Raw allocator does not support alignment, so we allocate several pages at once plus the memory
+    // required to align them. The number of pages in a chunk grows with the pool, so that the alignment
+    // overhead stays small relative to the total memory. The raw allocator returns memory aligned by at
+    // least the pointer size, and the last page only needs the space used by its blocks, which keeps the
+    // overhead of the first chunk below one page.
+    const auto NumPages     = std::min(std::max(m_PagePool.size(), size_t{1}), MaxAlignedPagesPerChunk);
+    const auto PageUsedSize = AlignedPageHeaderSize + m_BlockSize * m_NumBlocksInPage;
+    const auto ChunkSize    = (NumPages - 1) * m_PageAlignment + PageUsedSize + (m_PageAlignment - sizeof(void*));
+
+    auto* pChunk = m_RawMemoryAllocator.Allocate(ChunkSize, "FixedBlockMemoryAllocator aligned page chunk", __FILE__, __LINE__);
+    m_AlignedPageChunks.push_back(pChunk);
+
+    const auto ChunkStart = reinterpret_cast<uintptr_t>(pChunk);
+    const auto ChunkEnd   = ChunkStart + ChunkSize;
+    VERIFY(ChunkStart % sizeof(void*) == 0, "Raw memory is expected to be aligned by the pointer size");
+
+    const auto FirstPageStart = Align(ChunkStart, static_cast<uintptr_t>(m_PageAlignment));
+    auto       NumChunkPages  = size_t{0};
+    while (FirstPageStart + NumChunkPages * m_PageAlignment + PageUsedSize <= ChunkEnd)
+        ++NumChunkPages;
+    VERIFY_EXPR(NumChunkPages >= NumPages);
+
+    // Add pages in reverse order so that they are used in the order of increasing addresses
+    while (NumChunkPages > 0)
+    {
+        --NumChunkPages;
+        m_SpareAlignedPages.push_back(reinterpret_cast<void*>(FirstPageStart + NumChunkPages * m_PageAlignment));
+    }
 }
 
 void* FixedBlockMemoryAllocator::Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber)
@@ -77,8 +329,51 @@ void* FixedBlockMemoryAllocator::Allocate(size_t Size, const Char* dbgDescriptio
     Size = AdjustBlockSize(Size);
     VERIFY(m_BlockSize == Size, "Requested size (", Size, ") does not match the block size (", m_BlockSize, ")");
 
+    if (m_ThreadCacheSize != 0)
+    {
+        auto& Cache = *GetThreadCache();
+        if (Cache.NumBlocks == 0)
+            RefillThreadCache(Cache);
+
+        auto* Ptr = Cache.Blocks[--Cache.NumBlocks];
+        FillWithDebugPattern(Ptr, MemoryPage::AllocatedBlockMemPattern, m_BlockSize);
+        return Ptr;
+    }
+
     std::lock_guard<std::mutex> LockGuard(m_Mutex);
+    return AllocateFromPages();
+}
 
+void FixedBlockMemoryAllocator::Free(void* Ptr)
+{
+    if (m_ThreadCacheSize != 0)
+    {
+#ifdef DILIGENT_DEBUG
+        if (m_PageAlignment == 0 || TrackAlignedPageBlocks)
+        {
+            std::lock_guard<std::mutex> LockGuard(m_Mutex);
+            DEV_CHECK_ERR(m_AddrToPageId.find(Ptr) != m_AddrToPageId.end(), "Address not found in the allocations list - double freeing memory or the address was not allocated by this allocator?");
+        }
+#endif
+        auto& Cache = *GetThreadCache();
+        // Blocks in thread caches are still in the allocations list, so the check above
+        // does not detect a block that is freed twice by the same thread
+        DEV_CHECK_ERR(std::find(Cache.Blocks.begin(), Cache.Blocks.begin() + Cache.NumBlocks, Ptr) == Cache.Blocks.begin() + Cache.NumBlocks,
+                      "The block is already in the thread cache - double freeing memory?");
+        if (Cache.NumBlocks == m_ThreadCacheSize)
+            FlushThreadCache(Cache, std::max(m_ThreadCacheSize / 2, Uint32{1}));
+
+        FillWithDebugPattern(Ptr, MemoryPage::DeallocatedBlockMemPattern, m_BlockSize);
+        Cache.Blocks[Cache.NumBlocks++] = Ptr;
+        return;
+    }
+
+    std::lock_guard<std::mutex> LockGuard(m_Mutex);
+    FreeToPages(Ptr);
+}
+
+void* FixedBlockMemoryAllocator::AllocateFromPages()
+{
     if (m_AvailablePages.empty())
     {
         CreateNewPage();
@@ -87,7 +382,9 @@ void* FixedBlockMemoryAllocator::Allocate(size_t Size, const Char* dbgDescriptio
     auto  PageId = *m_AvailablePages.begin();
     auto& Page   = m_PagePool[PageId];
     auto* Ptr    = Page.Allocate();
-    m_AddrToPageId.insert(std::make_pair(Ptr, PageId));
+    ++m_NumAllocatedBlocks;
+    if (m_PageAlignment == 0 || TrackAlignedPageBlocks)
+        m_AddrToPageId.insert(std::make_pair(Ptr, PageId));
     if (!Page.HasSpace())
     {
         m_AvailablePages.erase(m_AvailablePages.begin());
@@ -96,30 +393,108 @@ void* FixedBlockMemoryAllocator::Allocate(size_t Size, const Char* dbgDescriptio
     return Ptr;
 }
 
-void FixedBlockMemoryAllocator::Free(void* Ptr)
+void FixedBlockMemoryAllocator::FreeToPages(void* Ptr)
 {
-    std::lock_guard<std::mutex> LockGuard(m_Mutex);
-    auto                        PageIdIt = m_AddrToPageId.find(Ptr);
-    if (PageIdIt != m_AddrToPageId.end())
+    size_t PageId = 0;
+    if (m_PageAlignment != 0)
     {
-        auto PageId = PageIdIt->second;
-        VERIFY_EXPR(PageId >= 0 && PageId < m_PagePool.size());
-        m_PagePool[PageId].DeAllocate(Ptr);
-        m_AvailablePages.insert(PageId);
-        m_AddrToPageId.erase(PageIdIt);
-        if (m_AvailablePages.size() > 1 && !m_PagePool[PageId].HasAllocations())
+        // The page index is stored in the header at the beginning of the aligned page
+        const auto PageStart = AlignDown(reinterpret_cast<uintptr_t>(Ptr), static_cast<uintptr_t>(m_PageAlignment));
+
+        if (TrackAlignedPageBlocks)
         {
-            // In current implementation pages are never released!
-            // Note that if we delete a page, all indices past it will be invalid
+            auto PageIdIt = m_AddrToPageId.find(Ptr);
+            if (PageIdIt == m_AddrToPageId.end())
+            {
+                UNEXPECTED("Address not found in the allocations list - double freeing memory or the address was not allocated by this allocator?");
+                return;
+            }
+            m_AddrToPageId.erase(PageIdIt);
+        }
 
-            //m_PagePool.erase(m_PagePool.begin() + PageId);
-            //m_AvailablePages.erase(PageId);
+        PageId = *reinterpret_cast<const size_t*>(PageStart);
+        if (PageId >= m_PagePool.size())
+        {
+            UNEXPECTED("Invalid page index - the address was not allocated by this allocator?");
+            return;
         }
     }
     else
     {
-        UNEXPECTED("Address not found in the allocations list - double freeing memory?");
+        auto PageIdIt = m_AddrToPageId.find(Ptr);
+        if (PageIdIt == m_AddrToPageId.end())
+        {
+            UNEXPECTED("Address not found in the allocations list - double freeing memory?");
+            return;
+        }
+        PageId = PageIdIt->second;
+        m_AddrToPageId.erase(PageIdIt);
+    }
+
+    VERIFY_EXPR(PageId >= 0 && PageId < m_PagePool.size());
+    auto& Page = m_PagePool[PageId];
+    // Pages that have space are already in the available page pool
+    if (!Page.HasSpace())
+        m_AvailablePages.insert(PageId);
+    Page.DeAllocate(Ptr);
+    VERIFY_EXPR(m_NumAllocatedBlocks > 0);
+    --m_NumAllocatedBlocks;
+    if (m_AvailablePages.size() > 1 && !Page.HasAllocations())
+    {
+        // In current implementation pages are never released!
+        // Note that if we delete a page, all indices past it will be invalid
+
+        //m_PagePool.erase(m_PagePool.begin() + PageId);
+        //m_AvailablePages.erase(PageId);
+    }
+}
+
+FixedBlockMemoryAllocator::Statistics FixedBlockMemoryAllocator::GetStatistics()
+{
+    std::lock_guard<std::mutex> LockGuard(m_Mutex);
+
+    Statistics Stats;
+    Stats.NumPages           = m_PagePool.size();
+    Stats.NumBlocks          = m_TotalNumBlocks;
+    Stats.NumAllocatedBlocks = m_NumAllocatedBlocks;
+    Stats.ReservedSize       = m_PageAlignment != 0 ? m_PagePool.size() * m_PageAlignment : m_TotalNumBlocks * m_BlockSize;
+    return Stats;
+}
+
+FixedBlockMemoryAllocator::ThreadCache* FixedBlockMemoryAllocator::GetThreadCache()
+{
+    thread_local ThreadCacheList Caches;
+
+    auto* pCache = Caches.Find(m_AllocatorId);
+    if (pCache == nullptr)
+        pCache = Caches.Create(*this);
+    return pCache;
+}
+
+void FixedBlockMemoryAllocator::RefillThreadCache(ThreadCache& Cache)
+{
+    VERIFY_EXPR(Cache.NumBlocks == 0);
+    const auto NumBlocksToAllocate = std::max(m_ThreadCacheSize / 2, Uint32{1});
+
+    std::lock_guard<std::mutex> LockGuard(m_Mutex);
+    while (Cache.NumBlocks < NumBlocksToAllocate)
+        Cache.Blocks[Cache.NumBlocks++] = AllocateFromPages();
+}
+
+void FixedBlockMemoryAllocator::FlushThreadCache(ThreadCache& Cache, Uint32 NumBlocksToFlush)
+{
+    VERIFY_EXPR(NumBlocksToFlush <= Cache.NumBlocks);
+    if (NumBlocksToFlush == 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> LockGuard(m_Mutex);
+        // Return the least recently freed blocks and keep the hot ones in the cache
+        for (Uint32 i = 0; i < NumBlocksToFlush; ++i)
+            FreeToPages(Cache.Blocks[i]);
     }
+    std::move(Cache.Blocks.begin() + NumBlocksToFlush, Cache.Blocks.begin() + Cache.NumBlocks, Cache.Blocks.begin());
+    Cache.NumBlocks -= NumBlocksToFlush;
 }
 
 } // namespace Diligent
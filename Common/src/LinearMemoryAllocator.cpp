@@ -0,0 +1,161 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+#include <algorithm>
+#include <cstddef>
+#include "LinearMemoryAllocator.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+#include "Align.hpp"
+
+namespace Diligent
+{
+
+// All allocations are aligned the same way as memory returned by operator new
+static constexpr size_t AllocationAlignment = alignof(std::max_align_t);
+
+LinearMemoryAllocator::LinearMemoryAllocator(IMemoryAllocator& RawMemoryAllocator, size_t PageSize) :
+    // clang-format off
+    m_RawMemoryAllocator{RawMemoryAllocator},
+    m_PageSize          {Align(std::max(PageSize, AllocationAlignment), AllocationAlignment)},
+    m_Pages             (STD_ALLOCATOR_RAW_MEM(Page, RawMemoryAllocator, "Allocator for vector<Page>"))
+// clang-format on
+{
+}
+
+LinearMemoryAllocator::~LinearMemoryAllocator()
+{
+    VERIFY(m_DbgNumAllocations == 0, m_DbgNumAllocations, " allocation(s) have not been released");
+    ReleasePages();
+}
+
+void LinearMemoryAllocator::AddPage(size_t Size)
+{
+    Page NewPage;
+    NewPage.Size       = Size;
+    NewPage.pRawMemory = m_RawMemoryAllocator.Allocate(Size + AllocationAlignment - 1, "Linear allocator page", __FILE__, __LINE__);
+    NewPage.pData      = reinterpret_cast<Uint8*>(Align(reinterpret_cast<size_t>(NewPage.pRawMemory), AllocationAlignment));
+    m_Pages.emplace_back(NewPage);
+    m_ReservedSize += Size;
+}
+
+void* LinearMemoryAllocator::Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber)
+{
+    Size = Align(std::max(Size, size_t{1}), AllocationAlignment);
+
+    // Look for the first page starting from the current one that has enough space
+    while (m_CurrPage < m_Pages.size() && m_CurrOffset + Size > m_Pages[m_CurrPage].Size)
+    {
+        m_PrevPagesUsedSize += m_CurrOffset;
+        ++m_CurrPage;
+        m_CurrOffset = 0;
+    }
+
+    if (m_CurrPage == m_Pages.size())
+    {
+        VERIFY_EXPR(m_CurrOffset == 0);
+        AddPage(std::max(m_PageSize, Size));
+    }
+
+    auto* Ptr = m_Pages[m_CurrPage].pData + m_CurrOffset;
+    m_CurrOffset += Size;
+    m_pLastAlloc = Ptr;
+
+#ifdef DILIGENT_DEBUG
+    ++m_DbgNumAllocations;
+#endif
+
+    return Ptr;
+}
+
+void LinearMemoryAllocator::Free(void* Ptr)
+{
+    if (Ptr == nullptr)
+        return;
+
+#ifdef DILIGENT_DEBUG
+    VERIFY(m_DbgNumAllocations > 0, "Releasing memory that was not allocated by this allocator or has already been released");
+    --m_DbgNumAllocations;
+#endif
+
+    if (Ptr == m_pLastAlloc)
+    {
+        // Roll back the most recent allocation
+        const auto* pPageData = m_Pages[m_CurrPage].pData;
+        VERIFY_EXPR(Ptr >= pPageData && Ptr < pPageData + m_Pages[m_CurrPage].Size);
+        m_CurrOffset = static_cast<size_t>(reinterpret_cast<Uint8*>(Ptr) - pPageData);
+        m_pLastAlloc = nullptr;
+    }
+}
+
+void LinearMemoryAllocator::Reset()
+{
+    VERIFY(m_DbgNumAllocations == 0, m_DbgNumAllocations, " allocation(s) have not been released. "
+                                                           "Resetting the allocator will leave dangling pointers.");
+
+    if (m_CurrPage > 0)
+    {
+        // The allocations did not fit into one page. Replace all pages with a single
+        // page large enough to hold them.
+        const auto NewPageSize = m_ReservedSize;
+        ReleasePages();
+        AddPage(NewPageSize);
+    }
+
+    m_CurrPage          = 0;
+    m_CurrOffset        = 0;
+    m_pLastAlloc        = nullptr;
+    m_PrevPagesUsedSize = 0;
+}
+
+void LinearMemoryAllocator::ReleasePages()
+{
+    for (auto& Page : m_Pages)
+        m_RawMemoryAllocator.Free(Page.pRawMemory);
+    m_Pages.clear();
+
+    m_CurrPage          = 0;
+    m_CurrOffset        = 0;
+    m_ReservedSize      = 0;
+    m_pLastAlloc        = nullptr;
+    m_PrevPagesUsedSize = 0;
+}
+
+size_t LinearMemoryAllocator::GetUsedSize() const
+{
+    return m_PrevPagesUsedSize + m_CurrOffset;
+}
+
+LinearMemoryAllocator& LinearMemoryAllocator::GetThreadAllocator()
+{
+    static constexpr size_t ThreadAllocatorPageSize = 64 << 10;
+
+    thread_local LinearMemoryAllocator ThreadAllocator{DefaultRawMemoryAllocator::GetAllocator(), ThreadAllocatorPageSize};
+    return ThreadAllocator;
+}
+
+} // namespace Diligent
@@ -26,7 +26,15 @@
  */
 
 #include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64) || defined(_M_ARM) || defined(_M_ARM64))
+#    include <intrin.h>
+#elif defined(__i386__) || defined(__x86_64__)
+#    include <immintrin.h>
+#endif
+
 #include "LockHelper.hpp"
+#include "ParkingLot.hpp"
 
 namespace ThreadingTools
 {
@@ -36,4 +44,105 @@ void LockHelper::YieldThread() noexcept
     std::this_thread::yield();
 }
 
+void SharedLockFlag::YieldThread() noexcept
+{
+    std::this_thread::yield();
+}
+
+namespace
+{
+
+inline void CpuPause() noexcept
+{
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    _mm_pause();
+#elif defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
+    __yield();
+#elif defined(__i386__) || defined(__x86_64__)
+    _mm_pause();
+#elif defined(__arm__) || defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+std::atomic<bool>             g_ContentionStatsEnabled{false};
+std::atomic<Diligent::Uint64> g_NumContendedLocks{0};
+std::atomic<Diligent::Uint64> g_NumSpins{0};
+std::atomic<Diligent::Uint64> g_NumParks{0};
+
+} // namespace
+
+void AdaptiveLockFlag::LockContended(std::atomic<Diligent::Uint32>& State, int SpinCount) noexcept
+{
+    const bool CollectStats = g_ContentionStatsEnabled.load(std::memory_order_relaxed);
+
+    // Spin while the lock is held, but nobody sleeps on it: the owner is likely to release it shortly
+    bool Acquired = false;
+    int  Spins    = 0;
+    for (; Spins < SpinCount && !Acquired; ++Spins)
+    {
+        const auto Value = State.load(std::memory_order_relaxed);
+        if (Value == Contended)
+        {
+            // Other threads are already sleeping - there is no point in spinning
+            break;
+        }
+        else if (Value == Unlocked)
+        {
+            Acquired = TryLock(State);
+        }
+        else
+        {
+            CpuPause();
+        }
+    }
+
+    Diligent::Uint64 NumParks = 0;
+    if (!Acquired)
+    {
+        // Mark the lock as contended and go to sleep until it is released. If the lock
+        // happens to be free, we acquire it in the contended state, which only costs
+        // one extra wake-up call at unlock.
+        while (State.exchange(Contended, std::memory_order_acquire) != Unlocked)
+        {
+            ++NumParks;
+            ParkingLot::Park(State, Contended);
+        }
+    }
+
+    if (CollectStats)
+    {
+        g_NumContendedLocks.fetch_add(1, std::memory_order_relaxed);
+        g_NumSpins.fetch_add(static_cast<Diligent::Uint64>(Spins), std::memory_order_relaxed);
+        if (NumParks != 0)
+            g_NumParks.fetch_add(NumParks, std::memory_order_relaxed);
+    }
+}
+
+void AdaptiveLockFlag::WakeOne(const void* pAddress) noexcept
+{
+    ParkingLot::WakeOne(pAddress);
+}
+
+void AdaptiveLockFlag::EnableContentionStats(bool Enable) noexcept
+{
+    g_ContentionStatsEnabled.store(Enable);
+}
+
+AdaptiveLockFlag::ContentionStats AdaptiveLockFlag::GetContentionStats() noexcept
+{
+    ContentionStats Stats;
+    Stats.NumContendedLocks = g_NumContendedLocks.load();
+    Stats.NumSpins          = g_NumSpins.load();
+    Stats.NumParks          = g_NumParks.load();
+    return Stats;
+}
+
+void AdaptiveLockFlag::ResetContentionStats() noexcept
+{
+    g_NumContendedLocks.store(0);
+    g_NumSpins.store(0);
+    g_NumParks.store(0);
+}
+
 } // namespace ThreadingTools
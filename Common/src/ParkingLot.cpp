@@ -0,0 +1,139 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+
+#include <chrono>
+#include <climits>
+#include <mutex>
+#include <condition_variable>
+
+#if PLATFORM_LINUX || PLATFORM_ANDROID
+#    include <unistd.h>
+#    include <time.h>
+#    include <sys/syscall.h>
+#    include <linux/futex.h>
+#    define DILIGENT_USE_FUTEX 1
+#else
+#    define DILIGENT_USE_FUTEX 0
+#endif
+
+#include "ParkingLot.hpp"
+
+namespace ThreadingTools
+{
+
+namespace ParkingLot
+{
+
+#if DILIGENT_USE_FUTEX
+
+static_assert(sizeof(std::atomic<Diligent::Uint32>) == sizeof(int), "Futex word must be 32 bits");
+
+void Park(const std::atomic<Diligent::Uint32>& StateWord, Diligent::Uint32 ExpectedValue, Diligent::Int64 TimeoutNs) noexcept
+{
+    timespec  Timeout  = {};
+    timespec* pTimeout = nullptr;
+    if (TimeoutNs >= 0)
+    {
+        Timeout.tv_sec  = static_cast<time_t>(TimeoutNs / 1000000000);
+        Timeout.tv_nsec = static_cast<long>(TimeoutNs % 1000000000);
+        pTimeout        = &Timeout;
+    }
+    // The call returns immediately if the value does not match the expected one
+    syscall(SYS_futex, reinterpret_cast<const int*>(&StateWord), FUTEX_WAIT_PRIVATE, static_cast<int>(ExpectedValue), pTimeout, nullptr, 0);
+}
+
+void WakeOne(const void* pStateWord) noexcept
+{
+    // If the memory has been released and reused by another futex, that futex will
+    // get a spurious wake-up, which is harmless.
+    syscall(SYS_futex, pStateWord, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+void WakeAll(const void* pStateWord) noexcept
+{
+    syscall(SYS_futex, pStateWord, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+#else
+
+namespace
+{
+
+// Several state words may share the same bucket, so all bucket waiters are woken up
+// and recheck their state.
+struct ParkingBucket
+{
+    std::mutex              Mtx;
+    std::condition_variable CondVar;
+};
+
+ParkingBucket& GetParkingBucket(const void* pAddress)
+{
+    static constexpr size_t NumBuckets = 64;
+    static ParkingBucket    Buckets[NumBuckets];
+
+    const auto Hash = reinterpret_cast<size_t>(pAddress) >> 2;
+    return Buckets[(Hash ^ (Hash >> 6)) % NumBuckets];
+}
+
+} // namespace
+
+void Park(const std::atomic<Diligent::Uint32>& StateWord, Diligent::Uint32 ExpectedValue, Diligent::Int64 TimeoutNs) noexcept
+{
+    auto&                        Bucket = GetParkingBucket(&StateWord);
+    std::unique_lock<std::mutex> Lock{Bucket.Mtx};
+    // The state is changed before the waker locks the bucket mutex, so the wake-up can't be lost
+    if (StateWord.load(std::memory_order_relaxed) != ExpectedValue)
+        return;
+
+    if (TimeoutNs >= 0)
+        Bucket.CondVar.wait_for(Lock, std::chrono::nanoseconds{TimeoutNs});
+    else
+        Bucket.CondVar.wait(Lock);
+}
+
+void WakeOne(const void* pStateWord) noexcept
+{
+    WakeAll(pStateWord);
+}
+
+void WakeAll(const void* pStateWord) noexcept
+{
+    auto& Bucket = GetParkingBucket(pStateWord);
+    {
+        std::lock_guard<std::mutex> Lock{Bucket.Mtx};
+    }
+    Bucket.CondVar.notify_all();
+}
+
+#endif
+
+} // namespace ParkingLot
+
+} // namespace ThreadingTools
@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "StringInterner.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+
+namespace Diligent
+{
+
+StringInterner::StringInterner(IMemoryAllocator& Allocator, size_t PageSize) :
+    // clang-format off
+    m_Allocator{Allocator},
+    m_PageSize {PageSize }
+// clang-format on
+{
+    VERIFY_EXPR(m_PageSize > 0);
+}
+
+StringInterner::~StringInterner()
+{
+    // Keys reference the strings in the pages and must be destroyed first
+    m_Strings.clear();
+}
+
+InternedString StringInterner::Intern(const Char* Str)
+{
+    VERIFY(Str != nullptr, "String must not be null");
+
+    // Compute the hash outside of the lock
+    const auto Hash = CStringHash<Char>{}(Str);
+
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+
+    auto It = m_Strings.find(HashMapStringKey{Str, Hash});
+    if (It != m_Strings.end())
+        return It->second;
+
+    const auto Size = StringPool::GetRequiredReserveSize(Str);
+    if (m_Pages.empty() || m_Pages.back().GetRemainingSize() < Size)
+    {
+        // Long strings get dedicated pages
+        m_Pages.emplace_back();
+        m_Pages.back().Reserve(std::max(Size, m_PageSize), m_Allocator);
+    }
+    const auto* InternedStr = m_Pages.back().CopyString(Str);
+
+    const InternedString Handle{InternedStr, Hash, static_cast<Uint32>(m_Strings.size() + 1)};
+    m_Strings.emplace(HashMapStringKey{InternedStr, Hash}, Handle);
+    return Handle;
+}
+
+InternedString StringInterner::Find(const Char* Str) const
+{
+    VERIFY(Str != nullptr, "String must not be null");
+
+    const auto Hash = CStringHash<Char>{}(Str);
+
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+
+    auto It = m_Strings.find(HashMapStringKey{Str, Hash});
+    return It != m_Strings.end() ? It->second : InternedString{};
+}
+
+size_t StringInterner::GetNumStrings() const
+{
+    std::lock_guard<std::mutex> Lock{m_Mtx};
+    return m_Strings.size();
+}
+
+StringInterner& StringInterner::GetGlobal()
+{
+    static StringInterner GlobalInterner{DefaultRawMemoryAllocator::GetAllocator()};
+    return GlobalInterner;
+}
+
+} // namespace Diligent
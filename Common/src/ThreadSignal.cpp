@@ -0,0 +1,83 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "pch.h"
+
+#include "ThreadSignal.hpp"
+#include "ParkingLot.hpp"
+
+namespace ThreadingTools
+{
+
+bool CountingSignal::WaitSlow(bool Acquire, Diligent::Int64 TimeoutNs) noexcept
+{
+    const auto StartTime = std::chrono::steady_clock::now();
+
+    auto State = m_State.load(std::memory_order_acquire);
+    for (;;)
+    {
+        if ((State & CountMask) != 0)
+        {
+            if (!Acquire)
+                return true;
+
+            if (m_State.compare_exchange_weak(State, State - 1, std::memory_order_acquire, std::memory_order_acquire))
+                return true;
+            else
+                continue;
+        }
+
+        Diligent::Int64 RemainingNs = -1;
+        if (TimeoutNs >= 0)
+        {
+            const auto ElapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - StartTime).count();
+            if (ElapsedNs >= TimeoutNs)
+                return false;
+            RemainingNs = TimeoutNs - static_cast<Diligent::Int64>(ElapsedNs);
+        }
+
+        // Tell triggering threads that they need to wake us up
+        if ((State & WaitersBit) == 0)
+        {
+            if (!m_State.compare_exchange_weak(State, State | WaitersBit, std::memory_order_acquire, std::memory_order_acquire))
+                continue;
+            State |= WaitersBit;
+        }
+
+        // Any change of the state (trigger or reset of the waiters bit) makes the call return
+        ParkingLot::Park(m_State, State, RemainingNs);
+
+        State = m_State.load(std::memory_order_acquire);
+    }
+}
+
+void CountingSignal::WakeWaiters() noexcept
+{
+    ParkingLot::WakeAll(&m_State);
+}
+
+} // namespace ThreadingTools
@@ -46,6 +46,39 @@ inline float SRGBToLinear(float x)
 float LinearToSRGB(Uint8 x);
 float SRGBToLinear(Uint8 x);
 
+/// Converts 8-bit sRGB values to linear values using a lookup table.
+/// The results are identical to those of SRGBToLinear(Uint8).
+void SRGBToLinear(const Uint8* pSRGB, float* pLinear, size_t NumValues);
+
+/// Converts linear values to 8-bit sRGB values using a piecewise-linear approximation of the sRGB curve.
+/// The values are clamped to [0, 1] range, NaNs are converted to 0.
+/// The result differs from 255 * LinearToSRGB(x) by at most SRGB8EncodeMaxError, so it only differs from
+/// the correctly rounded value when the exact value is within (SRGB8EncodeMaxError - 0.5) of the midpoint
+/// between two integers.
+void LinearToSRGB(const float* pLinear, Uint8* pSRGB, size_t NumValues);
+
+static constexpr float SRGB8EncodeMaxError = 0.52f;
+
+/// Converts RGBA8 pixels with sRGB color and linear alpha to linear RGBA32F pixels.
+void SRGBA8ToLinearRGBA32F(const Uint8* pSrc, float* pDst, size_t NumPixels);
+
+/// Converts RGBA8 pixels with sRGB color and linear alpha to linear RGBA16F pixels.
+void SRGBA8ToLinearRGBA16F(const Uint8* pSrc, Uint16* pDst, size_t NumPixels);
+
+/// Converts linear RGBA32F pixels to RGBA8 pixels with sRGB color and linear alpha.
+/// The color is encoded as by LinearToSRGB(const float*, Uint8*, size_t), the alpha is clamped to [0, 1] and rounded.
+void LinearRGBA32FToSRGBA8(const float* pSrc, Uint8* pDst, size_t NumPixels);
+
+/// Converts linear RGBA16F pixels to RGBA8 pixels with sRGB color and linear alpha.
+void LinearRGBA16FToSRGBA8(const Uint16* pSrc, Uint8* pDst, size_t NumPixels);
+
+/// Converts a 32-bit float to a 16-bit half-precision float with rounding to nearest even.
+/// Values that are too large to be represented become infinities, NaNs are preserved.
+Uint16 FloatToHalf(float f);
+
+/// Converts a 16-bit half-precision float to a 32-bit float. The conversion is exact.
+float HalfToFloat(Uint16 h);
+
 inline float FastLinearToSRGB(float x)
 {
     return x < 0.0031308f ? 12.92f * x : 1.13005f * sqrtf(std::abs(x - 0.00228f)) - 0.13448f * x + 0.005719f;
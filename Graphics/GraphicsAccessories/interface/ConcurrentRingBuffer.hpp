@@ -0,0 +1,232 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Implementation of Diligent::ConcurrentRingBuffer class
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+
+#include "../../../Primitives/interface/MemoryAllocator.h"
+#include "../../../Platforms/Basic/interface/DebugUtilities.hpp"
+#include "../../../Common/interface/Align.hpp"
+#include "../../../Common/interface/STDAllocator.hpp"
+
+namespace Diligent
+{
+
+/// Implementation of a ring buffer that multiple threads may allocate from concurrently.
+
+/// Unlike RingBuffer, head and tail are kept as virtual offsets that grow monotonically, and the
+/// physical offset is the virtual offset modulo the buffer size. This lets an allocation be
+/// a single atomic bump of the head that never takes a lock. The tail only moves
+/// forward when frames are released, so an allocation that fits when the tail is read
+/// is guaranteed to fit when the head is updated.
+///
+/// Allocate() never takes a lock and may be called from any thread. It only retries while
+/// ReleaseCompletedFrames() is moving the head and the tail of an empty buffer, which takes
+/// a single compare-and-swap and a store. FinishCurrentFrame() and ReleaseCompletedFrames()
+/// are also thread-safe, but the application must make sure that all allocations that belong
+/// to a frame are made before the frame is finished.
+class ConcurrentRingBuffer
+{
+public:
+    using OffsetType = size_t;
+
+    static constexpr const OffsetType InvalidOffset = static_cast<OffsetType>(-1);
+
+    ConcurrentRingBuffer(OffsetType MaxSize, IMemoryAllocator& Allocator) noexcept :
+        m_CompletedFrameHeads(STD_ALLOCATOR_RAW_MEM(FrameHeadAttribs, Allocator, "Allocator for deque<FrameHeadAttribs>")),
+        m_MaxSize{MaxSize}
+    {}
+
+    // clang-format off
+    ConcurrentRingBuffer             (const ConcurrentRingBuffer&) = delete;
+    ConcurrentRingBuffer             (ConcurrentRingBuffer&&)      = delete;
+    ConcurrentRingBuffer& operator = (const ConcurrentRingBuffer&) = delete;
+    ConcurrentRingBuffer& operator = (ConcurrentRingBuffer&&)      = delete;
+    // clang-format on
+
+    ~ConcurrentRingBuffer()
+    {
+        VERIFY(IsEmpty(), "All space in the ring buffer must be released");
+    }
+
+    OffsetType Allocate(OffsetType Size, OffsetType Alignment)
+    {
+        VERIFY_EXPR(Size > 0);
+        VERIFY(IsPowerOfTwo(Alignment), "Alignment (", Alignment, ") must be power of 2");
+        Size = Align(Size, Alignment);
+
+        if (Size > m_MaxSize)
+            return InvalidOffset;
+
+        auto Head = m_Head.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            const auto HeadOffset = static_cast<OffsetType>(Head % m_MaxSize);
+
+            auto Offset = Align(HeadOffset, Alignment);
+            if (Offset + Size > m_MaxSize)
+            {
+                // Allocate from the beginning of the buffer. The space between the head
+                // and the end of the buffer is released along with the allocation.
+                //
+                // Offset              Tail          Head               MaxSize
+                //  |                  |                |<---Padding--->|
+                //  [                  xxxxxxxxxxxxxxxxx++++++++++++++++]
+                //
+                Offset = 0;
+            }
+
+            const Uint64 Padding = Offset >= HeadOffset ?
+                Offset - HeadOffset :
+                m_MaxSize - HeadOffset + Offset;
+            const Uint64 NewHead = Head + Padding + Size;
+
+            // The tail only moves forward, so reading a stale value is safe
+            const auto Tail = m_Tail.load(std::memory_order_acquire);
+            if (NewHead - Tail > m_MaxSize)
+            {
+                // ReleaseCompletedFrames() may have released frames or moved the head and the tail
+                // to the beginning of the buffer after they were read. The rewind moves the head
+                // before the tail, so the new head may have been read together with the old tail.
+                // Sequentially consistent loads guarantee that if the rewind flag is clear after
+                // the new head is observed, the new tail is observed as well.
+                const auto CurrHead = m_Head.load();
+                if (m_RewindInProgress.load() || m_Tail.load() != Tail || CurrHead != Head)
+                {
+                    Head = CurrHead;
+                    continue;
+                }
+                return InvalidOffset;
+            }
+
+            if (m_Head.compare_exchange_weak(Head, NewHead, std::memory_order_relaxed, std::memory_order_relaxed))
+                return Offset;
+        }
+    }
+
+    // FenceValue is the fence value associated with the command list in which the head
+    // could have been referenced last time
+    // See http://diligentgraphics.com/diligent-engine/architecture/d3d12/managing-resource-lifetimes/
+    void FinishCurrentFrame(Uint64 FenceValue)
+    {
+        std::lock_guard<std::mutex> Lock{m_FramesMtx};
+#ifdef DILIGENT_DEBUG
+        if (!m_CompletedFrameHeads.empty())
+            VERIFY(FenceValue >= m_CompletedFrameHeads.back().FenceValue, "Current frame fence value (", FenceValue, ") is lower than the fence value of the previous frame (", m_CompletedFrameHeads.back().FenceValue, ")");
+#endif
+        // Ignore zero-size frames
+        const auto Head = m_Head.load(std::memory_order_relaxed);
+        if (Head != m_LastFrameHead)
+        {
+            m_CompletedFrameHeads.emplace_back(FenceValue, Head);
+            m_LastFrameHead = Head;
+        }
+    }
+
+    // CompletedFenceValue indicates GPU progress
+    // See http://diligentgraphics.com/diligent-engine/architecture/d3d12/managing-resource-lifetimes/
+    void ReleaseCompletedFrames(Uint64 CompletedFenceValue)
+    {
+        std::lock_guard<std::mutex> Lock{m_FramesMtx};
+        // We can release all heads whose associated fence value is less than or equal to CompletedFenceValue
+        while (!m_CompletedFrameHeads.empty() && m_CompletedFrameHeads.front().FenceValue <= CompletedFenceValue)
+        {
+            m_Tail.store(m_CompletedFrameHeads.front().Head, std::memory_order_release);
+            m_CompletedFrameHeads.pop_front();
+        }
+
+        // If the buffer is empty, move the head and the tail to the beginning of the buffer, so that
+        // the next allocation does not have to wrap around. If another thread allocates
+        // concurrently, the head is not changed.
+        //
+        //       t,h                                   t,h
+        //  |     |     |   ====>     |           |     |           |
+        auto       Head       = m_Tail.load(std::memory_order_relaxed);
+        const auto HeadOffset = static_cast<OffsetType>(Head % m_MaxSize);
+        if (HeadOffset != 0)
+        {
+            const Uint64 NewHead = Head + (m_MaxSize - HeadOffset);
+            // Allocate() retries instead of failing while the flag is set
+            m_RewindInProgress.store(true);
+            if (m_Head.compare_exchange_strong(Head, NewHead))
+            {
+                m_Tail.store(NewHead);
+                m_LastFrameHead = NewHead;
+            }
+            m_RewindInProgress.store(false);
+        }
+    }
+
+    OffsetType GetMaxSize() const { return m_MaxSize; }
+
+    OffsetType GetUsedSize() const
+    {
+        // Read the tail first as the head is never behind it
+        const auto Tail = m_Tail.load(std::memory_order_acquire);
+        return static_cast<OffsetType>(m_Head.load(std::memory_order_relaxed) - Tail);
+    }
+
+    bool IsEmpty() const { return GetUsedSize() == 0; }
+
+private:
+    struct FrameHeadAttribs
+    {
+        // clang-format off
+        FrameHeadAttribs(Uint64 fv, Uint64 head) noexcept :
+            FenceValue{fv  },
+            Head      {head}
+        {}
+        // clang-format on
+
+        // Fence value associated with the command list in which
+        // the allocation could have been referenced last time
+        Uint64 FenceValue;
+        // Virtual head offset at the end of the frame
+        Uint64 Head;
+    };
+
+    std::mutex                                                          m_FramesMtx;
+    std::deque<FrameHeadAttribs, STDAllocatorRawMem<FrameHeadAttribs>> m_CompletedFrameHeads;
+    Uint64                                                              m_LastFrameHead = 0;
+
+    const OffsetType m_MaxSize;
+
+    // Virtual offsets
+    std::atomic<Uint64> m_Head{0};
+    std::atomic<Uint64> m_Tail{0};
+
+    // Set while ReleaseCompletedFrames() moves the head and the tail to the beginning of the buffer
+    std::atomic<bool> m_RewindInProgress{false};
+};
+
+} // namespace Diligent
@@ -36,6 +36,7 @@
 #include "../../GraphicsEngine/interface/Buffer.h"
 #include "../../GraphicsEngine/interface/RenderDevice.h"
 #include "../../../Platforms/Basic/interface/DebugUtilities.hpp"
+#include "TextureFormatTraits.hpp"
 
 namespace Diligent
 {
@@ -159,7 +160,13 @@ const Char* GetValueTypeString(VALUE_TYPE Val);
 /// \param [in] Format - Texture format which attributes are requested for.
 /// \return Constant reference to the TextureFormatAttribs structure containing
 ///         format attributes.
-const TextureFormatAttribs& GetTextureFormatAttribs(TEXTURE_FORMAT Format);
+///
+/// \remarks The attributes are looked up in a constant table, so the compiler can fold
+///          the query when the format is known. See also TextureFormatTraits.
+inline constexpr const TextureFormatAttribs& GetTextureFormatAttribs(TEXTURE_FORMAT Format)
+{
+    return TextureFormatTraitsInternal::GetTableEntry(Format).Attribs;
+}
 
 /// Returns the default format for a specified texture view type
 
@@ -34,10 +34,17 @@
 /// Implementation of Diligent::ResourceReleaseQueue class
 
 #include <mutex>
+#include <condition_variable>
+#include <thread>
 #include <deque>
+#include <atomic>
+#include <new>
 
 #include "../../../Primitives/interface/MemoryAllocator.h"
 #include "../../../Common/interface/STDAllocator.hpp"
+#include "../../../Common/interface/FixedBlockMemoryAllocator.hpp"
+#include "../../../Common/interface/DefaultRawMemoryAllocator.hpp"
+#include "../../../Common/interface/Timer.hpp"
 #include "../../../Platforms/interface/Atomics.hpp"
 #include "../../../Platforms/Basic/interface/DebugUtilities.hpp"
 
@@ -85,7 +92,7 @@ public:
 
             virtual void Release() override final
             {
-                delete this;
+                DestroyStaleResource(this);
             }
 
         private:
@@ -112,7 +119,7 @@ public:
             {
                 if (Atomics::AtomicDecrement(m_RefCounter) == 0)
                 {
-                    delete this;
+                    DestroyStaleResource(this);
                 }
             }
 
@@ -123,8 +130,8 @@ public:
 
         return DynamicStaleResourceWrapper{
             NumReferences == 1 ?
-                static_cast<StaleResourceBase*>(new SpecificStaleResource{std::move(Resource)}) :
-                static_cast<StaleResourceBase*>(new SpecificSharedStaleResource{std::move(Resource), NumReferences})};
+                static_cast<StaleResourceBase*>(NewStaleResource<SpecificStaleResource>(std::move(Resource))) :
+                static_cast<StaleResourceBase*>(NewStaleResource<SpecificSharedStaleResource>(std::move(Resource), NumReferences))};
     }
 
     DynamicStaleResourceWrapper(DynamicStaleResourceWrapper&& rhs) noexcept :
@@ -166,6 +173,39 @@ private:
         m_pStaleResource(pStaleResource)
     {}
 
+    // Stale resources are allocated from the pool shared by all resources of the same type
+    // rather than from the heap. The pool keeps per-thread block caches, so resources can be
+    // created and released from any thread without taking a lock in most cases.
+    template <typename StaleResourceType>
+    static FixedBlockMemoryAllocator& GetStaleResourcePool()
+    {
+        static FixedBlockMemoryAllocator Pool{DefaultRawMemoryAllocator::GetAllocator(), sizeof(StaleResourceType), 64, 16, true};
+        return Pool;
+    }
+
+    template <typename StaleResourceType, typename... CtorArgTypes>
+    static StaleResourceType* NewStaleResource(CtorArgTypes&&... CtorArgs)
+    {
+        auto& Pool    = GetStaleResourcePool<StaleResourceType>();
+        void* pRawMem = Pool.Allocate(sizeof(StaleResourceType), "Stale resource", __FILE__, __LINE__);
+        try
+        {
+            return new (pRawMem) StaleResourceType{std::forward<CtorArgTypes>(CtorArgs)...};
+        }
+        catch (...)
+        {
+            Pool.Free(pRawMem);
+            throw;
+        }
+    }
+
+    template <typename StaleResourceType>
+    static void DestroyStaleResource(StaleResourceType* pStaleResource)
+    {
+        pStaleResource->~StaleResourceType();
+        GetStaleResourcePool<StaleResourceType>().Free(pStaleResource);
+    }
+
     StaleResourceBase* m_pStaleResource;
 };
 
@@ -207,6 +247,32 @@ private:
     ResourceType m_StaleResource;
 };
 
+/// Limits the amount of work done by a single call to ResourceReleaseQueue::Purge()
+struct ResourcePurgeBudget
+{
+    /// Maximum number of resources to destroy. 0 means no limit.
+    Uint32 MaxResources = 0;
+
+    /// Maximum time in microseconds to spend destroying resources. 0 means no limit.
+    /// The time is checked after every resource, so the limit may be exceeded by
+    /// the time it takes to destroy one resource.
+    Uint32 MaxMicroseconds = 0;
+};
+
+/// Resource release queue statistics
+struct ResourceReleaseQueueStats
+{
+    /// The number of resources waiting for the command lists they were released with to be submitted
+    size_t NumStaleResources = 0;
+
+    /// The number of resources waiting for their fences to complete
+    size_t NumPendingResources = 0;
+
+    /// The number of resources whose fences have completed, but that have not been destroyed
+    /// yet because of the purge budget or because they are waiting for the background thread
+    size_t BacklogSize = 0;
+};
+
 /// Facilitates safe resource destruction in D3D12 and Vulkan
 
 /// Resource destruction is a two-stage process:
@@ -216,6 +282,15 @@ private:
 ///   the command list
 /// * Resources are removed and actually destroyed from the queue when fence is signaled and the queue is Purged
 ///
+/// Resources may be released and discarded from any thread without locking: every resource
+/// wrapper is stored in a node allocated from the queue's fixed-block pool and is pushed to one of two
+/// lock-free lists. DiscardStaleResources() and Purge() are serialized with each other; they take the
+/// nodes from the lists and keep them in fence-stamped batches that are released all at once.
+///
+/// Purge() may be given a budget to spread the destruction of a large number of resources
+/// over several calls. Alternatively, completed batches may be handed over to a background
+/// thread that destroys them (see SetBackgroundRelease()).
+///
 /// \tparam ResourceWrapperType -  Type of the resource wrapper used by the release queue.
 template <typename ResourceWrapperType>
 class ResourceReleaseQueue
@@ -223,15 +298,32 @@ class ResourceReleaseQueue
 public:
     // clang-format off
     ResourceReleaseQueue(IMemoryAllocator& Allocator) :
-        m_ReleaseQueue  (STD_ALLOCATOR_RAW_MEM(ReleaseQueueElemType, Allocator, "Allocator for deque<ReleaseQueueElemType>")),
-        m_StaleResources(STD_ALLOCATOR_RAW_MEM(ReleaseQueueElemType, Allocator, "Allocator for deque<ReleaseQueueElemType>"))
+        m_NodeAllocator {Allocator, sizeof(QueueNode), NumNodesInPage, NodeThreadCacheSize, true},
+        m_ReleaseBatches(STD_ALLOCATOR_RAW_MEM(ReleaseBatch, Allocator, "Allocator for deque<ReleaseBatch>"))
     {}
     // clang-format on
 
+    // clang-format off
+    ResourceReleaseQueue             (const ResourceReleaseQueue&) = delete;
+    ResourceReleaseQueue             (ResourceReleaseQueue&&)      = delete;
+    ResourceReleaseQueue& operator = (const ResourceReleaseQueue&) = delete;
+    ResourceReleaseQueue& operator = (ResourceReleaseQueue&&)      = delete;
+    // clang-format on
+
     ~ResourceReleaseQueue()
     {
-        DEV_CHECK_ERR(m_StaleResources.empty(), "Not all stale objects were destroyed");
-        DEV_CHECK_ERR(m_ReleaseQueue.empty(), "Release queue is not empty");
+        SetBackgroundRelease(false);
+
+        DEV_CHECK_ERR(GetStaleResourceCount() == 0, "Not all stale objects were destroyed");
+        DEV_CHECK_ERR(GetPendingReleaseResourceCount() == 0, "Release queue is not empty");
+
+        TakeDiscardedResources();
+        for (auto& Batch : m_ReleaseBatches)
+            DestroyNodes(Batch.Nodes);
+        m_ReleaseBatches.clear();
+
+        TakeStaleResources();
+        DestroyNodes(m_StaleResources);
     }
 
     /// Creates a resource wrapper for the specific resource type
@@ -257,8 +349,9 @@ public:
     /// \param [in] NextCommandListNumber - Number of the command list that will be submitted to the queue next
     void SafeReleaseResource(ResourceWrapperType&& Wrapper, Uint64 NextCommandListNumber)
     {
-        std::lock_guard<std::mutex> LockGuard(m_StaleObjectsMutex);
-        m_StaleResources.emplace_back(NextCommandListNumber, std::move(Wrapper));
+        auto* pNode = NewNode(NextCommandListNumber, std::move(Wrapper));
+        m_NumStaleResources.fetch_add(1, std::memory_order_relaxed);
+        PushNodes(m_StaleHead, pNode, pNode);
     }
 
     /// Moves a copy of the resource wrapper to the stale resources queue
@@ -266,8 +359,9 @@ public:
     /// \param [in] NextCommandListNumber - Number of the command list that will be submitted to the queue next
     void SafeReleaseResource(const ResourceWrapperType& Wrapper, Uint64 NextCommandListNumber)
     {
-        std::lock_guard<std::mutex> LockGuard(m_StaleObjectsMutex);
-        m_StaleResources.emplace_back(NextCommandListNumber, Wrapper);
+        auto* pNode = NewNode(NextCommandListNumber, Wrapper);
+        m_NumStaleResources.fetch_add(1, std::memory_order_relaxed);
+        PushNodes(m_StaleHead, pNode, pNode);
     }
 
     /// Adds a resource directly to the release queue
@@ -284,8 +378,9 @@ public:
     /// \param [in] FenceValue  - Fence value indicating when the resource was used last time.
     void DiscardResource(ResourceWrapperType&& Wrapper, Uint64 FenceValue)
     {
-        std::lock_guard<std::mutex> ReleaseQueueLock(m_ReleaseQueueMutex);
-        m_ReleaseQueue.emplace_back(FenceValue, std::move(Wrapper));
+        auto* pNode = NewNode(FenceValue, std::move(Wrapper));
+        m_NumPendingResources.fetch_add(1, std::memory_order_relaxed);
+        PushNodes(m_DiscardedHead, pNode, pNode);
     }
 
     /// Adds a copy of the resource wrapper directly to the release queue
@@ -293,8 +388,9 @@ public:
     /// \param [in] FenceValue  - Fence value indicating when the resource was used last time.
     void DiscardResource(const ResourceWrapperType& Wrapper, Uint64 FenceValue)
     {
-        std::lock_guard<std::mutex> ReleaseQueueLock(m_ReleaseQueueMutex);
-        m_ReleaseQueue.emplace_back(FenceValue, Wrapper);
+        auto* pNode = NewNode(FenceValue, Wrapper);
+        m_NumPendingResources.fetch_add(1, std::memory_order_relaxed);
+        PushNodes(m_DiscardedHead, pNode, pNode);
     }
 
     /// Adds multiple resources directly to the release queue
@@ -303,11 +399,26 @@ public:
     template <typename ResourceType, typename IteratorType>
     void DiscardResources(Uint64 FenceValue, IteratorType Iterator)
     {
-        std::lock_guard<std::mutex> ReleaseQueueLock(m_ReleaseQueueMutex);
-        ResourceType                Resource;
+        // Link all nodes together and publish them with a single operation.
+        // The list is built newest-first, which is the order the lock-free list keeps.
+        QueueNode*   pNewest  = nullptr;
+        QueueNode*   pOldest  = nullptr;
+        size_t       NumNodes = 0;
+        ResourceType Resource;
         while (Iterator(Resource))
         {
-            m_ReleaseQueue.emplace_back(FenceValue, CreateWrapper(std::move(Resource), 1));
+            auto* pNode  = NewNode(FenceValue, CreateWrapper(std::move(Resource), 1));
+            pNode->pNext = pNewest;
+            pNewest      = pNode;
+            if (pOldest == nullptr)
+                pOldest = pNode;
+            ++NumNodes;
+        }
+
+        if (NumNodes != 0)
+        {
+            m_NumPendingResources.fetch_add(NumNodes, std::memory_order_relaxed);
+            PushNodes(m_DiscardedHead, pNewest, pOldest);
         }
     }
 
@@ -320,62 +431,416 @@ public:
     ///                                      is greater or equal to the fence value associated with the resource
     void DiscardStaleResources(Uint64 SubmittedCmdBuffNumber, Uint64 FenceValue)
     {
+        std::lock_guard<std::mutex> Lock{m_ConsumerMutex};
+
+        // Resources that were discarded directly before this call must precede
+        // the stale resources in the release queue
+        TakeDiscardedResources();
+        TakeStaleResources();
+
         // Only discard these stale objects that were released before CmdBuffNumber
-        // was executed
-        std::lock_guard<std::mutex> StaleObjectsLock(m_StaleObjectsMutex);
-        std::lock_guard<std::mutex> ReleaseQueueLock(m_ReleaseQueueMutex);
-        while (!m_StaleResources.empty())
+        // was executed. Since multiple threads may release resources concurrently, the
+        // command list numbers in the list are not necessarily monotonic, so the entire
+        // list is checked.
+        NodeList Discarded;
+        NodeList Remaining;
+        for (auto* pNode = m_StaleResources.pFirst; pNode != nullptr;)
         {
-            auto& FirstStaleObj = m_StaleResources.front();
-            if (FirstStaleObj.first <= SubmittedCmdBuffNumber)
-            {
-                m_ReleaseQueue.emplace_back(FenceValue, std::move(FirstStaleObj.second));
-                m_StaleResources.pop_front();
-            }
+            auto* pNext = pNode->pNext;
+            if (pNode->Value <= SubmittedCmdBuffNumber)
+                Discarded.Append(pNode);
             else
-                break;
+                Remaining.Append(pNode);
+            pNode = pNext;
+        }
+        m_StaleResources = Remaining;
+
+        if (Discarded.Count != 0)
+        {
+            m_NumPendingResources.fetch_add(Discarded.Count, std::memory_order_relaxed);
+            m_NumStaleResources.fetch_sub(Discarded.Count, std::memory_order_relaxed);
+            AddToReleaseQueue(FenceValue, Discarded);
         }
     }
 
 
-    /// Removes all objects from the release queue whose fence value is
+    /// Removes objects from the release queue whose fence value is
     /// less than or equal to CompletedFenceValue
     /// \param [in] CompletedFenceValue  -  Value of the fence that has been completed by the GPU
-    void Purge(Uint64 CompletedFenceValue)
+    /// \param [in] Budget               -  Limits the number of resources destroyed by this call.
+    ///                                     At least one resource is always destroyed if there are
+    ///                                     completed resources in the queue. The remaining resources are
+    ///                                     destroyed by subsequent calls.
+    /// \return The number of resources that were destroyed or handed over to the background thread.
+    ///
+    /// \remarks  When background release is enabled, completed resources are handed over to the
+    ///           background thread and the budget is ignored.
+    size_t Purge(Uint64 CompletedFenceValue, const ResourcePurgeBudget& Budget = ResourcePurgeBudget{})
     {
-        std::lock_guard<std::mutex> LockGuard(m_ReleaseQueueMutex);
+        std::lock_guard<std::mutex> Lock{m_ConsumerMutex};
+
+        TakeDiscardedResources();
+
+        if (m_BackgroundThread.joinable())
+            return HandOverCompletedResources(CompletedFenceValue);
 
         // Release all objects whose associated fence value is at most CompletedFenceValue
         // See http://diligentgraphics.com/diligent-engine/architecture/d3d12/managing-resource-lifetimes/
-        while (!m_ReleaseQueue.empty())
+        Timer  PurgeTimer;
+        size_t NumDestroyed = 0;
+        while (!m_ReleaseBatches.empty() && m_ReleaseBatches.front().FenceValue <= CompletedFenceValue)
         {
-            auto& FirstObj = m_ReleaseQueue.front();
-            if (FirstObj.first <= CompletedFenceValue)
-                m_ReleaseQueue.pop_front();
-            else
+            auto& Nodes = m_ReleaseBatches.front().Nodes;
+            while (Nodes.Count != 0 && !IsBudgetExhausted(Budget, NumDestroyed, PurgeTimer))
+            {
+                DestroyNode(Nodes.PopFront());
+                m_NumPendingResources.fetch_sub(1, std::memory_order_relaxed);
+                ++NumDestroyed;
+            }
+            if (Nodes.Count != 0)
                 break;
+            m_ReleaseBatches.pop_front();
+        }
+
+        size_t Backlog = 0;
+        for (const auto& Batch : m_ReleaseBatches)
+        {
+            if (Batch.FenceValue > CompletedFenceValue)
+                break;
+            Backlog += Batch.Nodes.Count;
+        }
+        m_NumBacklogResources.store(Backlog, std::memory_order_relaxed);
+
+        return NumDestroyed;
+    }
+
+    /// Enables or disables destruction of resources in a background thread.
+
+    /// When enabled, Purge() hands completed resources over to a thread owned by the queue
+    /// instead of destroying them. The resources must be safe to destroy in any thread.
+    /// Disabling background release waits until the thread destroys all resources handed over to it.
+    void SetBackgroundRelease(bool Enable)
+    {
+        std::lock_guard<std::mutex> Lock{m_ConsumerMutex};
+        if (Enable == m_BackgroundThread.joinable())
+            return;
+
+        if (Enable)
+        {
+            m_StopBackgroundThread = false;
+            m_BackgroundThread     = std::thread{&ResourceReleaseQueue::BackgroundReleaseThread, this};
+        }
+        else
+        {
+            {
+                std::lock_guard<std::mutex> BackgroundLock{m_BackgroundMutex};
+                m_StopBackgroundThread = true;
+            }
+            m_BackgroundWorkCV.notify_one();
+            // The thread destroys all remaining resources before exiting
+            m_BackgroundThread.join();
         }
     }
 
+    /// Returns true if resources are destroyed in the background thread
+    bool IsBackgroundReleaseEnabled()
+    {
+        std::lock_guard<std::mutex> Lock{m_ConsumerMutex};
+        return m_BackgroundThread.joinable();
+    }
+
+    /// Waits until the background thread destroys all resources handed over to it by Purge()
+    void WaitForBackgroundRelease()
+    {
+        std::unique_lock<std::mutex> Lock{m_BackgroundMutex};
+        m_BackgroundIdleCV.wait(Lock, [this]() { return m_BackgroundResources.Count == 0 && !m_BackgroundThreadBusy; });
+    }
+
+    /// Returns the queue statistics
+    ResourceReleaseQueueStats GetStats() const
+    {
+        ResourceReleaseQueueStats Stats;
+        Stats.NumStaleResources = m_NumStaleResources.load(std::memory_order_relaxed);
+        Stats.BacklogSize       = m_NumBacklogResources.load(std::memory_order_relaxed) +
+            m_NumBackgroundResources.load(std::memory_order_relaxed);
+        // Counters are updated independently, so make sure the difference is not negative
+        const auto NumPending     = m_NumPendingResources.load(std::memory_order_relaxed);
+        Stats.NumPendingResources = NumPending > Stats.BacklogSize ? NumPending - Stats.BacklogSize : 0;
+        return Stats;
+    }
+
     /// Returns the number of stale resources
     size_t GetStaleResourceCount() const
     {
-        return m_StaleResources.size();
+        return m_NumStaleResources.load(std::memory_order_relaxed);
     }
 
     /// Returns the number of resources pending release
     size_t GetPendingReleaseResourceCount() const
     {
-        return m_ReleaseQueue.size();
+        return m_NumPendingResources.load(std::memory_order_relaxed);
     }
 
 private:
-    std::mutex m_ReleaseQueueMutex;
-    using ReleaseQueueElemType = std::pair<Uint64, ResourceWrapperType>;
-    std::deque<ReleaseQueueElemType, STDAllocatorRawMem<ReleaseQueueElemType>> m_ReleaseQueue;
+    static constexpr Uint32 NumNodesInPage      = 128;
+    static constexpr Uint32 NodeThreadCacheSize = 64;
+
+    struct QueueNode
+    {
+        QueueNode(Uint64 _Value, ResourceWrapperType&& _Wrapper) :
+            Value{_Value},
+            Wrapper{std::move(_Wrapper)}
+        {}
+
+        QueueNode(Uint64 _Value, const ResourceWrapperType& _Wrapper) :
+            Value{_Value},
+            Wrapper{_Wrapper}
+        {}
+
+        // Command list number for stale resources, fence value for resources in the release queue
+        Uint64              Value;
+        QueueNode*          pNext = nullptr;
+        ResourceWrapperType Wrapper;
+    };
+
+    // Singly-linked list of nodes in the order they were added
+    struct NodeList
+    {
+        QueueNode* pFirst = nullptr;
+        QueueNode* pLast  = nullptr;
+        size_t     Count  = 0;
+
+        void Append(QueueNode* pNode)
+        {
+            pNode->pNext = nullptr;
+            if (pLast != nullptr)
+                pLast->pNext = pNode;
+            else
+                pFirst = pNode;
+            pLast = pNode;
+            ++Count;
+        }
+
+        QueueNode* PopFront()
+        {
+            VERIFY_EXPR(Count != 0);
+            auto* pNode = pFirst;
+            pFirst      = pNode->pNext;
+            if (pFirst == nullptr)
+                pLast = nullptr;
+            --Count;
+            return pNode;
+        }
+
+        void Append(const NodeList& List)
+        {
+            if (List.Count == 0)
+                return;
+            if (pLast != nullptr)
+                pLast->pNext = List.pFirst;
+            else
+                pFirst = List.pFirst;
+            pLast = List.pLast;
+            Count += List.Count;
+        }
+    };
+
+    // Resources that are released when the fence reaches the given value
+    struct ReleaseBatch
+    {
+        ReleaseBatch(Uint64 _FenceValue, const NodeList& _Nodes) :
+            FenceValue{_FenceValue},
+            Nodes{_Nodes}
+        {}
+
+        Uint64   FenceValue;
+        NodeList Nodes;
+    };
+
+    template <typename WrapperType>
+    QueueNode* NewNode(Uint64 Value, WrapperType&& Wrapper)
+    {
+        void* pRawMem = m_NodeAllocator.Allocate(sizeof(QueueNode), "Release queue node", __FILE__, __LINE__);
+        try
+        {
+            return new (pRawMem) QueueNode{Value, std::forward<WrapperType>(Wrapper)};
+        }
+        catch (...)
+        {
+            m_NodeAllocator.Free(pRawMem);
+            throw;
+        }
+    }
+
+    void DestroyNode(QueueNode* pNode)
+    {
+        pNode->~QueueNode();
+        m_NodeAllocator.Free(pNode);
+    }
+
+    void DestroyNodes(NodeList& Nodes)
+    {
+        while (Nodes.Count != 0)
+            DestroyNode(Nodes.PopFront());
+    }
+
+    static bool IsBudgetExhausted(const ResourcePurgeBudget& Budget, size_t NumDestroyed, const Timer& PurgeTimer)
+    {
+        // Always make progress
+        if (NumDestroyed == 0)
+            return false;
+
+        if (Budget.MaxResources != 0 && NumDestroyed >= Budget.MaxResources)
+            return true;
+
+        if (Budget.MaxMicroseconds != 0 && PurgeTimer.GetElapsedTime() * 1e+6 >= static_cast<double>(Budget.MaxMicroseconds))
+            return true;
+
+        return false;
+    }
+
+    // Moves all completed batches to the background thread
+    size_t HandOverCompletedResources(Uint64 CompletedFenceValue)
+    {
+        NodeList Completed;
+        while (!m_ReleaseBatches.empty() && m_ReleaseBatches.front().FenceValue <= CompletedFenceValue)
+        {
+            Completed.Append(m_ReleaseBatches.front().Nodes);
+            m_ReleaseBatches.pop_front();
+        }
+        m_NumBacklogResources.store(0, std::memory_order_relaxed);
+
+        if (Completed.Count != 0)
+        {
+            m_NumBackgroundResources.fetch_add(Completed.Count, std::memory_order_relaxed);
+            {
+                std::lock_guard<std::mutex> BackgroundLock{m_BackgroundMutex};
+                m_BackgroundResources.Append(Completed);
+            }
+            m_BackgroundWorkCV.notify_one();
+        }
+
+        return Completed.Count;
+    }
+
+    void BackgroundReleaseThread()
+    {
+        std::unique_lock<std::mutex> Lock{m_BackgroundMutex};
+        for (;;)
+        {
+            m_BackgroundWorkCV.wait(Lock, [this]() { return m_BackgroundResources.Count != 0 || m_StopBackgroundThread; });
+            if (m_BackgroundResources.Count == 0)
+                break; // Stop was requested and all resources have been destroyed
+
+            auto Resources          = m_BackgroundResources;
+            m_BackgroundResources   = NodeList{};
+            m_BackgroundThreadBusy  = true;
+            Lock.unlock();
+
+            while (Resources.Count != 0)
+            {
+                DestroyNode(Resources.PopFront());
+                m_NumBackgroundResources.fetch_sub(1, std::memory_order_relaxed);
+                m_NumPendingResources.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            Lock.lock();
+            m_BackgroundThreadBusy = false;
+            if (m_BackgroundResources.Count == 0)
+                m_BackgroundIdleCV.notify_all();
+        }
+    }
+
+    // Atomically prepends the chain pNewest -> ... -> pOldest to the list
+    static void PushNodes(std::atomic<QueueNode*>& Head, QueueNode* pNewest, QueueNode* pOldest)
+    {
+        auto* pHead = Head.load(std::memory_order_relaxed);
+        do
+        {
+            pOldest->pNext = pHead;
+        } while (!Head.compare_exchange_weak(pHead, pNewest, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Takes all nodes from the lock-free list and returns them in the order they were pushed
+    static NodeList PopAllNodes(std::atomic<QueueNode*>& Head)
+    {
+        // Reverse the list that is kept newest-first
+        NodeList List;
+        for (auto* pNode = Head.exchange(nullptr, std::memory_order_acquire); pNode != nullptr;)
+        {
+            auto* pNext  = pNode->pNext;
+            pNode->pNext = List.pFirst;
+            List.pFirst  = pNode;
+            if (List.pLast == nullptr)
+                List.pLast = pNode;
+            ++List.Count;
+            pNode = pNext;
+        }
+        return List;
+    }
+
+    void TakeStaleResources()
+    {
+        m_StaleResources.Append(PopAllNodes(m_StaleHead));
+    }
+
+    void TakeDiscardedResources()
+    {
+        auto Discarded = PopAllNodes(m_DiscardedHead);
+        for (auto* pNode = Discarded.pFirst; pNode != nullptr;)
+        {
+            // Group consecutive resources with the same fence value into one batch
+            NodeList Batch;
+            const auto FenceValue = pNode->Value;
+            while (pNode != nullptr && pNode->Value == FenceValue)
+            {
+                auto* pNext = pNode->pNext;
+                Batch.Append(pNode);
+                pNode = pNext;
+            }
+            AddToReleaseQueue(FenceValue, Batch);
+        }
+    }
+
+    void AddToReleaseQueue(Uint64 FenceValue, const NodeList& Nodes)
+    {
+        if (!m_ReleaseBatches.empty() && m_ReleaseBatches.back().FenceValue == FenceValue)
+            m_ReleaseBatches.back().Nodes.Append(Nodes);
+        else
+            m_ReleaseBatches.emplace_back(FenceValue, Nodes);
+    }
+
+    FixedBlockMemoryAllocator m_NodeAllocator;
+
+    // Lock-free lists of released and discarded resources, newest first
+    std::atomic<QueueNode*> m_StaleHead{nullptr};
+    std::atomic<QueueNode*> m_DiscardedHead{nullptr};
+
+    std::atomic<size_t> m_NumStaleResources{0};
+    // Includes resources in the backlog
+    std::atomic<size_t> m_NumPendingResources{0};
+    // Completed resources left in the release queue by the last budgeted purge
+    std::atomic<size_t> m_NumBacklogResources{0};
+    // Resources handed over to the background thread that have not been destroyed yet
+    std::atomic<size_t> m_NumBackgroundResources{0};
+
+    // Serializes DiscardStaleResources() and Purge(); protects all members below
+    std::mutex m_ConsumerMutex;
+
+    // Stale resources whose command lists have not been submitted yet
+    NodeList m_StaleResources;
+
+    std::deque<ReleaseBatch, STDAllocatorRawMem<ReleaseBatch>> m_ReleaseBatches;
+
+    std::thread m_BackgroundThread;
 
-    std::mutex                                                                 m_StaleObjectsMutex;
-    std::deque<ReleaseQueueElemType, STDAllocatorRawMem<ReleaseQueueElemType>> m_StaleResources;
+    // Protects all members below
+    std::mutex              m_BackgroundMutex;
+    std::condition_variable m_BackgroundWorkCV;
+    std::condition_variable m_BackgroundIdleCV;
+    NodeList                m_BackgroundResources;
+    bool                    m_StopBackgroundThread = false;
+    bool                    m_BackgroundThreadBusy = false;
 };
 
 } // namespace Diligent
@@ -29,11 +29,49 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "../../../Common/interface/FixedBlockMemoryAllocator.hpp"
 
 namespace Diligent
 {
 
+/// SRB memory statistics of one pipeline state
+struct SRBMemoryStats
+{
+    /// The number of live allocations of shader variable and resource cache data
+    size_t NumAllocations = 0;
+
+    /// The memory requested by the allocations, in bytes
+    size_t RequestedSize = 0;
+
+    /// The memory occupied by the allocations in the shared pools, in bytes.
+    /// This includes the rounding of the data sizes up to the pool size classes.
+    size_t AllocatedSize = 0;
+};
+
+/// Statistics of the SRB memory pools shared by all pipeline states
+struct SRBMemoryPoolStats
+{
+    /// The number of size-class pools
+    size_t NumPools = 0;
+
+    /// The number of pages in all pools
+    size_t NumPages = 0;
+
+    /// The memory reserved by all pools, in bytes
+    size_t ReservedSize = 0;
+
+    /// The memory taken from the pools, in bytes
+    size_t AllocatedSize = 0;
+};
+
+/// Allocates shader variable and resource cache data of shader resource binding objects.
+
+/// Data of every type is allocated from a fixed-block pool that is shared by all pipeline states
+/// whose data sizes fall into the same size class. Pools start with small pages that grow
+/// geometrically with demand. Every SRBMemoryAllocator keeps track of the memory used by
+/// its pipeline state.
 class SRBMemoryAllocator
 {
 public:
@@ -43,6 +81,15 @@ public:
 
     ~SRBMemoryAllocator();
 
+    // clang-format off
+    SRBMemoryAllocator             (const SRBMemoryAllocator&) = delete;
+    SRBMemoryAllocator             (SRBMemoryAllocator&&)      = delete;
+    SRBMemoryAllocator& operator = (const SRBMemoryAllocator&) = delete;
+    SRBMemoryAllocator& operator = (SRBMemoryAllocator&&)      = delete;
+    // clang-format on
+
+    /// SRBAllocationGranularity is the number of blocks in the first page of a pool
+    /// created by this allocator. Subsequent pages grow geometrically.
     void Initialize(Uint32              SRBAllocationGranularity,
                     Uint32              ShaderVariableDataAllocatorCount,
                     const size_t* const ShaderVariableDataSizes,
@@ -52,20 +99,63 @@ public:
     IMemoryAllocator& GetShaderVariableDataAllocator(Uint32 Ind)
     {
         VERIFY_EXPR(m_DataAllocators == nullptr || Ind < m_ShaderVariableDataAllocatorCount);
-        return m_DataAllocators != nullptr ? m_DataAllocators[Ind] : m_RawMemAllocator;
+        return m_DataAllocators != nullptr ? static_cast<IMemoryAllocator&>(m_DataAllocators[Ind]) : m_RawMemAllocator;
     }
 
     IMemoryAllocator& GetResourceCacheDataAllocator(Uint32 Ind)
     {
         VERIFY_EXPR(m_DataAllocators == nullptr || Ind < m_ResourceCacheDataAllocatorCount);
-        return m_DataAllocators != nullptr ? m_DataAllocators[m_ShaderVariableDataAllocatorCount + Ind] : m_RawMemAllocator;
+        return m_DataAllocators != nullptr ? static_cast<IMemoryAllocator&>(m_DataAllocators[m_ShaderVariableDataAllocatorCount + Ind]) : m_RawMemAllocator;
     }
 
+    /// Returns the memory statistics of this allocator. Allocations made from the raw
+    /// allocator when the allocator is not initialized are not counted.
+    SRBMemoryStats GetStats() const;
+
+    /// Returns the statistics of the pools shared by all SRB memory allocators
+    static SRBMemoryPoolStats GetPoolStats();
+
+    /// Returns the size of the blocks that data of the given size is allocated from
+    static size_t GetSizeClass(size_t DataSize);
+
 private:
+    // Allocates data of one type from the shared pool and counts the allocations
+    class DataAllocator final : public IMemoryAllocator
+    {
+    public:
+        DataAllocator(FixedBlockMemoryAllocator& Pool, size_t DataSize) :
+            m_Pool{Pool},
+            m_DataSize{DataSize}
+        {}
+
+        virtual void* Allocate(size_t Size, const Char* dbgDescription, const char* dbgFileName, const Int32 dbgLineNumber) override final
+        {
+            VERIFY(Size <= m_DataSize, "Requested size (", Size, ") exceeds the data size (", m_DataSize, ")");
+            auto* Ptr = m_Pool.Allocate(m_Pool.GetBlockSize(), dbgDescription, dbgFileName, dbgLineNumber);
+            m_NumAllocations.fetch_add(1, std::memory_order_relaxed);
+            return Ptr;
+        }
+
+        virtual void Free(void* Ptr) override final
+        {
+            m_Pool.Free(Ptr);
+            m_NumAllocations.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        FixedBlockMemoryAllocator& GetPool() const { return m_Pool; }
+        size_t                     GetDataSize() const { return m_DataSize; }
+        size_t                     GetNumAllocations() const { return m_NumAllocations.load(std::memory_order_relaxed); }
+
+    private:
+        FixedBlockMemoryAllocator& m_Pool;
+        const size_t               m_DataSize;
+        std::atomic<size_t>        m_NumAllocations{0};
+    };
+
     IMemoryAllocator& m_RawMemAllocator;
 
-    // Fixed-block allocators for every shader stage
-    FixedBlockMemoryAllocator* m_DataAllocators = nullptr;
+    // Allocators for every shader stage
+    DataAllocator* m_DataAllocators = nullptr;
 
     Uint32 m_ShaderVariableDataAllocatorCount = 0;
     Uint32 m_ResourceCacheDataAllocatorCount  = 0;
@@ -0,0 +1,585 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+// Two-level segregated fit (TLSF) free block manager that handles variable-size allocation requests
+// in constant time. See M. Masmano, I. Ripoll, A. Crespo, J. Real, "TLSF: a New Dynamic Memory Allocator
+// for Real-Time Systems"
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include "../../../Primitives/interface/MemoryAllocator.h"
+#include "../../../Platforms/Basic/interface/DebugUtilities.hpp"
+#include "../../../Platforms/interface/PlatformMisc.hpp"
+#include "../../../Common/interface/Align.hpp"
+#include "../../../Common/interface/STDAllocator.hpp"
+
+namespace Diligent
+{
+// The class manages free space of a linear range of size MaxSize. Like VariableSizeAllocationsManager,
+// it only keeps track of free blocks and does not record allocation sizes.
+//
+// Free blocks are sorted into bins by size. The first level splits the sizes into power-of-two classes,
+// the second level splits every class into SLCount linear subranges. Non-empty bins are tracked by
+// bitmasks, so a bin that holds a large enough block is found with two bit scans. Every bin is a doubly
+// linked list of block records.
+//
+//                     FL bitmap:  0 0 1 0 1 ...
+//                                     |   |
+//    SL bitmaps      [FL = 2]:  0 1 0 0   |
+//                                 |       |
+//                                 '-> Block -> Block
+//                    [FL = 4]:  1 0 0 1
+//                               |     |
+//                               |     '-> Block
+//                               '-> Block -> Block -> Block
+//
+// Since the managed memory may not be accessible by the CPU (e.g. GPU memory or descriptor heaps), block
+// records are kept in a separate pool, and free blocks adjacent to the released range are located through
+// two open-addressing hash tables indexed by the block start and end offsets. Records are recycled, so
+// allocating and freeing blocks does not allocate memory once the pool has grown to its working size.
+class TLSFAllocationsManager
+{
+public:
+    using OffsetType = size_t;
+
+    static constexpr OffsetType InvalidOffset = static_cast<OffsetType>(-1);
+
+    TLSFAllocationsManager(OffsetType MaxSize, IMemoryAllocator& Allocator) :
+        // clang-format off
+        m_Blocks      (STD_ALLOCATOR_RAW_MEM(BlockInfo, Allocator, "Allocator for vector<BlockInfo>")),
+        m_BlockByStart{Allocator},
+        m_BlockByEnd  {Allocator},
+        m_MaxSize     {MaxSize  }
+    // clang-format on
+    {
+        for (auto& FLBins : m_BinHeads)
+        {
+            for (auto& Head : FLBins)
+                Head = InvalidIndex;
+        }
+
+        if (MaxSize > 0)
+            AddFreeRange(0, MaxSize);
+        m_FreeSize = MaxSize;
+
+#ifdef DILIGENT_DEBUG
+        DbgVerifyBins();
+#endif
+    }
+
+    ~TLSFAllocationsManager()
+    {
+#ifdef DILIGENT_DEBUG
+        if (m_MaxSize > 0)
+        {
+            VERIFY(m_NumFreeBlocks == 1, "Single free block is expected");
+            VERIFY(m_FreeSize == m_MaxSize, "All allocations are expected to be released");
+        }
+#endif
+    }
+
+    // clang-format off
+    TLSFAllocationsManager             (const TLSFAllocationsManager&) = delete;
+    TLSFAllocationsManager             (TLSFAllocationsManager&&)      = delete;
+    TLSFAllocationsManager& operator = (const TLSFAllocationsManager&) = delete;
+    TLSFAllocationsManager& operator = (TLSFAllocationsManager&&)      = delete;
+    // clang-format on
+
+    // Allocates the range large enough to hold Size bytes aligned by Alignment and returns its offset,
+    // or InvalidOffset if there is no suitable free block. Similar to VariableSizeAllocationsManager,
+    // the returned offset may not be aligned, but AllocatedSize includes the padding required to align it.
+    OffsetType Allocate(OffsetType Size, OffsetType Alignment, OffsetType& AllocatedSize)
+    {
+        VERIFY_EXPR(Size > 0);
+        VERIFY(IsPowerOfTwo(Alignment), "Alignment (", Alignment, ") must be power of 2");
+        Size          = Align(Size, Alignment);
+        AllocatedSize = 0;
+        if (m_FreeSize < Size)
+            return InvalidOffset;
+
+        // Look for a block of at least Size bytes first. If its offset is not aligned and the
+        // padding does not fit, look for a block that is guaranteed to fit Size + padding bytes.
+        auto BlockIdx = FindFreeBlock(Size);
+        if (BlockIdx != InvalidIndex && Size + (Align(m_Blocks[BlockIdx].Offset, Alignment) - m_Blocks[BlockIdx].Offset) > m_Blocks[BlockIdx].Size)
+            BlockIdx = InvalidIndex;
+        if (BlockIdx == InvalidIndex && Alignment > 1)
+            BlockIdx = FindFreeBlock(Size + Alignment - 1);
+        if (BlockIdx == InvalidIndex)
+            return InvalidOffset;
+
+        const auto Offset    = m_Blocks[BlockIdx].Offset;
+        const auto BlockSize = m_Blocks[BlockIdx].Size;
+        AllocatedSize        = Size + (Align(Offset, Alignment) - Offset);
+        VERIFY_EXPR(AllocatedSize <= BlockSize);
+
+        RemoveFreeBlock(BlockIdx);
+        ReleaseBlockRecord(BlockIdx);
+        if (BlockSize > AllocatedSize)
+        {
+            //    Offset
+            //     |
+            //     |<------------------BlockSize------------------>|
+            //     |<-----AllocatedSize----->|<-------Remainder--->|
+            //
+            InsertFreeBlock(Offset + AllocatedSize, BlockSize - AllocatedSize);
+        }
+
+        m_FreeSize -= AllocatedSize;
+
+#ifdef DILIGENT_DEBUG
+        DbgVerifyBins();
+#endif
+        return Offset;
+    }
+
+    void Free(OffsetType Offset, OffsetType Size)
+    {
+        VERIFY_EXPR(Size > 0 && Offset + Size <= m_MaxSize);
+        VERIFY(m_BlockByStart.Find(Offset) == InvalidIndex, "Block at offset ", Offset, " is already free");
+        AddFreeRange(Offset, Size);
+        m_FreeSize += Size;
+
+#ifdef DILIGENT_DEBUG
+        DbgVerifyBins();
+#endif
+    }
+
+    // Removes the [Offset, Offset + Size) range from the free space. The range must be entirely
+    // contained in a single free block. Returns false if there is no such block.
+    bool AllocateRange(OffsetType Offset, OffsetType Size)
+    {
+        VERIFY_EXPR(Size > 0 && Offset + Size <= m_MaxSize);
+
+        // Blocks in bins below the bin of Size are too small to contain the range
+        Uint32 FL = 0, SL = 0;
+        MapSizeToBin(Size, FL, SL);
+        for (; FL < FLCount; ++FL, SL = 0)
+        {
+            if (((m_FLBitmap >> FL) & 0x01) == 0)
+                continue;
+
+            for (; SL < SLCount; ++SL)
+            {
+                for (auto Idx = m_BinHeads[FL][SL]; Idx != InvalidIndex; Idx = m_Blocks[Idx].NextFree)
+                {
+                    const auto BlockOffset = m_Blocks[Idx].Offset;
+                    const auto BlockSize   = m_Blocks[Idx].Size;
+                    if (Offset < BlockOffset || Offset + Size > BlockOffset + BlockSize)
+                        continue;
+
+                    //  BlockOffset          Offset
+                    //     |                   |
+                    //     |<---------------------BlockSize--------------------->|
+                    //     |<---Remainder0---->|<-----Size----->|<--Remainder1-->|
+                    //
+                    RemoveFreeBlock(Idx);
+                    ReleaseBlockRecord(Idx);
+                    if (Offset > BlockOffset)
+                        InsertFreeBlock(BlockOffset, Offset - BlockOffset);
+                    if (Offset + Size < BlockOffset + BlockSize)
+                        InsertFreeBlock(Offset + Size, BlockOffset + BlockSize - (Offset + Size));
+
+                    m_FreeSize -= Size;
+
+#ifdef DILIGENT_DEBUG
+                    DbgVerifyBins();
+#endif
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    void Extend(OffsetType ExtraSize)
+    {
+        if (ExtraSize == 0)
+            return;
+
+        AddFreeRange(m_MaxSize, ExtraSize);
+        m_MaxSize += ExtraSize;
+        m_FreeSize += ExtraSize;
+
+#ifdef DILIGENT_DEBUG
+        DbgVerifyBins();
+#endif
+    }
+
+    // clang-format off
+    bool       IsFull()      const { return m_FreeSize == 0;         }
+    bool       IsEmpty()     const { return m_FreeSize == m_MaxSize; }
+    OffsetType GetMaxSize()  const { return m_MaxSize;               }
+    OffsetType GetFreeSize() const { return m_FreeSize;              }
+    OffsetType GetUsedSize() const { return m_MaxSize - m_FreeSize;  }
+    // clang-format on
+
+    size_t GetNumFreeBlocks() const { return m_NumFreeBlocks; }
+
+    // Calls Handler(Offset, Size) for every free block. Blocks are visited in no particular order.
+    template <typename HandlerType>
+    void ProcessFreeBlocks(HandlerType Handler) const
+    {
+        for (Uint32 FL = 0; FL < FLCount; ++FL)
+        {
+            if (m_SLBitmaps[FL] == 0)
+                continue;
+
+            for (Uint32 SL = 0; SL < SLCount; ++SL)
+            {
+                for (auto Idx = m_BinHeads[FL][SL]; Idx != InvalidIndex; Idx = m_Blocks[Idx].NextFree)
+                    Handler(m_Blocks[Idx].Offset, m_Blocks[Idx].Size);
+            }
+        }
+    }
+
+private:
+    static constexpr Uint32 InvalidIndex = ~Uint32{0};
+
+    // Number of second-level bins in every first-level class is 2^SLIndexBits.
+    // Sizes below SLCount are mapped to the first class with a granularity of one.
+    static constexpr Uint32 SLIndexBits = 4;
+    static constexpr Uint32 SLCount     = 1u << SLIndexBits;
+    static constexpr Uint32 FLCount     = sizeof(OffsetType) * 8 - SLIndexBits + 1;
+    static_assert(FLCount <= 64, "First-level bitmap is too small");
+
+    struct BlockInfo
+    {
+        OffsetType Offset   = 0;
+        OffsetType Size     = 0;
+        Uint32     PrevFree = InvalidIndex; // Previous block in the same bin
+        Uint32     NextFree = InvalidIndex; // Next block in the same bin, or next unused record
+    };
+
+    // Open-addressing hash table with linear probing that maps block boundary offsets to block indices
+    class OffsetToBlockMap
+    {
+    public:
+        OffsetToBlockMap(IMemoryAllocator& Allocator) :
+            m_Slots(STD_ALLOCATOR_RAW_MEM(Slot, Allocator, "Allocator for vector<Slot>"))
+        {}
+
+        Uint32 Find(OffsetType Key) const
+        {
+            if (m_Slots.empty())
+                return InvalidIndex;
+
+            for (auto i = GetHomeSlot(Key);; i = (i + 1) & m_Mask)
+            {
+                const auto& S = m_Slots[i];
+                if (S.Value == InvalidIndex || S.Key == Key)
+                    return S.Value;
+            }
+        }
+
+        void Insert(OffsetType Key, Uint32 Value)
+        {
+            VERIFY_EXPR(Value != InvalidIndex);
+            if ((m_Count + 1) * 2 > m_Slots.size())
+                Rehash(std::max(m_Slots.size() * 2, size_t{16}));
+
+            auto i = GetHomeSlot(Key);
+            while (m_Slots[i].Value != InvalidIndex)
+            {
+                VERIFY(m_Slots[i].Key != Key, "Key ", Key, " is already in the table");
+                i = (i + 1) & m_Mask;
+            }
+            m_Slots[i].Key   = Key;
+            m_Slots[i].Value = Value;
+            ++m_Count;
+        }
+
+        void Erase(OffsetType Key)
+        {
+            VERIFY_EXPR(!m_Slots.empty());
+            auto i = GetHomeSlot(Key);
+            while (m_Slots[i].Key != Key || m_Slots[i].Value == InvalidIndex)
+            {
+                VERIFY(m_Slots[i].Value != InvalidIndex, "Key ", Key, " is not found");
+                i = (i + 1) & m_Mask;
+            }
+            m_Slots[i].Value = InvalidIndex;
+            --m_Count;
+
+            // Shift back the elements that follow the removed one in the same probe sequence
+            for (auto j = (i + 1) & m_Mask; m_Slots[j].Value != InvalidIndex; j = (j + 1) & m_Mask)
+            {
+                auto Home = GetHomeSlot(m_Slots[j].Key);
+                // Move the element if its home slot is not in the cyclic range (i, j]
+                bool CanMove = (i <= j) ? (Home <= i || Home > j) : (Home <= i && Home > j);
+                if (CanMove)
+                {
+                    m_Slots[i]       = m_Slots[j];
+                    m_Slots[j].Value = InvalidIndex;
+                    i                = j;
+                }
+            }
+        }
+
+    private:
+        struct Slot
+        {
+            OffsetType Key   = 0;
+            Uint32     Value = InvalidIndex;
+        };
+
+        size_t GetHomeSlot(OffsetType Key) const
+        {
+            // Fibonacci hashing
+            return static_cast<size_t>((static_cast<Uint64>(Key) * 0x9E3779B97F4A7C15ull) >> m_Shift);
+        }
+
+        void Rehash(size_t NewSize)
+        {
+            VERIFY_EXPR(IsPowerOfTwo(NewSize));
+            decltype(m_Slots) OldSlots{NewSize, Slot{}, m_Slots.get_allocator()};
+            std::swap(OldSlots, m_Slots);
+            m_Mask  = NewSize - 1;
+            m_Shift = 64 - PlatformMisc::GetMSB(static_cast<Uint64>(NewSize));
+            m_Count = 0;
+            for (const auto& S : OldSlots)
+            {
+                if (S.Value != InvalidIndex)
+                    Insert(S.Key, S.Value);
+            }
+        }
+
+        std::vector<Slot, STDAllocatorRawMem<Slot>> m_Slots;
+
+        size_t m_Count = 0;
+        size_t m_Mask  = 0;
+        Uint32 m_Shift = 64;
+    };
+
+    static void MapSizeToBin(OffsetType Size, Uint32& FL, Uint32& SL)
+    {
+        if (Size < SLCount)
+        {
+            FL = 0;
+            SL = static_cast<Uint32>(Size);
+        }
+        else
+        {
+            const auto MSB = PlatformMisc::GetMSB(static_cast<Uint64>(Size));
+            FL             = MSB - SLIndexBits + 1;
+            SL             = static_cast<Uint32>(Size >> (MSB - SLIndexBits)) - SLCount;
+        }
+        VERIFY_EXPR(FL < FLCount && SL < SLCount);
+    }
+
+    // Finds a free block that is at least Size bytes large. Unlike bins used for insertion,
+    // the search starts from the bin where all blocks are guaranteed to be large enough.
+    Uint32 FindFreeBlock(const OffsetType RequiredSize) const
+    {
+        auto Size = RequiredSize;
+        if (Size >= SLCount)
+        {
+            // Round the size up to the next bin boundary
+            const auto MSB      = PlatformMisc::GetMSB(static_cast<Uint64>(Size));
+            const auto RoundUp  = (OffsetType{1} << (MSB - SLIndexBits)) - 1;
+            const auto NextSize = Size + RoundUp;
+            if (NextSize < Size)
+                return InvalidIndex; // Overflow
+            Size = NextSize;
+        }
+
+        Uint32 FL = 0, SL = 0;
+        MapSizeToBin(Size, FL, SL);
+
+        auto SLMap = m_SLBitmaps[FL] & (~Uint32{0} << SL);
+        if (SLMap == 0)
+        {
+            const auto FLMap = (FL + 1 < 64) ? m_FLBitmap & (~Uint64{0} << (FL + 1)) : Uint64{0};
+            if (FLMap == 0)
+                return InvalidIndex;
+
+            FL    = PlatformMisc::GetLSB(FLMap);
+            SLMap = m_SLBitmaps[FL];
+            VERIFY_EXPR(SLMap != 0);
+        }
+        SL = PlatformMisc::GetLSB(SLMap);
+
+        VERIFY_EXPR(m_BinHeads[FL][SL] != InvalidIndex && m_Blocks[m_BinHeads[FL][SL]].Size >= RequiredSize);
+        return m_BinHeads[FL][SL];
+    }
+
+    Uint32 AcquireBlockRecord()
+    {
+        if (m_FirstUnusedRecord != InvalidIndex)
+        {
+            auto Idx            = m_FirstUnusedRecord;
+            m_FirstUnusedRecord = m_Blocks[Idx].NextFree;
+            return Idx;
+        }
+
+        m_Blocks.emplace_back();
+        return static_cast<Uint32>(m_Blocks.size() - 1);
+    }
+
+    void ReleaseBlockRecord(Uint32 Idx)
+    {
+        m_Blocks[Idx]          = BlockInfo{};
+        m_Blocks[Idx].NextFree = m_FirstUnusedRecord;
+        m_FirstUnusedRecord    = Idx;
+    }
+
+    void InsertFreeBlock(OffsetType Offset, OffsetType Size)
+    {
+        const auto Idx = AcquireBlockRecord();
+
+        auto& Block  = m_Blocks[Idx];
+        Block.Offset = Offset;
+        Block.Size   = Size;
+
+        Uint32 FL = 0, SL = 0;
+        MapSizeToBin(Size, FL, SL);
+        auto& Head     = m_BinHeads[FL][SL];
+        Block.PrevFree = InvalidIndex;
+        Block.NextFree = Head;
+        if (Head != InvalidIndex)
+            m_Blocks[Head].PrevFree = Idx;
+        Head = Idx;
+        m_SLBitmaps[FL] |= 1u << SL;
+        m_FLBitmap |= Uint64{1} << FL;
+
+        m_BlockByStart.Insert(Offset, Idx);
+        m_BlockByEnd.Insert(Offset + Size, Idx);
+        ++m_NumFreeBlocks;
+    }
+
+    void RemoveFreeBlock(Uint32 Idx)
+    {
+        const auto& Block = m_Blocks[Idx];
+
+        Uint32 FL = 0, SL = 0;
+        MapSizeToBin(Block.Size, FL, SL);
+        if (Block.PrevFree != InvalidIndex)
+            m_Blocks[Block.PrevFree].NextFree = Block.NextFree;
+        else
+        {
+            VERIFY_EXPR(m_BinHeads[FL][SL] == Idx);
+            m_BinHeads[FL][SL] = Block.NextFree;
+            if (Block.NextFree == InvalidIndex)
+            {
+                m_SLBitmaps[FL] &= ~(1u << SL);
+                if (m_SLBitmaps[FL] == 0)
+                    m_FLBitmap &= ~(Uint64{1} << FL);
+            }
+        }
+        if (Block.NextFree != InvalidIndex)
+            m_Blocks[Block.NextFree].PrevFree = Block.PrevFree;
+
+        m_BlockByStart.Erase(Block.Offset);
+        m_BlockByEnd.Erase(Block.Offset + Block.Size);
+        VERIFY_EXPR(m_NumFreeBlocks > 0);
+        --m_NumFreeBlocks;
+    }
+
+    // Adds the range to the free space and merges it with the adjacent free blocks
+    void AddFreeRange(OffsetType Offset, OffsetType Size)
+    {
+        auto NewOffset = Offset;
+        auto NewSize   = Size;
+
+        //   PrevBlock.Offset           Offset            NextBlock.Offset
+        //     |                          |                    |
+        //     |<-----PrevBlock.Size----->|<------Size-------->|<-----NextBlock.Size----->|
+        //
+        const auto PrevBlockIdx = m_BlockByEnd.Find(Offset);
+        if (PrevBlockIdx != InvalidIndex)
+        {
+            NewOffset = m_Blocks[PrevBlockIdx].Offset;
+            NewSize += m_Blocks[PrevBlockIdx].Size;
+            RemoveFreeBlock(PrevBlockIdx);
+            ReleaseBlockRecord(PrevBlockIdx);
+        }
+
+        const auto NextBlockIdx = m_BlockByStart.Find(Offset + Size);
+        if (NextBlockIdx != InvalidIndex)
+        {
+            NewSize += m_Blocks[NextBlockIdx].Size;
+            RemoveFreeBlock(NextBlockIdx);
+            ReleaseBlockRecord(NextBlockIdx);
+        }
+
+        InsertFreeBlock(NewOffset, NewSize);
+    }
+
+#ifdef DILIGENT_DEBUG
+    void DbgVerifyBins() const
+    {
+        OffsetType TotalFreeSize  = 0;
+        size_t     TotalNumBlocks = 0;
+        for (Uint32 FL = 0; FL < FLCount; ++FL)
+        {
+            VERIFY_EXPR(((m_FLBitmap >> FL) & 0x01) == (m_SLBitmaps[FL] != 0 ? 1 : 0));
+            for (Uint32 SL = 0; SL < SLCount; ++SL)
+            {
+                VERIFY_EXPR(((m_SLBitmaps[FL] >> SL) & 0x01) == (m_BinHeads[FL][SL] != InvalidIndex ? 1 : 0));
+                auto Prev = InvalidIndex;
+                for (auto Idx = m_BinHeads[FL][SL]; Idx != InvalidIndex; Idx = m_Blocks[Idx].NextFree)
+                {
+                    const auto& Block = m_Blocks[Idx];
+                    VERIFY_EXPR(Block.PrevFree == Prev);
+                    Uint32 BlockFL = 0, BlockSL = 0;
+                    MapSizeToBin(Block.Size, BlockFL, BlockSL);
+                    VERIFY(BlockFL == FL && BlockSL == SL, "Block is in the wrong bin");
+                    VERIFY_EXPR(Block.Offset + Block.Size <= m_MaxSize);
+                    VERIFY_EXPR(m_BlockByStart.Find(Block.Offset) == Idx);
+                    VERIFY_EXPR(m_BlockByEnd.Find(Block.Offset + Block.Size) == Idx);
+                    VERIFY(m_BlockByEnd.Find(Block.Offset) == InvalidIndex, "Unmerged adjacent blocks detected");
+                    TotalFreeSize += Block.Size;
+                    ++TotalNumBlocks;
+                    Prev = Idx;
+                }
+            }
+        }
+        VERIFY_EXPR(TotalFreeSize == m_FreeSize);
+        VERIFY_EXPR(TotalNumBlocks == m_NumFreeBlocks);
+    }
+#endif
+
+    // Pool of block records. Unused records are linked through BlockInfo::NextFree
+    std::vector<BlockInfo, STDAllocatorRawMem<BlockInfo>> m_Blocks;
+    Uint32                                                m_FirstUnusedRecord = InvalidIndex;
+
+    Uint64 m_FLBitmap                   = 0;
+    Uint32 m_SLBitmaps[FLCount]         = {};
+    Uint32 m_BinHeads[FLCount][SLCount] = {};
+
+    OffsetToBlockMap m_BlockByStart;
+    OffsetToBlockMap m_BlockByEnd;
+
+    OffsetType m_MaxSize       = 0;
+    OffsetType m_FreeSize      = 0;
+    size_t     m_NumFreeBlocks = 0;
+};
+
+} // namespace Diligent
@@ -0,0 +1,270 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// Compile-time texture format traits
+
+#include "../../GraphicsEngine/interface/GraphicsTypes.h"
+
+namespace Diligent
+{
+
+namespace TextureFormatTraitsInternal
+{
+
+struct TextureFormatTableEntry
+{
+    TextureFormatAttribs Attribs;
+
+    // Default SRV, RTV, DSV and UAV formats, indexed by TEXTURE_VIEW_TYPE - 1
+    TEXTURE_FORMAT ViewFormats[TEXTURE_VIEW_NUM_VIEWS - 1];
+};
+
+// The table is a static member of a class template so that it can be defined in the header
+// and still have a single instance in the program. Entries are indexed by the texture format.
+template <typename T = void>
+struct TextureFormatTable
+{
+    static constexpr TextureFormatTableEntry Entries[TEX_FORMAT_NUM_FORMATS] =
+        {
+            // clang-format off
+#define TEX_FORMAT_TABLE_ENTRY(Fmt, ComponentSize, NumComponents, ComponentType, IsTypeless, BlockWidth, BlockHeight, SRVFmt, RTVFmt, DSVFmt, UAVFmt) \
+            {                                                                                                                         \
+                TextureFormatAttribs{"TEX_FORMAT_" #Fmt, TEX_FORMAT_##Fmt, ComponentSize, NumComponents, ComponentType, IsTypeless, BlockWidth, BlockHeight}, \
+                {TEX_FORMAT_##SRVFmt, TEX_FORMAT_##RTVFmt, TEX_FORMAT_##DSVFmt, TEX_FORMAT_##UAVFmt}                                 \
+            }
+
+            TEX_FORMAT_TABLE_ENTRY(UNKNOWN,                    0,  0, COMPONENT_TYPE_UNDEFINED,     false, 0, 0, UNKNOWN,                    UNKNOWN,          UNKNOWN,              UNKNOWN),
+
+            TEX_FORMAT_TABLE_ENTRY(RGBA32_TYPELESS,            4,  4, COMPONENT_TYPE_UNDEFINED,     true,  1, 1, RGBA32_FLOAT,               RGBA32_FLOAT,     UNKNOWN,              RGBA32_FLOAT),
+            TEX_FORMAT_TABLE_ENTRY(RGBA32_FLOAT,               4,  4, COMPONENT_TYPE_FLOAT,         false, 1, 1, RGBA32_FLOAT,               RGBA32_FLOAT,     UNKNOWN,              RGBA32_FLOAT),
+            TEX_FORMAT_TABLE_ENTRY(RGBA32_UINT,                4,  4, COMPONENT_TYPE_UINT,          false, 1, 1, RGBA32_UINT,                RGBA32_UINT,      UNKNOWN,              RGBA32_UINT),
+            TEX_FORMAT_TABLE_ENTRY(RGBA32_SINT,                4,  4, COMPONENT_TYPE_SINT,          false, 1, 1, RGBA32_SINT,                RGBA32_SINT,      UNKNOWN,              RGBA32_SINT),
+
+            TEX_FORMAT_TABLE_ENTRY(RGB32_TYPELESS,             4,  3, COMPONENT_TYPE_UNDEFINED,     true,  1, 1, RGB32_FLOAT,                RGB32_FLOAT,      UNKNOWN,              RGB32_FLOAT),
+            TEX_FORMAT_TABLE_ENTRY(RGB32_FLOAT,                4,  3, COMPONENT_TYPE_FLOAT,         false, 1, 1, RGB32_FLOAT,                RGB32_FLOAT,      UNKNOWN,              RGB32_FLOAT),
+            TEX_FORMAT_TABLE_ENTRY(RGB32_UINT,                 4,  3, COMPONENT_TYPE_UINT,          false, 1, 1, RGB32_UINT,                 RGB32_UINT,       UNKNOWN,              RGB32_UINT),
+            TEX_FORMAT_TABLE_ENTRY(RGB32_SINT,                 4,  3, COMPONENT_TYPE_SINT,          false, 1, 1, RGB32_SINT,                 RGB32_SINT,       UNKNOWN,              RGB32_SINT),
+
+            TEX_FORMAT_TABLE_ENTRY(RGBA16_TYPELESS,            2,  4, COMPONENT_TYPE_UNDEFINED,     true,  1, 1, RGBA16_FLOAT,               RGBA16_FLOAT,     UNKNOWN,              RGBA16_FLOAT),
+            TEX_FORMAT_TABLE_ENTRY(RGBA16_FLOAT,               2,  4, COMPONENT_TYPE_FLOAT,         false, 1, 1, RGBA16_FLOAT,               RGBA16_FLOAT,     UNKNOWN,              RGBA16_FLOAT),
+            TEX_FORMAT_TABLE_ENTRY(RGBA16_UNORM,               2,  4, COMPONENT_TYPE_UNORM,         false, 1, 1, RGBA16_UNORM,               RGBA16_UNORM,     UNKNOWN,              RGBA16_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(RGBA16_UINT,                2,  4, COMPONENT_TYPE_UINT,          false, 1, 1, RGBA16_UINT,                RGBA16_UINT,      UNKNOWN,              RGBA16_UINT),
+            TEX_FORMAT_TABLE_ENTRY(RGBA16_SNORM,               2,  4, COMPONENT_TYPE_SNORM,         false, 1, 1, RGBA16_SNORM,               RGBA16_SNORM,     UNKNOWN,              RGBA16_SNORM),
+            TEX_FORMAT_TABLE_ENTRY(RGBA16_SINT,                2,  4, COMPONENT_TYPE_SINT,          false, 1, 1, RGBA16_SINT,                RGBA16_SINT,      UNKNOWN,              RGBA16_SINT),
+
+            TEX_FORMAT_TABLE_ENTRY(RG32_TYPELESS,              4,  2, COMPONENT_TYPE_UNDEFINED,     true,  1, 1, RG32_FLOAT,                 RG32_FLOAT,       UNKNOWN,              RG32_FLOAT),
+            TEX_FORMAT_TABLE_ENTRY(RG32_FLOAT,                 4,  2, COMPONENT_TYPE_FLOAT,         false, 1, 1, RG32_FLOAT,                 RG32_FLOAT,       UNKNOWN,              RG32_FLOAT),
+            TEX_FORMAT_TABLE_ENTRY(RG32_UINT,                  4,  2, COMPONENT_TYPE_UINT,          false, 1, 1, RG32_UINT,                  RG32_UINT,        UNKNOWN,              RG32_UINT),
+            TEX_FORMAT_TABLE_ENTRY(RG32_SINT,                  4,  2, COMPONENT_TYPE_SINT,          false, 1, 1, RG32_SINT,                  RG32_SINT,        UNKNOWN,              RG32_SINT),
+
+            TEX_FORMAT_TABLE_ENTRY(R32G8X24_TYPELESS,          4,  2, COMPONENT_TYPE_DEPTH_STENCIL, true,  1, 1, R32_FLOAT_X8X24_TYPELESS,   UNKNOWN,          D32_FLOAT_S8X24_UINT, UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(D32_FLOAT_S8X24_UINT,       4,  2, COMPONENT_TYPE_DEPTH_STENCIL, false, 1, 1, R32_FLOAT_X8X24_TYPELESS,   UNKNOWN,          D32_FLOAT_S8X24_UINT, UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(R32_FLOAT_X8X24_TYPELESS,   4,  2, COMPONENT_TYPE_DEPTH_STENCIL, false, 1, 1, R32_FLOAT_X8X24_TYPELESS,   UNKNOWN,          D32_FLOAT_S8X24_UINT, R32_FLOAT_X8X24_TYPELESS),
+            TEX_FORMAT_TABLE_ENTRY(X32_TYPELESS_G8X24_UINT,    4,  2, COMPONENT_TYPE_DEPTH_STENCIL, false, 1, 1, X32_TYPELESS_G8X24_UINT,    UNKNOWN,          D32_FLOAT_S8X24_UINT, X32_TYPELESS_G8X24_UINT),
+
+            TEX_FORMAT_TABLE_ENTRY(RGB10A2_TYPELESS,           4,  1, COMPONENT_TYPE_COMPOUND,      true,  1, 1, RGB10A2_UNORM,              RGB10A2_UNORM,    UNKNOWN,              RGB10A2_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(RGB10A2_UNORM,              4,  1, COMPONENT_TYPE_COMPOUND,      false, 1, 1, RGB10A2_UNORM,              RGB10A2_UNORM,    UNKNOWN,              RGB10A2_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(RGB10A2_UINT,               4,  1, COMPONENT_TYPE_COMPOUND,      false, 1, 1, RGB10A2_UINT,               RGB10A2_UINT,     UNKNOWN,              RGB10A2_UINT),
+            TEX_FORMAT_TABLE_ENTRY(R11G11B10_FLOAT,            4,  1, COMPONENT_TYPE_COMPOUND,      false, 1, 1, R11G11B10_FLOAT,            R11G11B10_FLOAT,  UNKNOWN,              R11G11B10_FLOAT),
+
+            TEX_FORMAT_TABLE_ENTRY(RGBA8_TYPELESS,             1,  4, COMPONENT_TYPE_UNDEFINED,     true,  1, 1, RGBA8_UNORM_SRGB,           RGBA8_UNORM_SRGB, UNKNOWN,              RGBA8_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(RGBA8_UNORM,                1,  4, COMPONENT_TYPE_UNORM,         false, 1, 1, RGBA8_UNORM,                RGBA8_UNORM,      UNKNOWN,              RGBA8_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(RGBA8_UNORM_SRGB,           1,  4, COMPONENT_TYPE_UNORM_SRGB,    false, 1, 1, RGBA8_UNORM_SRGB,           RGBA8_UNORM_SRGB, UNKNOWN,              RGBA8_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(RGBA8_UINT,                 1,  4, COMPONENT_TYPE_UINT,          false, 1, 1, RGBA8_UINT,                 RGBA8_UINT,       UNKNOWN,              RGBA8_UINT),
+            TEX_FORMAT_TABLE_ENTRY(RGBA8_SNORM,                1,  4, COMPONENT_TYPE_SNORM,         false, 1, 1, RGBA8_SNORM,                RGBA8_SNORM,      UNKNOWN,              RGBA8_SNORM),
+            TEX_FORMAT_TABLE_ENTRY(RGBA8_SINT,                 1,  4, COMPONENT_TYPE_SINT,          false, 1, 1, RGBA8_SINT,                 RGBA8_SINT,       UNKNOWN,              RGBA8_SINT),
+
+            TEX_FORMAT_TABLE_ENTRY(RG16_TYPELESS,              2,  2, COMPONENT_TYPE_UNDEFINED,     true,  1, 1, RG16_FLOAT,                 RG16_FLOAT,       UNKNOWN,              RG16_FLOAT),
+            TEX_FORMAT_TABLE_ENTRY(RG16_FLOAT,                 2,  2, COMPONENT_TYPE_FLOAT,         false, 1, 1, RG16_FLOAT,                 RG16_FLOAT,       UNKNOWN,              RG16_FLOAT),
+            TEX_FORMAT_TABLE_ENTRY(RG16_UNORM,                 2,  2, COMPONENT_TYPE_UNORM,         false, 1, 1, RG16_UNORM,                 RG16_UNORM,       UNKNOWN,              RG16_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(RG16_UINT,                  2,  2, COMPONENT_TYPE_UINT,          false, 1, 1, RG16_UINT,                  RG16_UINT,        UNKNOWN,              RG16_UINT),
+            TEX_FORMAT_TABLE_ENTRY(RG16_SNORM,                 2,  2, COMPONENT_TYPE_SNORM,         false, 1, 1, RG16_SNORM,                 RG16_SNORM,       UNKNOWN,              RG16_SNORM),
+            TEX_FORMAT_TABLE_ENTRY(RG16_SINT,                  2,  2, COMPONENT_TYPE_SINT,          false, 1, 1, RG16_SINT,                  RG16_SINT,        UNKNOWN,              RG16_SINT),
+
+            TEX_FORMAT_TABLE_ENTRY(R32_TYPELESS,               4,  1, COMPONENT_TYPE_UNDEFINED,     true,  1, 1, R32_FLOAT,                  R32_FLOAT,        D32_FLOAT,            R32_FLOAT),
+            TEX_FORMAT_TABLE_ENTRY(D32_FLOAT,                  4,  1, COMPONENT_TYPE_DEPTH,         false, 1, 1, R32_FLOAT,                  R32_FLOAT,        D32_FLOAT,            R32_FLOAT),
+            TEX_FORMAT_TABLE_ENTRY(R32_FLOAT,                  4,  1, COMPONENT_TYPE_FLOAT,         false, 1, 1, R32_FLOAT,                  R32_FLOAT,        D32_FLOAT,            R32_FLOAT),
+            TEX_FORMAT_TABLE_ENTRY(R32_UINT,                   4,  1, COMPONENT_TYPE_UINT,          false, 1, 1, R32_UINT,                   R32_UINT,         UNKNOWN,              R32_UINT),
+            TEX_FORMAT_TABLE_ENTRY(R32_SINT,                   4,  1, COMPONENT_TYPE_SINT,          false, 1, 1, R32_SINT,                   R32_SINT,         UNKNOWN,              R32_SINT),
+
+            TEX_FORMAT_TABLE_ENTRY(R24G8_TYPELESS,             4,  1, COMPONENT_TYPE_DEPTH_STENCIL, true,  1, 1, R24_UNORM_X8_TYPELESS,      UNKNOWN,          D24_UNORM_S8_UINT,    UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(D24_UNORM_S8_UINT,          4,  1, COMPONENT_TYPE_DEPTH_STENCIL, false, 1, 1, R24_UNORM_X8_TYPELESS,      UNKNOWN,          D24_UNORM_S8_UINT,    UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(R24_UNORM_X8_TYPELESS,      4,  1, COMPONENT_TYPE_DEPTH_STENCIL, false, 1, 1, R24_UNORM_X8_TYPELESS,      UNKNOWN,          D24_UNORM_S8_UINT,    R24_UNORM_X8_TYPELESS),
+            TEX_FORMAT_TABLE_ENTRY(X24_TYPELESS_G8_UINT,       4,  1, COMPONENT_TYPE_DEPTH_STENCIL, false, 1, 1, X24_TYPELESS_G8_UINT,       UNKNOWN,          D24_UNORM_S8_UINT,    X24_TYPELESS_G8_UINT),
+
+            TEX_FORMAT_TABLE_ENTRY(RG8_TYPELESS,               1,  2, COMPONENT_TYPE_UNDEFINED,     true,  1, 1, RG8_UNORM,                  RG8_UNORM,        UNKNOWN,              RG8_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(RG8_UNORM,                  1,  2, COMPONENT_TYPE_UNORM,         false, 1, 1, RG8_UNORM,                  RG8_UNORM,        UNKNOWN,              RG8_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(RG8_UINT,                   1,  2, COMPONENT_TYPE_UINT,          false, 1, 1, RG8_UINT,                   RG8_UINT,         UNKNOWN,              RG8_UINT),
+            TEX_FORMAT_TABLE_ENTRY(RG8_SNORM,                  1,  2, COMPONENT_TYPE_SNORM,         false, 1, 1, RG8_SNORM,                  RG8_SNORM,        UNKNOWN,              RG8_SNORM),
+            TEX_FORMAT_TABLE_ENTRY(RG8_SINT,                   1,  2, COMPONENT_TYPE_SINT,          false, 1, 1, RG8_SINT,                   RG8_SINT,         UNKNOWN,              RG8_SINT),
+
+            TEX_FORMAT_TABLE_ENTRY(R16_TYPELESS,               2,  1, COMPONENT_TYPE_UNDEFINED,     true,  1, 1, R16_FLOAT,                  R16_FLOAT,        UNKNOWN,              R16_FLOAT),
+            TEX_FORMAT_TABLE_ENTRY(R16_FLOAT,                  2,  1, COMPONENT_TYPE_FLOAT,         false, 1, 1, R16_FLOAT,                  R16_FLOAT,        UNKNOWN,              R16_FLOAT),
+            TEX_FORMAT_TABLE_ENTRY(D16_UNORM,                  2,  1, COMPONENT_TYPE_DEPTH,         false, 1, 1, R16_UNORM,                  R16_UNORM,        D16_UNORM,            R16_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(R16_UNORM,                  2,  1, COMPONENT_TYPE_UNORM,         false, 1, 1, R16_UNORM,                  R16_UNORM,        D16_UNORM,            R16_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(R16_UINT,                   2,  1, COMPONENT_TYPE_UINT,          false, 1, 1, R16_UINT,                   R16_UINT,         UNKNOWN,              R16_UINT),
+            TEX_FORMAT_TABLE_ENTRY(R16_SNORM,                  2,  1, COMPONENT_TYPE_SNORM,         false, 1, 1, R16_SNORM,                  R16_SNORM,        UNKNOWN,              R16_SNORM),
+            TEX_FORMAT_TABLE_ENTRY(R16_SINT,                   2,  1, COMPONENT_TYPE_SINT,          false, 1, 1, R16_SINT,                   R16_SINT,         UNKNOWN,              R16_SINT),
+
+            TEX_FORMAT_TABLE_ENTRY(R8_TYPELESS,                1,  1, COMPONENT_TYPE_UNDEFINED,     true,  1, 1, R8_UNORM,                   R8_UNORM,         UNKNOWN,              R8_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(R8_UNORM,                   1,  1, COMPONENT_TYPE_UNORM,         false, 1, 1, R8_UNORM,                   R8_UNORM,         UNKNOWN,              R8_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(R8_UINT,                    1,  1, COMPONENT_TYPE_UINT,          false, 1, 1, R8_UINT,                    R8_UINT,          UNKNOWN,              R8_UINT),
+            TEX_FORMAT_TABLE_ENTRY(R8_SNORM,                   1,  1, COMPONENT_TYPE_SNORM,         false, 1, 1, R8_SNORM,                   R8_SNORM,         UNKNOWN,              R8_SNORM),
+            TEX_FORMAT_TABLE_ENTRY(R8_SINT,                    1,  1, COMPONENT_TYPE_SINT,          false, 1, 1, R8_SINT,                    R8_SINT,          UNKNOWN,              R8_SINT),
+            TEX_FORMAT_TABLE_ENTRY(A8_UNORM,                   1,  1, COMPONENT_TYPE_UNORM,         false, 1, 1, A8_UNORM,                   A8_UNORM,         UNKNOWN,              A8_UNORM),
+
+            TEX_FORMAT_TABLE_ENTRY(R1_UNORM,                   1,  1, COMPONENT_TYPE_UNORM,         false, 1, 1, R1_UNORM,                   R1_UNORM,         UNKNOWN,              R1_UNORM),
+
+            TEX_FORMAT_TABLE_ENTRY(RGB9E5_SHAREDEXP,           4,  1, COMPONENT_TYPE_COMPOUND,      false, 1, 1, RGB9E5_SHAREDEXP,           RGB9E5_SHAREDEXP, UNKNOWN,              RGB9E5_SHAREDEXP),
+            TEX_FORMAT_TABLE_ENTRY(RG8_B8G8_UNORM,             1,  4, COMPONENT_TYPE_UNORM,         false, 1, 1, RG8_B8G8_UNORM,             RG8_B8G8_UNORM,   UNKNOWN,              RG8_B8G8_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(G8R8_G8B8_UNORM,            1,  4, COMPONENT_TYPE_UNORM,         false, 1, 1, G8R8_G8B8_UNORM,            G8R8_G8B8_UNORM,  UNKNOWN,              G8R8_G8B8_UNORM),
+
+            // http://www.g-truc.net/post-0335.html
+            // http://renderingpipeline.com/2012/07/texture-compression/
+            TEX_FORMAT_TABLE_ENTRY(BC1_TYPELESS,               8,  3, COMPONENT_TYPE_COMPRESSED,    true,  4, 4, BC1_UNORM_SRGB,             UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC1_UNORM,                  8,  3, COMPONENT_TYPE_COMPRESSED,    false, 4, 4, BC1_UNORM,                  UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC1_UNORM_SRGB,             8,  3, COMPONENT_TYPE_COMPRESSED,    false, 4, 4, BC1_UNORM_SRGB,             UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC2_TYPELESS,               16, 4, COMPONENT_TYPE_COMPRESSED,    true,  4, 4, BC2_UNORM_SRGB,             UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC2_UNORM,                  16, 4, COMPONENT_TYPE_COMPRESSED,    false, 4, 4, BC2_UNORM,                  UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC2_UNORM_SRGB,             16, 4, COMPONENT_TYPE_COMPRESSED,    false, 4, 4, BC2_UNORM_SRGB,             UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC3_TYPELESS,               16, 4, COMPONENT_TYPE_COMPRESSED,    true,  4, 4, BC3_UNORM_SRGB,             UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC3_UNORM,                  16, 4, COMPONENT_TYPE_COMPRESSED,    false, 4, 4, BC3_UNORM,                  UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC3_UNORM_SRGB,             16, 4, COMPONENT_TYPE_COMPRESSED,    false, 4, 4, BC3_UNORM_SRGB,             UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC4_TYPELESS,               8,  1, COMPONENT_TYPE_COMPRESSED,    true,  4, 4, BC4_UNORM,                  UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC4_UNORM,                  8,  1, COMPONENT_TYPE_COMPRESSED,    false, 4, 4, BC4_UNORM,                  UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC4_SNORM,                  8,  1, COMPONENT_TYPE_COMPRESSED,    false, 4, 4, BC4_SNORM,                  UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC5_TYPELESS,               16, 2, COMPONENT_TYPE_COMPRESSED,    true,  4, 4, BC5_UNORM,                  UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC5_UNORM,                  16, 2, COMPONENT_TYPE_COMPRESSED,    false, 4, 4, BC5_UNORM,                  UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC5_SNORM,                  16, 2, COMPONENT_TYPE_COMPRESSED,    false, 4, 4, BC5_SNORM,                  UNKNOWN,          UNKNOWN,              UNKNOWN),
+
+            TEX_FORMAT_TABLE_ENTRY(B5G6R5_UNORM,               2,  1, COMPONENT_TYPE_COMPOUND,      false, 1, 1, B5G6R5_UNORM,               B5G6R5_UNORM,     UNKNOWN,              B5G6R5_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(B5G5R5A1_UNORM,             2,  1, COMPONENT_TYPE_COMPOUND,      false, 1, 1, B5G5R5A1_UNORM,             B5G5R5A1_UNORM,   UNKNOWN,              B5G5R5A1_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(BGRA8_UNORM,                1,  4, COMPONENT_TYPE_UNORM,         false, 1, 1, BGRA8_UNORM,                BGRA8_UNORM,      UNKNOWN,              BGRA8_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(BGRX8_UNORM,                1,  4, COMPONENT_TYPE_UNORM,         false, 1, 1, BGRX8_UNORM,                BGRX8_UNORM,      UNKNOWN,              BGRX8_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(R10G10B10_XR_BIAS_A2_UNORM, 4,  1, COMPONENT_TYPE_COMPOUND,      false, 1, 1, R10G10B10_XR_BIAS_A2_UNORM, UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BGRA8_TYPELESS,             1,  4, COMPONENT_TYPE_UNDEFINED,     true,  1, 1, BGRA8_UNORM_SRGB,           BGRA8_UNORM_SRGB, UNKNOWN,              BGRA8_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(BGRA8_UNORM_SRGB,           1,  4, COMPONENT_TYPE_UNORM_SRGB,    false, 1, 1, BGRA8_UNORM_SRGB,           BGRA8_UNORM_SRGB, UNKNOWN,              BGRA8_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(BGRX8_TYPELESS,             1,  4, COMPONENT_TYPE_UNDEFINED,     true,  1, 1, BGRX8_UNORM_SRGB,           BGRX8_UNORM_SRGB, UNKNOWN,              BGRX8_UNORM),
+            TEX_FORMAT_TABLE_ENTRY(BGRX8_UNORM_SRGB,           1,  4, COMPONENT_TYPE_UNORM_SRGB,    false, 1, 1, BGRX8_UNORM_SRGB,           BGRX8_UNORM_SRGB, UNKNOWN,              BGRX8_UNORM),
+
+            TEX_FORMAT_TABLE_ENTRY(BC6H_TYPELESS,              16, 3, COMPONENT_TYPE_COMPRESSED,    true,  4, 4, BC6H_UF16,                  UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC6H_UF16,                  16, 3, COMPONENT_TYPE_COMPRESSED,    false, 4, 4, BC6H_UF16,                  UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC6H_SF16,                  16, 3, COMPONENT_TYPE_COMPRESSED,    false, 4, 4, BC6H_SF16,                  UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC7_TYPELESS,               16, 4, COMPONENT_TYPE_COMPRESSED,    true,  4, 4, BC7_UNORM_SRGB,             UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC7_UNORM,                  16, 4, COMPONENT_TYPE_COMPRESSED,    false, 4, 4, BC7_UNORM,                  UNKNOWN,          UNKNOWN,              UNKNOWN),
+            TEX_FORMAT_TABLE_ENTRY(BC7_UNORM_SRGB,             16, 4, COMPONENT_TYPE_COMPRESSED,    false, 4, 4, BC7_UNORM_SRGB,             UNKNOWN,          UNKNOWN,              UNKNOWN),
+#undef TEX_FORMAT_TABLE_ENTRY
+            // clang-format on
+        };
+};
+
+template <typename T>
+constexpr TextureFormatTableEntry TextureFormatTable<T>::Entries[TEX_FORMAT_NUM_FORMATS];
+
+constexpr bool IsTableSorted(Uint32 Fmt = TEX_FORMAT_UNKNOWN)
+{
+    return Fmt == TEX_FORMAT_NUM_FORMATS ||
+        (TextureFormatTable<>::Entries[Fmt].Attribs.Format == static_cast<TEXTURE_FORMAT>(Fmt) && IsTableSorted(Fmt + 1));
+}
+static_assert(TEX_FORMAT_NUM_FORMATS == TEX_FORMAT_BC7_UNORM_SRGB + 1, "Not all texture formats initialized.");
+static_assert(IsTableSorted(), "Texture format table entries must be in the order of TEXTURE_FORMAT enum values");
+
+// Reports an invalid texture format. Not constexpr to make invalid formats a compile-time error.
+void ReportInvalidTextureFormat(TEXTURE_FORMAT Format);
+
+constexpr const TextureFormatTableEntry& GetTableEntry(TEXTURE_FORMAT Format)
+{
+    return Format < TEX_FORMAT_NUM_FORMATS ?
+        TextureFormatTable<>::Entries[Format] :
+        (ReportInvalidTextureFormat(Format), TextureFormatTable<>::Entries[TEX_FORMAT_UNKNOWN]);
+}
+
+} // namespace TextureFormatTraitsInternal
+
+
+/// Compile-time attributes of a texture format
+
+/// The traits are constant expressions, for example:
+///
+///     static_assert(TextureFormatTraits<TEX_FORMAT_BC1_UNORM>::IsCompressed, "BC1 is a compressed format");
+///     const auto RowSize = Width * TextureFormatTraits<TEX_FORMAT_RGBA8_UNORM>::ElementSize;
+///
+/// See GetTextureFormatAttribs() for the run-time counterpart.
+template <TEXTURE_FORMAT Format>
+struct TextureFormatTraits
+{
+    static_assert(Format < TEX_FORMAT_NUM_FORMATS, "Invalid texture format");
+
+    /// Texture format attributes, see Diligent::TextureFormatAttribs
+    static constexpr const TextureFormatAttribs& GetAttribs()
+    {
+        return TextureFormatTraitsInternal::TextureFormatTable<>::Entries[Format].Attribs;
+    }
+
+    // clang-format off
+    static constexpr const Char*    Name          = GetAttribs().Name;
+    static constexpr Uint8          ComponentSize = GetAttribs().ComponentSize;
+    static constexpr Uint8          NumComponents = GetAttribs().NumComponents;
+    static constexpr COMPONENT_TYPE ComponentType = GetAttribs().ComponentType;
+    static constexpr bool           IsTypeless    = GetAttribs().IsTypeless;
+    static constexpr Uint8          BlockWidth    = GetAttribs().BlockWidth;
+    static constexpr Uint8          BlockHeight   = GetAttribs().BlockHeight;
+
+    /// Indicates if the format is a block-compressed format
+    static constexpr bool IsCompressed = ComponentType == COMPONENT_TYPE_COMPRESSED;
+
+    /// Texel size for non-compressed formats, block size for block-compressed formats
+    static constexpr Uint32 ElementSize = GetAttribs().GetElementSize();
+
+    /// Default view formats, see GetDefaultTextureViewFormat()
+    static constexpr TEXTURE_FORMAT SRVFormat = TextureFormatTraitsInternal::TextureFormatTable<>::Entries[Format].ViewFormats[TEXTURE_VIEW_SHADER_RESOURCE - 1];
+    static constexpr TEXTURE_FORMAT RTVFormat = TextureFormatTraitsInternal::TextureFormatTable<>::Entries[Format].ViewFormats[TEXTURE_VIEW_RENDER_TARGET - 1];
+    static constexpr TEXTURE_FORMAT DSVFormat = TextureFormatTraitsInternal::TextureFormatTable<>::Entries[Format].ViewFormats[TEXTURE_VIEW_DEPTH_STENCIL - 1];
+    static constexpr TEXTURE_FORMAT UAVFormat = TextureFormatTraitsInternal::TextureFormatTable<>::Entries[Format].ViewFormats[TEXTURE_VIEW_UNORDERED_ACCESS - 1];
+    // clang-format on
+};
+
+// clang-format off
+template <TEXTURE_FORMAT Format> constexpr const Char*    TextureFormatTraits<Format>::Name;
+template <TEXTURE_FORMAT Format> constexpr Uint8          TextureFormatTraits<Format>::ComponentSize;
+template <TEXTURE_FORMAT Format> constexpr Uint8          TextureFormatTraits<Format>::NumComponents;
+template <TEXTURE_FORMAT Format> constexpr COMPONENT_TYPE TextureFormatTraits<Format>::ComponentType;
+template <TEXTURE_FORMAT Format> constexpr bool           TextureFormatTraits<Format>::IsTypeless;
+template <TEXTURE_FORMAT Format> constexpr Uint8          TextureFormatTraits<Format>::BlockWidth;
+template <TEXTURE_FORMAT Format> constexpr Uint8          TextureFormatTraits<Format>::BlockHeight;
+template <TEXTURE_FORMAT Format> constexpr bool           TextureFormatTraits<Format>::IsCompressed;
+template <TEXTURE_FORMAT Format> constexpr Uint32         TextureFormatTraits<Format>::ElementSize;
+template <TEXTURE_FORMAT Format> constexpr TEXTURE_FORMAT TextureFormatTraits<Format>::SRVFormat;
+template <TEXTURE_FORMAT Format> constexpr TEXTURE_FORMAT TextureFormatTraits<Format>::RTVFormat;
+template <TEXTURE_FORMAT Format> constexpr TEXTURE_FORMAT TextureFormatTraits<Format>::DSVFormat;
+template <TEXTURE_FORMAT Format> constexpr TEXTURE_FORMAT TextureFormatTraits<Format>::UAVFormat;
+// clang-format on
+
+} // namespace Diligent
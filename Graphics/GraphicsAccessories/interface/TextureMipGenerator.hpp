@@ -0,0 +1,132 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#pragma once
+
+/// \file
+/// CPU mip chain generation
+
+#include "../../GraphicsEngine/interface/Texture.h"
+#include "../../GraphicsEngine/interface/Sampler.h"
+
+namespace Diligent
+{
+
+/// Mip level downsampling filter
+enum MIP_FILTER_TYPE : Uint8
+{
+    /// Box filter: every texel of the coarser level is the area-weighted average
+    /// of the texels of the finer level it covers.
+    MIP_FILTER_TYPE_BOX = 0,
+
+    /// Kaiser-windowed sinc filter. Preserves more detail than the box filter
+    /// at the cost of a wider footprint.
+    MIP_FILTER_TYPE_KAISER,
+
+    MIP_FILTER_TYPE_NUM_TYPES
+};
+
+/// Mip generation attributes, see Diligent::GenerateMipLevels.
+struct MipGenerationAttribs
+{
+    /// Downsampling filter.
+    MIP_FILTER_TYPE Filter = MIP_FILTER_TYPE_BOX;
+
+    /// Addressing mode used to fetch texels outside of the level.
+    /// Only TEXTURE_ADDRESS_WRAP, TEXTURE_ADDRESS_MIRROR and TEXTURE_ADDRESS_CLAMP
+    /// are supported, other modes are treated as TEXTURE_ADDRESS_CLAMP.
+    /// Box filter never samples outside of the level.
+    TEXTURE_ADDRESS_MODE AddressMode = TEXTURE_ADDRESS_CLAMP;
+
+    /// Kaiser filter radius, in texels of the coarser level.
+    float KaiserWidth = 3;
+
+    /// Kaiser window shape parameter. Larger values reduce ringing, but blur the result.
+    float KaiserAlpha = 4;
+
+    /// If greater than zero, the alpha channel of every mip level is scaled so that the fraction
+    /// of texels with alpha greater than AlphaCutoff matches that of the most detailed level.
+    /// This keeps alpha-tested geometry such as foliage from thinning out in the distance.
+    /// Ignored for formats that have no alpha channel and for integer formats.
+    float AlphaCutoff = 0;
+
+    /// The number of threads to use. Rows of every level are distributed between the threads.
+    Uint32 NumThreads = 1;
+};
+
+/// Destination mip level data, see Diligent::GenerateMipLevels.
+struct MipLevelData
+{
+    /// Pointer to the level data
+    void* pData = nullptr;
+
+    /// Row stride, in bytes
+    Uint32 Stride = 0;
+
+    /// Depth slice stride, in bytes. Only used for 3D textures.
+    Uint32 DepthStride = 0;
+};
+
+/// Returns true if Diligent::GenerateMipLevels supports the format.
+
+/// All formats with UNORM, UNORM_SRGB, SNORM, UINT, SINT and FLOAT components, D16_UNORM and D32_FLOAT
+/// as well as RGB10A2, R11G11B10_FLOAT, RGB9E5_SHAREDEXP, B5G6R5, B5G5R5A1 and R10G10B10_XR_BIAS_A2
+/// packed formats are supported.
+/// Typeless, depth-stencil, block-compressed, R1_UNORM and 4:2:2 formats are not supported.
+bool IsMipGenerationSupported(TEXTURE_FORMAT Format);
+
+/// Generates mip levels 1 to TexDesc.MipLevels-1 of every array slice of a texture on the CPU.
+
+/// \param [in] TexDesc    - Texture description. If TexDesc.MipLevels is 0, the full mip chain is generated.
+/// \param [in] pSrcLevels - Level 0 data of every array slice. The number of elements must be equal to
+///                          TexDesc.ArraySize for array and cube textures and 1 otherwise.
+///                          pSrcBuffer and SrcOffset members are not used.
+/// \param [in] pDstLevels - Destination data of levels 1 to MipLevels-1 of every array slice.
+///                          The levels are ordered by array slice, then by mip level,
+///                          i.e. level M of slice S is pDstLevels[S * (MipLevels - 1) + M - 1].
+/// \param [in] Attribs    - Mip generation attributes, see Diligent::MipGenerationAttribs.
+/// \return     true if the levels have been generated, and false if the format is not supported.
+///
+/// \remarks    Every level is filtered from the previous one, so the levels are processed sequentially
+///             while the rows of all slices of a level are processed in parallel.
+///             The texels are filtered in 32-bit float precision. sRGB formats are filtered in linear space.
+///             Integer formats are rounded to the nearest integer; 32-bit integer values above 2^24
+///             lose precision.
+bool GenerateMipLevels(const TextureDesc&          TexDesc,
+                       const TextureSubResData*    pSrcLevels,
+                       const MipLevelData*         pDstLevels,
+                       const MipGenerationAttribs& Attribs);
+
+/// Generates mip levels with the default attributes.
+inline bool GenerateMipLevels(const TextureDesc&       TexDesc,
+                              const TextureSubResData* pSrcLevels,
+                              const MipLevelData*      pDstLevels)
+{
+    return GenerateMipLevels(TexDesc, pSrcLevels, pDstLevels, MipGenerationAttribs{});
+}
+
+} // namespace Diligent
@@ -31,12 +31,16 @@
 #pragma once
 
 #include <map>
+#include <array>
+#include <vector>
 #include <algorithm>
 
 #include "../../../Primitives/interface/MemoryAllocator.h"
 #include "../../../Platforms/Basic/interface/DebugUtilities.hpp"
+#include "../../../Platforms/interface/PlatformMisc.hpp"
 #include "../../../Common/interface/Align.hpp"
 #include "../../../Common/interface/STDAllocator.hpp"
+#include "TLSFAllocationsManager.hpp"
 
 namespace Diligent
 {
@@ -61,11 +65,24 @@ namespace Diligent
 //
 //                32 ------------------> 104 ---------->  {size = 32, &m_FreeBlocksBySize[3]}
 //
+// Alternatively, an instance may be created with the STRATEGY_TLSF strategy, in which case free blocks
+// are managed by TLSFAllocationsManager. Allocate and Free then run in constant time and do not allocate
+// memory for every free block, at the cost of a good-fit rather than best-fit block selection.
 class VariableSizeAllocationsManager
 {
 public:
     using OffsetType = size_t;
 
+    // Free block management strategy
+    enum STRATEGY : Uint8
+    {
+        // Free blocks are kept in two ordered maps. Allocate() selects the best fitting block.
+        STRATEGY_ORDERED_MAPS = 0,
+
+        // Free blocks are kept in two-level segregated fit lists (see TLSFAllocationsManager)
+        STRATEGY_TLSF
+    };
+
 private:
     struct FreeBlockInfo;
 
@@ -98,12 +115,21 @@ private:
     };
 
 public:
-    VariableSizeAllocationsManager(OffsetType MaxSize, IMemoryAllocator& Allocator) :
+    VariableSizeAllocationsManager(OffsetType MaxSize, IMemoryAllocator& Allocator, STRATEGY Strategy = STRATEGY_ORDERED_MAPS) :
         m_FreeBlocksByOffset(STD_ALLOCATOR_RAW_MEM(TFreeBlocksByOffsetMap::value_type, Allocator, "Allocator for map<OffsetType, FreeBlockInfo>")),
         m_FreeBlocksBySize(STD_ALLOCATOR_RAW_MEM(TFreeBlocksBySizeMap::value_type, Allocator, "Allocator for multimap<OffsetType, TFreeBlocksByOffsetMap::iterator>")),
         m_MaxSize(MaxSize),
         m_FreeSize(MaxSize)
     {
+        if (Strategy == STRATEGY_TLSF)
+        {
+            m_pAllocator = &Allocator;
+
+            auto* pTLSFRawMem = Allocator.Allocate(sizeof(TLSFAllocationsManager), "Raw memory for TLSFAllocationsManager", __FILE__, __LINE__);
+            m_pTLSF           = new (pTLSFRawMem) TLSFAllocationsManager{MaxSize, Allocator};
+            return;
+        }
+
         // Insert single maximum-size block
         AddNewBlock(0, m_MaxSize);
         ResetCurrAlignment();
@@ -115,6 +141,8 @@ public:
 
     ~VariableSizeAllocationsManager()
     {
+        DestroyTLSF();
+
 #ifdef DILIGENT_DEBUG
         if (!m_FreeBlocksByOffset.empty() || !m_FreeBlocksBySize.empty())
         {
@@ -137,16 +165,40 @@ public:
         m_FreeBlocksBySize   {std::move(rhs.m_FreeBlocksBySize)  },
         m_MaxSize            {rhs.m_MaxSize      },
         m_FreeSize           {rhs.m_FreeSize     },
-        m_CurrAlignment      {rhs.m_CurrAlignment}
+        m_CurrAlignment      {rhs.m_CurrAlignment},
+        m_pTLSF              {rhs.m_pTLSF        },
+        m_pAllocator         {rhs.m_pAllocator   }
     {
         // clang-format on
         rhs.m_MaxSize       = 0;
         rhs.m_FreeSize      = 0;
         rhs.m_CurrAlignment = 0;
+        rhs.m_pTLSF         = nullptr;
+        rhs.m_pAllocator    = nullptr;
+    }
+
+    VariableSizeAllocationsManager& operator=(VariableSizeAllocationsManager&& rhs)
+    {
+        DestroyTLSF();
+
+        m_FreeBlocksByOffset = std::move(rhs.m_FreeBlocksByOffset);
+        m_FreeBlocksBySize   = std::move(rhs.m_FreeBlocksBySize);
+        m_MaxSize            = rhs.m_MaxSize;
+        m_FreeSize           = rhs.m_FreeSize;
+        m_CurrAlignment      = rhs.m_CurrAlignment;
+        m_pTLSF              = rhs.m_pTLSF;
+        m_pAllocator         = rhs.m_pAllocator;
+
+        rhs.m_MaxSize       = 0;
+        rhs.m_FreeSize      = 0;
+        rhs.m_CurrAlignment = 0;
+        rhs.m_pTLSF         = nullptr;
+        rhs.m_pAllocator    = nullptr;
+
+        return *this;
     }
 
     // clang-format off
-    VariableSizeAllocationsManager& operator = (VariableSizeAllocationsManager&& rhs) = default;
     VariableSizeAllocationsManager             (const VariableSizeAllocationsManager&) = delete;
     VariableSizeAllocationsManager& operator = (const VariableSizeAllocationsManager&) = delete;
     // clang-format on
@@ -193,6 +245,18 @@ public:
         if (m_FreeSize < Size)
             return Allocation::InvalidAllocation();
 
+        if (m_pTLSF != nullptr)
+        {
+            OffsetType AllocatedSize = 0;
+
+            auto Offset = m_pTLSF->Allocate(Size, Alignment, AllocatedSize);
+            if (Offset == TLSFAllocationsManager::InvalidOffset)
+                return Allocation::InvalidAllocation();
+
+            m_FreeSize -= AllocatedSize;
+            return Allocation{Offset, AllocatedSize};
+        }
+
         auto AlignmentReserve = (Alignment > m_CurrAlignment) ? Alignment - m_CurrAlignment : 0;
         // Get the first block that is large enough to encompass Size + AlignmentReserve bytes
         // lower_bound() returns an iterator pointing to the first element that
@@ -258,6 +322,13 @@ public:
     {
         VERIFY_EXPR(Offset + Size <= m_MaxSize);
 
+        if (m_pTLSF != nullptr)
+        {
+            m_pTLSF->Free(Offset, Size);
+            m_FreeSize += Size;
+            return;
+        }
+
         // Find the first element whose offset is greater than the specified offset.
         // upper_bound() returns an iterator pointing to the first element in the
         // container whose key is considered to go after k.
@@ -360,11 +431,237 @@ public:
 
     size_t GetNumFreeBlocks() const
     {
-        return m_FreeBlocksByOffset.size();
+        return m_pTLSF != nullptr ? m_pTLSF->GetNumFreeBlocks() : m_FreeBlocksByOffset.size();
+    }
+
+    // Free space statistics that help understand why an allocation fails while
+    // the total free size is sufficient to accommodate it
+    struct FreeBlockStatistics
+    {
+        static constexpr Uint32 NumHistogramBins = sizeof(OffsetType) * 8;
+
+        // Total size of all free blocks
+        OffsetType TotalFreeSize = 0;
+
+        // Size of the largest free block, which is the largest allocation
+        // that can currently succeed (ignoring alignment)
+        OffsetType LargestFreeBlockSize = 0;
+
+        // The total number of free blocks
+        size_t NumFreeBlocks = 0;
+
+        // Free block size histogram. Bin i counts free blocks whose size is in [2^i, 2^(i+1)) range.
+        std::array<size_t, NumHistogramBins> SizeHistogram = {};
+
+        // Returns the fraction of the free space that is not available to the largest
+        // possible allocation: 0 means that all free space is in a single block,
+        // values close to 1 indicate heavy fragmentation.
+        double GetFragmentation() const
+        {
+            return TotalFreeSize > 0 ?
+                1.0 - static_cast<double>(LargestFreeBlockSize) / static_cast<double>(TotalFreeSize) :
+                0.0;
+        }
+
+        void AddFreeBlock(OffsetType Size)
+        {
+            VERIFY_EXPR(Size > 0);
+            TotalFreeSize += Size;
+            LargestFreeBlockSize = std::max(LargestFreeBlockSize, Size);
+            ++NumFreeBlocks;
+            ++SizeHistogram[PlatformMisc::GetMSB(static_cast<Uint64>(Size))];
+        }
+
+        // Accumulates statistics of another free space. Since an allocation cannot span
+        // multiple free spaces, the largest block is the largest of the two.
+        FreeBlockStatistics& operator+=(const FreeBlockStatistics& rhs)
+        {
+            TotalFreeSize += rhs.TotalFreeSize;
+            LargestFreeBlockSize = std::max(LargestFreeBlockSize, rhs.LargestFreeBlockSize);
+            NumFreeBlocks += rhs.NumFreeBlocks;
+            for (Uint32 i = 0; i < NumHistogramBins; ++i)
+                SizeHistogram[i] += rhs.SizeHistogram[i];
+            return *this;
+        }
+    };
+
+    // Computes free block statistics. The method iterates through all free blocks
+    // and is intended for diagnostics rather than for use on hot paths.
+    FreeBlockStatistics GetFreeBlockStatistics() const
+    {
+        FreeBlockStatistics Stats;
+        if (m_pTLSF != nullptr)
+        {
+            m_pTLSF->ProcessFreeBlocks([&Stats](OffsetType /*Offset*/, OffsetType Size) {
+                Stats.AddFreeBlock(Size);
+            });
+        }
+        else
+        {
+            for (const auto& Block : m_FreeBlocksBySize)
+                Stats.AddFreeBlock(Block.first);
+        }
+        VERIFY_EXPR(Stats.TotalFreeSize == m_FreeSize);
+        VERIFY_EXPR(Stats.NumFreeBlocks == GetNumFreeBlocks());
+        return Stats;
+    }
+
+    // Describes relocation of a live allocation during defragmentation
+    struct DefragmentationMove
+    {
+        // clang-format off
+        DefragmentationMove(OffsetType _SrcOffset, OffsetType _DstOffset, OffsetType _Size) :
+            SrcOffset{_SrcOffset},
+            DstOffset{_DstOffset},
+            Size     {_Size     }
+        {}
+        // clang-format on
+
+        OffsetType SrcOffset = 0; // Current unaligned offset of the allocation
+        OffsetType DstOffset = 0; // New unaligned offset of the allocation
+        OffsetType Size      = 0; // Allocation size
+    };
+
+    // Plans compaction of the allocations range. Starting from the end of the range, live allocations
+    // are moved to the lowest free blocks that can hold them, so that free space coalesces at the end.
+    //
+    // pAllocations   - allocations that may be moved. Allocations that are not listed (e.g. stale allocations
+    //                  of VariableSizeGPUAllocationsManager) stay in place.
+    // Alignment      - every allocation is moved by a multiple of this value, so that the aligned data offset
+    //                  within the allocation remains aligned. Must be at least the largest alignment
+    //                  the allocations were created with.
+    // MoveBudget     - the maximum total size of the allocations to move.
+    //
+    // Destination ranges overlap neither each other nor any live allocation, so the moves may be performed in any
+    // order, e.g. as a single batch of GPU copies. The space released by the moved allocations is not reused
+    // by the same plan; running the planner again after the plan has been committed compacts the range further.
+    // The manager must not be modified until the plan is committed with CommitDefragmentation() or discarded.
+    std::vector<DefragmentationMove, STDAllocatorRawMem<DefragmentationMove>> PlanDefragmentation(const Allocation* pAllocations, size_t NumAllocations, OffsetType Alignment, OffsetType MoveBudget) const
+    {
+        VERIFY(IsPowerOfTwo(Alignment), "Alignment (", Alignment, ") must be power of 2");
+
+        // Use the same raw memory allocator as the free block maps
+        auto& Allocator = m_FreeBlocksByOffset.get_allocator().m_Allocator;
+
+        std::vector<DefragmentationMove, STDAllocatorRawMem<DefragmentationMove>> Moves(STD_ALLOCATOR_RAW_MEM(DefragmentationMove, Allocator, "Allocator for vector<DefragmentationMove>"));
+        if (NumAllocations == 0 || IsFull())
+            return Moves;
+
+        using FreeBlockRange = std::pair<OffsetType, OffsetType>;
+
+        // Free blocks sorted by offset as (offset, size) pairs
+        std::vector<FreeBlockRange, STDAllocatorRawMem<FreeBlockRange>> FreeBlocks(STD_ALLOCATOR_RAW_MEM(FreeBlockRange, Allocator, "Allocator for vector<pair<OffsetType, OffsetType>>"));
+        FreeBlocks.reserve(GetNumFreeBlocks());
+        if (m_pTLSF != nullptr)
+        {
+            m_pTLSF->ProcessFreeBlocks([&FreeBlocks](OffsetType Offset, OffsetType Size) {
+                FreeBlocks.emplace_back(Offset, Size);
+            });
+            std::sort(FreeBlocks.begin(), FreeBlocks.end());
+        }
+        else
+        {
+            for (const auto& Block : m_FreeBlocksByOffset)
+                FreeBlocks.emplace_back(Block.first, Block.second.Size);
+
+            // Offsets of all free blocks must remain aligned by the current alignment
+            Alignment = std::max(Alignment, m_CurrAlignment);
+        }
+
+        std::vector<const Allocation*, STDAllocatorRawMem<const Allocation*>> SortedAllocations(NumAllocations, nullptr, STD_ALLOCATOR_RAW_MEM(const Allocation*, Allocator, "Allocator for vector<const Allocation*>"));
+        for (size_t i = 0; i < NumAllocations; ++i)
+        {
+            VERIFY_EXPR(pAllocations[i].IsValid() && pAllocations[i].Size > 0);
+            VERIFY_EXPR(pAllocations[i].UnalignedOffset + pAllocations[i].Size <= m_MaxSize);
+            SortedAllocations[i] = &pAllocations[i];
+        }
+        std::sort(SortedAllocations.begin(), SortedAllocations.end(),
+                  [](const Allocation* pAlloc0, const Allocation* pAlloc1) {
+                      return pAlloc0->UnalignedOffset > pAlloc1->UnalignedOffset;
+                  });
+
+        for (const auto* pAlloc : SortedAllocations)
+        {
+            const auto SrcOffset = pAlloc->UnalignedOffset;
+            const auto Size      = pAlloc->Size;
+            if (Size > MoveBudget)
+                continue;
+
+            if (m_pTLSF == nullptr && ((SrcOffset + Size) & (m_CurrAlignment - 1)) != 0)
+            {
+                // The allocation ends at the unaligned end of the range. Moving it would
+                // create a free block at unaligned offset.
+                continue;
+            }
+
+            for (size_t i = 0; i < FreeBlocks.size() && FreeBlocks[i].first < SrcOffset; ++i)
+            {
+                const auto BlockOffset = FreeBlocks[i].first;
+                const auto BlockEnd    = BlockOffset + FreeBlocks[i].second;
+
+                // The first offset in the block that is congruent to the source offset
+                const auto DstOffset = BlockOffset + ((SrcOffset - BlockOffset) & (Alignment - 1));
+                // The destination must not overlap the source
+                if (DstOffset + Size > std::min(BlockEnd, SrcOffset))
+                    continue;
+
+                Moves.emplace_back(SrcOffset, DstOffset, Size);
+                MoveBudget -= Size;
+
+                //  BlockOffset          DstOffset
+                //     |                   |
+                //     |<---Remainder0---->|<-----Size----->|<--Remainder1-->|
+                //
+                if (DstOffset + Size < BlockEnd)
+                {
+                    if (DstOffset > BlockOffset)
+                    {
+                        FreeBlocks[i].second = DstOffset - BlockOffset;
+                        FreeBlocks.emplace(FreeBlocks.begin() + i + 1, DstOffset + Size, BlockEnd - (DstOffset + Size));
+                    }
+                    else
+                    {
+                        FreeBlocks[i] = std::make_pair(DstOffset + Size, BlockEnd - (DstOffset + Size));
+                    }
+                }
+                else if (DstOffset > BlockOffset)
+                {
+                    FreeBlocks[i].second = DstOffset - BlockOffset;
+                }
+                else
+                {
+                    FreeBlocks.erase(FreeBlocks.begin() + i);
+                }
+                break;
+            }
+        }
+
+        return Moves;
+    }
+
+    // Commits the plan returned by PlanDefragmentation() after all moves have been performed.
+    // Destination ranges become allocated, and source ranges are released.
+    void CommitDefragmentation(const DefragmentationMove* pMoves, size_t NumMoves)
+    {
+        // Reserve all destination ranges first since free blocks may contain both
+        // destination ranges and released source ranges
+        for (size_t i = 0; i < NumMoves; ++i)
+            AllocateRange(pMoves[i].DstOffset, pMoves[i].Size);
+
+        for (size_t i = 0; i < NumMoves; ++i)
+            Free(pMoves[i].SrcOffset, pMoves[i].Size);
     }
 
     void Extend(size_t ExtraSize)
     {
+        if (m_pTLSF != nullptr)
+        {
+            m_pTLSF->Extend(ExtraSize);
+            m_MaxSize += ExtraSize;
+            m_FreeSize += ExtraSize;
+            return;
+        }
+
         size_t NewBlockOffset = m_MaxSize;
         size_t NewBlockSize   = ExtraSize;
 
@@ -399,6 +696,65 @@ public:
     }
 
 private:
+    void DestroyTLSF()
+    {
+        if (m_pTLSF != nullptr)
+        {
+            m_pTLSF->~TLSFAllocationsManager();
+            m_pAllocator->Free(m_pTLSF);
+            m_pTLSF      = nullptr;
+            m_pAllocator = nullptr;
+        }
+    }
+
+    // Removes the [Offset, Offset + Size) range, which must be entirely contained
+    // in a single free block, from the free space
+    void AllocateRange(OffsetType Offset, OffsetType Size)
+    {
+        VERIFY_EXPR(Size > 0 && Offset + Size <= m_MaxSize);
+
+        if (m_pTLSF != nullptr)
+        {
+            if (!m_pTLSF->AllocateRange(Offset, Size))
+            {
+                UNEXPECTED("Range [", Offset, ", ", Offset + Size, ") is not free");
+                return;
+            }
+            m_FreeSize -= Size;
+            return;
+        }
+
+        // Find the last block whose offset is not greater than the range offset
+        auto BlockIt = m_FreeBlocksByOffset.upper_bound(Offset);
+        if (BlockIt == m_FreeBlocksByOffset.begin())
+        {
+            UNEXPECTED("Range [", Offset, ", ", Offset + Size, ") is not free");
+            return;
+        }
+        --BlockIt;
+
+        const auto BlockOffset = BlockIt->first;
+        const auto BlockSize   = BlockIt->second.Size;
+        if (Offset + Size > BlockOffset + BlockSize)
+        {
+            UNEXPECTED("Range [", Offset, ", ", Offset + Size, ") is not free");
+            return;
+        }
+
+        m_FreeBlocksBySize.erase(BlockIt->second.OrderBySizeIt);
+        m_FreeBlocksByOffset.erase(BlockIt);
+        if (Offset > BlockOffset)
+            AddNewBlock(BlockOffset, Offset - BlockOffset);
+        if (Offset + Size < BlockOffset + BlockSize)
+            AddNewBlock(Offset + Size, BlockOffset + BlockSize - (Offset + Size));
+
+        m_FreeSize -= Size;
+
+#ifdef DILIGENT_DEBUG
+        DbgVerifyList();
+#endif
+    }
+
     void AddNewBlock(OffsetType Offset, OffsetType Size)
     {
         auto NewBlockIt = m_FreeBlocksByOffset.emplace(Offset, Size);
@@ -458,6 +814,10 @@ private:
     OffsetType m_MaxSize       = 0;
     OffsetType m_FreeSize      = 0;
     OffsetType m_CurrAlignment = 0;
-    // When adding new members, do not forget to update move ctor
+
+    // TLSF free block manager used instead of the maps when the instance is created with STRATEGY_TLSF
+    TLSFAllocationsManager* m_pTLSF      = nullptr;
+    IMemoryAllocator*       m_pAllocator = nullptr;
+    // When adding new members, do not forget to update move ctor and move assignment
 };
 } // namespace Diligent
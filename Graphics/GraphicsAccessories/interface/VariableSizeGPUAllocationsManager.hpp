@@ -52,8 +52,8 @@ private:
     };
 
 public:
-    VariableSizeGPUAllocationsManager(OffsetType MaxSize, IMemoryAllocator& Allocator) :
-        VariableSizeAllocationsManager{MaxSize, Allocator},
+    VariableSizeGPUAllocationsManager(OffsetType MaxSize, IMemoryAllocator& Allocator, STRATEGY Strategy = STRATEGY_ORDERED_MAPS) :
+        VariableSizeAllocationsManager{MaxSize, Allocator, Strategy},
         m_StaleAllocations{0, StaleAllocationAttribs(0, 0, 0), STD_ALLOCATOR_RAW_MEM(StaleAllocationAttribs, Allocator, "Allocator for deque<StaleAllocationAttribs>")}
     {}
 
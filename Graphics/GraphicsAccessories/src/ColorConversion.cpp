@@ -27,6 +27,7 @@
 
 #include <array>
 #include <algorithm>
+#include <cstring>
 #include "ColorConversion.h"
 
 namespace Diligent
@@ -75,8 +76,154 @@ private:
     std::array<float, 256> m_ToLinear;
 };
 
+// Encodes linear values to 8-bit sRGB using piecewise-linear approximation of the sRGB curve.
+// The [2^-13, 1) range is split into 16 segments per power of two, and the segment is selected
+// by the exponent and the four most significant bits of the mantissa. Values below 2^-13 are
+// in the linear part of the curve and use the first segment.
+class LinearToSRGB8Encoder
+{
+public:
+    LinearToSRGB8Encoder() noexcept
+    {
+        auto RefSRGB = [](double x) {
+            return 255.0 * (x <= 0.0031308 ? x * 12.92 : 1.055 * std::pow(x, 1.0 / 2.4) - 0.055);
+        };
+
+        for (Uint32 i = 0; i < NumSegments; ++i)
+        {
+            const double x0 = BitsToFloat(MinValueBits + (i << SegmentShift));
+            const double x1 = BitsToFloat(MinValueBits + ((i + 1) << SegmentShift));
+
+            // Chord through the end points, shifted by half of the maximum deviation from the curve
+            const double Scale  = (RefSRGB(x1) - RefSRGB(x0)) / (x1 - x0);
+            double       MinDev = 0;
+            double       MaxDev = 0;
+            for (int s = 0; s <= 64; ++s)
+            {
+                const double x   = x0 + (x1 - x0) * s / 64.0;
+                const double Dev = RefSRGB(x) - (RefSRGB(x0) + Scale * (x - x0));
+                MinDev           = std::min(MinDev, Dev);
+                MaxDev           = std::max(MaxDev, Dev);
+            }
+
+            m_Segments[i].Scale = static_cast<float>(Scale);
+            // Add 0.5 to round to nearest by truncation
+            m_Segments[i].Bias = static_cast<float>(RefSRGB(x0) - Scale * x0 + (MinDev + MaxDev) * 0.5 + 0.5);
+        }
+    }
+
+    Uint8 operator()(float x) const
+    {
+        // Clamp the value to [0, 1) range. The argument order makes NaNs turn into 0.
+        x = std::min(std::max(0.f, x), AlmostOne);
+
+        Uint32 Bits;
+        memcpy(&Bits, &x, sizeof(Bits));
+        const Uint32   SegmentIdx = (std::max(Bits, MinValueBits) - MinValueBits) >> SegmentShift;
+        const Segment& Seg        = m_Segments[SegmentIdx];
+
+        // The result is in [0, 256) range by construction
+        return static_cast<Uint8>(Seg.Scale * x + Seg.Bias);
+    }
+
+private:
+    static float BitsToFloat(Uint32 Bits)
+    {
+        float f;
+        memcpy(&f, &Bits, sizeof(f));
+        return f;
+    }
+
+    static constexpr Uint32 MinValueBits = (127 - 13) << 23; // 2^-13
+    static constexpr Uint32 SegmentShift = 23 - 4;            // 16 segments per power of two
+    static constexpr Uint32 NumSegments  = 13 << 4;
+    static constexpr float  AlmostOne    = 1.f - 1.f / 16777216.f; // The largest float below 1
+
+    struct Segment
+    {
+        float Scale;
+        float Bias;
+    };
+    std::array<Segment, NumSegments> m_Segments;
+};
+
+constexpr Uint32 LinearToSRGB8Encoder::MinValueBits;
+constexpr float  LinearToSRGB8Encoder::AlmostOne;
+
+const SRGBToLinearMap& GetSRGBToLinearMap()
+{
+    static const SRGBToLinearMap map;
+    return map;
+}
+
+const LinearToSRGB8Encoder& GetLinearToSRGB8Encoder()
+{
+    static const LinearToSRGB8Encoder Encoder;
+    return Encoder;
+}
+
+Uint8 EncodeUNorm8(float x)
+{
+    // Also converts NaNs to 0
+    return x > 0 ? static_cast<Uint8>(std::min(x, 1.f) * 255.f + 0.5f) : 0;
+}
+
 } // namespace
 
+Uint16 FloatToHalf(float f)
+{
+    Uint32 Bits;
+    memcpy(&Bits, &f, sizeof(Bits));
+
+    const Uint16 Sign = static_cast<Uint16>((Bits >> 16) & 0x8000);
+    Bits &= 0x7FFFFFFF;
+
+    if (Bits >= 0x7F800000) // Inf or NaN
+        return Sign | 0x7C00 | (Bits > 0x7F800000 ? 0x200 : 0);
+    if (Bits >= 0x477FF000) // Values that round above the largest half (65504)
+        return Sign | 0x7C00;
+    if (Bits < 0x38800000) // Values below 2^-14 become denormals
+    {
+        float Abs;
+        memcpy(&Abs, &Bits, sizeof(Abs));
+        // Scaling by a power of two is exact, and the result rounds to the nearest even integer
+        return Sign | static_cast<Uint16>(std::nearbyint(Abs * 16777216.f));
+    }
+
+    // Rebias the exponent and round the mantissa to nearest even
+    Bits -= (127 - 15) << 23;
+    Bits += 0xFFF + ((Bits >> 13) & 1);
+    return Sign | static_cast<Uint16>(Bits >> 13);
+}
+
+float HalfToFloat(Uint16 h)
+{
+    const Uint32 Sign     = static_cast<Uint32>(h & 0x8000) << 16;
+    const Uint32 Exponent = (h >> 10) & 0x1F;
+    const Uint32 Mantissa = h & 0x3FF;
+
+    Uint32 Bits = 0;
+    if (Exponent == 0)
+    {
+        // Zero or denormal: the value is exactly representable as float
+        const float Abs = static_cast<float>(Mantissa) / 16777216.f;
+        memcpy(&Bits, &Abs, sizeof(Bits));
+        Bits |= Sign;
+    }
+    else if (Exponent == 0x1F)
+    {
+        Bits = Sign | 0x7F800000 | (Mantissa << 13);
+    }
+    else
+    {
+        Bits = Sign | ((Exponent + 127 - 15) << 23) | (Mantissa << 13);
+    }
+
+    float f;
+    memcpy(&f, &Bits, sizeof(f));
+    return f;
+}
+
 float LinearToSRGB(Uint8 x)
 {
     static const LinearToSRGBMap map;
@@ -85,8 +232,85 @@ float LinearToSRGB(Uint8 x)
 
 float SRGBToLinear(Uint8 x)
 {
-    static const SRGBToLinearMap map;
-    return map[x];
+    return GetSRGBToLinearMap()[x];
+}
+
+void SRGBToLinear(const Uint8* pSRGB, float* pLinear, size_t NumValues)
+{
+    const SRGBToLinearMap& Map = GetSRGBToLinearMap();
+    for (size_t i = 0; i < NumValues; ++i)
+        pLinear[i] = Map[pSRGB[i]];
+}
+
+void LinearToSRGB(const float* pLinear, Uint8* pSRGB, size_t NumValues)
+{
+    const LinearToSRGB8Encoder& Encoder = GetLinearToSRGB8Encoder();
+    for (size_t i = 0; i < NumValues; ++i)
+        pSRGB[i] = Encoder(pLinear[i]);
+}
+
+void SRGBA8ToLinearRGBA32F(const Uint8* pSrc, float* pDst, size_t NumPixels)
+{
+    const SRGBToLinearMap& Map = GetSRGBToLinearMap();
+    for (size_t i = 0; i < NumPixels * 4; i += 4)
+    {
+        pDst[i + 0] = Map[pSrc[i + 0]];
+        pDst[i + 1] = Map[pSrc[i + 1]];
+        pDst[i + 2] = Map[pSrc[i + 2]];
+        pDst[i + 3] = static_cast<float>(pSrc[i + 3]) / 255.f;
+    }
+}
+
+void SRGBA8ToLinearRGBA16F(const Uint8* pSrc, Uint16* pDst, size_t NumPixels)
+{
+    // Both sRGB and UNORM decoding tables are tiny, so the results are converted to half in advance
+    struct HalfMaps
+    {
+        std::array<Uint16, 256> SRGB;
+        std::array<Uint16, 256> UNorm;
+
+        HalfMaps() noexcept
+        {
+            for (Uint32 i = 0; i < 256; ++i)
+            {
+                SRGB[i]  = FloatToHalf(SRGBToLinear(static_cast<Uint8>(i)));
+                UNorm[i] = FloatToHalf(static_cast<float>(i) / 255.f);
+            }
+        }
+    };
+    static const HalfMaps Maps;
+
+    for (size_t i = 0; i < NumPixels * 4; i += 4)
+    {
+        pDst[i + 0] = Maps.SRGB[pSrc[i + 0]];
+        pDst[i + 1] = Maps.SRGB[pSrc[i + 1]];
+        pDst[i + 2] = Maps.SRGB[pSrc[i + 2]];
+        pDst[i + 3] = Maps.UNorm[pSrc[i + 3]];
+    }
+}
+
+void LinearRGBA32FToSRGBA8(const float* pSrc, Uint8* pDst, size_t NumPixels)
+{
+    const LinearToSRGB8Encoder& Encoder = GetLinearToSRGB8Encoder();
+    for (size_t i = 0; i < NumPixels * 4; i += 4)
+    {
+        pDst[i + 0] = Encoder(pSrc[i + 0]);
+        pDst[i + 1] = Encoder(pSrc[i + 1]);
+        pDst[i + 2] = Encoder(pSrc[i + 2]);
+        pDst[i + 3] = EncodeUNorm8(pSrc[i + 3]);
+    }
+}
+
+void LinearRGBA16FToSRGBA8(const Uint16* pSrc, Uint8* pDst, size_t NumPixels)
+{
+    const LinearToSRGB8Encoder& Encoder = GetLinearToSRGB8Encoder();
+    for (size_t i = 0; i < NumPixels * 4; i += 4)
+    {
+        pDst[i + 0] = Encoder(HalfToFloat(pSrc[i + 0]));
+        pDst[i + 1] = Encoder(HalfToFloat(pSrc[i + 1]));
+        pDst[i + 2] = Encoder(HalfToFloat(pSrc[i + 2]));
+        pDst[i + 3] = EncodeUNorm8(HalfToFloat(pSrc[i + 3]));
+    }
 }
 
 } // namespace Diligent
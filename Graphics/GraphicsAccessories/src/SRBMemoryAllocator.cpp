@@ -25,24 +25,129 @@
  *  of the possibility of such damages.
  */
 
+#include <algorithm>
+#include <mutex>
+#include <memory>
+#include <unordered_map>
+
 #include "SRBMemoryAllocator.hpp"
+#include "PlatformMisc.hpp"
+#include "Align.hpp"
 
 namespace Diligent
 {
 
+namespace
+{
+
+// Size-class pools shared by all SRB memory allocators
+class SRBMemoryPoolRegistry
+{
+public:
+    static SRBMemoryPoolRegistry& Get()
+    {
+        // The registry is intentionally never destroyed. Pools that are still alive at exit
+        // would otherwise be destroyed after the statics that FixedBlockMemoryAllocator
+        // uses to manage thread caches.
+        static SRBMemoryPoolRegistry* const pRegistry = new SRBMemoryPoolRegistry{};
+        return *pRegistry;
+    }
+
+    FixedBlockMemoryAllocator& AcquirePool(size_t BlockSize, Uint32 NumBlocksInFirstPage)
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+
+        auto& Pool = m_Pools[BlockSize];
+        if (!Pool.pAllocator)
+        {
+            // SRBs are often created from multiple threads, so let every thread cache a few blocks
+            const auto ThreadCacheSize    = std::min(NumBlocksInFirstPage / 2, Uint32{16});
+            const auto MaxNumBlocksInPage = std::max(static_cast<Uint32>(MaxPageSize / BlockSize), NumBlocksInFirstPage);
+            Pool.pAllocator.reset(new FixedBlockMemoryAllocator{GetRawAllocator(), BlockSize, NumBlocksInFirstPage, ThreadCacheSize, false, MaxNumBlocksInPage});
+        }
+        ++Pool.RefCount;
+        return *Pool.pAllocator;
+    }
+
+    void ReleasePool(FixedBlockMemoryAllocator& Allocator)
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+
+        auto it = m_Pools.find(Allocator.GetBlockSize());
+        if (it == m_Pools.end() || it->second.pAllocator.get() != &Allocator)
+        {
+            UNEXPECTED("The pool is not found in the registry");
+            return;
+        }
+
+        VERIFY_EXPR(it->second.RefCount > 0);
+        if (--it->second.RefCount == 0)
+            m_Pools.erase(it);
+    }
+
+    SRBMemoryPoolStats GetStats()
+    {
+        std::lock_guard<std::mutex> Lock{m_Mtx};
+
+        SRBMemoryPoolStats Stats;
+        Stats.NumPools = m_Pools.size();
+        for (auto& it : m_Pools)
+        {
+            const auto PoolStats = it.second.pAllocator->GetStatistics();
+            Stats.NumPages += PoolStats.NumPages;
+            Stats.ReservedSize += PoolStats.ReservedSize;
+            Stats.AllocatedSize += PoolStats.NumAllocatedBlocks * it.first;
+        }
+        return Stats;
+    }
+
+private:
+    // Pages stop growing when they reach this size
+    static constexpr size_t MaxPageSize = 64 << 10;
+
+    struct PoolInfo
+    {
+        std::unique_ptr<FixedBlockMemoryAllocator> pAllocator;
+        Uint32                                     RefCount = 0;
+    };
+
+    std::mutex                           m_Mtx;
+    std::unordered_map<size_t, PoolInfo> m_Pools;
+};
+
+} // namespace
+
 SRBMemoryAllocator::~SRBMemoryAllocator()
 {
     if (m_DataAllocators != nullptr)
     {
-        auto TotalAllocatorCount = m_ShaderVariableDataAllocatorCount + m_ResourceCacheDataAllocatorCount;
+        auto& Registry            = SRBMemoryPoolRegistry::Get();
+        auto  TotalAllocatorCount = m_ShaderVariableDataAllocatorCount + m_ResourceCacheDataAllocatorCount;
         for (Uint32 s = 0; s < TotalAllocatorCount; ++s)
         {
-            m_DataAllocators[s].~FixedBlockMemoryAllocator();
+            auto& DataAllocator = m_DataAllocators[s];
+            VERIFY(DataAllocator.GetNumAllocations() == 0, "Memory leak detected: not all SRB data has been released");
+            Registry.ReleasePool(DataAllocator.GetPool());
+            DataAllocator.~DataAllocator();
         }
         m_RawMemAllocator.Free(m_DataAllocators);
     }
 }
 
+size_t SRBMemoryAllocator::GetSizeClass(size_t DataSize)
+{
+    // Small sizes are rounded up to a multiple of 16 bytes. Larger sizes are rounded up to one of
+    // four classes between consecutive powers of two, so that less than 25% of a block is wasted.
+    constexpr size_t MinGranularity = 16;
+
+    DataSize = std::max(DataSize, size_t{1});
+    if (DataSize <= MinGranularity * 8)
+        return Align(DataSize, MinGranularity);
+
+    const auto Granularity = (size_t{1} << PlatformMisc::GetMSB(DataSize - 1)) / 4;
+    return Align(DataSize, Granularity);
+}
+
 void SRBMemoryAllocator::Initialize(Uint32              SRBAllocationGranularity,
                                     Uint32              ShaderVariableDataAllocatorCount,
                                     const size_t* const ShaderVariableDataSizes,
@@ -60,16 +165,38 @@ void SRBMemoryAllocator::Initialize(Uint32              SRBAllocationGranularity
         return;
 
     auto* pAllocatorsRawMem = m_RawMemAllocator.Allocate(
-        sizeof(FixedBlockMemoryAllocator) * TotalAllocatorCount,
-        "Raw memory for SRBMemoryAllocator::m_ShaderVariableDataAllocators",
+        sizeof(DataAllocator) * TotalAllocatorCount,
+        "Raw memory for SRBMemoryAllocator::m_DataAllocators",
         __FILE__, __LINE__);
-    m_DataAllocators = reinterpret_cast<FixedBlockMemoryAllocator*>(pAllocatorsRawMem);
+    m_DataAllocators = reinterpret_cast<DataAllocator*>(pAllocatorsRawMem);
 
+    auto& Registry = SRBMemoryPoolRegistry::Get();
     for (Uint32 s = 0; s < TotalAllocatorCount; ++s)
     {
-        auto size = s < ShaderVariableDataAllocatorCount ? ShaderVariableDataSizes[s] : ResourceCacheDataSizes[s - ShaderVariableDataAllocatorCount];
-        new (m_DataAllocators + s) FixedBlockMemoryAllocator(GetRawAllocator(), size, SRBAllocationGranularity);
+        auto  size = s < ShaderVariableDataAllocatorCount ? ShaderVariableDataSizes[s] : ResourceCacheDataSizes[s - ShaderVariableDataAllocatorCount];
+        auto& Pool = Registry.AcquirePool(GetSizeClass(size), SRBAllocationGranularity);
+        new (m_DataAllocators + s) DataAllocator(Pool, size);
     }
 }
 
+SRBMemoryStats SRBMemoryAllocator::GetStats() const
+{
+    SRBMemoryStats Stats;
+    auto           TotalAllocatorCount = m_ShaderVariableDataAllocatorCount + m_ResourceCacheDataAllocatorCount;
+    for (Uint32 s = 0; m_DataAllocators != nullptr && s < TotalAllocatorCount; ++s)
+    {
+        const auto& DataAllocator  = m_DataAllocators[s];
+        const auto  NumAllocations = DataAllocator.GetNumAllocations();
+        Stats.NumAllocations += NumAllocations;
+        Stats.RequestedSize += NumAllocations * DataAllocator.GetDataSize();
+        Stats.AllocatedSize += NumAllocations * DataAllocator.GetPool().GetBlockSize();
+    }
+    return Stats;
+}
+
+SRBMemoryPoolStats SRBMemoryAllocator::GetPoolStats()
+{
+    return SRBMemoryPoolRegistry::Get().GetStats();
+}
+
 } // namespace Diligent
@@ -0,0 +1,1138 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "TextureMipGenerator.hpp"
+#include "GraphicsAccessories.hpp"
+#include "ColorConversion.h"
+#include "BasicMath.hpp"
+#include "DebugUtilities.hpp"
+
+namespace Diligent
+{
+
+namespace
+{
+
+// Converts texel rows to and from 32-bit float channels.
+// Decode and Encode process NumElements elements, where an element is a single channel value
+// for plain formats and a whole texel for packed formats.
+struct TexelCodec
+{
+    using DecodeFuncType = void (*)(const void* pSrc, float* pDst, size_t NumElements);
+    using EncodeFuncType = void (*)(const float* pSrc, void* pDst, size_t NumElements);
+
+    DecodeFuncType Decode = nullptr;
+    EncodeFuncType Encode = nullptr;
+
+    Uint32 NumChannels      = 0;
+    Uint32 ElementsPerTexel = 0;
+
+    // Index of the normalized alpha channel, or -1 if there is none
+    Int32 AlphaChannel = -1;
+};
+
+template <typename CodecType>
+TexelCodec MakeTexelCodec(Uint32 NumChannels, Uint32 ElementsPerTexel, Int32 AlphaChannel)
+{
+    TexelCodec Codec;
+    Codec.Decode           = CodecType::Decode;
+    Codec.Encode           = CodecType::Encode;
+    Codec.NumChannels      = NumChannels;
+    Codec.ElementsPerTexel = ElementsPerTexel;
+    Codec.AlphaChannel     = AlphaChannel;
+    return Codec;
+}
+
+// Clamps x to [0, 1] and converts it to an unsigned normalized value with MaxValue quantization steps.
+// NaNs are converted to 0.
+inline Uint32 EncodeUNorm(float x, Uint32 MaxValue)
+{
+    return x > 0 ? static_cast<Uint32>(std::min(x, 1.f) * static_cast<float>(MaxValue) + 0.5f) : 0;
+}
+
+template <typename T>
+struct UNormCodec
+{
+    static void Decode(const void* pSrc, float* pDst, size_t NumElements)
+    {
+        const auto* pValues = static_cast<const T*>(pSrc);
+        const float Scale   = 1.f / static_cast<float>(std::numeric_limits<T>::max());
+        for (size_t i = 0; i < NumElements; ++i)
+            pDst[i] = static_cast<float>(pValues[i]) * Scale;
+    }
+
+    static void Encode(const float* pSrc, void* pDst, size_t NumElements)
+    {
+        auto* pValues = static_cast<T*>(pDst);
+        for (size_t i = 0; i < NumElements; ++i)
+            pValues[i] = static_cast<T>(EncodeUNorm(pSrc[i], std::numeric_limits<T>::max()));
+    }
+};
+
+template <typename T>
+struct SNormCodec
+{
+    static void Decode(const void* pSrc, float* pDst, size_t NumElements)
+    {
+        const auto* pValues = static_cast<const T*>(pSrc);
+        const float Scale   = 1.f / static_cast<float>(std::numeric_limits<T>::max());
+        // The most negative value maps to -1 as well as the next one
+        for (size_t i = 0; i < NumElements; ++i)
+            pDst[i] = std::max(static_cast<float>(pValues[i]) * Scale, -1.f);
+    }
+
+    static void Encode(const float* pSrc, void* pDst, size_t NumElements)
+    {
+        auto*       pValues = static_cast<T*>(pDst);
+        const float Max     = static_cast<float>(std::numeric_limits<T>::max());
+        for (size_t i = 0; i < NumElements; ++i)
+        {
+            float x = pSrc[i];
+            // Clamps to [-1, 1] and converts NaNs to 0
+            x          = x > -1.f ? (x < 1.f ? x : 1.f) : (x <= -1.f ? -1.f : 0.f);
+            x          = x * Max;
+            pValues[i] = static_cast<T>(x >= 0 ? x + 0.5f : x - 0.5f);
+        }
+    }
+};
+
+template <typename T>
+struct IntCodec
+{
+    static void Decode(const void* pSrc, float* pDst, size_t NumElements)
+    {
+        const auto* pValues = static_cast<const T*>(pSrc);
+        for (size_t i = 0; i < NumElements; ++i)
+            pDst[i] = static_cast<float>(pValues[i]);
+    }
+
+    static void Encode(const float* pSrc, void* pDst, size_t NumElements)
+    {
+        auto* pValues = static_cast<T*>(pDst);
+        // Double precision is required to represent the range of 32-bit integers
+        const double Min = static_cast<double>(std::numeric_limits<T>::min());
+        const double Max = static_cast<double>(std::numeric_limits<T>::max());
+        for (size_t i = 0; i < NumElements; ++i)
+        {
+            const double x = std::floor(static_cast<double>(pSrc[i]) + 0.5);
+            // NaNs are converted to 0
+            pValues[i] = static_cast<T>(x > Min ? (x < Max ? x : Max) : (x <= Min ? Min : 0.0));
+        }
+    }
+};
+
+struct Float32Codec
+{
+    static void Decode(const void* pSrc, float* pDst, size_t NumElements)
+    {
+        memcpy(pDst, pSrc, NumElements * sizeof(float));
+    }
+
+    static void Encode(const float* pSrc, void* pDst, size_t NumElements)
+    {
+        memcpy(pDst, pSrc, NumElements * sizeof(float));
+    }
+};
+
+struct Float16Codec
+{
+    static void Decode(const void* pSrc, float* pDst, size_t NumElements)
+    {
+        const auto* pValues = static_cast<const Uint16*>(pSrc);
+        for (size_t i = 0; i < NumElements; ++i)
+            pDst[i] = HalfToFloat(pValues[i]);
+    }
+
+    static void Encode(const float* pSrc, void* pDst, size_t NumElements)
+    {
+        auto* pValues = static_cast<Uint16*>(pDst);
+        for (size_t i = 0; i < NumElements; ++i)
+            pValues[i] = FloatToHalf(pSrc[i]);
+    }
+};
+
+// Four-channel 8-bit sRGB formats. Color channels are converted to linear space, alpha is linear.
+struct SRGBA8Codec
+{
+    static void Decode(const void* pSrc, float* pDst, size_t NumTexels)
+    {
+        SRGBA8ToLinearRGBA32F(static_cast<const Uint8*>(pSrc), pDst, NumTexels);
+    }
+
+    static void Encode(const float* pSrc, void* pDst, size_t NumTexels)
+    {
+        LinearRGBA32FToSRGBA8(pSrc, static_cast<Uint8*>(pDst), NumTexels);
+    }
+};
+
+// Packed formats are described by the bit widths of their channels, starting from the least significant bits
+template <typename T, Uint32 Bits0, Uint32 Bits1, Uint32 Bits2, Uint32 Bits3>
+struct PackedUNormCodec
+{
+    static constexpr Uint32 NumChannels = Bits3 != 0 ? 4 : 3;
+
+    static void Decode(const void* pSrc, float* pDst, size_t NumTexels)
+    {
+        const auto* pTexels = static_cast<const T*>(pSrc);
+        for (size_t i = 0; i < NumTexels; ++i)
+        {
+            const Uint32 Texel = pTexels[i];
+            float*       pDstTexel{pDst + i * NumChannels};
+
+            pDstTexel[0] = DecodeChannel<Bits0>(Texel);
+            pDstTexel[1] = DecodeChannel<Bits1>(Texel >> Bits0);
+            pDstTexel[2] = DecodeChannel<Bits2>(Texel >> (Bits0 + Bits1));
+            if (Bits3 != 0)
+                pDstTexel[3] = DecodeChannel<Bits3>(Texel >> (Bits0 + Bits1 + Bits2));
+        }
+    }
+
+    static void Encode(const float* pSrc, void* pDst, size_t NumTexels)
+    {
+        auto* pTexels = static_cast<T*>(pDst);
+        for (size_t i = 0; i < NumTexels; ++i)
+        {
+            const float* pSrcTexel{pSrc + i * NumChannels};
+
+            Uint32 Texel = EncodeUNorm(pSrcTexel[0], MaxValue<Bits0>());
+            Texel |= EncodeUNorm(pSrcTexel[1], MaxValue<Bits1>()) << Bits0;
+            Texel |= EncodeUNorm(pSrcTexel[2], MaxValue<Bits2>()) << (Bits0 + Bits1);
+            if (Bits3 != 0)
+                Texel |= EncodeUNorm(pSrcTexel[3], MaxValue<Bits3>()) << (Bits0 + Bits1 + Bits2);
+            pTexels[i] = static_cast<T>(Texel);
+        }
+    }
+
+private:
+    template <Uint32 Bits>
+    static constexpr Uint32 MaxValue()
+    {
+        return (1u << Bits) - 1u;
+    }
+
+    template <Uint32 Bits>
+    static float DecodeChannel(Uint32 Value)
+    {
+        return static_cast<float>(Value & MaxValue<Bits>()) / static_cast<float>(MaxValue<Bits>());
+    }
+};
+
+struct RGB10A2UIntCodec
+{
+    static void Decode(const void* pSrc, float* pDst, size_t NumTexels)
+    {
+        const auto* pTexels = static_cast<const Uint32*>(pSrc);
+        for (size_t i = 0; i < NumTexels; ++i)
+        {
+            const Uint32 Texel = pTexels[i];
+
+            pDst[i * 4 + 0] = static_cast<float>(Texel & 0x3FF);
+            pDst[i * 4 + 1] = static_cast<float>((Texel >> 10) & 0x3FF);
+            pDst[i * 4 + 2] = static_cast<float>((Texel >> 20) & 0x3FF);
+            pDst[i * 4 + 3] = static_cast<float>(Texel >> 30);
+        }
+    }
+
+    static void Encode(const float* pSrc, void* pDst, size_t NumTexels)
+    {
+        auto* pTexels = static_cast<Uint32*>(pDst);
+        for (size_t i = 0; i < NumTexels; ++i)
+        {
+            Uint32 Texel = EncodeUInt(pSrc[i * 4 + 0], 0x3FF);
+            Texel |= EncodeUInt(pSrc[i * 4 + 1], 0x3FF) << 10;
+            Texel |= EncodeUInt(pSrc[i * 4 + 2], 0x3FF) << 20;
+            Texel |= EncodeUInt(pSrc[i * 4 + 3], 0x3) << 30;
+            pTexels[i] = Texel;
+        }
+    }
+
+private:
+    static Uint32 EncodeUInt(float x, Uint32 MaxValue)
+    {
+        return x > 0 ? static_cast<Uint32>(std::min(x + 0.5f, static_cast<float>(MaxValue))) : 0;
+    }
+};
+
+// Three 10-bit channels with 2.8 fixed point encoding and the bias of 0x180, and the 2-bit alpha
+struct XRBiasCodec
+{
+    static void Decode(const void* pSrc, float* pDst, size_t NumTexels)
+    {
+        const auto* pTexels = static_cast<const Uint32*>(pSrc);
+        for (size_t i = 0; i < NumTexels; ++i)
+        {
+            const Uint32 Texel = pTexels[i];
+
+            pDst[i * 4 + 0] = DecodeXR(Texel & 0x3FF);
+            pDst[i * 4 + 1] = DecodeXR((Texel >> 10) & 0x3FF);
+            pDst[i * 4 + 2] = DecodeXR((Texel >> 20) & 0x3FF);
+            pDst[i * 4 + 3] = static_cast<float>(Texel >> 30) / 3.f;
+        }
+    }
+
+    static void Encode(const float* pSrc, void* pDst, size_t NumTexels)
+    {
+        auto* pTexels = static_cast<Uint32*>(pDst);
+        for (size_t i = 0; i < NumTexels; ++i)
+        {
+            Uint32 Texel = EncodeXR(pSrc[i * 4 + 0]);
+            Texel |= EncodeXR(pSrc[i * 4 + 1]) << 10;
+            Texel |= EncodeXR(pSrc[i * 4 + 2]) << 20;
+            Texel |= EncodeUNorm(pSrc[i * 4 + 3], 0x3) << 30;
+            pTexels[i] = Texel;
+        }
+    }
+
+private:
+    static float DecodeXR(Uint32 Value)
+    {
+        return (static_cast<float>(Value) - 384.f) / 510.f;
+    }
+
+    static Uint32 EncodeXR(float x)
+    {
+        // Maps [-0.7529, 1.2529] to [0, 1023]
+        return EncodeUNorm((x * 510.f + 384.f) / 1023.f, 0x3FF);
+    }
+};
+
+// Unsigned 11- and 10-bit floats have the same 5-bit exponent as 16-bit floats
+inline float DecodeUFloat(Uint32 Value, Uint32 MantissaBits)
+{
+    return HalfToFloat(static_cast<Uint16>(Value << (10 - MantissaBits)));
+}
+
+inline Uint32 EncodeUFloat(float x, Uint32 MantissaBits)
+{
+    // Negative values and NaNs are converted to 0
+    if (!(x > 0))
+        return 0;
+
+    const Uint32 MaxFinite = (0x1Eu << MantissaBits) | ((1u << MantissaBits) - 1u);
+    const Uint32 Shift     = 10 - MantissaBits;
+
+    Uint32 Half = FloatToHalf(x);
+    if (Half >= 0x7C00)
+        return MaxFinite;
+
+    // Round to nearest even
+    Half += (1u << (Shift - 1)) - 1u + ((Half >> Shift) & 1u);
+    return std::min(Half >> Shift, MaxFinite);
+}
+
+struct R11G11B10FloatCodec
+{
+    static void Decode(const void* pSrc, float* pDst, size_t NumTexels)
+    {
+        const auto* pTexels = static_cast<const Uint32*>(pSrc);
+        for (size_t i = 0; i < NumTexels; ++i)
+        {
+            const Uint32 Texel = pTexels[i];
+
+            pDst[i * 3 + 0] = DecodeUFloat(Texel & 0x7FF, 6);
+            pDst[i * 3 + 1] = DecodeUFloat((Texel >> 11) & 0x7FF, 6);
+            pDst[i * 3 + 2] = DecodeUFloat(Texel >> 22, 5);
+        }
+    }
+
+    static void Encode(const float* pSrc, void* pDst, size_t NumTexels)
+    {
+        auto* pTexels = static_cast<Uint32*>(pDst);
+        for (size_t i = 0; i < NumTexels; ++i)
+        {
+            pTexels[i] =
+                EncodeUFloat(pSrc[i * 3 + 0], 6) |
+                (EncodeUFloat(pSrc[i * 3 + 1], 6) << 11) |
+                (EncodeUFloat(pSrc[i * 3 + 2], 5) << 22);
+        }
+    }
+};
+
+// Three 9-bit mantissas with a shared 5-bit exponent, see
+// https://www.khronos.org/registry/OpenGL/extensions/EXT/EXT_texture_shared_exponent.txt
+struct RGB9E5Codec
+{
+    static void Decode(const void* pSrc, float* pDst, size_t NumTexels)
+    {
+        const auto* pTexels = static_cast<const Uint32*>(pSrc);
+        for (size_t i = 0; i < NumTexels; ++i)
+        {
+            const Uint32 Texel = pTexels[i];
+            const float  Scale = std::ldexp(1.f, static_cast<int>(Texel >> 27) - ExpBias - MantissaBits);
+
+            pDst[i * 3 + 0] = static_cast<float>(Texel & 0x1FF) * Scale;
+            pDst[i * 3 + 1] = static_cast<float>((Texel >> 9) & 0x1FF) * Scale;
+            pDst[i * 3 + 2] = static_cast<float>((Texel >> 18) & 0x1FF) * Scale;
+        }
+    }
+
+    static void Encode(const float* pSrc, void* pDst, size_t NumTexels)
+    {
+        auto* pTexels = static_cast<Uint32*>(pDst);
+        for (size_t i = 0; i < NumTexels; ++i)
+            pTexels[i] = EncodeTexel(pSrc + i * 3);
+    }
+
+private:
+    static constexpr int ExpBias      = 15;
+    static constexpr int MantissaBits = 9;
+    static constexpr int MaxExp       = 31;
+
+    static Uint32 EncodeTexel(const float* pRGB)
+    {
+        // (2^9 - 1) / 2^9 * 2^(31 - 15)
+        const float MaxValue = 65408.f;
+
+        float RGB[3];
+        for (size_t c = 0; c < 3; ++c)
+        {
+            // Also converts NaNs to 0
+            RGB[c] = pRGB[c] > 0 ? std::min(pRGB[c], MaxValue) : 0.f;
+        }
+
+        const float MaxRGB = std::max(std::max(RGB[0], RGB[1]), RGB[2]);
+
+        int Exp = -ExpBias - 1; // floor(log2(MaxRGB)), clamped
+        if (MaxRGB > 0)
+        {
+            int MaxRGBExp = 0;
+            std::frexp(MaxRGB, &MaxRGBExp);
+            Exp = std::max(Exp, MaxRGBExp - 1);
+        }
+        int SharedExp = Exp + 1 + ExpBias;
+
+        float Scale = std::ldexp(1.f, -(SharedExp - ExpBias - MantissaBits));
+        if (static_cast<int>(std::floor(MaxRGB * Scale + 0.5f)) == (1 << MantissaBits))
+        {
+            Scale *= 0.5f;
+            ++SharedExp;
+        }
+        VERIFY_EXPR(SharedExp >= 0 && SharedExp <= MaxExp);
+
+        Uint32 Texel = static_cast<Uint32>(SharedExp) << 27;
+        for (Uint32 c = 0; c < 3; ++c)
+            Texel |= static_cast<Uint32>(std::floor(RGB[c] * Scale + 0.5f)) << (c * 9);
+        return Texel;
+    }
+};
+
+constexpr int RGB9E5Codec::ExpBias;
+constexpr int RGB9E5Codec::MantissaBits;
+constexpr int RGB9E5Codec::MaxExp;
+
+// Returns the codec for the format, or the codec with null functions if the format is not supported
+TexelCodec GetTexelCodec(TEXTURE_FORMAT Format)
+{
+    switch (Format)
+    {
+        // clang-format off
+        case TEX_FORMAT_RGB10A2_UNORM:              return MakeTexelCodec<PackedUNormCodec<Uint32, 10, 10, 10, 2>>(4, 1, 3);
+        case TEX_FORMAT_RGB10A2_UINT:               return MakeTexelCodec<RGB10A2UIntCodec>(4, 1, -1);
+        case TEX_FORMAT_R10G10B10_XR_BIAS_A2_UNORM: return MakeTexelCodec<XRBiasCodec>(4, 1, 3);
+        case TEX_FORMAT_R11G11B10_FLOAT:            return MakeTexelCodec<R11G11B10FloatCodec>(3, 1, -1);
+        case TEX_FORMAT_RGB9E5_SHAREDEXP:           return MakeTexelCodec<RGB9E5Codec>(3, 1, -1);
+        case TEX_FORMAT_B5G6R5_UNORM:               return MakeTexelCodec<PackedUNormCodec<Uint16, 5, 6, 5, 0>>(3, 1, -1);
+        case TEX_FORMAT_B5G5R5A1_UNORM:             return MakeTexelCodec<PackedUNormCodec<Uint16, 5, 5, 5, 1>>(4, 1, 3);
+        case TEX_FORMAT_RGBA8_UNORM_SRGB:
+        case TEX_FORMAT_BGRA8_UNORM_SRGB:           return MakeTexelCodec<SRGBA8Codec>(4, 1, 3);
+        case TEX_FORMAT_BGRX8_UNORM_SRGB:           return MakeTexelCodec<SRGBA8Codec>(4, 1, -1);
+        // clang-format on
+
+        case TEX_FORMAT_R1_UNORM:
+        case TEX_FORMAT_RG8_B8G8_UNORM:
+        case TEX_FORMAT_G8R8_G8B8_UNORM:
+            return TexelCodec{};
+
+        default:
+            break;
+    }
+
+    const auto& FmtAttribs = GetTextureFormatAttribs(Format);
+    if (FmtAttribs.IsTypeless)
+        return TexelCodec{};
+
+    const Uint32 NumChannels  = FmtAttribs.NumComponents;
+    const Int32  AlphaChannel = (Format == TEX_FORMAT_A8_UNORM) ? 0 : (NumChannels == 4 && Format != TEX_FORMAT_BGRX8_UNORM ? 3 : -1);
+    switch (FmtAttribs.ComponentType)
+    {
+        case COMPONENT_TYPE_FLOAT:
+            if (FmtAttribs.ComponentSize == 4)
+                return MakeTexelCodec<Float32Codec>(NumChannels, NumChannels, AlphaChannel);
+            else if (FmtAttribs.ComponentSize == 2)
+                return MakeTexelCodec<Float16Codec>(NumChannels, NumChannels, AlphaChannel);
+            break;
+
+        case COMPONENT_TYPE_UNORM:
+            if (FmtAttribs.ComponentSize == 1)
+                return MakeTexelCodec<UNormCodec<Uint8>>(NumChannels, NumChannels, AlphaChannel);
+            else if (FmtAttribs.ComponentSize == 2)
+                return MakeTexelCodec<UNormCodec<Uint16>>(NumChannels, NumChannels, AlphaChannel);
+            break;
+
+        case COMPONENT_TYPE_SNORM:
+            if (FmtAttribs.ComponentSize == 1)
+                return MakeTexelCodec<SNormCodec<Int8>>(NumChannels, NumChannels, AlphaChannel);
+            else if (FmtAttribs.ComponentSize == 2)
+                return MakeTexelCodec<SNormCodec<Int16>>(NumChannels, NumChannels, AlphaChannel);
+            break;
+
+        case COMPONENT_TYPE_UINT:
+            if (FmtAttribs.ComponentSize == 1)
+                return MakeTexelCodec<IntCodec<Uint8>>(NumChannels, NumChannels, -1);
+            else if (FmtAttribs.ComponentSize == 2)
+                return MakeTexelCodec<IntCodec<Uint16>>(NumChannels, NumChannels, -1);
+            else if (FmtAttribs.ComponentSize == 4)
+                return MakeTexelCodec<IntCodec<Uint32>>(NumChannels, NumChannels, -1);
+            break;
+
+        case COMPONENT_TYPE_SINT:
+            if (FmtAttribs.ComponentSize == 1)
+                return MakeTexelCodec<IntCodec<Int8>>(NumChannels, NumChannels, -1);
+            else if (FmtAttribs.ComponentSize == 2)
+                return MakeTexelCodec<IntCodec<Int16>>(NumChannels, NumChannels, -1);
+            else if (FmtAttribs.ComponentSize == 4)
+                return MakeTexelCodec<IntCodec<Int32>>(NumChannels, NumChannels, -1);
+            break;
+
+        case COMPONENT_TYPE_DEPTH:
+            if (FmtAttribs.ComponentSize == 4)
+                return MakeTexelCodec<Float32Codec>(1, 1, -1);
+            else if (FmtAttribs.ComponentSize == 2)
+                return MakeTexelCodec<UNormCodec<Uint16>>(1, 1, -1);
+            break;
+
+        default:
+            break;
+    }
+
+    return TexelCodec{};
+}
+
+// Texel taps of a one-dimensional filter that maps SrcSize texels to DstSize texels
+struct FilterTaps
+{
+    // Taps of the destination texel i are in [Offsets[i], Offsets[i + 1])
+    std::vector<Uint32> Offsets;
+    std::vector<Uint32> Indices;
+    std::vector<float>  Weights;
+
+    Uint32 GetMaxTaps() const
+    {
+        Uint32 MaxTaps = 0;
+        for (size_t i = 0; i + 1 < Offsets.size(); ++i)
+            MaxTaps = std::max(MaxTaps, Offsets[i + 1] - Offsets[i]);
+        return MaxTaps;
+    }
+};
+
+Uint32 ResolveTexelCoord(Int32 i, Uint32 Size, TEXTURE_ADDRESS_MODE AddressMode)
+{
+    const auto Size32 = static_cast<Int32>(Size);
+    switch (AddressMode)
+    {
+        case TEXTURE_ADDRESS_WRAP:
+            // Note that the sign of a%b is implementation-dependent when one of the operands is negative.
+            i = i - (i / Size32) * Size32;
+            return static_cast<Uint32>(i < 0 ? i + Size32 : i);
+
+        case TEXTURE_ADDRESS_MIRROR:
+        {
+            const Int32 Period = Size32 * 2;
+
+            i = i - (i / Period) * Period;
+            if (i < 0)
+                i += Period;
+            return static_cast<Uint32>(i < Size32 ? i : Period - 1 - i);
+        }
+
+        default:
+            return static_cast<Uint32>(std::min(std::max(i, 0), Size32 - 1));
+    }
+}
+
+// Zeroth-order modified Bessel function of the first kind
+double BesselI0(double x)
+{
+    // I0(x) = sum_k ((x/2)^k / k!)^2
+    const double HalfX2 = x * x * 0.25;
+
+    double Sum  = 1;
+    double Term = 1;
+    for (int k = 1; k < 64 && Term > Sum * 1e-12; ++k)
+    {
+        Term *= HalfX2 / (k * k);
+        Sum += Term;
+    }
+    return Sum;
+}
+
+double KaiserWindowedSinc(double x, double Width, double Alpha)
+{
+    const double t = x / Width;
+    if (t * t >= 1)
+        return 0;
+
+    const double Sinc = x != 0 ? std::sin(PI * x) / (PI * x) : 1.0;
+    return Sinc * BesselI0(Alpha * std::sqrt(1 - t * t)) / BesselI0(Alpha);
+}
+
+FilterTaps ComputeFilterTaps(Uint32 SrcSize, Uint32 DstSize, const MipGenerationAttribs& Attribs)
+{
+    FilterTaps Taps;
+    Taps.Offsets.reserve(DstSize + 1);
+    Taps.Offsets.push_back(0);
+
+    const double Scale = static_cast<double>(SrcSize) / static_cast<double>(DstSize);
+
+    std::vector<double> Weights;
+    for (Uint32 i = 0; i < DstSize; ++i)
+    {
+        Weights.clear();
+        if (SrcSize == DstSize)
+        {
+            Taps.Indices.push_back(i);
+            Weights.push_back(1);
+        }
+        else if (Attribs.Filter == MIP_FILTER_TYPE_KAISER)
+        {
+            // Filter coordinates are in destination texels
+            const double Center = (i + 0.5) * Scale;
+            const double Radius = Attribs.KaiserWidth * Scale;
+            const auto   First  = static_cast<Int32>(std::floor(Center - Radius));
+            const auto   Last   = static_cast<Int32>(std::ceil(Center + Radius));
+            for (Int32 j = First; j <= Last; ++j)
+            {
+                const double w = KaiserWindowedSinc((j + 0.5 - Center) / Scale, Attribs.KaiserWidth, Attribs.KaiserAlpha);
+                if (w != 0)
+                {
+                    Taps.Indices.push_back(ResolveTexelCoord(j, SrcSize, Attribs.AddressMode));
+                    Weights.push_back(w);
+                }
+            }
+        }
+        else
+        {
+            // Weight of every source texel is its overlap with the destination texel footprint
+            const double Start = i * Scale;
+            const double End   = (i + 1) * Scale;
+            for (auto j = static_cast<Uint32>(Start); j < End && j < SrcSize; ++j)
+            {
+                const double w = std::min(j + 1.0, End) - std::max(static_cast<double>(j), Start);
+                if (w > 0)
+                {
+                    Taps.Indices.push_back(j);
+                    Weights.push_back(w);
+                }
+            }
+        }
+
+        double WeightSum = 0;
+        for (auto w : Weights)
+            WeightSum += w;
+        for (auto w : Weights)
+            Taps.Weights.push_back(static_cast<float>(WeightSum != 0 ? w / WeightSum : w));
+
+        VERIFY_EXPR(Taps.Indices.size() == Taps.Weights.size() && Taps.Indices.size() > Taps.Offsets.back());
+        Taps.Offsets.push_back(static_cast<Uint32>(Taps.Indices.size()));
+    }
+
+    return Taps;
+}
+
+template <Uint32 NumChannels>
+void FilterRowHorizontal(const float* pSrc, float* pDst, const FilterTaps& Taps, Uint32 DstWidth)
+{
+    for (Uint32 x = 0; x < DstWidth; ++x)
+    {
+        float Sum[NumChannels] = {};
+        for (Uint32 t = Taps.Offsets[x]; t < Taps.Offsets[x + 1]; ++t)
+        {
+            const float* pSrcTexel = pSrc + size_t{Taps.Indices[t]} * NumChannels;
+            const float  w         = Taps.Weights[t];
+            for (Uint32 c = 0; c < NumChannels; ++c)
+                Sum[c] += w * pSrcTexel[c];
+        }
+        for (Uint32 c = 0; c < NumChannels; ++c)
+            pDst[x * NumChannels + c] = Sum[c];
+    }
+}
+
+// Runs Job(JobIdx, ThreadIdx) for every job in [0, NumJobs) on up to NumThreads threads
+template <typename JobFuncType>
+void RunJobs(Uint32 NumJobs, Uint32 NumThreads, const JobFuncType& Job)
+{
+    NumThreads = std::max(std::min(NumThreads, NumJobs), 1u);
+
+    std::atomic<Uint32> NextJob{0};
+
+    auto Worker = [&](Uint32 ThreadIdx) //
+    {
+        for (Uint32 JobIdx = NextJob.fetch_add(1); JobIdx < NumJobs; JobIdx = NextJob.fetch_add(1))
+            Job(JobIdx, ThreadIdx);
+    };
+
+    std::vector<std::thread> Workers;
+    Workers.reserve(NumThreads - 1);
+    for (Uint32 t = 1; t < NumThreads; ++t)
+        Workers.emplace_back(Worker, t);
+
+    Worker(0u);
+
+    for (auto& Thread : Workers)
+        Thread.join();
+}
+
+// Returns the alpha scale that makes the fraction of values greater than Cutoff equal to Coverage.
+// The values are reordered.
+float ComputeAlphaScale(std::vector<float>& Alpha, float Cutoff, double Coverage)
+{
+    if (Alpha.empty())
+        return 1;
+
+    const auto NumAbove = static_cast<size_t>(Coverage * static_cast<double>(Alpha.size()) + 0.5);
+
+    float Threshold = 0;
+    if (NumAbove == 0)
+    {
+        Threshold = *std::max_element(Alpha.begin(), Alpha.end());
+    }
+    else if (NumAbove >= Alpha.size())
+    {
+        // Slightly below the smallest value so that all values are above the cutoff after scaling
+        Threshold = *std::min_element(Alpha.begin(), Alpha.end()) * (1.f - 1.f / 1024.f);
+    }
+    else
+    {
+        // The first NumAbove elements are the largest ones
+        std::nth_element(Alpha.begin(), Alpha.begin() + NumAbove, Alpha.end(), std::greater<float>{});
+        const float LowestAbove = *std::min_element(Alpha.begin(), Alpha.begin() + NumAbove);
+        Threshold               = (LowestAbove + Alpha[NumAbove]) * 0.5f;
+    }
+
+    return Threshold > 0 ? Cutoff / Threshold : 1.f;
+}
+
+class MipChainGenerator
+{
+public:
+    MipChainGenerator(const TextureDesc&          TexDesc,
+                      const MipGenerationAttribs& Attribs,
+                      const TexelCodec&           Codec,
+                      Uint32                      MipLevels,
+                      Uint32                      NumSlices) :
+        m_TexDesc{TexDesc},
+        m_Attribs{Attribs},
+        m_Codec{Codec},
+        m_MipLevels{MipLevels},
+        m_NumSlices{NumSlices},
+        m_ElementSize{GetTextureFormatAttribs(TexDesc.Format).GetElementSize()}
+    {}
+
+    void Generate(const TextureSubResData* pSrcLevels, const MipLevelData* pDstLevels);
+
+private:
+    struct LevelView
+    {
+        const Uint8* pData       = nullptr;
+        size_t       Stride      = 0;
+        size_t       DepthStride = 0;
+
+        const Uint8* GetRow(Uint32 y, Uint32 z) const
+        {
+            return pData + z * DepthStride + y * Stride;
+        }
+    };
+
+    struct LevelSize
+    {
+        Uint32 Width;
+        Uint32 Height;
+        Uint32 Depth;
+    };
+
+    // Per-thread scratch memory
+    struct RowScratch
+    {
+        std::vector<float> Decoded;
+        std::vector<float> Accum;
+        std::vector<float> Filtered;
+    };
+
+    LevelSize GetLevelSize(Uint32 Mip) const
+    {
+        LevelSize Size;
+        Size.Width  = std::max(m_TexDesc.Width >> Mip, 1u);
+        Size.Height = (m_TexDesc.Type == RESOURCE_DIM_TEX_1D || m_TexDesc.Type == RESOURCE_DIM_TEX_1D_ARRAY) ? 1u : std::max(m_TexDesc.Height >> Mip, 1u);
+        Size.Depth  = m_TexDesc.Type == RESOURCE_DIM_TEX_3D ? std::max(m_TexDesc.Depth >> Mip, 1u) : 1u;
+        return Size;
+    }
+
+    LevelView GetLevelView(Uint32 Slice, Uint32 Mip) const
+    {
+        LevelView View;
+        if (Mip == 0)
+        {
+            const auto& SrcLevel = m_pSrcLevels[Slice];
+            View.pData           = static_cast<const Uint8*>(SrcLevel.pData);
+            View.Stride          = SrcLevel.Stride;
+            View.DepthStride     = SrcLevel.DepthStride;
+        }
+        else
+        {
+            const auto& DstLevel = m_pDstLevels[Slice * (m_MipLevels - 1) + Mip - 1];
+            View.pData           = static_cast<const Uint8*>(DstLevel.pData);
+            View.Stride          = DstLevel.Stride;
+            View.DepthStride     = DstLevel.DepthStride;
+        }
+        return View;
+    }
+
+    void FilterRow(const LevelView&  Src,
+                   const LevelSize&  SrcSize,
+                   Uint8*            pDstRow,
+                   const LevelSize&  DstSize,
+                   const FilterTaps& TapsX,
+                   const FilterTaps& TapsY,
+                   const FilterTaps& TapsZ,
+                   Uint32            y,
+                   Uint32            z,
+                   RowScratch&       Scratch) const;
+
+    void GenerateLevel(Uint32 Mip, std::vector<RowScratch>& Scratch) const;
+
+    void ComputeAlphaCoverage(std::vector<RowScratch>& Scratch);
+    void PreserveAlphaCoverage(Uint32 Mip, std::vector<RowScratch>& Scratch) const;
+
+    // Calls Func(pRow, y, z) for every row of the level
+    template <typename FuncType>
+    void ProcessRows(const LevelView& View, const LevelSize& Size, FuncType&& Func) const
+    {
+        for (Uint32 z = 0; z < Size.Depth; ++z)
+        {
+            for (Uint32 y = 0; y < Size.Height; ++y)
+                Func(View.GetRow(y, z), y, z);
+        }
+    }
+
+    // Levels smaller than this are processed on a single thread
+    static constexpr Uint32 MinTexelsPerThread = 16384;
+
+    const TextureDesc&          m_TexDesc;
+    const MipGenerationAttribs& m_Attribs;
+    const TexelCodec&           m_Codec;
+
+    const Uint32 m_MipLevels;
+    const Uint32 m_NumSlices;
+    const Uint32 m_ElementSize;
+
+    const TextureSubResData* m_pSrcLevels = nullptr;
+    const MipLevelData*      m_pDstLevels = nullptr;
+
+    // Alpha coverage of the level 0 of every slice
+    std::vector<double> m_AlphaCoverage;
+};
+
+constexpr Uint32 MipChainGenerator::MinTexelsPerThread;
+
+void MipChainGenerator::FilterRow(const LevelView&  Src,
+                                  const LevelSize&  SrcSize,
+                                  Uint8*            pDstRow,
+                                  const LevelSize&  DstSize,
+                                  const FilterTaps& TapsX,
+                                  const FilterTaps& TapsY,
+                                  const FilterTaps& TapsZ,
+                                  Uint32            y,
+                                  Uint32            z,
+                                  RowScratch&       Scratch) const
+{
+    const Uint32 NumChannels    = m_Codec.NumChannels;
+    const size_t SrcRowValues   = size_t{SrcSize.Width} * NumChannels;
+    const size_t SrcRowElements = size_t{SrcSize.Width} * m_Codec.ElementsPerTexel;
+
+    float* const pDecoded = Scratch.Decoded.data();
+    float* const pAccum   = Scratch.Accum.data();
+
+    // Vertical and depth filtering
+    bool IsFirstTap = true;
+    for (Uint32 tz = TapsZ.Offsets[z]; tz < TapsZ.Offsets[z + 1]; ++tz)
+    {
+        for (Uint32 ty = TapsY.Offsets[y]; ty < TapsY.Offsets[y + 1]; ++ty)
+        {
+            const float w = TapsZ.Weights[tz] * TapsY.Weights[ty];
+            m_Codec.Decode(Src.GetRow(TapsY.Indices[ty], TapsZ.Indices[tz]), pDecoded, SrcRowElements);
+            if (IsFirstTap)
+            {
+                for (size_t i = 0; i < SrcRowValues; ++i)
+                    pAccum[i] = w * pDecoded[i];
+                IsFirstTap = false;
+            }
+            else
+            {
+                for (size_t i = 0; i < SrcRowValues; ++i)
+                    pAccum[i] += w * pDecoded[i];
+            }
+        }
+    }
+
+    // Horizontal filtering
+    float* const pFiltered = Scratch.Filtered.data();
+    switch (NumChannels)
+    {
+        case 1: FilterRowHorizontal<1>(pAccum, pFiltered, TapsX, DstSize.Width); break;
+        case 2: FilterRowHorizontal<2>(pAccum, pFiltered, TapsX, DstSize.Width); break;
+        case 3: FilterRowHorizontal<3>(pAccum, pFiltered, TapsX, DstSize.Width); break;
+        case 4: FilterRowHorizontal<4>(pAccum, pFiltered, TapsX, DstSize.Width); break;
+        default: UNEXPECTED("Unexpected number of channels");
+    }
+
+    m_Codec.Encode(pFiltered, pDstRow, size_t{DstSize.Width} * m_Codec.ElementsPerTexel);
+}
+
+void MipChainGenerator::GenerateLevel(Uint32 Mip, std::vector<RowScratch>& Scratch) const
+{
+    VERIFY_EXPR(Mip > 0);
+    const auto SrcSize = GetLevelSize(Mip - 1);
+    const auto DstSize = GetLevelSize(Mip);
+
+    const auto TapsX = ComputeFilterTaps(SrcSize.Width, DstSize.Width, m_Attribs);
+    const auto TapsY = ComputeFilterTaps(SrcSize.Height, DstSize.Height, m_Attribs);
+    const auto TapsZ = ComputeFilterTaps(SrcSize.Depth, DstSize.Depth, m_Attribs);
+
+    // Rows of all slices are distributed between the threads in batches
+    const Uint32 RowsPerSlice = DstSize.Height * DstSize.Depth;
+    const Uint32 TotalRows    = RowsPerSlice * m_NumSlices;
+    const Uint32 NumThreads   = std::min(m_Attribs.NumThreads, std::max(TotalRows * DstSize.Width / MinTexelsPerThread, 1u));
+    const Uint32 RowsPerJob   = std::max(TotalRows / (NumThreads * 8), 1u);
+    const Uint32 NumJobs      = (TotalRows + RowsPerJob - 1) / RowsPerJob;
+
+    RunJobs(NumJobs, NumThreads,
+            [&](Uint32 JobIdx, Uint32 ThreadIdx) //
+            {
+                const Uint32 FirstRow = JobIdx * RowsPerJob;
+                const Uint32 EndRow   = std::min(FirstRow + RowsPerJob, TotalRows);
+                for (Uint32 Row = FirstRow; Row < EndRow; ++Row)
+                {
+                    const Uint32 Slice = Row / RowsPerSlice;
+                    const Uint32 y     = Row % DstSize.Height;
+                    const Uint32 z     = (Row % RowsPerSlice) / DstSize.Height;
+
+                    const auto& DstLevel = m_pDstLevels[Slice * (m_MipLevels - 1) + Mip - 1];
+                    auto*       pDstRow  = static_cast<Uint8*>(DstLevel.pData) + z * size_t{DstLevel.DepthStride} + y * size_t{DstLevel.Stride};
+                    FilterRow(GetLevelView(Slice, Mip - 1), SrcSize, pDstRow, DstSize, TapsX, TapsY, TapsZ, y, z, Scratch[ThreadIdx]);
+                }
+            });
+}
+
+void MipChainGenerator::ComputeAlphaCoverage(std::vector<RowScratch>& Scratch)
+{
+    const auto   Size         = GetLevelSize(0);
+    const Uint32 NumChannels  = m_Codec.NumChannels;
+    const auto   AlphaChannel = static_cast<Uint32>(m_Codec.AlphaChannel);
+
+    m_AlphaCoverage.resize(m_NumSlices);
+    RunJobs(m_NumSlices, m_Attribs.NumThreads,
+            [&](Uint32 Slice, Uint32 ThreadIdx) //
+            {
+                float* const pDecoded = Scratch[ThreadIdx].Decoded.data();
+
+                size_t NumAbove = 0;
+                ProcessRows(GetLevelView(Slice, 0), Size,
+                            [&](const Uint8* pRow, Uint32, Uint32) //
+                            {
+                                m_Codec.Decode(pRow, pDecoded, size_t{Size.Width} * m_Codec.ElementsPerTexel);
+                                for (Uint32 x = 0; x < Size.Width; ++x)
+                                {
+                                    if (pDecoded[x * NumChannels + AlphaChannel] > m_Attribs.AlphaCutoff)
+                                        ++NumAbove;
+                                }
+                            });
+                m_AlphaCoverage[Slice] = static_cast<double>(NumAbove) / (static_cast<double>(Size.Width) * Size.Height * Size.Depth);
+            });
+}
+
+void MipChainGenerator::PreserveAlphaCoverage(Uint32 Mip, std::vector<RowScratch>& Scratch) const
+{
+    const auto   Size         = GetLevelSize(Mip);
+    const Uint32 NumChannels  = m_Codec.NumChannels;
+    const auto   AlphaChannel = static_cast<Uint32>(m_Codec.AlphaChannel);
+    const size_t NumElements  = size_t{Size.Width} * m_Codec.ElementsPerTexel;
+
+    RunJobs(m_NumSlices, m_Attribs.NumThreads,
+            [&](Uint32 Slice, Uint32 ThreadIdx) //
+            {
+                float* const pDecoded = Scratch[ThreadIdx].Decoded.data();
+                const auto&  DstLevel = m_pDstLevels[Slice * (m_MipLevels - 1) + Mip - 1];
+                const auto   View     = GetLevelView(Slice, Mip);
+
+                std::vector<float> Alpha;
+                Alpha.reserve(size_t{Size.Width} * Size.Height * Size.Depth);
+                ProcessRows(View, Size,
+                            [&](const Uint8* pRow, Uint32, Uint32) //
+                            {
+                                m_Codec.Decode(pRow, pDecoded, NumElements);
+                                for (Uint32 x = 0; x < Size.Width; ++x)
+                                {
+                                    const float a = pDecoded[x * NumChannels + AlphaChannel];
+                                    // NaNs would break the ordering
+                                    Alpha.push_back(a == a ? a : 0.f);
+                                }
+                            });
+
+                const float Scale = ComputeAlphaScale(Alpha, m_Attribs.AlphaCutoff, m_AlphaCoverage[Slice]);
+                if (Scale == 1)
+                    return;
+
+                ProcessRows(View, Size,
+                            [&](const Uint8* pRow, Uint32 y, Uint32 z) //
+                            {
+                                m_Codec.Decode(pRow, pDecoded, NumElements);
+                                for (Uint32 x = 0; x < Size.Width; ++x)
+                                    pDecoded[x * NumChannels + AlphaChannel] *= Scale;
+                                m_Codec.Encode(pDecoded, static_cast<Uint8*>(DstLevel.pData) + z * size_t{DstLevel.DepthStride} + y * size_t{DstLevel.Stride}, NumElements);
+                            });
+            });
+}
+
+void MipChainGenerator::Generate(const TextureSubResData* pSrcLevels, const MipLevelData* pDstLevels)
+{
+    m_pSrcLevels = pSrcLevels;
+    m_pDstLevels = pDstLevels;
+
+    const auto Level0Size = GetLevelSize(0);
+
+    std::vector<RowScratch> Scratch(std::max(m_Attribs.NumThreads, 1u));
+    for (auto& ThreadScratch : Scratch)
+    {
+        ThreadScratch.Decoded.resize(size_t{Level0Size.Width} * m_Codec.NumChannels);
+        ThreadScratch.Accum.resize(size_t{Level0Size.Width} * m_Codec.NumChannels);
+        ThreadScratch.Filtered.resize(size_t{std::max(Level0Size.Width / 2, 1u)} * m_Codec.NumChannels);
+    }
+
+    const bool PreserveCoverage = m_Attribs.AlphaCutoff > 0 && m_Codec.AlphaChannel >= 0;
+    if (PreserveCoverage)
+        ComputeAlphaCoverage(Scratch);
+
+    for (Uint32 Mip = 1; Mip < m_MipLevels; ++Mip)
+    {
+        GenerateLevel(Mip, Scratch);
+        if (PreserveCoverage)
+            PreserveAlphaCoverage(Mip, Scratch);
+    }
+}
+
+} // namespace
+
+bool IsMipGenerationSupported(TEXTURE_FORMAT Format)
+{
+    return GetTexelCodec(Format).Decode != nullptr;
+}
+
+bool GenerateMipLevels(const TextureDesc&          TexDesc,
+                       const TextureSubResData*    pSrcLevels,
+                       const MipLevelData*         pDstLevels,
+                       const MipGenerationAttribs& Attribs)
+{
+    const auto Codec = GetTexelCodec(TexDesc.Format);
+    if (Codec.Decode == nullptr)
+    {
+        LOG_ERROR_MESSAGE("Mip generation is not supported for format ", GetTextureFormatAttribs(TexDesc.Format).Name);
+        return false;
+    }
+
+    Uint32 FullMipChainSize = 0;
+    Uint32 NumSlices        = 1;
+    switch (TexDesc.Type)
+    {
+        case RESOURCE_DIM_TEX_1D:
+            FullMipChainSize = ComputeMipLevelsCount(TexDesc.Width);
+            break;
+
+        case RESOURCE_DIM_TEX_1D_ARRAY:
+            FullMipChainSize = ComputeMipLevelsCount(TexDesc.Width);
+            NumSlices        = TexDesc.ArraySize;
+            break;
+
+        case RESOURCE_DIM_TEX_2D:
+            FullMipChainSize = ComputeMipLevelsCount(TexDesc.Width, TexDesc.Height);
+            break;
+
+        case RESOURCE_DIM_TEX_2D_ARRAY:
+        case RESOURCE_DIM_TEX_CUBE:
+        case RESOURCE_DIM_TEX_CUBE_ARRAY:
+            FullMipChainSize = ComputeMipLevelsCount(TexDesc.Width, TexDesc.Height);
+            NumSlices        = TexDesc.ArraySize;
+            break;
+
+        case RESOURCE_DIM_TEX_3D:
+            FullMipChainSize = ComputeMipLevelsCount(TexDesc.Width, TexDesc.Height, TexDesc.Depth);
+            break;
+
+        default:
+            LOG_ERROR_MESSAGE("Unexpected resource dimension");
+            return false;
+    }
+
+    const Uint32 MipLevels = TexDesc.MipLevels != 0 ? TexDesc.MipLevels : FullMipChainSize;
+    if (MipLevels > FullMipChainSize)
+    {
+        LOG_ERROR_MESSAGE("The number of mip levels (", MipLevels, ") exceeds the full mip chain size (", FullMipChainSize, ")");
+        return false;
+    }
+
+    if (Attribs.Filter >= MIP_FILTER_TYPE_NUM_TYPES)
+    {
+        LOG_ERROR_MESSAGE("Unexpected mip filter type (", Uint32{Attribs.Filter}, ")");
+        return false;
+    }
+
+    if (Attribs.Filter == MIP_FILTER_TYPE_KAISER && !(Attribs.KaiserWidth >= 0.5f))
+    {
+        LOG_ERROR_MESSAGE("Kaiser filter width (", Attribs.KaiserWidth, ") must be at least 0.5");
+        return false;
+    }
+
+    if (MipLevels <= 1 || NumSlices == 0)
+        return true;
+
+    DEV_CHECK_ERR(pSrcLevels != nullptr, "Source levels must not be null");
+    DEV_CHECK_ERR(pDstLevels != nullptr, "Destination levels must not be null");
+
+    MipChainGenerator Generator{TexDesc, Attribs, Codec, MipLevels, NumSlices};
+    Generator.Generate(pSrcLevels, pDstLevels);
+
+    return true;
+}
+
+} // namespace Diligent
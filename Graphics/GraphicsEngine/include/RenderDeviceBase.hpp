@@ -250,8 +250,8 @@ public:
         m_ShaderObjAllocator    {RawMemAllocator, ObjectSizes.ShaderObjSize,    32  },
         m_SamplerObjAllocator   {RawMemAllocator, ObjectSizes.SamplerObjSize,   32  },
         m_PSOAllocator          {RawMemAllocator, ObjectSizes.PSOSize,          128 },
-        m_SRBAllocator          {RawMemAllocator, ObjectSizes.SRBSize,          1024},
-        m_ResMappingAllocator   {RawMemAllocator, sizeof(ResourceMappingImpl),  16  },
+        m_SRBAllocator          {RawMemAllocator, ObjectSizes.SRBSize,          1024, 32},
+        m_ResMappingAllocator   {RawMemAllocator, sizeof(ResourceMappingImpl),  16,   8 },
         m_FenceAllocator        {RawMemAllocator, ObjectSizes.FenceSize,        16  },
         m_QueryAllocator        {RawMemAllocator, ObjectSizes.QuerySize,        16  }
     // clang-format on
@@ -35,6 +35,7 @@
 #include <unordered_map>
 #include "HashUtils.hpp"
 #include "STDAllocator.hpp"
+#include "StringInterner.hpp"
 
 namespace Diligent
 {
@@ -46,6 +47,13 @@ struct ResMappingHashKey
     {
     }
 
+    // Uses the precomputed hash of the interned string; the string is not copied
+    ResMappingHashKey(const InternedString& Str, Uint32 ArrInd) :
+        StrKey{Str.GetStr(), Str.GetHash()},
+        ArrayIndex{ArrInd}
+    {
+    }
+
     ResMappingHashKey(ResMappingHashKey&& rhs) :
         StrKey{std::move(rhs.StrKey)},
         ArrayIndex{rhs.ArrayIndex}
@@ -131,12 +139,19 @@ public:
                                                 IDeviceObject** ppResource,
                                                 Uint32          ArrayIndex) override final;
 
+    /// Same as GetResource(), but uses the precomputed hash of the interned name
+    void GetResource(const InternedString& Name,
+                     IDeviceObject**       ppResource,
+                     Uint32                ArrayIndex = 0);
+
     /// Returns number of resources in the resource mapping.
     virtual size_t DILIGENT_CALL_TYPE GetSize() override final;
 
 private:
     ThreadingTools::LockHelper Lock();
 
+    void FindResource(const ResMappingHashKey& Key, IDeviceObject** ppResource);
+
     ThreadingTools::LockFlag                                                                                                                                               m_LockFlag;
     typedef std::pair<const ResMappingHashKey, RefCntAutoPtr<IDeviceObject>>                                                                                               HashTableElem;
     std::unordered_map<ResMappingHashKey, RefCntAutoPtr<IDeviceObject>, std::hash<ResMappingHashKey>, std::equal_to<ResMappingHashKey>, STDAllocatorRawMem<HashTableElem>> m_HashTable;
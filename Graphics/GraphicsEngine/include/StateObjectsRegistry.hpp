@@ -30,9 +30,14 @@
 /// \file
 /// Implementation of the Diligent::StateObjectsRegistry template class
 
-#include "DeviceObject.h"
 #include <unordered_map>
+#include <atomic>
+#include <algorithm>
+
+#include "DeviceObject.h"
+#include "RefCntAutoPtr.hpp"
 #include "STDAllocator.hpp"
+#include "LockHelper.hpp"
 
 namespace Diligent
 {
@@ -62,13 +67,24 @@ template <typename ResourceDescType>
 class StateObjectsRegistry
 {
 public:
-    /// Number of outstanding deleted objects to purge the registry.
+    /// Number of outstanding deleted objects to start purging the registry.
     static constexpr int DeletedObjectsToPurge = 32;
 
+    /// Number of shards. Every shard is a separate hash map protected by its own lock.
+    static constexpr Uint32 NumShardBits = 4;
+    static constexpr Uint32 NumShards    = 1u << NumShardBits;
+
+    /// Maximum number of shards purged by a single Add() call.
+    static constexpr Uint32 ShardsToPurgePerAdd = 2;
+
     StateObjectsRegistry(IMemoryAllocator& RawAllocator, const Char* RegistryName) :
-        m_DescToObjHashMap(STD_ALLOCATOR_RAW_MEM(HashMapElem, RawAllocator, "Allocator for unordered_map<ResourceDescType, RefCntWeakPtr<IDeviceObject> >")),
+        m_RawAllocator{RawAllocator},
         m_RegistryName{RegistryName}
-    {}
+    {
+        m_pShards = reinterpret_cast<RegistryShard*>(m_RawAllocator.Allocate(sizeof(RegistryShard) * NumShards, "Raw memory for state object registry shards", __FILE__, __LINE__));
+        for (Uint32 i = 0; i < NumShards; ++i)
+            new (m_pShards + i) RegistryShard{RawAllocator};
+    }
 
     ~StateObjectsRegistry()
     {
@@ -78,35 +94,41 @@ public:
         // may only be expired references in the registry. After we
         // purge it, the registry must be empty.
         Purge();
-        VERIFY(m_DescToObjHashMap.empty(), "DescToObjHashMap is not empty");
+        for (Uint32 i = 0; i < NumShards; ++i)
+        {
+            VERIFY(m_pShards[i].DescToObjHashMap.empty(), "DescToObjHashMap is not empty");
+            m_pShards[i].~RegistryShard();
+        }
+        m_RawAllocator.Free(m_pShards);
     }
 
+    // clang-format off
+    StateObjectsRegistry           (const StateObjectsRegistry&) = delete;
+    StateObjectsRegistry& operator=(const StateObjectsRegistry&) = delete;
+    // clang-format on
+
     /// Adds a new object to the registry
 
     /// \param [in] ObjectDesc - object description.
     /// \param [in] pObject - pointer to the object.
     ///
     /// Besides adding a new object, the function also checks the number of
-    /// outstanding deleted objects and calls Purge() if the number has reached
-    /// the threshold value DeletedObjectsToPurge. Creating a state object is
-    /// assumed to be an expensive operation and should be performed during
-    /// the initialization. Occasional purge operations should not add significant
-    /// cost to it.
+    /// outstanding deleted objects and, if the number has reached the threshold
+    /// value DeletedObjectsToPurge, purges up to ShardsToPurgePerAdd shards.
+    /// Creating a state object is assumed to be an expensive operation and should
+    /// be performed during the initialization. Occasional purge operations should
+    /// not add significant cost to it.
     void Add(const ResourceDescType& ObjectDesc, IDeviceObject* pObject)
     {
-        ThreadingTools::LockHelper Lock(m_LockFlag);
+        if (m_NumDeletedObjects.load() >= DeletedObjectsToPurge)
+            PurgeIncremental(ShardsToPurgePerAdd);
 
-        // If the number of outstanding deleted objects reached the threshold value,
-        // purge the registry. Since we have exclusive access now, it is safe
-        // to do.
-        if (m_NumDeletedObjects >= DeletedObjectsToPurge)
-        {
-            Purge();
-            m_NumDeletedObjects = 0;
-        }
+        const auto                          Hash  = std::hash<ResourceDescType>{}(ObjectDesc);
+        auto&                               Shard = m_pShards[GetShardIndex(Hash)];
+        ThreadingTools::ExclusiveLockHelper Lock{Shard.LockFlag};
 
         // Try to construct the new element in place
-        auto Elems = m_DescToObjHashMap.emplace(std::make_pair(ObjectDesc, Diligent::RefCntWeakPtr<IDeviceObject>(pObject)));
+        auto Elems = Shard.DescToObjHashMap.emplace(std::make_pair(ObjectDesc, Diligent::RefCntWeakPtr<IDeviceObject>(pObject)));
         // It is theorertically possible that the same object can be found
         // in the registry. This might happen if two threads try to create
         // the same object at the same time. They both will not find the
@@ -120,52 +142,135 @@ public:
         // the second thread creates the same object and tries to add it to
         // the registry. It will find an existing expired reference to the
         // object.
+        //
+        // Since Find() does not remove expired references, the same happens every
+        // time an object is created again after the previous one was destroyed.
+        // The expired reference is then replaced silently and counted as purged.
         if (!Elems.second)
         {
             VERIFY(Elems.first->first == ObjectDesc, "Incorrect object description");
-            LOG_WARNING_MESSAGE("Object named '", Elems.first->first.Name,
-                                "' with the same description already exists in the registry."
-                                "Replacing with the new object named '",
-                                ObjectDesc.Name ? ObjectDesc.Name : "", "'.");
+            if (Elems.first->second.IsValid())
+            {
+                LOG_WARNING_MESSAGE("Object named '", Elems.first->first.Name,
+                                    "' with the same description already exists in the registry."
+                                    "Replacing with the new object named '",
+                                    ObjectDesc.Name ? ObjectDesc.Name : "", "'.");
+            }
+            else
+            {
+                OnObjectsPurged(1);
+            }
             Elems.first->second = pObject;
         }
     }
 
     /// Finds the object in the registry
+
+    /// \remarks Lookups only take the shared lock of one shard, so that any number of
+    ///          threads can look up objects simultaneously. The lookup never modifies
+    ///          the stored references; expired ones are left for the purge.
     void Find(const ResourceDescType& Desc, IDeviceObject** ppObject)
     {
         VERIFY(*ppObject == nullptr, "Overwriting reference to existing object may cause memory leaks");
         *ppObject = nullptr;
-        ThreadingTools::LockHelper Lock(m_LockFlag);
 
-        auto It = m_DescToObjHashMap.find(Desc);
-        if (It != m_DescToObjHashMap.end())
+        const auto Hash  = std::hash<ResourceDescType>{}(Desc);
+        auto&      Shard = m_pShards[GetShardIndex(Hash)];
+
+        // RefCntWeakPtr::Lock() releases the weak reference if the object has expired,
+        // so it must not be called on the map entry while other readers may access it.
+        // Copy the weak reference under the shared lock instead.
+        RefCntWeakPtr<IDeviceObject> pWeakObject;
         {
-            // Try to obtain strong reference to the object.
-            // This is an atomic operation and we either get
-            // a new strong reference or object has been destroyed
-            // and we get null.
-            auto pObject = It->second.Lock();
-            if (pObject)
-            {
-                *ppObject = pObject.Detach();
-                //LOG_INFO_MESSAGE( "Equivalent of the requested state object named \"", Desc.Name ? Desc.Name : "", "\" found in the ", m_RegistryName, " registry. Reusing existing object.");
-            }
-            else
-            {
-                // Expired object found: remove it from the map
-                m_DescToObjHashMap.erase(It);
-                Atomics::AtomicDecrement(m_NumDeletedObjects);
-            }
+            ThreadingTools::SharedLockHelper Lock{Shard.LockFlag};
+
+            auto It = Shard.DescToObjHashMap.find(Desc);
+            if (It == Shard.DescToObjHashMap.end())
+                return;
+
+            pWeakObject = It->second;
+        }
+
+        // Try to obtain strong reference to the object.
+        // This is an atomic operation and we either get
+        // a new strong reference or object has been destroyed
+        // and we get null.
+        auto pObject = pWeakObject.Lock();
+        if (pObject)
+        {
+            *ppObject = pObject.Detach();
+            //LOG_INFO_MESSAGE( "Equivalent of the requested state object named \"", Desc.Name ? Desc.Name : "", "\" found in the ", m_RegistryName, " registry. Reusing existing object.");
         }
     }
 
-    /// Purges outstanding deleted objects from the registry
+    /// Purges outstanding deleted objects from all shards of the registry
     void Purge()
     {
         Uint32 NumPurgedObjects = 0;
-        auto   It               = m_DescToObjHashMap.begin();
-        while (It != m_DescToObjHashMap.end())
+        for (Uint32 i = 0; i < NumShards; ++i)
+            NumPurgedObjects += PurgeShard(m_pShards[i]);
+        OnObjectsPurged(NumPurgedObjects);
+        LOG_INFO_MESSAGE("Purged ", NumPurgedObjects, " deleted objects from the ", m_RegistryName, " registry");
+    }
+
+    /// Purges outstanding deleted objects from at most MaxShards shards. Every call
+    /// continues from the shard where the previous call stopped.
+    void PurgeIncremental(Uint32 MaxShards)
+    {
+        Uint32 NumPurgedObjects = 0;
+        for (Uint32 i = 0; i < std::min(MaxShards, NumShards); ++i)
+        {
+            const auto ShardIdx = m_NextShardToPurge.fetch_add(1) % NumShards;
+            NumPurgedObjects += PurgeShard(m_pShards[ShardIdx]);
+        }
+        OnObjectsPurged(NumPurgedObjects);
+    }
+
+    /// Increments the number of outstanding deleted objects.
+    /// When this number reaches DeletedObjectsToPurge, Add() will
+    /// start purging the registry.
+    void ReportDeletedObject()
+    {
+        m_NumDeletedObjects.fetch_add(1);
+    }
+
+    /// Returns the number of outstanding deleted objects that have not been purged
+    int GetNumDeletedObjects() const
+    {
+        return m_NumDeletedObjects.load();
+    }
+
+private:
+    /// Hash map that stores weak pointers to the referenced objects
+    typedef std::pair<const ResourceDescType, RefCntWeakPtr<IDeviceObject>>                                                                                                   HashMapElem;
+    typedef std::unordered_map<ResourceDescType, RefCntWeakPtr<IDeviceObject>, std::hash<ResourceDescType>, std::equal_to<ResourceDescType>, STDAllocatorRawMem<HashMapElem>> HashMapType;
+
+    struct RegistryShard
+    {
+        RegistryShard(IMemoryAllocator& RawAllocator) :
+            DescToObjHashMap(STD_ALLOCATOR_RAW_MEM(HashMapElem, RawAllocator, "Allocator for unordered_map<ResourceDescType, RefCntWeakPtr<IDeviceObject> >"))
+        {}
+
+        /// Lock flag to protect the DescToObjHashMap
+        ThreadingTools::SharedLockFlag LockFlag;
+
+        HashMapType DescToObjHashMap;
+    };
+
+    static Uint32 GetShardIndex(size_t Hash)
+    {
+        // Hash maps in the shards use the low bits of the hash to select the bucket,
+        // so use the high bits of the scrambled hash to select the shard.
+        return static_cast<Uint32>((Hash * size_t{0x9E3779B9u}) >> (sizeof(size_t) * 8 - NumShardBits));
+    }
+
+    static Uint32 PurgeShard(RegistryShard& Shard)
+    {
+        ThreadingTools::ExclusiveLockHelper Lock{Shard.LockFlag};
+
+        Uint32 NumPurgedObjects = 0;
+        auto   It               = Shard.DescToObjHashMap.begin();
+        while (It != Shard.DescToObjHashMap.end())
         {
             auto NextIt = It;
             ++NextIt;
@@ -179,35 +284,47 @@ public:
             // pointer as it will definitiely be removed next time.
             if (!It->second.IsValid())
             {
-                m_DescToObjHashMap.erase(It);
+                Shard.DescToObjHashMap.erase(It);
                 ++NumPurgedObjects;
             }
 
             It = NextIt;
         }
-        LOG_INFO_MESSAGE("Purged ", NumPurgedObjects, " deleted objects from the ", m_RegistryName, " registry");
+        return NumPurgedObjects;
     }
 
-    /// Increments the number of outstanding deleted objects.
-    /// When this number reaches DeletedObjectsToPurge, Purge() will
-    /// be called.
-    void ReportDeletedObject()
+    void OnObjectsPurged(Uint32 NumPurgedObjects)
     {
-        Atomics::AtomicIncrement(m_NumDeletedObjects);
+        // Objects that were replaced in Add() while alive are reported as deleted but are
+        // never purged. An expired reference may also be replaced in Add() before the
+        // object's destructor reports the deletion. So the counter must not go below zero.
+        auto NumDeleted = m_NumDeletedObjects.load();
+        while (!m_NumDeletedObjects.compare_exchange_weak(NumDeleted, std::max(NumDeleted - static_cast<int>(NumPurgedObjects), 0)))
+        {
+        }
     }
 
-private:
-    /// Lock flag to protect the m_DescToObjHashMap
-    ThreadingTools::LockFlag m_LockFlag;
+    IMemoryAllocator& m_RawAllocator;
+
+    RegistryShard* m_pShards = nullptr;
 
     /// Nmber of outstanding deleted objects that have not been purged
-    Atomics::AtomicLong m_NumDeletedObjects;
+    std::atomic<int> m_NumDeletedObjects{0};
 
-    /// Hash map that stores weak pointers to the referenced objects
-    typedef std::pair<const ResourceDescType, RefCntWeakPtr<IDeviceObject>>                                                                                           HashMapElem;
-    std::unordered_map<ResourceDescType, RefCntWeakPtr<IDeviceObject>, std::hash<ResourceDescType>, std::equal_to<ResourceDescType>, STDAllocatorRawMem<HashMapElem>> m_DescToObjHashMap;
+    /// Index of the next shard to purge by PurgeIncremental()
+    std::atomic<Uint32> m_NextShardToPurge{0};
 
     /// Registry name used for debug output
     const String m_RegistryName;
 };
+
+template <typename ResourceDescType>
+constexpr int StateObjectsRegistry<ResourceDescType>::DeletedObjectsToPurge;
+template <typename ResourceDescType>
+constexpr Uint32 StateObjectsRegistry<ResourceDescType>::NumShardBits;
+template <typename ResourceDescType>
+constexpr Uint32 StateObjectsRegistry<ResourceDescType>::NumShards;
+template <typename ResourceDescType>
+constexpr Uint32 StateObjectsRegistry<ResourceDescType>::ShardsToPurgePerAdd;
+
 } // namespace Diligent
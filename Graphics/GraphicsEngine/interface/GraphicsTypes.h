@@ -1828,20 +1828,20 @@ struct TextureFormatAttribs
 #if DILIGENT_CPP_INTERFACE
     /// For non-compressed formats, returns the texel size.
     /// For block-compressed formats, returns the block size.
-    Uint32 GetElementSize() const
+    constexpr Uint32 GetElementSize() const
     {
         return Uint32{ComponentSize} * (ComponentType != COMPONENT_TYPE_COMPRESSED ? Uint32{NumComponents} : Uint32{1});
     }
 
     /// Initializes the structure
-    TextureFormatAttribs( const Char*    _Name,
-                            TEXTURE_FORMAT _Format, 
-                            Uint8          _ComponentSize,
-                            Uint8          _NumComponents,
-                            COMPONENT_TYPE _ComponentType,
-                            bool           _IsTypeless,
-                            Uint8          _BlockWidth,
-                            Uint8          _BlockHeight)noexcept : 
+    constexpr TextureFormatAttribs( const Char*    _Name,
+                                    TEXTURE_FORMAT _Format, 
+                                    Uint8          _ComponentSize,
+                                    Uint8          _NumComponents,
+                                    COMPONENT_TYPE _ComponentType,
+                                    bool           _IsTypeless,
+                                    Uint8          _BlockWidth,
+                                    Uint8          _BlockHeight)noexcept : 
         Name         {_Name         },
         Format       {_Format       },
         ComponentSize{_ComponentSize},
@@ -101,14 +101,32 @@ void ResourceMappingImpl::GetResource(const Char* Name, IDeviceObject** ppResour
     if (!ppResource)
         return;
 
+    // Name will be implicitly converted to HashMapStringKey without making a copy
+    FindResource(ResMappingHashKey(Name, false, ArrayIndex), ppResource);
+}
+
+void ResourceMappingImpl::GetResource(const InternedString& Name, IDeviceObject** ppResource, Uint32 ArrayIndex)
+{
+    VERIFY(Name, "Name is null");
+    if (!Name || *Name.GetStr() == 0)
+        return;
+
+    VERIFY(ppResource, "Null pointer provided");
+    if (!ppResource)
+        return;
+
+    FindResource(ResMappingHashKey(Name, ArrayIndex), ppResource);
+}
+
+void ResourceMappingImpl::FindResource(const ResMappingHashKey& Key, IDeviceObject** ppResource)
+{
     VERIFY(*ppResource == nullptr, "Overwriting reference to existing object may cause memory leaks");
     *ppResource = nullptr;
 
     auto LockHelper = Lock();
 
     // Find an object with the requested name
-    // Name will be implicitly converted to HashMapStringKey without making a copy
-    auto It = m_HashTable.find(ResMappingHashKey(Name, false, ArrayIndex));
+    auto It = m_HashTable.find(Key);
     if (It != m_HashTable.end())
     {
         *ppResource = It->second.RawPtr();
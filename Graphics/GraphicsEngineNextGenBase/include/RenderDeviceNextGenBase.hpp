@@ -144,9 +144,38 @@ public:
     void PurgeReleaseQueue(Uint32 QueueIndex, bool ForceRelease = false)
     {
         VERIFY_EXPR(QueueIndex < m_CmdQueueCount);
-        auto& Queue               = m_CommandQueues[QueueIndex];
-        auto  CompletedFenceValue = ForceRelease ? std::numeric_limits<Uint64>::max() : Queue.CmdQueue->GetCompletedFenceValue();
-        Queue.ReleaseQueue.Purge(CompletedFenceValue);
+        auto& Queue = m_CommandQueues[QueueIndex];
+        if (ForceRelease)
+        {
+            // Release everything regardless of the budget and make sure the resources
+            // are actually destroyed if they were handed over to the background thread
+            Queue.ReleaseQueue.Purge(std::numeric_limits<Uint64>::max());
+            Queue.ReleaseQueue.WaitForBackgroundRelease();
+        }
+        else
+        {
+            Queue.ReleaseQueue.Purge(Queue.CmdQueue->GetCompletedFenceValue(), m_PurgeBudget);
+        }
+    }
+
+    /// Sets the budget used by PurgeReleaseQueue() and PurgeReleaseQueues() when ForceRelease is false.
+    /// Must not be called concurrently with these methods.
+    void SetReleaseQueuePurgeBudget(const ResourcePurgeBudget& Budget)
+    {
+        m_PurgeBudget = Budget;
+    }
+
+    /// Enables or disables destruction of released device objects in background threads
+    void SetBackgroundResourceRelease(bool Enable)
+    {
+        for (size_t q = 0; q < m_CmdQueueCount; ++q)
+            m_CommandQueues[q].ReleaseQueue.SetBackgroundRelease(Enable);
+    }
+
+    ResourceReleaseQueueStats GetReleaseQueueStats(Uint32 QueueIndex) const
+    {
+        VERIFY_EXPR(QueueIndex < m_CmdQueueCount);
+        return m_CommandQueues[QueueIndex].ReleaseQueue.GetStats();
     }
 
     void IdleCommandQueue(size_t QueueIdx, bool ReleaseResources)
@@ -319,6 +348,8 @@ protected:
     };
     const size_t  m_CmdQueueCount = 0;
     CommandQueue* m_CommandQueues = nullptr;
+
+    ResourcePurgeBudget m_PurgeBudget;
 };
 
 } // namespace Diligent
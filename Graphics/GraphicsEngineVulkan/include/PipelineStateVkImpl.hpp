@@ -83,6 +83,9 @@ public:
     /// Implementation of IPipelineState::GetStaticVariableByName() in Vulkan backend.
     virtual IShaderResourceVariable* DILIGENT_CALL_TYPE GetStaticVariableByName(SHADER_TYPE ShaderType, const Char* Name) override final;
 
+    /// Same as GetStaticVariableByName(), but uses the precomputed hash of the interned name
+    IShaderResourceVariable* GetStaticVariableByName(SHADER_TYPE ShaderType, const InternedString& Name);
+
     /// Implementation of IPipelineState::GetStaticVariableByIndex() in Vulkan backend.
     virtual IShaderResourceVariable* DILIGENT_CALL_TYPE GetStaticVariableByIndex(SHADER_TYPE ShaderType, Uint32 Index) override final;
 
@@ -112,9 +112,15 @@ public:
         {
             if (Hash == 0)
             {
-                Hash = ComputeHash(NumRenderTargets, SampleCount, DSVFormat);
+                // Pack the used members into a local buffer so that the hash does not
+                // depend on the structure layout, and hash it with a single call
+                Uint16 KeyData[3 + MAX_RENDER_TARGETS];
+                KeyData[0] = NumRenderTargets;
+                KeyData[1] = SampleCount;
+                KeyData[2] = DSVFormat;
                 for (Uint32 rt = 0; rt < NumRenderTargets; ++rt)
-                    HashCombine(Hash, RTVFormats[rt]);
+                    KeyData[3 + rt] = RTVFormats[rt];
+                Hash = static_cast<size_t>(ComputeFastHash(KeyData, sizeof(KeyData[0]) * (3 + NumRenderTargets)));
             }
             return Hash;
         }
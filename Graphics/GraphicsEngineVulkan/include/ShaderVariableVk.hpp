@@ -63,6 +63,7 @@
 
 #include "ShaderResourceLayoutVk.hpp"
 #include "ShaderResourceVariableBase.hpp"
+#include "StringInterner.hpp"
 
 namespace Diligent
 {
@@ -85,6 +86,7 @@ public:
     void DestroyVariables(IMemoryAllocator& Allocator);
 
     ShaderVariableVkImpl* GetVariable(const Char* Name);
+    ShaderVariableVkImpl* GetVariable(const InternedString& Name);
     ShaderVariableVkImpl* GetVariable(Uint32 Index);
 
     void BindResources(IResourceMapping* pResourceMapping, Uint32 Flags);
@@ -101,6 +103,14 @@ private:
 
     Uint32 GetVariableIndex(const ShaderVariableVkImpl& Variable);
 
+    // Variables are looked up by name through the open-addressing hash table that
+    // immediately follows the variables in the same memory block
+    static Uint32 GetNameTableSize(Uint32 NumVariables);
+    void          InitNameTable();
+    Uint32*       GetNameTable() const;
+
+    ShaderVariableVkImpl* FindVariable(const Char* Name, size_t Hash);
+
     IObject& m_Owner;
     // Variable mgr is owned by either Pipeline state object (in which case m_ResourceCache references
     // static resource cache owned by the same PSO object), or by SRB object (in which case
@@ -95,6 +95,8 @@ struct VulkanMemoryAllocation
 class VulkanMemoryPage
 {
 public:
+    using FreeBlockStatistics = Diligent::VariableSizeAllocationsManager::FreeBlockStatistics;
+
     VulkanMemoryPage(VulkanMemoryManager& ParentMemoryMgr,
                      VkDeviceSize         PageSize,
                      uint32_t             MemoryTypeIndex,
@@ -124,6 +126,8 @@ public:
 
     VulkanMemoryAllocation Allocate(VkDeviceSize size, VkDeviceSize alignment);
 
+    FreeBlockStatistics GetFreeBlockStatistics() const;
+
     VkDeviceMemory GetVkMemory() const { return m_VkMemory; }
     void*          GetCPUMemory() const { return m_CPUMemory; }
 
@@ -136,7 +140,7 @@ private:
     void Free(VulkanMemoryAllocation&& Allocation);
 
     VulkanMemoryManager&                     m_ParentMemoryMgr;
-    std::mutex                               m_Mutex;
+    mutable std::mutex                       m_Mutex;
     Diligent::VariableSizeAllocationsManager m_AllocationMgr;
     VulkanUtilities::DeviceMemoryWrapper     m_VkMemory;
     void*                                    m_CPUMemory = nullptr;
@@ -202,6 +206,13 @@ public:
     VulkanMemoryAllocation Allocate(const VkMemoryRequirements& MemReqs, VkMemoryPropertyFlags MemoryProps);
     void                   ShrinkMemory();
 
+    using FreeBlockStatistics = VulkanMemoryPage::FreeBlockStatistics;
+
+    // Returns free block statistics accumulated over all host-visible or all device-local pages.
+    // Note that an allocation cannot span multiple pages, so the largest free block is the largest
+    // block among all pages.
+    FreeBlockStatistics GetFreeBlockStatistics(bool HostVisible) const;
+
 protected:
     friend class VulkanMemoryPage;
 
@@ -215,7 +226,7 @@ protected:
 
     Diligent::IMemoryAllocator& m_Allocator;
 
-    std::mutex m_PagesMtx;
+    mutable std::mutex m_PagesMtx;
     struct MemoryPageIndex
     {
         const uint32_t MemoryTypeIndex;
@@ -245,6 +256,10 @@ protected:
     };
     std::unordered_multimap<MemoryPageIndex, VulkanMemoryPage, MemoryPageIndex::Hasher> m_Pages;
 
+    // Logs fragmentation of the pages with the given index when a new page had to be created
+    // for an allocation of AllocationSize bytes. Must be called without m_PagesMtx being locked.
+    void LogFragmentation(const MemoryPageIndex& PageIdx, const VulkanMemoryPage* pNewPage, VkDeviceSize AllocationSize) const;
+
     const VkDeviceSize m_DeviceLocalPageSize;
     const VkDeviceSize m_HostVisiblePageSize;
     const VkDeviceSize m_DeviceLocalReserveSize;
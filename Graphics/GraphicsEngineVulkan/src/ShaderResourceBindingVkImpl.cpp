@@ -126,6 +126,19 @@ IShaderResourceVariable* ShaderResourceBindingVkImpl::GetVariableByName(SHADER_T
     return m_pShaderVarMgrs[ResLayoutInd].GetVariable(Name);
 }
 
+IShaderResourceVariable* ShaderResourceBindingVkImpl::GetVariableByName(SHADER_TYPE ShaderType, const InternedString& Name)
+{
+    auto ShaderInd    = GetShaderTypeIndex(ShaderType);
+    auto ResLayoutInd = m_ResourceLayoutIndex[ShaderInd];
+    if (ResLayoutInd < 0)
+    {
+        LOG_WARNING_MESSAGE("Unable to find mutable/dynamic variable '", Name.GetStr(), "': shader stage ", GetShaderTypeLiteralName(ShaderType),
+                            " is inactive in Pipeline State '", m_pPSO->GetDesc().Name, "'.");
+        return nullptr;
+    }
+    return m_pShaderVarMgrs[ResLayoutInd].GetVariable(Name);
+}
+
 Uint32 ShaderResourceBindingVkImpl::GetVariableCount(SHADER_TYPE ShaderType) const
 {
     auto ShaderInd    = GetShaderTypeIndex(ShaderType);
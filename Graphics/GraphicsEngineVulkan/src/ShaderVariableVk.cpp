@@ -61,7 +61,71 @@ size_t ShaderVariableManagerVk::GetRequiredMemorySize(const ShaderResourceLayout
         }
     }
 
-    return NumVariables * sizeof(ShaderVariableVkImpl);
+    return NumVariables * sizeof(ShaderVariableVkImpl) + GetNameTableSize(NumVariables) * sizeof(Uint32);
+}
+
+Uint32 ShaderVariableManagerVk::GetNameTableSize(Uint32 NumVariables)
+{
+    if (NumVariables == 0)
+        return 0;
+
+    // Keep the load factor at or below 0.5
+    Uint32 TableSize = 4;
+    while (TableSize < NumVariables * 2)
+        TableSize *= 2;
+    return TableSize;
+}
+
+// Every table slot contains the variable index + 1 in the lower 16 bits (0 for empty slots)
+// and 16 bits of the name hash that are not used for indexing in the upper bits
+static constexpr Uint32 NameTableIndexMask = 0xFFFFu;
+
+static Uint32 GetNameHashTag(size_t Hash)
+{
+    return static_cast<Uint32>(Hash) & ~NameTableIndexMask;
+}
+
+Uint32* ShaderVariableManagerVk::GetNameTable() const
+{
+    return reinterpret_cast<Uint32*>(m_pVariables + m_NumVariables);
+}
+
+void ShaderVariableManagerVk::InitNameTable()
+{
+    VERIFY(m_NumVariables < NameTableIndexMask, "Too many variables");
+
+    auto*        pTable    = GetNameTable();
+    const Uint32 TableMask = GetNameTableSize(m_NumVariables) - 1;
+    memset(pTable, 0, (TableMask + 1) * sizeof(Uint32));
+    for (Uint32 v = 0; v < m_NumVariables; ++v)
+    {
+        const auto Hash = CStringHash<Char>{}(m_pVariables[v].m_Resource.SpirvAttribs.Name);
+
+        auto Slot = static_cast<Uint32>(Hash) & TableMask;
+        while (pTable[Slot] != 0)
+            Slot = (Slot + 1) & TableMask;
+        pTable[Slot] = GetNameHashTag(Hash) | (v + 1);
+    }
+}
+
+ShaderVariableVkImpl* ShaderVariableManagerVk::FindVariable(const Char* Name, size_t Hash)
+{
+    if (m_NumVariables == 0)
+        return nullptr;
+
+    const auto*  pTable    = GetNameTable();
+    const Uint32 TableMask = GetNameTableSize(m_NumVariables) - 1;
+    const auto   Tag       = GetNameHashTag(Hash);
+    for (auto Slot = static_cast<Uint32>(Hash) & TableMask; pTable[Slot] != 0; Slot = (Slot + 1) & TableMask)
+    {
+        if ((pTable[Slot] & ~NameTableIndexMask) != Tag)
+            continue;
+
+        auto& Var = m_pVariables[(pTable[Slot] & NameTableIndexMask) - 1];
+        if (strcmp(Var.m_Resource.SpirvAttribs.Name, Name) == 0)
+            return &Var;
+    }
+    return nullptr;
 }
 
 // Creates shader variable for every resource from SrcLayout whose type is one AllowedVarTypes
@@ -110,6 +174,8 @@ ShaderVariableManagerVk::ShaderVariableManagerVk(IObject&
         }
     }
     VERIFY_EXPR(VarInd == m_NumVariables);
+
+    InitNameTable();
 }
 
 ShaderVariableManagerVk::~ShaderVariableManagerVk()
@@ -132,18 +198,13 @@ void ShaderVariableManagerVk::DestroyVariables(IMemoryAllocator& Allocator)
 
 ShaderVariableVkImpl* ShaderVariableManagerVk::GetVariable(const Char* Name)
 {
-    ShaderVariableVkImpl* pVar = nullptr;
-    for (Uint32 v = 0; v < m_NumVariables; ++v)
-    {
-        auto&       Var = m_pVariables[v];
-        const auto& Res = Var.m_Resource;
-        if (strcmp(Res.SpirvAttribs.Name, Name) == 0)
-        {
-            pVar = &Var;
-            break;
-        }
-    }
-    return pVar;
+    return FindVariable(Name, CStringHash<Char>{}(Name));
+}
+
+ShaderVariableVkImpl* ShaderVariableManagerVk::GetVariable(const InternedString& Name)
+{
+    VERIFY(Name, "Name is null");
+    return FindVariable(Name.GetStr(), Name.GetHash());
 }
 
 
@@ -106,6 +106,12 @@ VulkanMemoryAllocation VulkanMemoryPage::Allocate(VkDeviceSize size, VkDeviceSiz
     }
 }
 
+VulkanMemoryPage::FreeBlockStatistics VulkanMemoryPage::GetFreeBlockStatistics() const
+{
+    std::lock_guard<std::mutex> Lock{m_Mutex};
+    return m_AllocationMgr.GetFreeBlockStatistics();
+}
+
 void VulkanMemoryPage::Free(VulkanMemoryAllocation&& Allocation)
 {
     m_ParentMemoryMgr.OnFreeAllocation(Allocation.Size, m_CPUMemory != nullptr);
@@ -159,8 +165,8 @@ VulkanMemoryAllocation VulkanMemoryManager::Allocate(VkDeviceSize Size, VkDevice
     // even though on integrated GPUs same pages can be used for both GPU-only and staging
     // allocations. Staging allocations are short-living and will be released when upload is
     // complete, while GPU-only allocations are expected to be long-living.
-    MemoryPageIndex             PageIdx{MemoryTypeIndex, HostVisible};
-    std::lock_guard<std::mutex> Lock{m_PagesMtx};
+    MemoryPageIndex              PageIdx{MemoryTypeIndex, HostVisible};
+    std::unique_lock<std::mutex> Lock{m_PagesMtx};
 
     auto range = m_Pages.equal_range(PageIdx);
     for (auto page_it = range.first; page_it != range.second; ++page_it)
@@ -171,6 +177,8 @@ VulkanMemoryAllocation VulkanMemoryManager::Allocate(VkDeviceSize Size, VkDevice
     }
 
     size_t stat_ind = HostVisible ? 1 : 0;
+
+    const VulkanMemoryPage* pNewPage = nullptr;
     if (Allocation.Page == nullptr)
     {
         auto PageSize = HostVisible ? m_HostVisiblePageSize : m_DeviceLocalPageSize;
@@ -187,6 +195,7 @@ VulkanMemoryAllocation VulkanMemoryManager::Allocate(VkDeviceSize Size, VkDevice
         OnNewPageCreated(it->second);
         Allocation = it->second.Allocate(Size, Alignment);
         DEV_CHECK_ERR(Allocation.Page != nullptr, "Failed to allocate new memory page");
+        pNewPage = &it->second;
     }
 
     if (Allocation.Page != nullptr)
@@ -196,6 +205,15 @@ VulkanMemoryAllocation VulkanMemoryManager::Allocate(VkDeviceSize Size, VkDevice
 
     m_CurrUsedSize[stat_ind].fetch_add(Allocation.Size);
     m_PeakUsedSize[stat_ind] = std::max(m_PeakUsedSize[stat_ind], static_cast<VkDeviceSize>(m_CurrUsedSize[stat_ind].load()));
+    Lock.unlock();
+
+#ifdef DILIGENT_DEVELOPMENT
+    // Walking all pages is only affordable in development builds
+    if (pNewPage != nullptr)
+        LogFragmentation(PageIdx, pNewPage, Size);
+#else
+    (void)pNewPage;
+#endif
 
     return Allocation;
 }
@@ -228,6 +246,44 @@ void VulkanMemoryManager::ShrinkMemory()
     }
 }
 
+VulkanMemoryManager::FreeBlockStatistics VulkanMemoryManager::GetFreeBlockStatistics(bool HostVisible) const
+{
+    FreeBlockStatistics Stats;
+
+    std::lock_guard<std::mutex> Lock{m_PagesMtx};
+    for (const auto& it : m_Pages)
+    {
+        if (it.first.IsHostVisible == HostVisible)
+            Stats += it.second.GetFreeBlockStatistics();
+    }
+    return Stats;
+}
+
+void VulkanMemoryManager::LogFragmentation(const MemoryPageIndex& PageIdx, const VulkanMemoryPage* pNewPage, VkDeviceSize AllocationSize) const
+{
+    FreeBlockStatistics FreeStats;
+    {
+        std::lock_guard<std::mutex> Lock{m_PagesMtx};
+
+        auto range = m_Pages.equal_range(PageIdx);
+        for (auto page_it = range.first; page_it != range.second; ++page_it)
+        {
+            // The page created for the allocation does not count
+            if (&page_it->second != pNewPage)
+                FreeStats += page_it->second.GetFreeBlockStatistics();
+        }
+    }
+
+    if (FreeStats.NumFreeBlocks > 0 && FreeStats.TotalFreeSize >= AllocationSize)
+    {
+        LOG_INFO_MESSAGE("VulkanMemoryManager '", m_MgrName, "': existing ", (PageIdx.IsHostVisible ? "host-visible" : "device-local"),
+                         " pages have ", Diligent::FormatMemorySize(FreeStats.TotalFreeSize, 2), " free in ", FreeStats.NumFreeBlocks,
+                         " blocks, but the largest block (", Diligent::FormatMemorySize(FreeStats.LargestFreeBlockSize, 2),
+                         ") cannot accommodate ", Diligent::FormatMemorySize(AllocationSize, 2),
+                         ". Fragmentation: ", static_cast<int>(FreeStats.GetFragmentation() * 100.0), "%");
+    }
+}
+
 void VulkanMemoryManager::OnFreeAllocation(VkDeviceSize Size, bool IsHostVisble)
 {
     m_CurrUsedSize[IsHostVisble ? 1 : 0].fetch_add(-static_cast<int64_t>(Size));
@@ -61,6 +61,17 @@ public:
     virtual void                     WaitForCopyScheduled()                  = 0;
     virtual MappedTextureSubresource GetMappedData(Uint32 Mip, Uint32 Slice) = 0;
     virtual const UploadBufferDesc&  GetDesc() const                         = 0;
+
+    /// Waits until the copy is scheduled or the timeout expires.
+    /// Returns true if the copy has been scheduled.
+
+    /// \remarks The default implementation ignores the timeout and waits
+    ///          until the copy is scheduled.
+    virtual bool WaitForCopyScheduledFor(Uint32 TimeoutMilliseconds)
+    {
+        WaitForCopyScheduled();
+        return true;
+    }
 };
 
 /// Texture uploader description.
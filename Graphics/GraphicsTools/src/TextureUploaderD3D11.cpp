@@ -82,6 +82,11 @@ public:
         m_CopyScheduledSignal.Wait();
     }
 
+    virtual bool WaitForCopyScheduledFor(Uint32 TimeoutMilliseconds) override final
+    {
+        return m_CopyScheduledSignal.WaitFor(std::chrono::milliseconds{TimeoutMilliseconds});
+    }
+
     bool DbgIsCopyScheduled()
     {
         return m_CopyScheduledSignal.IsTriggered();
@@ -102,9 +107,9 @@ public:
     ID3D11Texture2D* GetStagingTex() { return m_pStagingTexture; }
 
 private:
-    ThreadingTools::Signal   m_BufferMappedSignal;
-    ThreadingTools::Signal   m_CopyScheduledSignal;
-    CComPtr<ID3D11Texture2D> m_pStagingTexture;
+    ThreadingTools::CountingSignal m_BufferMappedSignal;
+    ThreadingTools::CountingSignal m_CopyScheduledSignal;
+    CComPtr<ID3D11Texture2D>       m_pStagingTexture;
 };
 
 } // namespace
@@ -108,6 +108,11 @@ public:
         m_CopyScheduledSignal.Wait();
     }
 
+    virtual bool WaitForCopyScheduledFor(Uint32 TimeoutMilliseconds) override final
+    {
+        return m_CopyScheduledSignal.WaitFor(std::chrono::milliseconds{TimeoutMilliseconds});
+    }
+
     ITexture* GetStagingTexture() { return m_pStagingTexture; }
 
     bool DbgIsCopyScheduled() const
@@ -127,8 +132,8 @@ public:
     }
 
 private:
-    ThreadingTools::Signal m_CopyScheduledSignal;
-    ThreadingTools::Signal m_TextureMappedSignal;
+    ThreadingTools::CountingSignal m_CopyScheduledSignal;
+    ThreadingTools::CountingSignal m_TextureMappedSignal;
 
     RefCntAutoPtr<ITexture> m_pStagingTexture;
     Uint64                  m_CopyScheduledFenceValue = 0;
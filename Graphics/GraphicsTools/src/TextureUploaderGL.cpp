@@ -98,6 +98,11 @@ public:
         m_CopyScheduledSignal.Wait();
     }
 
+    virtual bool WaitForCopyScheduledFor(Uint32 TimeoutMilliseconds) override final
+    {
+        return m_CopyScheduledSignal.WaitFor(std::chrono::milliseconds{TimeoutMilliseconds});
+    }
+
     bool DbgIsCopyScheduled() const { return m_CopyScheduledSignal.IsTriggered(); }
 
     void SetDataPtr(Uint8* pBufferData)
@@ -137,11 +142,11 @@ private:
     }
 
     friend TextureUploaderGL;
-    ThreadingTools::Signal m_BufferMappedSignal;
-    ThreadingTools::Signal m_CopyScheduledSignal;
-    RefCntAutoPtr<IBuffer> m_pStagingBuffer;
-    std::vector<Uint32>    m_SubresourceOffsets;
-    std::vector<Uint32>    m_SubresourceStrides;
+    ThreadingTools::CountingSignal m_BufferMappedSignal;
+    ThreadingTools::CountingSignal m_CopyScheduledSignal;
+    RefCntAutoPtr<IBuffer>         m_pStagingBuffer;
+    std::vector<Uint32>            m_SubresourceOffsets;
+    std::vector<Uint32>            m_SubresourceStrides;
 };
 
 } // namespace
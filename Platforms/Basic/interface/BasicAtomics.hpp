@@ -61,9 +61,10 @@ struct BasicAtomics
         return Comparand;
     }
 
+    // The function returns the resulting value.
     template <typename Type>
     static inline Type AtomicAdd(std::atomic<Type>& Destination, Type Val)
     {
-        return std::atomic_fetch_add(&Destination, Val);
+        return std::atomic_fetch_add(&Destination, Val) + Val;
     }
 };
@@ -50,6 +50,7 @@ struct WindowsAtomics
     // The function returns the initial value of the Destination parameter
     static Long AtomicCompareExchange(AtomicLong& Destination, Long Exchange, Long Comparand);
 
+    // The function returns the resulting value.
     static Long  AtomicAdd(AtomicLong& Destination, Long Val);
     static Int64 AtomicAdd(AtomicInt64& Destination, Int64 Val);
 };
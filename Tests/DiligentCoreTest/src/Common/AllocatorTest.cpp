@@ -25,8 +25,19 @@
  *  of the possibility of such damages.
  */
 
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <string>
+
 #include "DefaultRawMemoryAllocator.hpp"
 #include "FixedBlockMemoryAllocator.hpp"
+#include "LinearMemoryAllocator.hpp"
+#include "STDAllocator.hpp"
+#include "RefCntAutoPtr.hpp"
+#include "Timer.hpp"
 
 #include "gtest/gtest.h"
 
@@ -120,4 +131,486 @@ TEST(Common_FixedBlockMemoryAllocator, UnalignedSize)
     }
 }
 
+TEST(Common_FixedBlockMemoryAllocator, ThreadCache)
+{
+    constexpr Uint32 AllocSize             = 16;
+    constexpr Uint32 NumAllocationsPerPage = 8;
+    constexpr Uint32 ThreadCacheSize       = 4;
+
+    FixedBlockMemoryAllocator TestAllocator(DefaultRawMemoryAllocator::GetAllocator(), AllocSize, NumAllocationsPerPage, ThreadCacheSize);
+
+    // Allocate enough blocks to go through several cache refills and page allocations
+    std::vector<void*> Allocations(NumAllocationsPerPage * 5);
+    for (auto& Alloc : Allocations)
+    {
+        Alloc = TestAllocator.Allocate(AllocSize, "Thread cache test", __FILE__, __LINE__);
+        ASSERT_NE(Alloc, nullptr);
+        memset(Alloc, 0x5A, AllocSize);
+    }
+
+    auto SortedAllocations = Allocations;
+    std::sort(SortedAllocations.begin(), SortedAllocations.end());
+    EXPECT_EQ(std::unique(SortedAllocations.begin(), SortedAllocations.end()), SortedAllocations.end()) << "Same block was allocated twice";
+
+    // Free the blocks from another thread to make sure they are
+    // returned through that thread's cache when it exits
+    std::thread FreeThread{
+        [&]() {
+            for (size_t i = 0; i < Allocations.size(); i += 2)
+                TestAllocator.Free(Allocations[i]);
+        }};
+    FreeThread.join();
+
+    for (size_t i = 1; i < Allocations.size(); i += 2)
+        TestAllocator.Free(Allocations[i]);
+
+    // Blocks that are still in the cache of this thread are returned by the destructor
+}
+
+TEST(Common_FixedBlockMemoryAllocator, ThreadCacheAllocatorLifetime)
+{
+    constexpr Uint32 AllocSize = 32;
+
+    // Threads that outlive allocators must not touch the caches of destroyed allocators
+    std::thread Worker{
+        [&]() {
+            for (int i = 0; i < 64; ++i)
+            {
+                FixedBlockMemoryAllocator TestAllocator(DefaultRawMemoryAllocator::GetAllocator(), AllocSize, 4, 8);
+
+                void* Allocations[6] = {};
+                for (auto& Alloc : Allocations)
+                    Alloc = TestAllocator.Allocate(AllocSize, "Thread cache lifetime test", __FILE__, __LINE__);
+                for (auto* Alloc : Allocations)
+                    TestAllocator.Free(Alloc);
+            }
+        }};
+    Worker.join();
+}
+
+TEST(Common_FixedBlockMemoryAllocator, AlignedPages)
+{
+    for (Uint32 ThreadCacheSize : {0u, 8u})
+    {
+        for (Uint32 AllocSize : {8u, 24u, 64u, 1000u})
+        {
+            for (Uint32 NumAllocationsPerPage : {1u, 7u, 16u})
+            {
+                FixedBlockMemoryAllocator TestAllocator(DefaultRawMemoryAllocator::GetAllocator(), AllocSize, NumAllocationsPerPage, ThreadCacheSize, true);
+                // Aligned pages are only allocated on first use
+                EXPECT_EQ(TestAllocator.GetStatistics().NumPages, 0u);
+
+                std::vector<void*> Allocations(NumAllocationsPerPage * 20);
+                for (size_t i = 0; i < Allocations.size(); ++i)
+                {
+                    Allocations[i] = TestAllocator.Allocate(AllocSize, "Aligned page allocator test", __FILE__, __LINE__);
+                    ASSERT_NE(Allocations[i], nullptr);
+                    EXPECT_EQ(reinterpret_cast<size_t>(Allocations[i]) % sizeof(void*), size_t{0});
+                    memset(Allocations[i], static_cast<int>(i & 0xFF), AllocSize);
+                }
+
+                auto SortedAllocations = Allocations;
+                std::sort(SortedAllocations.begin(), SortedAllocations.end());
+                for (size_t i = 1; i < SortedAllocations.size(); ++i)
+                {
+                    EXPECT_GE(reinterpret_cast<Uint8*>(SortedAllocations[i]), reinterpret_cast<Uint8*>(SortedAllocations[i - 1]) + AllocSize) << "Allocations overlap";
+                }
+
+                for (size_t i = 0; i < Allocations.size(); ++i)
+                {
+                    EXPECT_EQ(*reinterpret_cast<Uint8*>(Allocations[i]), static_cast<Uint8>(i & 0xFF)) << "Allocation was overwritten";
+                }
+
+                // Free every other block and reallocate to make sure blocks are returned to the right pages
+                for (size_t i = 0; i < Allocations.size(); i += 2)
+                    TestAllocator.Free(Allocations[i]);
+                for (size_t i = 0; i < Allocations.size(); i += 2)
+                    Allocations[i] = TestAllocator.Allocate(AllocSize, "Aligned page allocator test", __FILE__, __LINE__);
+
+                for (auto* Alloc : Allocations)
+                    TestAllocator.Free(Alloc);
+            }
+        }
+    }
+}
+
+TEST(Common_FixedBlockMemoryAllocator, GrowingPages)
+{
+    constexpr size_t AllocSize = 32;
+
+    FixedBlockMemoryAllocator TestAllocator(DefaultRawMemoryAllocator::GetAllocator(), AllocSize, 4, 0, false, 32);
+
+    auto Stats = TestAllocator.GetStatistics();
+    EXPECT_EQ(Stats.NumPages, size_t{1});
+    EXPECT_EQ(Stats.NumBlocks, size_t{4});
+    EXPECT_EQ(Stats.NumAllocatedBlocks, size_t{0});
+    EXPECT_EQ(Stats.ReservedSize, 4 * AllocSize);
+
+    // Pages: 4, 8, 16, 32, 32, 32
+    std::vector<void*> Allocations(124);
+    for (size_t i = 0; i < Allocations.size(); ++i)
+    {
+        Allocations[i] = TestAllocator.Allocate(AllocSize, "Growing page allocator test", __FILE__, __LINE__);
+        ASSERT_NE(Allocations[i], nullptr);
+        memset(Allocations[i], static_cast<int>(i & 0xFF), AllocSize);
+    }
+
+    Stats = TestAllocator.GetStatistics();
+    EXPECT_EQ(Stats.NumPages, size_t{6});
+    EXPECT_EQ(Stats.NumBlocks, size_t{124});
+    EXPECT_EQ(Stats.NumAllocatedBlocks, size_t{124});
+    EXPECT_EQ(Stats.ReservedSize, 124 * AllocSize);
+
+    auto SortedAllocations = Allocations;
+    std::sort(SortedAllocations.begin(), SortedAllocations.end());
+    for (size_t i = 1; i < SortedAllocations.size(); ++i)
+    {
+        EXPECT_GE(reinterpret_cast<Uint8*>(SortedAllocations[i]), reinterpret_cast<Uint8*>(SortedAllocations[i - 1]) + AllocSize) << "Allocations overlap";
+    }
+
+    for (size_t i = 0; i < Allocations.size(); ++i)
+    {
+        EXPECT_EQ(*reinterpret_cast<Uint8*>(Allocations[i]), static_cast<Uint8>(i & 0xFF)) << "Allocation was overwritten";
+    }
+
+    for (size_t i = 0; i < Allocations.size(); i += 2)
+        TestAllocator.Free(Allocations[i]);
+
+    Stats = TestAllocator.GetStatistics();
+    EXPECT_EQ(Stats.NumAllocatedBlocks, size_t{62});
+
+    for (size_t i = 0; i < Allocations.size(); i += 2)
+        Allocations[i] = TestAllocator.Allocate(AllocSize, "Growing page allocator test", __FILE__, __LINE__);
+
+    // Freed blocks must be reused
+    Stats = TestAllocator.GetStatistics();
+    EXPECT_EQ(Stats.NumPages, size_t{6});
+    EXPECT_EQ(Stats.NumAllocatedBlocks, size_t{124});
+
+    for (auto* Alloc : Allocations)
+        TestAllocator.Free(Alloc);
+
+    Stats = TestAllocator.GetStatistics();
+    EXPECT_EQ(Stats.NumAllocatedBlocks, size_t{0});
+}
+
+TEST(Common_FixedBlockMemoryAllocator, DISABLED_MultithreadedPerformance)
+{
+    constexpr Uint32 AllocSize             = 64;
+    constexpr Uint32 NumAllocationsPerPage = 1024;
+    constexpr Uint32 NumLiveAllocations    = 256;
+    constexpr Uint32 NumIterations         = 256;
+
+    const Uint32 MaxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (int Config = 0; Config < 4; ++Config)
+    {
+        const Uint32 ThreadCacheSize = (Config & 0x01) ? 64 : 0;
+        const bool   AlignedPages    = (Config & 0x02) != 0;
+        for (Uint32 NumThreads = 1; NumThreads <= MaxThreads; NumThreads *= 2)
+        {
+            FixedBlockMemoryAllocator TestAllocator(DefaultRawMemoryAllocator::GetAllocator(), AllocSize, NumAllocationsPerPage, ThreadCacheSize, AlignedPages);
+
+            std::atomic_bool StartFlag{false};
+
+            std::vector<std::thread> Threads(NumThreads);
+            for (auto& Thread : Threads)
+            {
+                Thread = std::thread{
+                    [&]() {
+                        while (!StartFlag)
+                            std::this_thread::yield();
+
+                        std::vector<void*> Allocations(NumLiveAllocations);
+                        for (Uint32 iter = 0; iter < NumIterations; ++iter)
+                        {
+                            for (auto& Alloc : Allocations)
+                                Alloc = TestAllocator.Allocate(AllocSize, "Multithreaded allocator test", __FILE__, __LINE__);
+                            for (auto* Alloc : Allocations)
+                                TestAllocator.Free(Alloc);
+                        }
+                    }};
+            }
+
+            Timer T;
+            StartFlag = true;
+            for (auto& Thread : Threads)
+                Thread.join();
+            auto ElapsedTime = T.GetElapsedTime();
+
+            auto NumAllocations = double{NumLiveAllocations} * NumIterations * NumThreads;
+            LOG_INFO_MESSAGE("Thread cache size: ", ThreadCacheSize, ", aligned pages: ", (AlignedPages ? "yes" : "no"), ", threads: ", NumThreads, ": ",
+                             static_cast<Uint64>(NumAllocations / ElapsedTime), " allocs/s, ",
+                             static_cast<Uint64>(NumAllocations / NumThreads / ElapsedTime), " allocs/s per thread");
+        }
+    }
+}
+
+TEST(Common_LinearMemoryAllocator, AllocateReset)
+{
+    constexpr size_t PageSize = 1024;
+
+    LinearMemoryAllocator Allocator{DefaultRawMemoryAllocator::GetAllocator(), PageSize};
+    EXPECT_EQ(Allocator.GetReservedSize(), size_t{0});
+    EXPECT_EQ(Allocator.GetUsedSize(), size_t{0});
+
+    for (int Frame = 0; Frame < 3; ++Frame)
+    {
+        std::vector<void*> Allocations;
+        for (size_t Size : {1, 7, 16, 100, 255})
+        {
+            auto* Ptr = Allocator.Allocate(Size, "Linear allocator test", __FILE__, __LINE__);
+            ASSERT_NE(Ptr, nullptr);
+            EXPECT_EQ(reinterpret_cast<size_t>(Ptr) % alignof(std::max_align_t), size_t{0});
+            memset(Ptr, 0xFF, Size);
+            for (auto* OtherPtr : Allocations)
+                EXPECT_NE(Ptr, OtherPtr);
+            Allocations.push_back(Ptr);
+        }
+        EXPECT_EQ(Allocator.GetReservedSize(), PageSize);
+        EXPECT_GT(Allocator.GetUsedSize(), size_t{0});
+
+        for (auto* Ptr : Allocations)
+            Allocator.Free(Ptr);
+        Allocator.Reset();
+        EXPECT_EQ(Allocator.GetUsedSize(), size_t{0});
+        EXPECT_EQ(Allocator.GetReservedSize(), PageSize);
+    }
+
+    // The most recent allocation is rolled back
+    {
+        auto* Ptr0 = Allocator.Allocate(64, "Linear allocator test", __FILE__, __LINE__);
+        Allocator.Free(Ptr0);
+        auto* Ptr1 = Allocator.Allocate(32, "Linear allocator test", __FILE__, __LINE__);
+        EXPECT_EQ(Ptr0, Ptr1);
+        Allocator.Free(Ptr1);
+        EXPECT_EQ(Allocator.GetUsedSize(), size_t{0});
+    }
+
+    Allocator.ReleasePages();
+    EXPECT_EQ(Allocator.GetReservedSize(), size_t{0});
+}
+
+TEST(Common_LinearMemoryAllocator, PageCoalescing)
+{
+    constexpr size_t PageSize = 256;
+
+    LinearMemoryAllocator Allocator{DefaultRawMemoryAllocator::GetAllocator(), PageSize};
+
+    std::vector<void*> Allocations;
+    for (int i = 0; i < 16; ++i)
+        Allocations.push_back(Allocator.Allocate(64, "Linear allocator test", __FILE__, __LINE__));
+    // Allocation larger than the page size
+    Allocations.push_back(Allocator.Allocate(PageSize * 4, "Linear allocator test", __FILE__, __LINE__));
+    EXPECT_EQ(Allocator.GetReservedSize(), PageSize * 4 + PageSize * 4);
+
+    for (auto* Ptr : Allocations)
+        Allocator.Free(Ptr);
+    Allocations.clear();
+
+    // All pages are replaced with a single page
+    Allocator.Reset();
+    const auto ReservedSize = Allocator.GetReservedSize();
+    EXPECT_EQ(ReservedSize, PageSize * 4 + PageSize * 4);
+
+    auto* pFirst = Allocator.Allocate(64, "Linear allocator test", __FILE__, __LINE__);
+    Allocations.push_back(pFirst);
+    for (int i = 0; i < 15; ++i)
+        Allocations.push_back(Allocator.Allocate(64, "Linear allocator test", __FILE__, __LINE__));
+    Allocations.push_back(Allocator.Allocate(PageSize * 4, "Linear allocator test", __FILE__, __LINE__));
+    EXPECT_EQ(Allocator.GetReservedSize(), ReservedSize);
+    // All allocations are contiguous
+    EXPECT_EQ(reinterpret_cast<Uint8*>(Allocations.back()), reinterpret_cast<Uint8*>(pFirst) + 64 * 16);
+
+    for (auto* Ptr : Allocations)
+        Allocator.Free(Ptr);
+    Allocator.Reset();
+}
+
+TEST(Common_LinearMemoryAllocator, UsedSize)
+{
+    constexpr size_t PageSize  = 256;
+    constexpr size_t Alignment = alignof(std::max_align_t);
+
+    LinearMemoryAllocator Allocator{DefaultRawMemoryAllocator::GetAllocator(), PageSize};
+
+    auto* Ptr0 = Allocator.Allocate(PageSize - Alignment * 2, "Linear allocator test", __FILE__, __LINE__);
+    EXPECT_EQ(Allocator.GetUsedSize(), PageSize - Alignment * 2);
+
+    // The allocation does not fit into the first page. The unused tail of the page is not counted.
+    auto* Ptr1 = Allocator.Allocate(Alignment * 4, "Linear allocator test", __FILE__, __LINE__);
+    EXPECT_EQ(Allocator.GetReservedSize(), PageSize * 2);
+    EXPECT_EQ(Allocator.GetUsedSize(), PageSize + Alignment * 2);
+
+    Allocator.Free(Ptr1);
+    EXPECT_EQ(Allocator.GetUsedSize(), PageSize - Alignment * 2);
+    Allocator.Free(Ptr0);
+
+    Allocator.Reset();
+    EXPECT_EQ(Allocator.GetUsedSize(), size_t{0});
+}
+
+TEST(Common_LinearMemoryAllocator, STDAllocator)
+{
+    LinearMemoryAllocator Allocator{DefaultRawMemoryAllocator::GetAllocator(), 4096};
+
+    for (int Frame = 0; Frame < 4; ++Frame)
+    {
+        {
+            std::vector<int, STDAllocatorRawMem<int>> Vec(STD_ALLOCATOR_RAW_MEM(int, Allocator, "Allocator for vector<int>"));
+            for (int i = 0; i < 1000; ++i)
+                Vec.push_back(i);
+            for (int i = 0; i < 1000; ++i)
+                EXPECT_EQ(Vec[i], i);
+        }
+        Allocator.Reset();
+    }
+    // Vector growth requires 1000*4 + 512*4 + 256*4 + ... bytes that do not fit into one page,
+    // so the pages must have been coalesced
+    EXPECT_GT(Allocator.GetReservedSize(), size_t{4096});
+}
+
+TEST(Common_LinearMemoryAllocator, ThreadAllocator)
+{
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 2u);
+
+    std::vector<std::thread> Threads;
+    for (size_t t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back(
+            []() {
+                auto& Allocator = LinearMemoryAllocator::GetThreadAllocator();
+                EXPECT_EQ(&Allocator, &LinearMemoryAllocator::GetThreadAllocator());
+                for (int Frame = 0; Frame < 100; ++Frame)
+                {
+                    std::vector<float, STDAllocatorRawMem<float>> Vec(STD_ALLOCATOR_RAW_MEM(float, Allocator, "Allocator for vector<float>"));
+                    Vec.resize(128 + Frame, static_cast<float>(Frame));
+                    for (auto f : Vec)
+                        EXPECT_EQ(f, static_cast<float>(Frame));
+                    Vec.clear();
+                    Vec.shrink_to_fit();
+                    Allocator.Reset();
+                }
+            });
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+}
+
+TEST(Common_DefaultRawMemoryAllocator, AllocationTracking)
+{
+    DefaultRawMemoryAllocator Allocator;
+    EXPECT_FALSE(Allocator.IsAllocationTrackingEnabled());
+    EXPECT_TRUE(Allocator.GetAllocationSiteStats().empty());
+
+    static constexpr char Site0Desc[] = "Tracking test site 0";
+    static constexpr char Site1Desc[] = "Tracking test site 1";
+
+    // Allocation made while tracking is disabled is not tracked
+    auto* pUntracked = Allocator.Allocate(1000, Site0Desc, __FILE__, __LINE__);
+
+    Allocator.EnableAllocationTracking(true);
+    EXPECT_TRUE(Allocator.IsAllocationTrackingEnabled());
+
+    std::vector<void*> Site0Allocs, Site1Allocs;
+    for (size_t i = 0; i < 4; ++i)
+        Site0Allocs.push_back(Allocator.Allocate(16, Site0Desc, __FILE__, 1000));
+    for (size_t i = 0; i < 2; ++i)
+        Site1Allocs.push_back(Allocator.Allocate(256, Site1Desc, __FILE__, 2000));
+
+    {
+        auto Stats = Allocator.GetAllocationSiteStats();
+        ASSERT_EQ(Stats.size(), size_t{2});
+        // Sites are sorted by live bytes
+        EXPECT_EQ(Stats[0].Description, Site1Desc);
+        EXPECT_EQ(Stats[0].LineNumber, 2000);
+        EXPECT_EQ(Stats[0].LiveBytes, size_t{512});
+        EXPECT_EQ(Stats[0].NumLiveAllocations, size_t{2});
+        EXPECT_EQ(Stats[0].PeakLiveBytes, size_t{512});
+        EXPECT_EQ(Stats[0].TotalAllocations, Uint64{2});
+
+        EXPECT_EQ(Stats[1].Description, Site0Desc);
+        EXPECT_EQ(Stats[1].LineNumber, 1000);
+        EXPECT_EQ(Stats[1].LiveBytes, size_t{64});
+        EXPECT_EQ(Stats[1].NumLiveAllocations, size_t{4});
+
+        EXPECT_EQ(Allocator.GetAllocationSiteStats(1).size(), size_t{1});
+    }
+
+    Allocator.Free(pUntracked);
+    for (auto* Ptr : Site1Allocs)
+        Allocator.Free(Ptr);
+
+    {
+        auto Stats = Allocator.GetAllocationSiteStats();
+        ASSERT_EQ(Stats.size(), size_t{2});
+        EXPECT_EQ(Stats[0].Description, Site0Desc);
+        EXPECT_EQ(Stats[0].LiveBytes, size_t{64});
+        EXPECT_EQ(Stats[1].Description, Site1Desc);
+        EXPECT_EQ(Stats[1].LiveBytes, size_t{0});
+        EXPECT_EQ(Stats[1].NumLiveAllocations, size_t{0});
+        EXPECT_EQ(Stats[1].PeakLiveBytes, size_t{512});
+    }
+
+    {
+        RefCntAutoPtr<IDataBlob> pSnapshot;
+        Allocator.SnapshotAllocationSites(&pSnapshot);
+        ASSERT_NE(pSnapshot, nullptr);
+        const std::string Report{static_cast<const char*>(pSnapshot->GetConstDataPtr()), pSnapshot->GetSize()};
+        EXPECT_EQ(std::count(Report.begin(), Report.end(), '\n'), 2);
+        EXPECT_EQ(Report.find("64\t4\t64\t4\t"), size_t{0});
+        EXPECT_NE(Report.find(Site1Desc), std::string::npos);
+    }
+
+    // Releases are accounted for after tracking has been disabled
+    Allocator.EnableAllocationTracking(false);
+    for (auto* Ptr : Site0Allocs)
+        Allocator.Free(Ptr);
+    Allocator.Free(Allocator.Allocate(16, Site0Desc, __FILE__, 1000));
+    for (const auto& Site : Allocator.GetAllocationSiteStats())
+        EXPECT_EQ(Site.LiveBytes, size_t{0});
+    // Sites with no live allocations are sorted by the peak usage
+    EXPECT_EQ(Allocator.GetAllocationSiteStats().front().Description, Site1Desc);
+    EXPECT_EQ(Allocator.GetAllocationSiteStats().back().TotalAllocations, Uint64{4});
+}
+
+TEST(Common_DefaultRawMemoryAllocator, MultithreadedAllocationTracking)
+{
+    DefaultRawMemoryAllocator Allocator;
+    Allocator.EnableAllocationTracking(true);
+
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 2u);
+
+    constexpr size_t NumAllocations = 1000;
+    constexpr size_t AllocSize      = 32;
+
+    std::vector<std::thread> Threads;
+    for (size_t t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back(
+            [&Allocator]() {
+                std::vector<void*> Allocations;
+                for (size_t i = 0; i < NumAllocations; ++i)
+                {
+                    Allocations.push_back(Allocator.Allocate(AllocSize, "Shared site", __FILE__, __LINE__));
+                    // Every thread keeps every other allocation
+                    if (i % 2 == 1)
+                    {
+                        Allocator.Free(Allocations.back());
+                        Allocations.pop_back();
+                    }
+                }
+            });
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    auto Stats = Allocator.GetAllocationSiteStats();
+    ASSERT_EQ(Stats.size(), size_t{1});
+    EXPECT_EQ(Stats[0].NumLiveAllocations, NumThreads * NumAllocations / 2);
+    EXPECT_EQ(Stats[0].LiveBytes, NumThreads * NumAllocations / 2 * AllocSize);
+    EXPECT_EQ(Stats[0].TotalAllocations, Uint64{NumThreads * NumAllocations});
+    EXPECT_GE(Stats[0].PeakLiveBytes, Stats[0].LiveBytes);
+}
+
 } // namespace
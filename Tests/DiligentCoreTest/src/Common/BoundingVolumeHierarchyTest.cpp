@@ -0,0 +1,434 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "BoundingVolumeHierarchy.hpp"
+#include "FastRand.hpp"
+#include "Errors.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Generates small boxes scattered in a cube, similar to objects in a scene
+std::vector<BoundBox> MakeRandomScene(Uint32 NumBoxes, float SceneSize, float MaxBoxSize, FastRand::StateType Seed = 0)
+{
+    FastRandFloat Rnd{Seed, 0, 1};
+
+    std::vector<BoundBox> Boxes(NumBoxes);
+    for (auto& Box : Boxes)
+    {
+        const float3 Center = float3{Rnd(), Rnd(), Rnd()} * SceneSize - float3{SceneSize, SceneSize, SceneSize} * 0.5f;
+        const float3 Size   = float3{Rnd(), Rnd(), Rnd()} * MaxBoxSize;
+
+        Box.Min = Center - Size * 0.5f;
+        Box.Max = Center + Size * 0.5f;
+    }
+    return Boxes;
+}
+
+bool BoxContains(const BoundBox& Outer, const BoundBox& Inner)
+{
+    // clang-format off
+    return Outer.Min.x <= Inner.Min.x && Outer.Min.y <= Inner.Min.y && Outer.Min.z <= Inner.Min.z &&
+           Outer.Max.x >= Inner.Max.x && Outer.Max.y >= Inner.Max.y && Outer.Max.z >= Inner.Max.z;
+    // clang-format on
+}
+
+void VerifyHierarchy(const BoundingVolumeHierarchy& BVH, const std::vector<BoundBox>& Boxes, Uint32 MaxLeafSize)
+{
+    const auto& Nodes   = BVH.GetNodes();
+    const auto& PrimIds = BVH.GetPrimIds();
+    ASSERT_EQ(PrimIds.size(), Boxes.size());
+    if (Boxes.empty())
+    {
+        EXPECT_TRUE(Nodes.empty());
+        return;
+    }
+    EXPECT_LE(Nodes.size(), Boxes.size() * 2 - 1);
+
+    // Every primitive must be referenced exactly once
+    std::vector<Uint32> SortedIds = PrimIds;
+    std::sort(SortedIds.begin(), SortedIds.end());
+    for (Uint32 i = 0; i < SortedIds.size(); ++i)
+        ASSERT_EQ(SortedIds[i], i);
+
+    std::vector<bool> SlotReferenced(PrimIds.size(), false);
+    for (size_t n = 0; n < Nodes.size(); ++n)
+    {
+        const auto& Node = Nodes[n];
+        if (Node.IsLeaf())
+        {
+            EXPECT_LE(Node.NumPrims, MaxLeafSize);
+            for (Uint32 Slot = Node.FirstChildOrPrim; Slot < Node.FirstChildOrPrim + Node.NumPrims; ++Slot)
+            {
+                ASSERT_LT(Slot, PrimIds.size());
+                EXPECT_FALSE(SlotReferenced[Slot]);
+                SlotReferenced[Slot] = true;
+                EXPECT_TRUE(BoxContains(Node.Box, Boxes[PrimIds[Slot]]));
+            }
+        }
+        else
+        {
+            ASSERT_GT(Node.FirstChildOrPrim, n);
+            ASSERT_LT(Node.FirstChildOrPrim + 1, Nodes.size());
+            EXPECT_TRUE(BoxContains(Node.Box, Nodes[Node.FirstChildOrPrim].Box));
+            EXPECT_TRUE(BoxContains(Node.Box, Nodes[Node.FirstChildOrPrim + 1].Box));
+        }
+    }
+    EXPECT_TRUE(std::all_of(SlotReferenced.begin(), SlotReferenced.end(), [](bool b) { return b; }));
+}
+
+ViewFrustum MakeTestFrustum(const float3& Position, float Angle)
+{
+    const auto ViewProj = float4x4::Translation(-Position) * float4x4::RotationY(Angle) * float4x4::Projection(PI_F / 4.f, 1.5f, 1.f, 100.f, false);
+
+    ViewFrustum Frustum;
+    ExtractViewFrustumPlanesFromMatrix(ViewProj, Frustum, false);
+    return Frustum;
+}
+
+void TestQueries(const BoundingVolumeHierarchy& BVH, const std::vector<BoundBox>& Boxes)
+{
+    FastRandFloat Rnd{1, -1, 1};
+
+    for (int test = 0; test < 20; ++test)
+    {
+        const auto Frustum = MakeTestFrustum(float3{Rnd(), Rnd(), Rnd()} * 50.f, Rnd() * PI_F);
+        for (auto PlaneFlags : {FRUSTUM_PLANE_FLAG_FULL_FRUSTUM, FRUSTUM_PLANE_FLAG_OPEN_NEAR})
+        {
+            std::vector<Uint32> Visible;
+            BVH.QueryFrustum(Frustum, Visible, PlaneFlags);
+            std::sort(Visible.begin(), Visible.end());
+
+            std::vector<Uint32> RefVisible;
+            for (Uint32 i = 0; i < Boxes.size(); ++i)
+            {
+                if (GetBoxVisibility(Frustum, Boxes[i], PlaneFlags) != BoxVisibility::Invisible)
+                    RefVisible.push_back(i);
+            }
+            EXPECT_EQ(Visible, RefVisible);
+        }
+    }
+
+    for (int test = 0; test < 20; ++test)
+    {
+        const float3 Center = float3{Rnd(), Rnd(), Rnd()} * 50.f;
+        const float3 Size   = float3{std::abs(Rnd()), std::abs(Rnd()), std::abs(Rnd())} * 20.f;
+        const BoundBox QueryBox{Center - Size, Center + Size};
+
+        std::vector<Uint32> Overlapping;
+        BVH.QueryBox(QueryBox, Overlapping);
+        std::sort(Overlapping.begin(), Overlapping.end());
+
+        std::vector<Uint32> RefOverlapping;
+        for (Uint32 i = 0; i < Boxes.size(); ++i)
+        {
+            const auto& Box = Boxes[i];
+            if (Box.Min.x <= QueryBox.Max.x && Box.Max.x >= QueryBox.Min.x &&
+                Box.Min.y <= QueryBox.Max.y && Box.Max.y >= QueryBox.Min.y &&
+                Box.Min.z <= QueryBox.Max.z && Box.Max.z >= QueryBox.Min.z)
+                RefOverlapping.push_back(i);
+        }
+        EXPECT_EQ(Overlapping, RefOverlapping);
+    }
+
+    for (int test = 0; test < 100; ++test)
+    {
+        const float3 Origin    = float3{Rnd(), Rnd(), Rnd()} * 60.f;
+        const float3 Direction = normalize(float3{Rnd(), Rnd(), Rnd()} + float3{0, 0, 1e-3f});
+        const float  MaxDist   = test % 2 == 0 ? FLT_MAX : 30.f;
+
+        const auto Hit = BVH.QueryClosestHit(Origin, Direction, MaxDist);
+
+        const float3 InvDir = BoundingVolumeHierarchy::GetInverseDirection(Direction);
+
+        BoundingVolumeHierarchy::RayHit RefHit;
+        RefHit.Distance = MaxDist;
+        for (Uint32 i = 0; i < Boxes.size(); ++i)
+        {
+            float Dist = 0;
+            if (BoundingVolumeHierarchy::IntersectRayBox(Origin, InvDir, Boxes[i], RefHit.Distance, Dist))
+            {
+                RefHit.PrimId   = i;
+                RefHit.Distance = Dist;
+            }
+        }
+
+        EXPECT_EQ(static_cast<bool>(Hit), static_cast<bool>(RefHit));
+        EXPECT_EQ(Hit.Distance, RefHit.Distance);
+
+        // Custom primitive test: intersect spheres inscribed into the boxes
+        auto IntersectSphere = [&](Uint32 PrimId, float& Distance) {
+            const float3 Center = (Boxes[PrimId].Min + Boxes[PrimId].Max) * 0.5f;
+            const float  Radius = std::min(std::min(Boxes[PrimId].Max.x - Center.x, Boxes[PrimId].Max.y - Center.y), Boxes[PrimId].Max.z - Center.z);
+
+            const float3 OC   = Origin - Center;
+            const float  b    = dot(OC, Direction);
+            const float  c    = dot(OC, OC) - Radius * Radius;
+            const float  Disc = b * b - c;
+            if (Disc < 0)
+                return false;
+            const float t = -b - std::sqrt(Disc);
+            if (t < 0 || t >= Distance)
+                return false;
+            Distance = t;
+            return true;
+        };
+        const auto SphereHit = BVH.QueryClosestHit(Origin, Direction, MaxDist, IntersectSphere);
+
+        BoundingVolumeHierarchy::RayHit RefSphereHit;
+        RefSphereHit.Distance = MaxDist;
+        for (Uint32 i = 0; i < Boxes.size(); ++i)
+        {
+            float Dist = RefSphereHit.Distance;
+            if (IntersectSphere(i, Dist))
+            {
+                RefSphereHit.PrimId   = i;
+                RefSphereHit.Distance = Dist;
+            }
+        }
+        EXPECT_EQ(SphereHit.PrimId, RefSphereHit.PrimId);
+        EXPECT_EQ(SphereHit.Distance, RefSphereHit.Distance);
+    }
+}
+
+TEST(Common_BoundingVolumeHierarchy, Build)
+{
+    for (Uint32 NumBoxes : {0u, 1u, 2u, 5u, 100u, 3000u})
+    {
+        const auto Boxes = MakeRandomScene(NumBoxes, 100.f, 5.f);
+        for (Uint32 MaxLeafSize : {1u, 4u, 8u})
+        {
+            BoundingVolumeHierarchy::BuildAttribs Attribs;
+            Attribs.MaxLeafSize = MaxLeafSize;
+
+            BoundingVolumeHierarchy BVH;
+            BVH.Build(Boxes.data(), NumBoxes, Attribs);
+            VerifyHierarchy(BVH, Boxes, MaxLeafSize);
+            TestQueries(BVH, Boxes);
+        }
+    }
+}
+
+TEST(Common_BoundingVolumeHierarchy, DegenerateScenes)
+{
+    // All boxes are the same
+    {
+        const std::vector<BoundBox> Boxes(1000, BoundBox{float3{-1, -1, -1}, float3{1, 1, 1}});
+
+        BoundingVolumeHierarchy BVH;
+        BVH.Build(Boxes.data(), static_cast<Uint32>(Boxes.size()));
+        VerifyHierarchy(BVH, Boxes, BoundingVolumeHierarchy::BuildAttribs{}.MaxLeafSize);
+        EXPECT_LE(BVH.GetDepth(), 12u);
+        TestQueries(BVH, Boxes);
+    }
+
+    // Boxes along a line with exponentially growing spacing, which makes SAH produce a very unbalanced tree
+    {
+        std::vector<BoundBox> Boxes(20000);
+        for (size_t i = 0; i < Boxes.size(); ++i)
+        {
+            const float x = std::pow(1.002f, static_cast<float>(i));
+            Boxes[i]      = BoundBox{float3{x, 0, 0}, float3{x + 0.1f, 1, 1}};
+        }
+
+        BoundingVolumeHierarchy BVH;
+        BVH.Build(Boxes.data(), static_cast<Uint32>(Boxes.size()));
+        VerifyHierarchy(BVH, Boxes, BoundingVolumeHierarchy::BuildAttribs{}.MaxLeafSize);
+        EXPECT_LE(BVH.GetDepth(), 64u);
+    }
+}
+
+TEST(Common_BoundingVolumeHierarchy, ParallelBuild)
+{
+    const auto Boxes = MakeRandomScene(20000, 100.f, 2.f);
+
+    BoundingVolumeHierarchy::BuildAttribs Attribs;
+
+    BoundingVolumeHierarchy RefBVH;
+    RefBVH.Build(Boxes.data(), static_cast<Uint32>(Boxes.size()), Attribs);
+
+    for (Uint32 NumThreads : {2u, 3u, 8u})
+    {
+        Attribs.NumThreads = NumThreads;
+
+        BoundingVolumeHierarchy BVH;
+        BVH.Build(Boxes.data(), static_cast<Uint32>(Boxes.size()), Attribs);
+        VerifyHierarchy(BVH, Boxes, Attribs.MaxLeafSize);
+
+        // The parallel builder makes the same splits, only the node order is different
+        EXPECT_EQ(BVH.GetNodes().size(), RefBVH.GetNodes().size());
+        EXPECT_EQ(BVH.GetPrimIds(), RefBVH.GetPrimIds());
+        EXPECT_EQ(BVH.GetDepth(), RefBVH.GetDepth());
+        TestQueries(BVH, Boxes);
+    }
+}
+
+TEST(Common_BoundingVolumeHierarchy, Refit)
+{
+    auto Boxes = MakeRandomScene(5000, 100.f, 5.f);
+
+    BoundingVolumeHierarchy BVH;
+    BVH.Build(Boxes.data(), static_cast<Uint32>(Boxes.size()));
+
+    FastRandFloat Rnd{2, -10, 10};
+
+    // Move all boxes
+    for (auto& Box : Boxes)
+    {
+        const float3 Offset{Rnd(), Rnd(), Rnd()};
+        Box.Min += Offset;
+        Box.Max += Offset;
+    }
+    BVH.Refit(Boxes.data());
+    VerifyHierarchy(BVH, Boxes, BoundingVolumeHierarchy::BuildAttribs{}.MaxLeafSize);
+    TestQueries(BVH, Boxes);
+
+    // Move a few boxes, some of them far away, so that the bounds grow and shrink
+    std::vector<Uint32> MovedIds;
+    for (Uint32 i = 0; i < Boxes.size(); i += 97)
+    {
+        const float3 Offset = float3{Rnd(), Rnd(), Rnd()} * (i % 2 == 0 ? 20.f : 1.f);
+        Boxes[i].Min += Offset;
+        Boxes[i].Max += Offset;
+        MovedIds.push_back(i);
+    }
+    BVH.RefitPrimitives(MovedIds.data(), static_cast<Uint32>(MovedIds.size()), Boxes.data());
+    VerifyHierarchy(BVH, Boxes, BoundingVolumeHierarchy::BuildAttribs{}.MaxLeafSize);
+    TestQueries(BVH, Boxes);
+
+    // Incremental refit must produce exactly the same boxes as the full refit
+    BoundingVolumeHierarchy RefBVH;
+    RefBVH.Build(Boxes.data(), static_cast<Uint32>(Boxes.size()));
+    auto Nodes = BVH.GetNodes();
+    BVH.Refit(Boxes.data());
+    for (size_t i = 0; i < Nodes.size(); ++i)
+    {
+        EXPECT_EQ(Nodes[i].Box.Min, BVH.GetNodes()[i].Box.Min);
+        EXPECT_EQ(Nodes[i].Box.Max, BVH.GetNodes()[i].Box.Max);
+    }
+}
+
+template <typename OpType>
+double MeasureTime(OpType Op)
+{
+    const auto StartTime = std::chrono::high_resolution_clock::now();
+    Op();
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - StartTime).count();
+}
+
+TEST(Common_BoundingVolumeHierarchy, DISABLED_Performance)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 NumBoxes   = 10000;
+    constexpr int    NumQueries = 10;
+#else
+    constexpr Uint32 NumBoxes   = 200000;
+    constexpr int    NumQueries = 100;
+#endif
+
+    const auto Boxes = MakeRandomScene(NumBoxes, 1000.f, 5.f);
+
+    BoundingVolumeHierarchy               BVH;
+    BoundingVolumeHierarchy::BuildAttribs Attribs;
+    for (Uint32 NumThreads : {1u, 4u})
+    {
+        Attribs.NumThreads = NumThreads;
+        const double Time  = MeasureTime([&]() { BVH.Build(Boxes.data(), NumBoxes, Attribs); });
+        LOG_INFO_MESSAGE("Build (", NumThreads, " thread(s)): ", Time * 1e+3, " ms for ", NumBoxes, " boxes, ",
+                         BVH.GetNodes().size(), " nodes, depth ", BVH.GetDepth());
+    }
+
+    LOG_INFO_MESSAGE("Refit: ", MeasureTime([&]() { BVH.Refit(Boxes.data()); }) * 1e+3, " ms");
+
+    std::vector<ViewFrustum> Frustums;
+    FastRandFloat            Rnd{3, -1, 1};
+    for (int i = 0; i < NumQueries; ++i)
+        Frustums.push_back(MakeTestFrustum(float3{Rnd(), Rnd(), Rnd()} * 400.f, Rnd() * PI_F));
+
+    std::vector<Uint32> Visible;
+    Visible.reserve(NumBoxes);
+    size_t NumVisible = 0;
+
+    double Time = MeasureTime([&]() {
+        for (const auto& Frustum : Frustums)
+        {
+            Visible.clear();
+            BVH.QueryFrustum(Frustum, Visible);
+            NumVisible += Visible.size();
+        }
+    });
+    LOG_INFO_MESSAGE("Frustum query (BVH):         ", Time / NumQueries * 1e+6, " us, ", NumVisible / NumQueries, " visible boxes on average");
+
+    Time = MeasureTime([&]() {
+        for (const auto& Frustum : Frustums)
+        {
+            Visible.clear();
+            for (Uint32 i = 0; i < NumBoxes; ++i)
+            {
+                if (GetBoxVisibility(Frustum, Boxes[i]) != BoxVisibility::Invisible)
+                    Visible.push_back(i);
+            }
+        }
+    });
+    LOG_INFO_MESSAGE("Frustum query (brute force): ", Time / NumQueries * 1e+6, " us");
+
+    constexpr int NumRays = NumQueries * 100;
+
+    std::vector<float3> Origins, Directions;
+    for (int i = 0; i < NumRays; ++i)
+    {
+        Origins.push_back(float3{Rnd(), Rnd(), Rnd()} * 500.f);
+        Directions.push_back(normalize(float3{Rnd(), Rnd(), Rnd()} + float3{0, 0, 1e-3f}));
+    }
+
+    size_t NumHits = 0;
+    Time           = MeasureTime([&]() {
+        for (int i = 0; i < NumRays; ++i)
+            NumHits += BVH.QueryClosestHit(Origins[i], Directions[i]) ? 1 : 0;
+    });
+    LOG_INFO_MESSAGE("Ray query (BVH): ", NumRays / Time * 1e-6, " Mrays/s, ", NumHits, " hits of ", NumRays);
+
+    std::vector<Uint32> Overlapping;
+    Time = MeasureTime([&]() {
+        for (int i = 0; i < NumRays; ++i)
+        {
+            Overlapping.clear();
+            BVH.QueryBox(BoundBox{Origins[i] - float3{10, 10, 10}, Origins[i] + float3{10, 10, 10}}, Overlapping);
+        }
+    });
+    LOG_INFO_MESSAGE("Box query (BVH): ", Time / NumRays * 1e+6, " us");
+}
+
+} // namespace
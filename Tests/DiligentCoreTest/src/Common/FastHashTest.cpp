@@ -0,0 +1,232 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <cstddef>
+#include <vector>
+#include <unordered_set>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include "FastHash.hpp"
+#include "HashUtils.hpp"
+#include "FastRand.hpp"
+#include "PlatformMisc.hpp"
+#include "Errors.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+std::vector<Uint8> MakeRandomData(size_t Size, Uint32 Seed)
+{
+    FastRand           Rnd{Seed};
+    std::vector<Uint8> Data(Size);
+    for (auto& b : Data)
+        b = static_cast<Uint8>(Rnd());
+    return Data;
+}
+
+TEST(Common_FastHash, Basic)
+{
+    const auto Data = MakeRandomData(256, 0);
+    for (size_t Size = 0; Size <= Data.size(); ++Size)
+    {
+        const auto Hash = ComputeFastHash(Data.data(), Size);
+        EXPECT_EQ(Hash, ComputeFastHash(Data.data(), Size)) << "Size: " << Size;
+        EXPECT_NE(Hash, ComputeFastHash(Data.data(), Size, 1)) << "Size: " << Size;
+        if (Size > 0)
+        {
+            EXPECT_NE(Hash, ComputeFastHash(Data.data(), Size - 1)) << "Size: " << Size;
+            EXPECT_NE(Hash, ComputeFastHash(Data.data() + 1, Size - 1)) << "Size: " << Size;
+        }
+    }
+
+    const char* Str = "Diligent Engine";
+    EXPECT_EQ(ComputeFastStringHash(Str), ComputeFastHash(Str, strlen(Str)));
+    EXPECT_EQ(CStringHash<Char>{}(Str), static_cast<size_t>(ComputeFastStringHash(Str)));
+    EXPECT_NE(ComputeFastStringHash("abc"), ComputeFastStringHash("abd"));
+
+    const Uint32 Val = 0x12345678u;
+    EXPECT_EQ(ComputePODHash(Val), ComputeFastHash(&Val, sizeof(Val)));
+}
+
+// Checks that typical cache keys (small integers, structures that differ in a single field,
+// similar strings) produce no 64-bit collisions and spread evenly over hash table buckets.
+TEST(Common_FastHash, CollisionQuality)
+{
+    constexpr Uint32 NumKeys    = 1 << 18;
+    constexpr Uint32 NumBuckets = 1 << 12;
+
+    auto TestKeys = [&](const char* KeyType, std::function<Uint64(Uint32)> HashKey) {
+        std::unordered_set<Uint64> Hashes;
+        std::vector<Uint32>        Buckets(NumBuckets);
+        for (Uint32 i = 0; i < NumKeys; ++i)
+        {
+            const auto Hash = HashKey(i);
+            Hashes.insert(Hash);
+            ++Buckets[Hash & (NumBuckets - 1)];
+        }
+        EXPECT_EQ(Hashes.size(), size_t{NumKeys}) << KeyType << ": 64-bit hash collisions";
+
+        // Chi-squared test of the low bits, which are used by hash tables to select the bucket
+        const double Expected = static_cast<double>(NumKeys) / NumBuckets;
+        double       ChiSq    = 0;
+        for (auto Count : Buckets)
+            ChiSq += (Count - Expected) * (Count - Expected) / Expected;
+        // For 4095 degrees of freedom, the 99.9% quantile is about 4440
+        EXPECT_LT(ChiSq, 4440.0) << KeyType << ": non-uniform bucket distribution";
+    };
+
+    TestKeys("Sequential integers", [](Uint32 i) { return ComputePODHash(i); });
+
+    struct KeyStruct
+    {
+        Uint8  NumRenderTargets;
+        Uint8  SampleCount;
+        Uint16 DSVFormat;
+        Uint16 RTVFormats[8];
+    };
+    TestKeys("Structures", [](Uint32 i) {
+        KeyStruct Key         = {};
+        Key.NumRenderTargets  = static_cast<Uint8>(i & 0x7);
+        Key.SampleCount       = static_cast<Uint8>((i >> 3) & 0x7);
+        Key.RTVFormats[i % 8] = static_cast<Uint16>(i >> 6);
+        return ComputePODHash(Key);
+    });
+
+    TestKeys("Strings", [](Uint32 i) {
+        const auto Str = std::string{"g_Texture"} + std::to_string(i);
+        return ComputeFastStringHash(Str.c_str());
+    });
+}
+
+// Flipping any input bit must change about half of the output bits
+TEST(Common_FastHash, Avalanche)
+{
+    for (size_t Size : {4, 8, 16, 33, 100})
+    {
+        auto Data = MakeRandomData(Size, static_cast<Uint32>(Size));
+
+        double TotalChangedBits = 0;
+        Uint32 MinChangedBits   = 64;
+        for (size_t bit = 0; bit < Size * 8; ++bit)
+        {
+            const auto Hash0 = ComputeFastHash(Data.data(), Size);
+            Data[bit / 8] ^= static_cast<Uint8>(1u << (bit % 8));
+            const auto Hash1 = ComputeFastHash(Data.data(), Size);
+            Data[bit / 8] ^= static_cast<Uint8>(1u << (bit % 8));
+
+            const auto NumChangedBits = PlatformMisc::CountOneBits(Hash0 ^ Hash1);
+            TotalChangedBits += NumChangedBits;
+            MinChangedBits = std::min(MinChangedBits, NumChangedBits);
+        }
+        const auto AvgChangedBits = TotalChangedBits / static_cast<double>(Size * 8);
+        EXPECT_NEAR(AvgChangedBits, 32.0, 2.0) << "Size: " << Size;
+        EXPECT_GE(MinChangedBits, 12u) << "Size: " << Size;
+    }
+}
+
+TEST(Common_FastHash, DISABLED_Performance)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 NumIterations = 20000;
+#else
+    constexpr Uint32 NumIterations = 4000000;
+#endif
+
+    // Typical render pass cache keys
+    struct RenderPassKey
+    {
+        Uint8  NumRenderTargets;
+        Uint8  SampleCount;
+        Uint16 DSVFormat;
+        Uint16 RTVFormats[8];
+    };
+    constexpr Uint32           NumKeys = 1024;
+    std::vector<RenderPassKey> Keys(NumKeys);
+    FastRandInt                Rnd{0, 0, 100};
+    for (auto& Key : Keys)
+    {
+        Key.NumRenderTargets = static_cast<Uint8>(Rnd() % 9);
+        Key.SampleCount      = static_cast<Uint8>(1 + Rnd() % 4);
+        Key.DSVFormat        = static_cast<Uint16>(Rnd());
+        for (auto& Fmt : Key.RTVFormats)
+            Fmt = static_cast<Uint16>(Rnd());
+    }
+
+    std::vector<std::string> Strings(NumKeys);
+    for (Uint32 i = 0; i < NumKeys; ++i)
+        Strings[i] = "g_ShadowMap_sampler" + std::to_string(i);
+
+    auto Measure = [&](const char* Name, std::function<size_t(Uint32)> Hash) {
+        size_t     Dummy     = 0;
+        const auto StartTime = std::chrono::high_resolution_clock::now();
+        for (Uint32 i = 0; i < NumIterations; ++i)
+            Dummy += Hash(i % NumKeys);
+        const auto ElapsedTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - StartTime).count();
+        LOG_INFO_MESSAGE(Name, ": ", ElapsedTime / NumIterations * 1e+9, " ns per key (", Dummy & 1, ")");
+    };
+
+    Measure("HashCombine    (key)   ", [&](Uint32 i) {
+        const auto& Key  = Keys[i];
+        size_t      Hash = ComputeHash(Key.NumRenderTargets, Key.SampleCount, Key.DSVFormat);
+        for (Uint32 rt = 0; rt < Key.NumRenderTargets; ++rt)
+            HashCombine(Hash, Key.RTVFormats[rt]);
+        return Hash;
+    });
+    Measure("ComputeFastHash(key)   ", [&](Uint32 i) {
+        // Hash the used part of the key in place
+        const auto& Key = Keys[i];
+        return static_cast<size_t>(ComputeFastHash(&Key, offsetof(RenderPassKey, RTVFormats) + sizeof(Key.RTVFormats[0]) * Key.NumRenderTargets));
+    });
+    Measure("ComputePODHash (key)   ", [&](Uint32 i) {
+        return static_cast<size_t>(ComputePODHash(Keys[i]));
+    });
+
+    Measure("sdbm           (string)", [&](Uint32 i) {
+        size_t Seed = 0;
+        for (const char* c = Strings[i].c_str(); *c != 0; ++c)
+            Seed = Seed * 65599 + static_cast<size_t>(*c);
+        return Seed;
+    });
+    Measure("ComputeFastHash(string)", [&](Uint32 i) {
+        return static_cast<size_t>(ComputeFastStringHash(Strings[i].c_str()));
+    });
+
+    const auto Data = MakeRandomData(4096, 2);
+    Measure("ComputeFastHash(4 KB)  ", [&](Uint32 i) {
+        return static_cast<size_t>(ComputeFastHash(Data.data(), Data.size(), i));
+    });
+}
+
+} // namespace
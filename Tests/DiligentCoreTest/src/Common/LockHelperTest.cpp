@@ -0,0 +1,299 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+
+#include "LockHelper.hpp"
+#include "Errors.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace ThreadingTools;
+
+namespace
+{
+
+TEST(Common_LockHelper, SharedLockFlag)
+{
+    SharedLockFlag LockFlag;
+
+    EXPECT_TRUE(LockFlag.TryLockShared());
+    EXPECT_TRUE(LockFlag.TryLockShared());
+    EXPECT_FALSE(LockFlag.TryLock());
+    LockFlag.UnlockShared();
+    EXPECT_FALSE(LockFlag.TryLock());
+    LockFlag.UnlockShared();
+
+    EXPECT_TRUE(LockFlag.TryLock());
+    EXPECT_FALSE(LockFlag.TryLock());
+    EXPECT_FALSE(LockFlag.TryLockShared());
+    LockFlag.Unlock();
+
+    {
+        SharedLockHelper Lock0{LockFlag};
+        SharedLockHelper Lock1{LockFlag};
+        EXPECT_FALSE(LockFlag.TryLock());
+    }
+    {
+        ExclusiveLockHelper Lock{LockFlag};
+        EXPECT_FALSE(LockFlag.TryLockShared());
+    }
+    EXPECT_TRUE(LockFlag.TryLock());
+    LockFlag.Unlock();
+}
+
+TEST(Common_LockHelper, SharedLockFlagStress)
+{
+    SharedLockFlag LockFlag;
+
+    // Writers keep the two values equal. Readers must never observe them different.
+    Uint32 Value0 = 0;
+    Uint32 Value1 = 0;
+
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 4u);
+
+    constexpr Uint32 NumIterations = 10000;
+
+    std::atomic<Uint32>      NumMismatches{0};
+    std::vector<std::thread> Threads;
+    for (Uint32 t = 0; t < NumThreads; ++t)
+    {
+        const bool IsWriter = (t % 4) == 0;
+        Threads.emplace_back(
+            [&, IsWriter]() {
+                for (Uint32 i = 0; i < NumIterations; ++i)
+                {
+                    if (IsWriter)
+                    {
+                        ExclusiveLockHelper Lock{LockFlag};
+                        ++Value0;
+                        ++Value1;
+                    }
+                    else
+                    {
+                        SharedLockHelper Lock{LockFlag};
+                        if (Value0 != Value1)
+                            NumMismatches.fetch_add(1);
+                    }
+                }
+            });
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    const Uint32 NumWriters = (NumThreads + 3) / 4;
+    EXPECT_EQ(NumMismatches.load(), Uint32{0});
+    EXPECT_EQ(Value0, NumWriters * NumIterations);
+    EXPECT_EQ(Value1, NumWriters * NumIterations);
+}
+
+TEST(Common_LockHelper, LockFlag)
+{
+    LockFlag Flag;
+    EXPECT_EQ(static_cast<Atomics::Long>(Flag), LockFlag::LOCK_FLAG_UNLOCKED);
+    {
+        LockHelper Lock{Flag};
+        EXPECT_EQ(static_cast<Atomics::Long>(Flag), LockFlag::LOCK_FLAG_LOCKED);
+        EXPECT_FALSE(LockHelper::UnsafeTryLock(Flag));
+
+        LockHelper Lock2{std::move(Lock)};
+        EXPECT_EQ(static_cast<Atomics::Long>(Flag), LockFlag::LOCK_FLAG_LOCKED);
+    }
+    EXPECT_EQ(static_cast<Atomics::Long>(Flag), LockFlag::LOCK_FLAG_UNLOCKED);
+
+    LockHelper Lock;
+    EXPECT_TRUE(Lock.TryLock(Flag));
+    Lock.Unlock();
+    EXPECT_EQ(static_cast<Atomics::Long>(Flag), LockFlag::LOCK_FLAG_UNLOCKED);
+}
+
+TEST(Common_LockHelper, AdaptiveLockFlag)
+{
+    AdaptiveLockFlag LockFlag;
+    EXPECT_FALSE(LockFlag.IsLocked());
+    EXPECT_TRUE(LockFlag.TryLock());
+    EXPECT_TRUE(LockFlag.IsLocked());
+    EXPECT_FALSE(LockFlag.TryLock());
+    LockFlag.Unlock();
+    EXPECT_FALSE(LockFlag.IsLocked());
+
+    LockFlag.Lock();
+    EXPECT_TRUE(LockFlag.IsLocked());
+
+    // The waiting thread must go to sleep after it runs out of spins
+    AdaptiveLockFlag::ResetContentionStats();
+    AdaptiveLockFlag::EnableContentionStats(true);
+
+    std::atomic<bool> Acquired{false};
+    std::thread       Waiter{
+        [&]() {
+            LockFlag.Lock(16);
+            Acquired.store(true);
+            LockFlag.Unlock();
+        }};
+    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    EXPECT_FALSE(Acquired.load());
+    LockFlag.Unlock();
+    Waiter.join();
+    EXPECT_TRUE(Acquired.load());
+    EXPECT_FALSE(LockFlag.IsLocked());
+
+    AdaptiveLockFlag::EnableContentionStats(false);
+    const auto Stats = AdaptiveLockFlag::GetContentionStats();
+    EXPECT_EQ(Stats.NumContendedLocks, Uint64{1});
+    EXPECT_LE(Stats.NumSpins, Uint64{16});
+    EXPECT_GE(Stats.NumParks, Uint64{1});
+}
+
+template <typename LockType, typename GuardType>
+double RunLockStress(LockType& Lock, Uint32 NumThreads, Uint32 NumIterations, Uint32 WorkSize, Uint64& Counter)
+{
+    std::vector<std::thread> Threads;
+
+    volatile Uint64* pCounter = &Counter;
+
+    const auto StartCPUTime = std::clock();
+    for (Uint32 t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back(
+            [&]() {
+                for (Uint32 i = 0; i < NumIterations; ++i)
+                {
+                    GuardType Guard{Lock};
+                    // Keep the lock for some time to create contention
+                    for (Uint32 w = 0; w < WorkSize; ++w)
+                        *pCounter = *pCounter + 1;
+                }
+            });
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    return static_cast<double>(std::clock() - StartCPUTime) / CLOCKS_PER_SEC;
+}
+
+struct AdaptiveLockGuard
+{
+    explicit AdaptiveLockGuard(AdaptiveLockFlag& Flag) :
+        m_Flag{Flag}
+    {
+        m_Flag.Lock();
+    }
+    ~AdaptiveLockGuard()
+    {
+        m_Flag.Unlock();
+    }
+    AdaptiveLockFlag& m_Flag;
+};
+
+TEST(Common_LockHelper, AdaptiveLockFlagStress)
+{
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 4u);
+
+    constexpr Uint32 NumIterations = 20000;
+
+    AdaptiveLockFlag AdaptiveFlag;
+    Uint64           Counter = 0;
+    RunLockStress<AdaptiveLockFlag, AdaptiveLockGuard>(AdaptiveFlag, NumThreads, NumIterations, 1, Counter);
+    EXPECT_EQ(Counter, Uint64{NumThreads} * NumIterations);
+    EXPECT_FALSE(AdaptiveFlag.IsLocked());
+
+    LockFlag Flag;
+    Counter = 0;
+    RunLockStress<LockFlag, LockHelper>(Flag, NumThreads, NumIterations, 1, Counter);
+    EXPECT_EQ(Counter, Uint64{NumThreads} * NumIterations);
+    EXPECT_EQ(static_cast<Atomics::Long>(Flag), LockFlag::LOCK_FLAG_UNLOCKED);
+}
+
+// Compares CPU time consumed by spin-yield and spin-then-park locks under heavy contention
+TEST(Common_LockHelper, DISABLED_AdaptiveLockPerformance)
+{
+    // Oversubscribe the CPU to make waiting threads compete with the lock owner
+    const auto NumThreads = std::max(std::thread::hardware_concurrency() * 2, 8u);
+
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 NumIterations = 2000;
+#else
+    constexpr Uint32 NumIterations = 20000;
+#endif
+    constexpr Uint32 WorkSize = 256;
+
+    Uint64 Counter = 0;
+
+    LockFlag   SpinFlag;
+    const auto SpinStartTime = std::chrono::high_resolution_clock::now();
+    // Always use the spin-yield path, regardless of DILIGENT_USE_ADAPTIVE_LOCKS
+    struct SpinYieldGuard
+    {
+        explicit SpinYieldGuard(LockFlag& Flag) :
+            m_Flag{Flag}
+        {
+            int SpinCount = 0;
+            while (!LockHelper::UnsafeTryLock(m_Flag))
+            {
+                if (++SpinCount == LockHelper::DefaultSpinCountToYield)
+                {
+                    SpinCount = 0;
+                    std::this_thread::yield();
+                }
+            }
+        }
+        ~SpinYieldGuard()
+        {
+            LockHelper::UnsafeUnlock(m_Flag);
+        }
+        LockFlag& m_Flag;
+    };
+    const auto SpinCPUTime  = RunLockStress<LockFlag, SpinYieldGuard>(SpinFlag, NumThreads, NumIterations, WorkSize, Counter);
+    const auto SpinWallTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - SpinStartTime).count();
+
+    AdaptiveLockFlag::ResetContentionStats();
+    AdaptiveLockFlag::EnableContentionStats(true);
+
+    AdaptiveLockFlag AdaptiveFlag;
+    const auto       AdaptiveStartTime = std::chrono::high_resolution_clock::now();
+    const auto       AdaptiveCPUTime   = RunLockStress<AdaptiveLockFlag, AdaptiveLockGuard>(AdaptiveFlag, NumThreads, NumIterations, WorkSize, Counter);
+    const auto       AdaptiveWallTime  = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - AdaptiveStartTime).count();
+
+    AdaptiveLockFlag::EnableContentionStats(false);
+    const auto Stats = AdaptiveLockFlag::GetContentionStats();
+
+    EXPECT_EQ(Counter, Uint64{NumThreads} * NumIterations * WorkSize * 2);
+
+    LOG_INFO_MESSAGE("Lock performance (", NumThreads, " threads x ", NumIterations, " iterations):\n",
+                     "    Spin-yield:      ", SpinWallTime * 1000.0, " ms wall, ", SpinCPUTime * 1000.0, " ms CPU\n",
+                     "    Spin-then-park:  ", AdaptiveWallTime * 1000.0, " ms wall, ", AdaptiveCPUTime * 1000.0, " ms CPU\n",
+                     "    Contended locks: ", Stats.NumContendedLocks, ", spins: ", Stats.NumSpins, ", parks: ", Stats.NumParks);
+}
+
+} // namespace
@@ -26,9 +26,13 @@
  */
 
 #include <climits>
+#include <chrono>
+#include <vector>
 
 #include "BasicMath.hpp"
 #include "AdvancedMath.hpp"
+#include "FastRand.hpp"
+#include "Errors.hpp"
 
 #include "gtest/gtest.h"
 
@@ -37,6 +41,19 @@ using namespace Diligent;
 namespace
 {
 
+// Returns the time in seconds it takes to run Op for every element NumIterations times
+template <typename OpType>
+double RunBenchmark(int NumIterations, size_t NumElements, OpType Op)
+{
+    const auto StartTime = std::chrono::high_resolution_clock::now();
+    for (int it = 0; it < NumIterations; ++it)
+    {
+        for (size_t i = 0; i < NumElements; ++i)
+            Op(i);
+    }
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - StartTime).count();
+}
+
 // Constructors
 TEST(Common_BasicMath, VectorConstructors)
 {
@@ -1373,6 +1390,241 @@ TEST(Common_AdvancedMath, IntersectRayTriangle)
     EXPECT_FLOAT_EQ(IntersectRayTriangle(float3{-2, -2, 0}, float3{+2, -2, 0}, float3{0, +2, 0}, float3{0, 0, -rsqrt2}, float3{+rsqrt2, 0, +rsqrt2}), 1);
 }
 
+TEST(Common_AdvancedMath, IntersectRayTriangleWatertight)
+{
+    const float3 Tris[][3] = {
+        {float3{0, -1, -1}, float3{0, +1, -1}, float3{0, 0, +1}},
+        {float3{-1, 0, -1}, float3{+1, 0, -1}, float3{0, 0, +1}},
+        {float3{-1, -1, 0}, float3{+1, -1, 0}, float3{0, +1, 0}} //
+    };
+    const float3 Directions[] = {
+        float3{+1, 0, 0}, float3{-1, 0, 0}, float3{0, +1, 0}, float3{0, -1, 0}, float3{0, 0, +1}, float3{0, 0, -1},
+        normalize(float3{+1, +1, 0}), normalize(float3{0, -1, +1}), normalize(float3{+1, -2, +3}) //
+    };
+    for (const auto& Tri : Tris)
+    {
+        for (const auto& Dir : Directions)
+        {
+            const float3 Origin = -Dir;
+            for (bool CullBackFace : {false, true})
+            {
+                const float Ref = IntersectRayTriangle(Tri[0], Tri[1], Tri[2], Origin, Dir, CullBackFace);
+                const float Res = IntersectRayTriangleWatertight(Tri[0], Tri[1], Tri[2], Origin, Dir, CullBackFace);
+                if (Ref == FLT_MAX)
+                    EXPECT_EQ(Res, FLT_MAX);
+                else
+                    EXPECT_FLOAT_EQ(Res, Ref);
+            }
+        }
+    }
+}
+
+TEST(Common_AdvancedMath, IntersectRayTrianglePackets)
+{
+    FastRandFloat Rnd{0, -1, 1};
+
+    auto RandomVec = [&]() {
+        return float3{Rnd(), Rnd(), Rnd()};
+    };
+
+    int NumHits       = 0;
+    int NumMismatches = 0;
+    for (int test = 0; test < 5000; ++test)
+    {
+        const float3 Origin    = RandomVec() * 3.f;
+        const float3 Direction = test % 4 == 0 ? RandomVec() * 10.f : normalize(-Origin + RandomVec() * 0.5f);
+        if (Direction == float3{})
+            continue;
+
+        float3          Verts[4][3];
+        TrianglePacket4 Triangles;
+        for (Uint32 i = 0; i < 4; ++i)
+        {
+            for (auto& V : Verts[i])
+                V = RandomVec();
+            Triangles.SetTriangle(i, Verts[i][0], Verts[i][1], Verts[i][2]);
+        }
+
+        RayPacket4 Rays;
+        float3     RayOrigins[4], RayDirections[4];
+        for (Uint32 i = 0; i < 4; ++i)
+        {
+            RayOrigins[i]    = RandomVec() * 3.f;
+            RayDirections[i] = normalize(Verts[0][i % 3] - RayOrigins[i] + RandomVec() * 0.3f);
+            Rays.SetRay(i, RayOrigins[i], RayDirections[i]);
+        }
+
+        for (bool CullBackFace : {false, true})
+        {
+            float Distances[4];
+            IntersectRayTriangles4(Origin, Direction, Triangles, Distances, CullBackFace);
+            for (Uint32 i = 0; i < 4; ++i)
+            {
+                const float Ref = IntersectRayTriangleWatertight(Verts[i][0], Verts[i][1], Verts[i][2], Origin, Direction, CullBackFace);
+                EXPECT_EQ(Distances[i], Ref);
+
+                // Moller-Trumbore results may only differ for the rays that pass very close to the edges
+                const float MTDist = IntersectRayTriangle(Verts[i][0], Verts[i][1], Verts[i][2], Origin, Direction, CullBackFace);
+                if ((Ref == FLT_MAX) != (MTDist == FLT_MAX))
+                    ++NumMismatches;
+                else if (Ref != FLT_MAX)
+                {
+                    EXPECT_NEAR(Ref, MTDist, std::abs(MTDist) * 1e-3f + 1e-3f);
+                    ++NumHits;
+                }
+            }
+
+            IntersectRays4Triangle(Rays, Verts[0][0], Verts[0][1], Verts[0][2], Distances, CullBackFace);
+            for (Uint32 i = 0; i < 4; ++i)
+            {
+                const float Ref = IntersectRayTriangleWatertight(Verts[0][0], Verts[0][1], Verts[0][2], RayOrigins[i], RayDirections[i], CullBackFace);
+                EXPECT_EQ(Distances[i], Ref);
+            }
+        }
+    }
+    EXPECT_GT(NumHits, 1000);
+    EXPECT_LE(NumMismatches, 2);
+}
+
+// Generates a random height field mesh
+std::vector<float3> MakeHeightFieldMesh(FastRandFloat& Rnd, Uint32 GridSize)
+{
+    std::vector<float3> Verts;
+    for (Uint32 y = 0; y <= GridSize; ++y)
+    {
+        for (Uint32 x = 0; x <= GridSize; ++x)
+            Verts.emplace_back(static_cast<float>(x) * 0.1f + Rnd() * 0.03f, static_cast<float>(y) * 0.1f + Rnd() * 0.03f, Rnd() * 0.1f);
+    }
+
+    std::vector<float3> Triangles;
+    for (Uint32 y = 0; y < GridSize; ++y)
+    {
+        for (Uint32 x = 0; x < GridSize; ++x)
+        {
+            const float3& V00 = Verts[y * (GridSize + 1) + x];
+            const float3& V10 = Verts[y * (GridSize + 1) + x + 1];
+            const float3& V01 = Verts[(y + 1) * (GridSize + 1) + x];
+            const float3& V11 = Verts[(y + 1) * (GridSize + 1) + x + 1];
+            Triangles.insert(Triangles.end(), {V00, V10, V11, V00, V11, V01});
+        }
+    }
+    return Triangles;
+}
+
+TEST(Common_AdvancedMath, IntersectRayTriangleWatertightEdges)
+{
+    FastRandFloat Rnd{1, -1, 1};
+
+    constexpr Uint32 GridSize  = 8;
+    const auto       Triangles = MakeHeightFieldMesh(Rnd, GridSize);
+
+    // Aim the rays at the points on the edges and at the vertices inside the mesh
+    int NumMisses = 0;
+    for (size_t t = 0; t < Triangles.size(); t += 3)
+    {
+        for (Uint32 e = 0; e < 3; ++e)
+        {
+            const float3& E0 = Triangles[t + e];
+            const float3& E1 = Triangles[t + (e + 1) % 3];
+            if (std::min(std::min(E0.x, E1.x), std::min(E0.y, E1.y)) < 0.05f ||
+                std::max(std::max(E0.x, E1.x), std::max(E0.y, E1.y)) > GridSize * 0.1f - 0.05f)
+                continue; // Boundary edge
+
+            for (float f : {0.f, 0.25f, 0.5f, 1.f / 3.f})
+            {
+                const float3 Target    = E0 + (E1 - E0) * f;
+                const float3 Origin    = Target + float3{Rnd(), Rnd(), 2.f};
+                const float3 Direction = Target - Origin;
+
+                bool Hit = false;
+                for (size_t i = 0; i < Triangles.size() && !Hit; i += 3)
+                    Hit = IntersectRayTriangleWatertight(Triangles[i], Triangles[i + 1], Triangles[i + 2], Origin, Direction) != FLT_MAX;
+
+                // Packet versions must produce the same results
+                TrianglePacket4 Packet;
+                bool            PacketHit = false;
+                for (size_t i = 0; i < Triangles.size(); i += 3)
+                {
+                    Packet.SetTriangle(static_cast<Uint32>(i / 3 % 4), Triangles[i], Triangles[i + 1], Triangles[i + 2]);
+                    if (i / 3 % 4 == 3)
+                    {
+                        float Distances[4];
+                        IntersectRayTriangles4(Origin, Direction, Packet, Distances);
+                        for (float d : Distances)
+                            PacketHit = PacketHit || d != FLT_MAX;
+                    }
+                }
+                EXPECT_EQ(Hit, PacketHit);
+
+                if (!Hit)
+                    ++NumMisses;
+            }
+        }
+    }
+    EXPECT_EQ(NumMisses, 0);
+}
+
+TEST(Common_AdvancedMath, DISABLED_IntersectRayTrianglePerformance)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 NumRays = 16;
+#else
+    constexpr Uint32 NumRays = 1024;
+#endif
+    FastRandFloat Rnd{2, -1, 1};
+
+    const auto   Triangles    = MakeHeightFieldMesh(Rnd, 32);
+    const Uint32 NumTriangles = static_cast<Uint32>(Triangles.size() / 3);
+
+    std::vector<TrianglePacket4> TrianglePackets(NumTriangles / 4);
+    for (Uint32 i = 0; i < NumTriangles; ++i)
+        TrianglePackets[i / 4].SetTriangle(i % 4, Triangles[i * 3], Triangles[i * 3 + 1], Triangles[i * 3 + 2]);
+
+    std::vector<float3>     Origins(NumRays), Directions(NumRays);
+    std::vector<RayPacket4> RayPackets(NumRays / 4);
+    for (Uint32 i = 0; i < NumRays; ++i)
+    {
+        Origins[i]    = float3{1.6f, 1.6f, 3.f} + float3{Rnd(), Rnd(), Rnd()};
+        Directions[i] = normalize(float3{Rnd(), Rnd(), -2.f});
+        RayPackets[i / 4].SetRay(i % 4, Origins[i], Directions[i]);
+    }
+
+    float MinDist = FLT_MAX;
+
+    auto Measure = [&](const char* Name, double ElapsedTime) {
+        LOG_INFO_MESSAGE(Name, ": ", static_cast<double>(NumRays) * NumTriangles / ElapsedTime * 1e-6, " M rays x triangles/s");
+    };
+
+    // clang-format off
+    Measure("Moller-Trumbore          ", RunBenchmark(1, NumRays, [&](size_t r) {
+        for (Uint32 t = 0; t < NumTriangles; ++t)
+            MinDist = std::min(MinDist, IntersectRayTriangle(Triangles[t * 3], Triangles[t * 3 + 1], Triangles[t * 3 + 2], Origins[r], Directions[r]));
+    }));
+    Measure("Watertight               ", RunBenchmark(1, NumRays, [&](size_t r) {
+        for (Uint32 t = 0; t < NumTriangles; ++t)
+            MinDist = std::min(MinDist, IntersectRayTriangleWatertight(Triangles[t * 3], Triangles[t * 3 + 1], Triangles[t * 3 + 2], Origins[r], Directions[r]));
+    }));
+    Measure("Watertight, 1 x 4 packets", RunBenchmark(1, NumRays, [&](size_t r) {
+        for (const auto& Packet : TrianglePackets)
+        {
+            float Distances[4];
+            IntersectRayTriangles4(Origins[r], Directions[r], Packet, Distances);
+            MinDist = std::min(MinDist, std::min(std::min(Distances[0], Distances[1]), std::min(Distances[2], Distances[3])));
+        }
+    }));
+    Measure("Watertight, 4 x 1 packets", RunBenchmark(1, NumRays / 4, [&](size_t r) {
+        for (Uint32 t = 0; t < NumTriangles; ++t)
+        {
+            float Distances[4];
+            IntersectRays4Triangle(RayPackets[r], Triangles[t * 3], Triangles[t * 3 + 1], Triangles[t * 3 + 2], Distances);
+            MinDist = std::min(MinDist, std::min(std::min(Distances[0], Distances[1]), std::min(Distances[2], Distances[3])));
+        }
+    }));
+    // clang-format on
+
+    LOG_INFO_MESSAGE("Checksum: ", MinDist);
+}
+
 
 
 static void TestLineTrace(float2 Start, float2 End, const std::initializer_list<int2> Reference, int2 GridSize = {10, 10})
@@ -1946,4 +2198,435 @@ TEST(Common_AdvancedMath, TransformBoundBox)
     }
 }
 
+// Scalar reference implementations of the float4x4 operations that have SIMD specializations
+struct ScalarMath
+{
+    static float4x4 Mul(const float4x4& m1, const float4x4& m2)
+    {
+        float4x4 mOut;
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+                for (int k = 0; k < 4; k++)
+                    mOut.m[i][j] += m1.m[i][k] * m2.m[k][j];
+        return mOut;
+    }
+
+    static float4x4 Transpose(const float4x4& m)
+    {
+        float4x4 mOut;
+        for (int i = 0; i < 4; i++)
+            for (int j = 0; j < 4; j++)
+                mOut.m[i][j] = m.m[j][i];
+        return mOut;
+    }
+
+    static float4 Mul(const float4& v, const float4x4& m)
+    {
+        float4 out;
+        for (int j = 0; j < 4; j++)
+            out[j] = v.x * m[0][j] + v.y * m[1][j] + v.z * m[2][j] + v.w * m[3][j];
+        return out;
+    }
+
+    static float4 Mul(const float4x4& m, const float4& v)
+    {
+        float4 out;
+        for (int i = 0; i < 4; i++)
+            out[i] = m[i][0] * v.x + m[i][1] * v.y + m[i][2] * v.z + m[i][3] * v.w;
+        return out;
+    }
+
+    static float4x4 Inverse(const float4x4& m)
+    {
+        // Uses the generic double-precision implementation
+        const auto inv = Matrix4x4<double>::MakeMatrix(m.Data()).Inverse();
+        return float4x4::MakeMatrix(inv.Data());
+    }
+};
+
+float4x4 MakeRandomMatrix(FastRandFloat& Rnd)
+{
+    float4x4 m;
+    for (int i = 0; i < 16; ++i)
+        m.Data()[i] = Rnd();
+    return m;
+}
+
+TEST(Common_BasicMath, SIMDMatrixOperations)
+{
+    FastRandFloat Rnd{0, -10, 10};
+    for (int test = 0; test < 1000; ++test)
+    {
+        const auto m1 = MakeRandomMatrix(Rnd);
+        const auto m2 = MakeRandomMatrix(Rnd);
+        const auto v  = float4{Rnd(), Rnd(), Rnd(), Rnd()};
+
+        // Transpose is exact
+        EXPECT_EQ(m1.Transpose(), ScalarMath::Transpose(m1));
+
+        // Products add the terms in the same order as the scalar code, so the results only
+        // differ if the compiler contracts the scalar operations into FMAs
+        const auto Prod    = m1 * m2;
+        const auto RefProd = ScalarMath::Mul(m1, m2);
+        for (int i = 0; i < 16; ++i)
+            EXPECT_NEAR(Prod.Data()[i], RefProd.Data()[i], std::abs(RefProd.Data()[i]) * 1e-6f + 1e-4f);
+
+        const auto vm    = v * m1;
+        const auto mv    = m1 * v;
+        const auto RefVM = ScalarMath::Mul(v, m1);
+        const auto RefMV = ScalarMath::Mul(m1, v);
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_NEAR(vm[i], RefVM[i], std::abs(RefVM[i]) * 1e-6f + 1e-4f);
+            EXPECT_NEAR(mv[i], RefMV[i], std::abs(RefMV[i]) * 1e-6f + 1e-4f);
+        }
+
+        // Skip ill-conditioned matrices
+        if (std::abs(Matrix4x4<double>::MakeMatrix(m1.Data()).Determinant()) < 1)
+            continue;
+
+        const auto Inv    = m1.Inverse();
+        const auto RefInv = ScalarMath::Inverse(m1);
+        for (int i = 0; i < 16; ++i)
+            EXPECT_NEAR(Inv.Data()[i], RefInv.Data()[i], std::abs(RefInv.Data()[i]) * 1e-3f + 1e-4f);
+
+        const auto Identity = m1 * Inv;
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+                EXPECT_NEAR(Identity[i][j], i == j ? 1.f : 0.f, 1e-3f);
+    }
+
+    // Exact results for integer-valued matrices
+    {
+        // clang-format off
+        float4x4 m
+        {
+            2, 0, 0, 0,
+            0, 4, 0, 0,
+            0, 0, 8, 0,
+            1, 2, 3, 1
+        };
+        float4x4 RefInv
+        {
+            0.5f,     0,       0,  0,
+            0,     0.25f,      0,  0,
+            0,        0,  0.125f,  0,
+           -0.5f, -0.5f, -0.375f,  1
+        };
+        // clang-format on
+        EXPECT_EQ(m.Inverse(), RefInv);
+    }
+}
+
+TEST(Common_BasicMath, DISABLED_SIMDPerformance)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr int NumIterations = 20;
+#else
+    constexpr int NumIterations = 2000;
+#endif
+    constexpr size_t NumMatrices = 1024;
+
+    FastRandFloat         Rnd{0, -10, 10};
+    std::vector<float4x4> Matrices(NumMatrices);
+    std::vector<float4>   Vectors(NumMatrices);
+    for (size_t i = 0; i < NumMatrices; ++i)
+    {
+        Matrices[i] = MakeRandomMatrix(Rnd);
+        Vectors[i]  = float4{Rnd(), Rnd(), Rnd(), Rnd()};
+    }
+    std::vector<float4x4> OutMatrices(NumMatrices);
+    std::vector<float4>   OutVectors(NumMatrices);
+
+    auto Measure = [&](const char* Name, double ElapsedTime) {
+        LOG_INFO_MESSAGE(Name, ": ", ElapsedTime / (NumIterations * NumMatrices) * 1e+9, " ns");
+    };
+
+    // clang-format off
+    Measure("float4x4 * float4x4 (scalar)", RunBenchmark(NumIterations, NumMatrices, [&](size_t i) { OutMatrices[i] = ScalarMath::Mul(Matrices[i], Matrices[(i + 1) % NumMatrices]); }));
+    Measure("float4x4 * float4x4 (SIMD)  ", RunBenchmark(NumIterations, NumMatrices, [&](size_t i) { OutMatrices[i] = Matrices[i] * Matrices[(i + 1) % NumMatrices]; }));
+    Measure("float4 * float4x4   (scalar)", RunBenchmark(NumIterations, NumMatrices, [&](size_t i) { OutVectors[i] = ScalarMath::Mul(Vectors[i], Matrices[i]); }));
+    Measure("float4 * float4x4   (SIMD)  ", RunBenchmark(NumIterations, NumMatrices, [&](size_t i) { OutVectors[i] = Vectors[i] * Matrices[i]; }));
+    Measure("float4x4 * float4   (scalar)", RunBenchmark(NumIterations, NumMatrices, [&](size_t i) { OutVectors[i] = ScalarMath::Mul(Matrices[i], Vectors[i]); }));
+    Measure("float4x4 * float4   (SIMD)  ", RunBenchmark(NumIterations, NumMatrices, [&](size_t i) { OutVectors[i] = Matrices[i] * Vectors[i]; }));
+    Measure("Transpose           (scalar)", RunBenchmark(NumIterations, NumMatrices, [&](size_t i) { OutMatrices[i] = ScalarMath::Transpose(Matrices[i]); }));
+    Measure("Transpose           (SIMD)  ", RunBenchmark(NumIterations, NumMatrices, [&](size_t i) { OutMatrices[i] = Matrices[i].Transpose(); }));
+    Measure("Inverse     (scalar, double)", RunBenchmark(NumIterations, NumMatrices, [&](size_t i) { OutMatrices[i] = ScalarMath::Inverse(Matrices[i]); }));
+    Measure("Inverse             (SIMD)  ", RunBenchmark(NumIterations, NumMatrices, [&](size_t i) { OutMatrices[i] = Matrices[i].Inverse(); }));
+    // clang-format on
+
+    float Sum = 0;
+    for (size_t i = 0; i < NumMatrices; ++i)
+        Sum += OutMatrices[i]._11 + OutVectors[i].x;
+    LOG_INFO_MESSAGE("Checksum: ", Sum);
+}
+
+
+struct RandomBoxesSoA
+{
+    std::vector<float> MinX, MinY, MinZ, MaxX, MaxY, MaxZ;
+
+    RandomBoxesSoA(FastRandFloat& Rnd, size_t NumBoxes, float MaxSize)
+    {
+        for (size_t i = 0; i < NumBoxes; ++i)
+        {
+            const float3 Center{Rnd(), Rnd(), Rnd()};
+            const float3 Extent = float3{Rnd(), Rnd(), Rnd()} * (MaxSize / 100.f);
+            const float3 Min    = Center - abs(Extent);
+            const float3 Max    = Center + abs(Extent);
+            MinX.push_back(Min.x);
+            MinY.push_back(Min.y);
+            MinZ.push_back(Min.z);
+            MaxX.push_back(Max.x);
+            MaxY.push_back(Max.y);
+            MaxZ.push_back(Max.z);
+        }
+    }
+
+    BoundBoxesSoA Get() const
+    {
+        BoundBoxesSoA Boxes;
+        Boxes.MinX = MinX.data();
+        Boxes.MinY = MinY.data();
+        Boxes.MinZ = MinZ.data();
+        Boxes.MaxX = MaxX.data();
+        Boxes.MaxY = MaxY.data();
+        Boxes.MaxZ = MaxZ.data();
+        return Boxes;
+    }
+};
+
+ViewFrustum MakeTestFrustum(float Angle)
+{
+    const auto ViewProj = float4x4::RotationY(Angle) * float4x4::Translation(0, 0, 10) * float4x4::Projection(PI_F / 3.f, 1.5f, 1.f, 50.f, false);
+
+    ViewFrustum Frustum;
+    ExtractViewFrustumPlanesFromMatrix(ViewProj, Frustum, false);
+    return Frustum;
+}
+
+TEST(Common_AdvancedMath, BatchBoxVisibility)
+{
+    FastRandFloat Rnd{0, -100, 100};
+
+    const FRUSTUM_PLANE_FLAGS TestFlags[] = {
+        FRUSTUM_PLANE_FLAG_FULL_FRUSTUM,
+        FRUSTUM_PLANE_FLAG_OPEN_NEAR,
+        FRUSTUM_PLANE_FLAG_LEFT_PLANE | FRUSTUM_PLANE_FLAG_TOP_PLANE,
+        FRUSTUM_PLANE_FLAG_NONE //
+    };
+
+    // Test counts that are not multiples of 4 and 32 to cover the tails
+    for (Uint32 NumBoxes : {0u, 1u, 3u, 4u, 31u, 32u, 33u, 1000u, 4099u})
+    {
+        const RandomBoxesSoA BoxData{Rnd, NumBoxes, 50.f};
+        const BoundBoxesSoA  Boxes = BoxData.Get();
+
+        for (int f = 0; f < 4; ++f)
+        {
+            const ViewFrustum Frustum = MakeTestFrustum(static_cast<float>(f) * PI_F / 2.f);
+            for (FRUSTUM_PLANE_FLAGS Flags : TestFlags)
+            {
+                const Uint32 NumWords = (NumBoxes + 31) / 32;
+
+                std::vector<Uint32> VisibleMask(NumWords, ~0u);
+                std::vector<Uint32> FullyVisibleMask(NumWords, ~0u);
+                GetBoxesVisibility(Frustum, Boxes, NumBoxes, VisibleMask.data(), FullyVisibleMask.data(), Flags);
+
+                std::vector<Uint32> VisibleIndices(NumBoxes);
+                const Uint32        NumVisible = GetVisibleBoxIndices(Frustum, Boxes, NumBoxes, VisibleIndices.data(), Flags);
+                VisibleIndices.resize(NumVisible);
+
+                std::vector<Uint32> RefIndices;
+                for (Uint32 i = 0; i < NumBoxes; ++i)
+                {
+                    const BoxVisibility RefVis = GetBoxVisibility(Frustum, Boxes.GetBox(i), Flags);
+
+                    const bool IsVisible      = (VisibleMask[i / 32] & (1u << (i % 32))) != 0;
+                    const bool IsFullyVisible = (FullyVisibleMask[i / 32] & (1u << (i % 32))) != 0;
+                    EXPECT_EQ(IsVisible, RefVis != BoxVisibility::Invisible) << "Box " << i;
+                    EXPECT_EQ(IsFullyVisible, RefVis == BoxVisibility::FullyVisible) << "Box " << i;
+
+                    if (RefVis != BoxVisibility::Invisible)
+                        RefIndices.push_back(i);
+                }
+                EXPECT_EQ(VisibleIndices, RefIndices);
+
+                // Unused bits must be zero
+                if (NumBoxes % 32 != 0)
+                {
+                    EXPECT_EQ(VisibleMask.back() >> (NumBoxes % 32), 0u);
+                    EXPECT_EQ(FullyVisibleMask.back() >> (NumBoxes % 32), 0u);
+                }
+
+                for (Uint32 NumThreads : {1u, 3u, 8u})
+                {
+                    std::vector<Uint32> VisibleMaskMT(NumWords, ~0u);
+                    std::vector<Uint32> FullyVisibleMaskMT(NumWords, ~0u);
+                    GetBoxesVisibilityMT(Frustum, Boxes, NumBoxes, VisibleMaskMT.data(), FullyVisibleMaskMT.data(), NumThreads, Flags);
+                    EXPECT_EQ(VisibleMaskMT, VisibleMask);
+                    EXPECT_EQ(FullyVisibleMaskMT, FullyVisibleMask);
+
+                    std::vector<Uint32> VisibleIndicesMT(NumBoxes);
+                    VisibleIndicesMT.resize(GetVisibleBoxIndicesMT(Frustum, Boxes, NumBoxes, VisibleIndicesMT.data(), NumThreads, Flags));
+                    EXPECT_EQ(VisibleIndicesMT, RefIndices);
+                }
+            }
+        }
+    }
+}
+
+TEST(Common_AdvancedMath, DISABLED_BatchBoxVisibilityPerformance)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr int NumIterations = 2;
+#else
+    constexpr int NumIterations = 200;
+#endif
+    constexpr Uint32 NumBoxes = 16384;
+
+    FastRandFloat        Rnd{0, -100, 100};
+    const RandomBoxesSoA BoxData{Rnd, NumBoxes, 10.f};
+    const BoundBoxesSoA  Boxes   = BoxData.Get();
+    const ViewFrustum    Frustum = MakeTestFrustum(0);
+
+    std::vector<BoundBox> AoSBoxes(NumBoxes);
+    for (Uint32 i = 0; i < NumBoxes; ++i)
+        AoSBoxes[i] = Boxes.GetBox(i);
+
+    std::vector<Uint32> VisibleMask((NumBoxes + 31) / 32);
+    std::vector<Uint32> VisibleIndices(NumBoxes);
+    std::vector<Uint32> Visibility(NumBoxes);
+
+    auto Measure = [&](const char* Name, double ElapsedTime) {
+        LOG_INFO_MESSAGE(Name, ": ", ElapsedTime / (NumIterations * NumBoxes) * 1e+9, " ns/box");
+    };
+
+    // clang-format off
+    Measure("GetBoxVisibility      ", RunBenchmark(NumIterations, NumBoxes, [&](size_t i) { Visibility[i] = static_cast<Uint32>(GetBoxVisibility(Frustum, AoSBoxes[i])); }));
+    Measure("GetBoxesVisibility    ", RunBenchmark(NumIterations, 1,        [&](size_t)   { GetBoxesVisibility(Frustum, Boxes, NumBoxes, VisibleMask.data()); }));
+    Measure("GetVisibleBoxIndices  ", RunBenchmark(NumIterations, 1,        [&](size_t)   { GetVisibleBoxIndices(Frustum, Boxes, NumBoxes, VisibleIndices.data()); }));
+    Measure("GetBoxesVisibilityMT  ", RunBenchmark(NumIterations, 1,        [&](size_t)   { GetBoxesVisibilityMT(Frustum, Boxes, NumBoxes, VisibleMask.data(), nullptr, 4); }));
+    // clang-format on
+
+    Uint32 NumVisible = 0;
+    for (Uint32 i = 0; i < NumBoxes; ++i)
+        NumVisible += Visibility[i] != 0 ? 1 : 0;
+    LOG_INFO_MESSAGE("Visible boxes: ", NumVisible, " of ", NumBoxes);
+}
+
+TEST(Common_AdvancedMath, TransformBoundBoxes)
+{
+    FastRandFloat Rnd{0, -10, 10};
+
+    for (size_t NumBoxes : {0, 1, 2, 17, 1000})
+    {
+        std::vector<BoundBox> Boxes(NumBoxes);
+        std::vector<float4x4> Matrices(NumBoxes);
+        for (size_t i = 0; i < NumBoxes; ++i)
+        {
+            const float3 Corner0{Rnd(), Rnd(), Rnd()};
+            const float3 Corner1{Rnd(), Rnd(), Rnd()};
+            Boxes[i]    = BoundBox{std::min(Corner0, Corner1), std::max(Corner0, Corner1)};
+            Matrices[i] = MakeRandomMatrix(Rnd);
+        }
+        const float4x4 Matrix = MakeRandomMatrix(Rnd);
+
+        const BoundBox EmptyBox{float3{+FLT_MAX, +FLT_MAX, +FLT_MAX}, float3{-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+
+        auto CheckResults = [&](const std::vector<BoundBox>& OutBoxes, const BoundBox& MergedBox, bool SingleMatrix) {
+            BoundBox RefMergedBox = EmptyBox;
+            for (size_t i = 0; i < NumBoxes; ++i)
+            {
+                const BoundBox RefBox = Boxes[i].Transform(SingleMatrix ? Matrix : Matrices[i]);
+                // The batch transform performs exactly the same operations
+                EXPECT_EQ(OutBoxes[i].Min, RefBox.Min) << "Box " << i;
+                EXPECT_EQ(OutBoxes[i].Max, RefBox.Max) << "Box " << i;
+                RefMergedBox.Min = std::min(RefMergedBox.Min, RefBox.Min);
+                RefMergedBox.Max = std::max(RefMergedBox.Max, RefBox.Max);
+            }
+            EXPECT_EQ(MergedBox.Min, RefMergedBox.Min);
+            EXPECT_EQ(MergedBox.Max, RefMergedBox.Max);
+        };
+
+        {
+            std::vector<BoundBox> OutBoxes(NumBoxes);
+            BoundBox              MergedBox = EmptyBox;
+            TransformBoundBoxes(Boxes.data(), Matrices.data(), NumBoxes, OutBoxes.data(), &MergedBox);
+            CheckResults(OutBoxes, MergedBox, false);
+        }
+
+        {
+            std::vector<BoundBox> OutBoxes(NumBoxes);
+            BoundBox              MergedBox = EmptyBox;
+            TransformBoundBoxes(Boxes.data(), Matrix, NumBoxes, OutBoxes.data(), &MergedBox);
+            CheckResults(OutBoxes, MergedBox, true);
+        }
+
+        // In-place transform without merging
+        {
+            std::vector<BoundBox> OutBoxes = Boxes;
+            TransformBoundBoxes(OutBoxes.data(), Matrices.data(), NumBoxes, OutBoxes.data());
+            for (size_t i = 0; i < NumBoxes; ++i)
+            {
+                const BoundBox RefBox = Boxes[i].Transform(Matrices[i]);
+                EXPECT_EQ(OutBoxes[i].Min, RefBox.Min);
+                EXPECT_EQ(OutBoxes[i].Max, RefBox.Max);
+            }
+        }
+
+        // Merging only
+        {
+            std::vector<BoundBox> RefBoxes(NumBoxes);
+            BoundBox              RefMergedBox = EmptyBox;
+            TransformBoundBoxes(Boxes.data(), Matrices.data(), NumBoxes, RefBoxes.data(), &RefMergedBox);
+
+            BoundBox MergedBox = EmptyBox;
+            TransformBoundBoxes(Boxes.data(), Matrices.data(), NumBoxes, nullptr, &MergedBox);
+            EXPECT_EQ(MergedBox.Min, RefMergedBox.Min);
+            EXPECT_EQ(MergedBox.Max, RefMergedBox.Max);
+        }
+    }
+}
+
+TEST(Common_AdvancedMath, DISABLED_TransformBoundBoxesPerformance)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr int NumIterations = 2;
+#else
+    constexpr int NumIterations = 200;
+#endif
+    constexpr size_t NumBoxes = 4096;
+
+    FastRandFloat         Rnd{0, -10, 10};
+    std::vector<BoundBox> Boxes(NumBoxes);
+    std::vector<float4x4> Matrices(NumBoxes);
+    for (size_t i = 0; i < NumBoxes; ++i)
+    {
+        const float3 Corner0{Rnd(), Rnd(), Rnd()};
+        const float3 Corner1{Rnd(), Rnd(), Rnd()};
+        Boxes[i]    = BoundBox{std::min(Corner0, Corner1), std::max(Corner0, Corner1)};
+        Matrices[i] = MakeRandomMatrix(Rnd);
+    }
+    std::vector<BoundBox> OutBoxes(NumBoxes);
+    BoundBox              MergedBox{float3{+FLT_MAX, +FLT_MAX, +FLT_MAX}, float3{-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+
+    auto Measure = [&](const char* Name, double ElapsedTime) {
+        LOG_INFO_MESSAGE(Name, ": ", ElapsedTime / (NumIterations * NumBoxes) * 1e+9, " ns/box");
+    };
+
+    // clang-format off
+    Measure("BoundBox::Transform          ", RunBenchmark(NumIterations, NumBoxes, [&](size_t i) { OutBoxes[i] = Boxes[i].Transform(Matrices[i]); }));
+    Measure("BoundBox::Transform + merge  ", RunBenchmark(NumIterations, NumBoxes, [&](size_t i) {
+        OutBoxes[i]   = Boxes[i].Transform(Matrices[i]);
+        MergedBox.Min = std::min(MergedBox.Min, OutBoxes[i].Min);
+        MergedBox.Max = std::max(MergedBox.Max, OutBoxes[i].Max);
+    }));
+    Measure("TransformBoundBoxes          ", RunBenchmark(NumIterations, 1, [&](size_t) { TransformBoundBoxes(Boxes.data(), Matrices.data(), NumBoxes, OutBoxes.data()); }));
+    Measure("TransformBoundBoxes + merge  ", RunBenchmark(NumIterations, 1, [&](size_t) { TransformBoundBoxes(Boxes.data(), Matrices.data(), NumBoxes, OutBoxes.data(), &MergedBox); }));
+    // clang-format on
+
+    LOG_INFO_MESSAGE("Checksum: ", MergedBox.Min.x + MergedBox.Max.x + OutBoxes[0].Min.x);
+}
+
 } // namespace
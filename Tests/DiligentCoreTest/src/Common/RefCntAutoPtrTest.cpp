@@ -30,6 +30,8 @@
 #include <mutex>
 #include <condition_variable>
 #include <algorithm>
+#include <chrono>
+#include <vector>
 
 #include "DefaultRawMemoryAllocator.hpp"
 #include "RefCntAutoPtr.hpp"
@@ -904,4 +906,122 @@ TEST(Common_RefCntAutoPtr, Threading)
     ThreadingTest.RunConcurrencyTest();
 }
 
+class UpgradeTestObject : public Object
+{
+public:
+    static constexpr int AliveValue = 0x5A5A;
+
+    UpgradeTestObject(IReferenceCounters* pRefCounters, std::atomic_int& NumDestroyed) :
+        Object{pRefCounters},
+        m_NumDestroyed{NumDestroyed}
+    {
+        m_Value = int{AliveValue};
+    }
+
+    ~UpgradeTestObject()
+    {
+        m_Value = 0;
+        m_NumDestroyed.fetch_add(1);
+    }
+
+private:
+    std::atomic_int& m_NumDestroyed;
+};
+
+// Many threads upgrade weak pointers while the last external strong reference is released.
+// Every successful upgrade must return a live object, and the object must be destroyed exactly once.
+TEST(Common_RefCntWeakPtr, UpgradeStress)
+{
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 4u);
+#ifdef DILIGENT_DEBUG
+    constexpr int NumRounds = 100;
+#else
+    constexpr int NumRounds = 1000;
+#endif
+
+    std::atomic_int NumDestroyed{0};
+    std::atomic_int NumDeadObjects{0};
+    for (int round = 0; round < NumRounds; ++round)
+    {
+        RefCntAutoPtr<UpgradeTestObject> pObj{MakeNewRCObj<UpgradeTestObject>{}(NumDestroyed)};
+        RefCntWeakPtr<UpgradeTestObject> wpObj{pObj};
+
+        std::atomic<Uint32>      NumReady{0};
+        std::vector<std::thread> Threads;
+        for (Uint32 t = 0; t < NumThreads; ++t)
+        {
+            Threads.emplace_back(
+                [&]() {
+                    RefCntWeakPtr<UpgradeTestObject> wpLocal{wpObj};
+                    NumReady.fetch_add(1);
+                    // Keep upgrading until the object expires
+                    for (int i = 0; i < 1000; ++i)
+                    {
+                        auto pLocal = wpLocal.Lock();
+                        if (!pLocal)
+                            break;
+                        if (pLocal->m_Value != UpgradeTestObject::AliveValue)
+                            NumDeadObjects.fetch_add(1);
+                    }
+                });
+        }
+        while (NumReady.load() < NumThreads)
+            std::this_thread::yield();
+        pObj.Release();
+
+        for (auto& Thread : Threads)
+            Thread.join();
+
+        EXPECT_FALSE(wpObj.IsValid());
+        EXPECT_FALSE(wpObj.Lock());
+        EXPECT_EQ(NumDestroyed.load(), round + 1);
+    }
+    EXPECT_EQ(NumDeadObjects.load(), 0);
+}
+
+// Measures the number of weak-to-strong upgrades per second
+TEST(Common_RefCntWeakPtr, DISABLED_UpgradePerformance)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 NumUpgrades = 100000;
+#else
+    constexpr Uint32 NumUpgrades = 2000000;
+#endif
+
+    std::atomic_int NumDestroyed{0};
+
+    RefCntAutoPtr<UpgradeTestObject> pObj{MakeNewRCObj<UpgradeTestObject>{}(NumDestroyed)};
+    RefCntWeakPtr<UpgradeTestObject> wpObj{pObj};
+
+    std::vector<Uint32> ThreadCounts = {1, std::max(std::thread::hardware_concurrency(), 4u)};
+    for (auto NumThreads : ThreadCounts)
+    {
+        std::atomic<Uint32> NumFailed{0};
+
+        std::vector<std::thread> Threads;
+        const auto               StartTime = std::chrono::high_resolution_clock::now();
+        for (Uint32 t = 0; t < NumThreads; ++t)
+        {
+            Threads.emplace_back(
+                [&]() {
+                    RefCntWeakPtr<UpgradeTestObject> wpLocal{wpObj};
+                    for (Uint32 i = 0; i < NumUpgrades / NumThreads; ++i)
+                    {
+                        if (!wpLocal.Lock())
+                            NumFailed.fetch_add(1);
+                    }
+                });
+        }
+        for (auto& Thread : Threads)
+            Thread.join();
+        const auto ElapsedTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - StartTime).count();
+
+        EXPECT_EQ(NumFailed.load(), 0u);
+        LOG_INFO_MESSAGE("Weak pointer upgrades on ", NumThreads, " thread(s): ", static_cast<double>(NumUpgrades) / ElapsedTime / 1e+6, " M/s");
+    }
+
+    pObj.Release();
+    EXPECT_EQ(NumDestroyed.load(), 1);
+}
+
 } // namespace
@@ -0,0 +1,144 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+
+#include "StringInterner.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+TEST(Common_StringInterner, Intern)
+{
+    StringInterner Interner{DefaultRawMemoryAllocator::GetAllocator(), 64};
+
+    EXPECT_FALSE(InternedString{});
+
+    std::string Name0 = "g_Texture";
+    std::string Name1 = "g_Texture";
+
+    const auto Handle0 = Interner.Intern(Name0.c_str());
+    const auto Handle1 = Interner.Intern(Name1.c_str());
+    EXPECT_TRUE(Handle0);
+    EXPECT_EQ(Handle0, Handle1);
+    EXPECT_EQ(Handle0.GetId(), 1u);
+    EXPECT_EQ(Handle0.GetHash(), CStringHash<Char>{}("g_Texture"));
+    EXPECT_STREQ(Handle0.GetStr(), "g_Texture");
+    EXPECT_NE(Handle0.GetStr(), Name0.c_str());
+
+    const auto Handle2 = Interner.Intern("g_Sampler");
+    EXPECT_NE(Handle0, Handle2);
+    EXPECT_EQ(Handle2.GetId(), 2u);
+
+    const auto Handle3 = Interner.Intern("");
+    EXPECT_TRUE(Handle3);
+    EXPECT_STREQ(Handle3.GetStr(), "");
+
+    // The string is longer than the page
+    const std::string LongName(200, 'x');
+    const auto        Handle4 = Interner.Intern(LongName.c_str());
+    EXPECT_EQ(Handle4.GetStr(), LongName);
+    EXPECT_EQ(Handle4, Interner.Intern(LongName.c_str()));
+
+    EXPECT_EQ(Interner.Find("g_Sampler"), Handle2);
+    EXPECT_FALSE(Interner.Find("g_Buffer"));
+    EXPECT_EQ(Interner.GetNumStrings(), size_t{4});
+
+    // Handles remain valid when new pages are added
+    for (int i = 0; i < 100; ++i)
+        Interner.Intern(("g_Var" + std::to_string(i)).c_str());
+    EXPECT_STREQ(Handle0.GetStr(), "g_Texture");
+    EXPECT_STREQ(Handle2.GetStr(), "g_Sampler");
+    EXPECT_EQ(Interner.Intern("g_Var10"), Interner.Find("g_Var10"));
+    EXPECT_EQ(Interner.GetNumStrings(), size_t{104});
+}
+
+TEST(Common_StringInterner, HashMapLookup)
+{
+    auto& Interner = StringInterner::GetGlobal();
+
+    std::unordered_map<HashMapStringKey, int, HashMapStringKey::Hasher> Map;
+    Map.emplace(HashMapStringKey{"g_Constants", true}, 1);
+    Map.emplace(HashMapStringKey{"g_Texture", true}, 2);
+
+    const auto Handle = Interner.Intern("g_Texture");
+
+    auto It = Map.find(HashMapStringKey{Handle.GetStr(), Handle.GetHash()});
+    ASSERT_NE(It, Map.end());
+    EXPECT_EQ(It->second, 2);
+
+    const auto Missing = Interner.Intern("g_Missing");
+    EXPECT_EQ(Map.find(HashMapStringKey{Missing.GetStr(), Missing.GetHash()}), Map.end());
+
+    std::unordered_map<InternedString, int, InternedString::Hasher> HandleMap;
+    HandleMap[Handle] = 3;
+    EXPECT_EQ(HandleMap[Interner.Intern("g_Texture")], 3);
+}
+
+TEST(Common_StringInterner, MultithreadedIntern)
+{
+    StringInterner Interner{DefaultRawMemoryAllocator::GetAllocator(), 256};
+
+    constexpr int NumStrings = 512;
+
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 4u);
+
+    std::vector<std::vector<InternedString>> Handles(NumThreads);
+    std::vector<std::thread>                 Threads;
+    for (Uint32 t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back([&, t]() {
+            Handles[t].resize(NumStrings);
+            // Every thread interns the same strings in different order
+            for (int i = 0; i < NumStrings; ++i)
+            {
+                const auto Idx  = (i * 7 + static_cast<int>(t) * 13) % NumStrings;
+                Handles[t][Idx] = Interner.Intern(("Resource" + std::to_string(Idx)).c_str());
+            }
+        });
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    EXPECT_EQ(Interner.GetNumStrings(), size_t{NumStrings});
+    for (int i = 0; i < NumStrings; ++i)
+    {
+        EXPECT_EQ(Handles[0][i].GetStr(), "Resource" + std::to_string(i));
+        for (Uint32 t = 1; t < NumThreads; ++t)
+            EXPECT_EQ(Handles[t][i], Handles[0][i]);
+    }
+}
+
+} // namespace
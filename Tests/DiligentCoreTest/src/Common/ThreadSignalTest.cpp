@@ -0,0 +1,159 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+
+#include "ThreadSignal.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+using namespace ThreadingTools;
+
+namespace
+{
+
+TEST(Common_ThreadSignal, CountingSignal)
+{
+    CountingSignal Signal;
+    EXPECT_FALSE(Signal.IsTriggered());
+    EXPECT_FALSE(Signal.TryAcquire());
+    EXPECT_FALSE(Signal.WaitFor(std::chrono::milliseconds{0}));
+    EXPECT_FALSE(Signal.AcquireFor(std::chrono::milliseconds{10}));
+
+    Signal.Trigger(2);
+    EXPECT_TRUE(Signal.IsTriggered());
+    EXPECT_EQ(Signal.GetCount(), 2u);
+
+    // Wait does not consume the signal
+    Signal.Wait();
+    EXPECT_TRUE(Signal.WaitFor(std::chrono::milliseconds{0}));
+    EXPECT_EQ(Signal.GetCount(), 2u);
+
+    EXPECT_TRUE(Signal.TryAcquire());
+    Signal.Acquire();
+    EXPECT_FALSE(Signal.TryAcquire());
+    EXPECT_FALSE(Signal.IsTriggered());
+
+    Signal.Trigger(3);
+    Signal.Reset();
+    EXPECT_FALSE(Signal.IsTriggered());
+    EXPECT_EQ(Signal.GetCount(), 0u);
+}
+
+TEST(Common_ThreadSignal, CountingSignalTimedWait)
+{
+    CountingSignal Signal;
+
+    const auto StartTime = std::chrono::steady_clock::now();
+    EXPECT_FALSE(Signal.WaitFor(std::chrono::milliseconds{20}));
+    EXPECT_GE(std::chrono::steady_clock::now() - StartTime, std::chrono::milliseconds{20});
+
+    std::thread Thread{
+        [&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds{10});
+            Signal.Trigger();
+        }};
+    EXPECT_TRUE(Signal.WaitFor(std::chrono::seconds{10}));
+    Thread.join();
+    EXPECT_TRUE(Signal.AcquireFor(std::chrono::seconds{10}));
+    EXPECT_FALSE(Signal.IsTriggered());
+}
+
+TEST(Common_ThreadSignal, CountingSignalWakeAll)
+{
+    CountingSignal Signal;
+
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 4u);
+
+    std::atomic<Uint32>      NumAwaken{0};
+    std::vector<std::thread> Threads;
+    for (Uint32 t = 0; t < NumThreads; ++t)
+    {
+        Threads.emplace_back(
+            [&]() {
+                Signal.Wait();
+                NumAwaken.fetch_add(1);
+            });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    EXPECT_EQ(NumAwaken.load(), 0u);
+
+    Signal.Trigger();
+    for (auto& Thread : Threads)
+        Thread.join();
+    EXPECT_EQ(NumAwaken.load(), NumThreads);
+    EXPECT_EQ(Signal.GetCount(), 1u);
+}
+
+// Producers and consumers exchange items through the semaphore. Every produced item
+// must be consumed exactly once.
+TEST(Common_ThreadSignal, CountingSignalStress)
+{
+    CountingSignal Signal;
+
+    const auto NumProducers = std::max(std::thread::hardware_concurrency() / 2, 2u);
+    const auto NumConsumers = NumProducers;
+
+    constexpr Uint32 NumItems = 20000;
+
+    std::atomic<Uint32>      NumConsumed{0};
+    std::vector<std::thread> Threads;
+    for (Uint32 t = 0; t < NumProducers; ++t)
+    {
+        Threads.emplace_back(
+            [&]() {
+                for (Uint32 i = 0; i < NumItems; ++i)
+                    Signal.Trigger();
+            });
+    }
+    for (Uint32 t = 0; t < NumConsumers; ++t)
+    {
+        Threads.emplace_back(
+            [&]() {
+                for (Uint32 i = 0; i < NumItems; ++i)
+                {
+                    if ((i & 1) != 0)
+                        Signal.Acquire();
+                    else
+                        EXPECT_TRUE(Signal.AcquireFor(std::chrono::seconds{30}));
+                    NumConsumed.fetch_add(1);
+                }
+            });
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    EXPECT_EQ(NumConsumed.load(), NumConsumers * NumItems);
+    EXPECT_FALSE(Signal.IsTriggered());
+}
+
+} // namespace
@@ -0,0 +1,200 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "PlatformDefinitions.h"
+#include "ColorConversion.h"
+#include "Errors.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+float BitsToFloat(Uint32 Bits)
+{
+    float f;
+    memcpy(&f, &Bits, sizeof(f));
+    return f;
+}
+
+TEST(GraphicsAccessories_ColorConversion, SRGBToLinearSpan)
+{
+    std::vector<Uint8> SRGB(256);
+    for (Uint32 i = 0; i < 256; ++i)
+        SRGB[i] = static_cast<Uint8>(i);
+
+    std::vector<float> Linear(256);
+    SRGBToLinear(SRGB.data(), Linear.data(), SRGB.size());
+    for (Uint32 i = 0; i < 256; ++i)
+        EXPECT_EQ(Linear[i], SRGBToLinear(static_cast<Uint8>(i)));
+
+    // Every 8-bit value must survive the round trip
+    std::vector<Uint8> Encoded(256);
+    LinearToSRGB(Linear.data(), Encoded.data(), Linear.size());
+    EXPECT_EQ(Encoded, SRGB);
+}
+
+TEST(GraphicsAccessories_ColorConversion, LinearToSRGBSpan)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 Stride = 10007;
+#else
+    constexpr Uint32 Stride = 101;
+#endif
+
+    // Sample all floats in [0, 1] range
+    std::vector<float> Linear;
+    for (Uint32 Bits = 0; Bits <= 0x3F800000; Bits += Stride)
+        Linear.push_back(BitsToFloat(Bits));
+    Linear.push_back(1.f);
+
+    std::vector<Uint8> Encoded(Linear.size());
+    LinearToSRGB(Linear.data(), Encoded.data(), Linear.size());
+
+    double MaxError       = 0;
+    size_t NumNotRounded = 0;
+    for (size_t i = 0; i < Linear.size(); ++i)
+    {
+        const double Ref   = 255.0 * LinearToSRGB(Linear[i]);
+        const double Error = std::abs(Encoded[i] - Ref);
+        MaxError           = std::max(MaxError, Error);
+        if (Encoded[i] != static_cast<Uint8>(Ref + 0.5))
+            ++NumNotRounded;
+    }
+    LOG_INFO_MESSAGE("Max sRGB encoding error: ", MaxError, ", ", NumNotRounded, " of ", Linear.size(), " values are not correctly rounded");
+    EXPECT_LE(MaxError, SRGB8EncodeMaxError);
+
+    // Out-of-range values are clamped
+    const float Special[]    = {-1.f, -0.f, 1.5f, 1e+10f, -1e+10f, INFINITY, -INFINITY, NAN};
+    const Uint8 RefSpecial[] = {0, 0, 255, 255, 0, 255, 0, 0};
+    Uint8       EncodedSpecial[_countof(Special)];
+    LinearToSRGB(Special, EncodedSpecial, _countof(Special));
+    for (size_t i = 0; i < _countof(Special); ++i)
+        EXPECT_EQ(EncodedSpecial[i], RefSpecial[i]) << Special[i];
+}
+
+TEST(GraphicsAccessories_ColorConversion, RGBA8Conversions)
+{
+    std::vector<Uint8> SRGBA8(256 * 4);
+    for (Uint32 i = 0; i < 256; ++i)
+    {
+        SRGBA8[i * 4 + 0] = static_cast<Uint8>(i);
+        SRGBA8[i * 4 + 1] = static_cast<Uint8>(255 - i);
+        SRGBA8[i * 4 + 2] = static_cast<Uint8>(i * 7);
+        SRGBA8[i * 4 + 3] = static_cast<Uint8>(i * 13);
+    }
+
+    std::vector<float> RGBA32F(SRGBA8.size());
+    SRGBA8ToLinearRGBA32F(SRGBA8.data(), RGBA32F.data(), 256);
+    for (size_t i = 0; i < SRGBA8.size(); ++i)
+    {
+        const float Ref = (i % 4 == 3) ? SRGBA8[i] / 255.f : SRGBToLinear(SRGBA8[i]);
+        EXPECT_EQ(RGBA32F[i], Ref);
+    }
+
+    std::vector<Uint16> RGBA16F(SRGBA8.size());
+    SRGBA8ToLinearRGBA16F(SRGBA8.data(), RGBA16F.data(), 256);
+
+    std::vector<Uint8> Encoded(SRGBA8.size());
+    LinearRGBA32FToSRGBA8(RGBA32F.data(), Encoded.data(), 256);
+    EXPECT_EQ(Encoded, SRGBA8);
+
+    std::fill(Encoded.begin(), Encoded.end(), Uint8{0});
+    LinearRGBA16FToSRGBA8(RGBA16F.data(), Encoded.data(), 256);
+    EXPECT_EQ(Encoded, SRGBA8);
+
+    // Known half-precision values
+    const Uint8 Black[] = {0, 0, 0, 0};
+    const Uint8 White[] = {255, 255, 255, 255};
+    Uint16      Half[4];
+    SRGBA8ToLinearRGBA16F(Black, Half, 1);
+    for (auto h : Half)
+        EXPECT_EQ(h, 0u);
+    SRGBA8ToLinearRGBA16F(White, Half, 1);
+    for (auto h : Half)
+        EXPECT_EQ(h, 0x3C00u);
+
+    // Special half values: -1, 0.5, +Inf, NaN, 2.0, 2^-24 (denormal), 0.5, 0.5
+    const Uint16 SpecialHalf[] = {0xBC00, 0x3800, 0x7C00, 0x7E00, 0x4000, 0x0001, 0x3800, 0x3800};
+    Uint8        EncodedSpecial[_countof(SpecialHalf)];
+    LinearRGBA16FToSRGBA8(SpecialHalf, EncodedSpecial, 2);
+    const Uint8 RefSpecial[] = {0, 188, 255, 0, 255, 0, 188, 128};
+    for (size_t i = 0; i < _countof(SpecialHalf); ++i)
+        EXPECT_EQ(EncodedSpecial[i], RefSpecial[i]) << i;
+}
+
+template <typename OpType>
+double MeasureTime(int NumIterations, OpType Op)
+{
+    const auto StartTime = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < NumIterations; ++i)
+        Op();
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - StartTime).count() / NumIterations;
+}
+
+TEST(GraphicsAccessories_ColorConversion, DISABLED_Performance)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr int NumIterations = 1;
+#else
+    constexpr int NumIterations = 20;
+#endif
+    constexpr size_t NumPixels = 512 * 512;
+
+    std::vector<Uint8> SRGBA8(NumPixels * 4);
+    for (size_t i = 0; i < SRGBA8.size(); ++i)
+        SRGBA8[i] = static_cast<Uint8>(i * 31 + i / 7);
+    std::vector<float> RGBA32F(NumPixels * 4);
+
+    auto Measure = [&](const char* Name, double Time) {
+        LOG_INFO_MESSAGE(Name, ": ", NumPixels / Time * 1e-6, " Mpix/s");
+    };
+
+    Measure("Decode, per-value SRGBToLinear(float)", MeasureTime(NumIterations, [&]() {
+                for (size_t i = 0; i < SRGBA8.size(); ++i)
+                    RGBA32F[i] = (i % 4 == 3) ? SRGBA8[i] / 255.f : SRGBToLinear(SRGBA8[i] / 255.f);
+            }));
+    Measure("Decode, SRGBA8ToLinearRGBA32F        ", MeasureTime(NumIterations, [&]() { SRGBA8ToLinearRGBA32F(SRGBA8.data(), RGBA32F.data(), NumPixels); }));
+    Measure("Encode, per-value LinearToSRGB(float)", MeasureTime(NumIterations, [&]() {
+                for (size_t i = 0; i < SRGBA8.size(); ++i)
+                    SRGBA8[i] = static_cast<Uint8>(((i % 4 == 3) ? RGBA32F[i] : LinearToSRGB(RGBA32F[i])) * 255.f + 0.5f);
+            }));
+    Measure("Encode, LinearRGBA32FToSRGBA8        ", MeasureTime(NumIterations, [&]() { LinearRGBA32FToSRGBA8(RGBA32F.data(), SRGBA8.data(), NumPixels); }));
+
+    std::vector<Uint16> RGBA16F(NumPixels * 4);
+    Measure("Decode, SRGBA8ToLinearRGBA16F        ", MeasureTime(NumIterations, [&]() { SRGBA8ToLinearRGBA16F(SRGBA8.data(), RGBA16F.data(), NumPixels); }));
+    Measure("Encode, LinearRGBA16FToSRGBA8        ", MeasureTime(NumIterations, [&]() { LinearRGBA16FToSRGBA8(RGBA16F.data(), SRGBA8.data(), NumPixels); }));
+}
+
+} // namespace
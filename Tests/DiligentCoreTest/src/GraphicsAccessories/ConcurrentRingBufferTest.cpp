@@ -0,0 +1,363 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <random>
+#include <algorithm>
+#include <memory>
+
+#include "ConcurrentRingBuffer.hpp"
+#include "RingBuffer.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+#include "Timer.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+TEST(GraphicsAccessories_ConcurrentRingBuffer, AllocDealloc)
+{
+    // Need to define local variable to avoid vexing linker errors
+    const auto InvalidOffset = ConcurrentRingBuffer::InvalidOffset;
+    using OffsetType         = ConcurrentRingBuffer::OffsetType;
+
+    ConcurrentRingBuffer RB(1024, DefaultRawMemoryAllocator::GetAllocator());
+    EXPECT_TRUE(RB.IsEmpty());
+
+    EXPECT_EQ(RB.Allocate(120, 16), OffsetType{0});
+    EXPECT_EQ(RB.Allocate(10, 1), OffsetType{128});
+    EXPECT_EQ(RB.Allocate(10, 32), OffsetType{160});
+    //
+    //  t                    h
+    //  |                    |                           |
+    //  0                   192                        1024
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{192});
+    RB.FinishCurrentFrame(1);
+
+    // Does not fit at the end of the buffer, and there is no space at the beginning
+    EXPECT_EQ(RB.Allocate(900, 1), InvalidOffset);
+
+    EXPECT_EQ(RB.Allocate(800, 16), OffsetType{192});
+    //
+    //  t                                              h
+    //  |                                              |  |
+    //  0                   192                      992 1024
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{992});
+    RB.FinishCurrentFrame(2);
+
+    RB.ReleaseCompletedFrames(1);
+    //
+    //                       t                         h
+    //  |                    |                         |  |
+    //  0                   192                      992 1024
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{800});
+
+    EXPECT_EQ(RB.Allocate(200, 1), InvalidOffset);
+    // The space at the end of the buffer is wasted
+    EXPECT_EQ(RB.Allocate(100, 1), OffsetType{0});
+    EXPECT_EQ(RB.Allocate(92, 1), OffsetType{100});
+    //
+    //                      h,t
+    //  |                    |                         |  |
+    //  0                   192                      992 1024
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{1024});
+    EXPECT_EQ(RB.Allocate(1, 1), InvalidOffset);
+    RB.FinishCurrentFrame(3);
+
+    RB.ReleaseCompletedFrames(2);
+    EXPECT_EQ(RB.GetUsedSize(), OffsetType{224});
+
+    // The buffer becomes empty and is rewound to the beginning
+    RB.ReleaseCompletedFrames(3);
+    EXPECT_TRUE(RB.IsEmpty());
+    EXPECT_EQ(RB.Allocate(1024, 1), OffsetType{0});
+
+    // Zero-size frames are ignored
+    RB.FinishCurrentFrame(4);
+    RB.FinishCurrentFrame(5);
+    RB.ReleaseCompletedFrames(4);
+    EXPECT_TRUE(RB.IsEmpty());
+}
+
+// Spin barrier that synchronizes the threads at the end of every frame
+class FrameBarrier
+{
+public:
+    explicit FrameBarrier(Uint32 NumThreads) :
+        m_NumThreads{NumThreads}
+    {}
+
+    void Wait()
+    {
+        const auto Generation = m_Generation.load();
+        if (m_NumArrived.fetch_add(1) + 1 == m_NumThreads)
+        {
+            m_NumArrived.store(0);
+            m_Generation.fetch_add(1);
+        }
+        else
+        {
+            while (m_Generation.load() == Generation)
+                std::this_thread::yield();
+        }
+    }
+
+private:
+    const Uint32        m_NumThreads;
+    std::atomic<Uint32> m_NumArrived{0};
+    std::atomic<Uint32> m_Generation{0};
+};
+
+TEST(GraphicsAccessories_ConcurrentRingBuffer, Multithreaded)
+{
+    using OffsetType = ConcurrentRingBuffer::OffsetType;
+
+    constexpr OffsetType BufferSize     = 64 << 10;
+    constexpr Uint32     NumFrames      = 256;
+    constexpr Uint64     FramesInFlight = 2;
+
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 4u);
+
+    ConcurrentRingBuffer RB(BufferSize, DefaultRawMemoryAllocator::GetAllocator());
+
+    // Every allocation is filled with a unique tag. If two allocations overlap,
+    // the tag of one of them will be overwritten.
+    std::vector<Uint32> Tags(BufferSize);
+
+    std::atomic<Uint32> NumAllocations{0};
+    std::atomic<Uint32> NumFailedAllocations{0};
+    std::atomic<Uint32> NumCorruptedAllocations{0};
+
+    FrameBarrier Barrier{NumThreads};
+
+    std::vector<std::thread> Threads(NumThreads);
+    for (Uint32 t = 0; t < NumThreads; ++t)
+    {
+        Threads[t] = std::thread{
+            [&](Uint32 ThreadId) {
+                std::mt19937 Rnd{ThreadId};
+
+                struct Allocation
+                {
+                    OffsetType Offset;
+                    OffsetType Size;
+                    Uint32     Tag;
+                };
+                std::vector<Allocation> FrameAllocations;
+
+                Uint32 NextTag = ThreadId << 20;
+                for (Uint32 Frame = 0; Frame < NumFrames; ++Frame)
+                {
+                    FrameAllocations.clear();
+                    const auto NumFrameAllocations = Rnd() % 32;
+                    for (Uint32 i = 0; i < NumFrameAllocations; ++i)
+                    {
+                        const OffsetType Size      = 1 + Rnd() % 256;
+                        const OffsetType Alignment = OffsetType{1} << (Rnd() % 7);
+
+                        const auto Offset = RB.Allocate(Size, Alignment);
+                        if (Offset == ConcurrentRingBuffer::InvalidOffset)
+                        {
+                            NumFailedAllocations.fetch_add(1);
+                            continue;
+                        }
+                        NumAllocations.fetch_add(1);
+                        EXPECT_EQ(Offset % Alignment, OffsetType{0});
+                        EXPECT_LE(Offset + Size, BufferSize);
+
+                        const auto Tag = ++NextTag;
+                        std::fill(Tags.begin() + Offset, Tags.begin() + Offset + Size, Tag);
+                        FrameAllocations.push_back({Offset, Size, Tag});
+                    }
+
+                    // Wait until all threads finish allocating
+                    Barrier.Wait();
+
+                    for (const auto& Alloc : FrameAllocations)
+                    {
+                        if (std::any_of(Tags.begin() + Alloc.Offset, Tags.begin() + Alloc.Offset + Alloc.Size,
+                                        [&](Uint32 Tag) { return Tag != Alloc.Tag; }))
+                            NumCorruptedAllocations.fetch_add(1);
+                    }
+
+                    if (ThreadId == 0)
+                    {
+                        const auto FenceValue = Uint64{Frame} + 1;
+                        RB.FinishCurrentFrame(FenceValue);
+                        if (FenceValue > FramesInFlight)
+                            RB.ReleaseCompletedFrames(FenceValue - FramesInFlight);
+                    }
+
+                    // Wait until the frame is finished
+                    Barrier.Wait();
+                }
+            },
+            t};
+    }
+
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    RB.ReleaseCompletedFrames(NumFrames);
+    EXPECT_TRUE(RB.IsEmpty());
+
+    EXPECT_GT(NumAllocations.load(), Uint32{0});
+    EXPECT_EQ(NumCorruptedAllocations.load(), Uint32{0});
+}
+
+// Every thread allocates a random number of blocks every frame from either
+// a shared concurrent ring buffer or its own ring buffer.
+// Returns the total time and the memory that must be reserved to satisfy all allocations.
+template <bool UseSharedBuffer>
+void RunRingBufferStressTest(Uint32 NumThreads, Uint32 NumFrames, Uint32 MaxAllocationsPerFrame, double& ElapsedTime, size_t& RequiredSize)
+{
+    using OffsetType = RingBuffer::OffsetType;
+
+    constexpr OffsetType BufferSize     = 64 << 20;
+    constexpr Uint64     FramesInFlight = 2;
+
+    auto& Allocator = DefaultRawMemoryAllocator::GetAllocator();
+
+    std::unique_ptr<ConcurrentRingBuffer> pSharedRB;
+    std::vector<RingBuffer>               PerThreadRBs;
+    if (UseSharedBuffer)
+        pSharedRB.reset(new ConcurrentRingBuffer{BufferSize, Allocator});
+    else
+    {
+        PerThreadRBs.reserve(NumThreads);
+        for (Uint32 t = 0; t < NumThreads; ++t)
+            PerThreadRBs.emplace_back(BufferSize, Allocator);
+    }
+
+    std::vector<OffsetType>  PeakUsedSize(NumThreads);
+    std::atomic<Uint32>      NumFailedAllocations{0};
+    FrameBarrier             Barrier{NumThreads};
+    std::vector<std::thread> Threads(NumThreads);
+
+    Timer T;
+    for (Uint32 t = 0; t < NumThreads; ++t)
+    {
+        Threads[t] = std::thread{
+            [&](Uint32 ThreadId) {
+                std::mt19937 Rnd{ThreadId};
+
+                auto& PeakSize = PeakUsedSize[ThreadId];
+                for (Uint32 Frame = 0; Frame < NumFrames; ++Frame)
+                {
+                    // Load is unevenly distributed between threads and frames
+                    const auto NumAllocations = Rnd() % (MaxAllocationsPerFrame + 1);
+                    for (Uint32 i = 0; i < NumAllocations; ++i)
+                    {
+                        const OffsetType Size   = 16 + Rnd() % 1024;
+                        const auto       Offset = UseSharedBuffer ?
+                            pSharedRB->Allocate(Size, 16) :
+                            PerThreadRBs[ThreadId].Allocate(Size, 16);
+                        if (Offset == RingBuffer::InvalidOffset)
+                            NumFailedAllocations.fetch_add(1);
+                    }
+
+                    const auto FenceValue = Uint64{Frame} + 1;
+                    if (UseSharedBuffer)
+                    {
+                        Barrier.Wait();
+                        if (ThreadId == 0)
+                        {
+                            PeakSize = std::max(PeakSize, pSharedRB->GetUsedSize());
+                            pSharedRB->FinishCurrentFrame(FenceValue);
+                            if (FenceValue > FramesInFlight)
+                                pSharedRB->ReleaseCompletedFrames(FenceValue - FramesInFlight);
+                        }
+                    }
+                    else
+                    {
+                        auto& RB = PerThreadRBs[ThreadId];
+                        PeakSize = std::max(PeakSize, RB.GetUsedSize());
+                        RB.FinishCurrentFrame(FenceValue);
+                        if (FenceValue > FramesInFlight)
+                            RB.ReleaseCompletedFrames(FenceValue - FramesInFlight);
+                        Barrier.Wait();
+                    }
+                    Barrier.Wait();
+                }
+            },
+            t};
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+    ElapsedTime = T.GetElapsedTime();
+
+    if (UseSharedBuffer)
+        pSharedRB->ReleaseCompletedFrames(NumFrames);
+    for (auto& RB : PerThreadRBs)
+        RB.ReleaseCompletedFrames(NumFrames);
+
+    EXPECT_EQ(NumFailedAllocations.load(), Uint32{0});
+
+    // Every per-thread buffer must be large enough for the peak load of its own thread
+    RequiredSize = 0;
+    for (auto PeakSize : PeakUsedSize)
+        RequiredSize += PeakSize;
+}
+
+TEST(GraphicsAccessories_ConcurrentRingBuffer, StressTest)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 NumFrames = 64;
+#else
+    constexpr Uint32 NumFrames = 1024;
+#endif
+    constexpr Uint32 MaxAllocationsPerFrame = 512;
+
+    const Uint32 MaxThreads = std::max(std::thread::hardware_concurrency(), 4u);
+    for (Uint32 NumThreads = 1; NumThreads <= MaxThreads; NumThreads *= 2)
+    {
+        double PerThreadTime = 0;
+        size_t PerThreadSize = 0;
+        RunRingBufferStressTest<false>(NumThreads, NumFrames, MaxAllocationsPerFrame, PerThreadTime, PerThreadSize);
+
+        double SharedTime = 0;
+        size_t SharedSize = 0;
+        RunRingBufferStressTest<true>(NumThreads, NumFrames, MaxAllocationsPerFrame, SharedTime, SharedSize);
+
+        if (NumThreads == 1)
+            EXPECT_EQ(SharedSize, PerThreadSize);
+        else
+            EXPECT_LE(SharedSize, PerThreadSize);
+
+        const auto NumAllocations = double{NumFrames} * NumThreads * MaxAllocationsPerFrame / 2;
+        LOG_INFO_MESSAGE("Threads: ", NumThreads,
+                         ". Per-thread buffers: ", static_cast<Uint64>(NumAllocations / PerThreadTime), " allocs/s, ", PerThreadSize >> 10, " KB required",
+                         ". Shared buffer: ", static_cast<Uint64>(NumAllocations / SharedTime), " allocs/s, ", SharedSize >> 10, " KB required");
+    }
+}
+
+} // namespace
@@ -26,9 +26,16 @@
  */
 
 #include <memory>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <deque>
+#include <algorithm>
 
 #include "ResourceReleaseQueue.hpp"
 #include "DefaultRawMemoryAllocator.hpp"
+#include "Timer.hpp"
 
 #include "gtest/gtest.h"
 
@@ -128,4 +135,426 @@ TEST(GraphicsAccessories_ResourceReleaseQueue, GetFilterTypeLiteralName)
     }
 }
 
+struct ReleaseTracker
+{
+    std::atomic<Uint64> CompletedFenceValue{0};
+    std::atomic<Uint32> NumDestroyed{0};
+    std::atomic<Uint32> NumDestroyedEarly{0};
+};
+
+// Resource that checks that it is not destroyed before the fence it was released with is completed
+class TrackedResource
+{
+public:
+    TrackedResource(ReleaseTracker& Tracker, Uint64 ReleaseFenceValue) :
+        m_pTracker{&Tracker},
+        m_ReleaseFenceValue{ReleaseFenceValue}
+    {}
+
+    TrackedResource(TrackedResource&& rhs) noexcept :
+        m_pTracker{rhs.m_pTracker},
+        m_ReleaseFenceValue{rhs.m_ReleaseFenceValue}
+    {
+        rhs.m_pTracker = nullptr;
+    }
+
+    // clang-format off
+    TrackedResource             (const TrackedResource&) = delete;
+    TrackedResource& operator = (const TrackedResource&) = delete;
+    TrackedResource& operator = (TrackedResource&&)      = delete;
+    // clang-format on
+
+    ~TrackedResource()
+    {
+        if (m_pTracker != nullptr)
+        {
+            if (m_pTracker->CompletedFenceValue.load() < m_ReleaseFenceValue)
+                m_pTracker->NumDestroyedEarly.fetch_add(1);
+            m_pTracker->NumDestroyed.fetch_add(1);
+        }
+    }
+
+private:
+    ReleaseTracker* m_pTracker;
+    Uint64          m_ReleaseFenceValue;
+};
+
+// Queue with the same interface that protects its deques with mutexes and
+// allocates a wrapper for every resource. Serves as the performance baseline.
+class MutexReleaseQueue
+{
+public:
+    template <typename ResourceType>
+    void SafeReleaseResource(ResourceType&& Resource, Uint64 NextCommandListNumber)
+    {
+        std::unique_ptr<ResourceHolderBase> pHolder{new ResourceHolder<ResourceType>{std::move(Resource)}};
+
+        std::lock_guard<std::mutex> Lock{m_StaleResourcesMtx};
+        m_StaleResources.emplace_back(NextCommandListNumber, std::move(pHolder));
+    }
+
+    template <typename ResourceType>
+    void DiscardResource(ResourceType&& Resource, Uint64 FenceValue)
+    {
+        std::unique_ptr<ResourceHolderBase> pHolder{new ResourceHolder<ResourceType>{std::move(Resource)}};
+
+        std::lock_guard<std::mutex> Lock{m_ReleaseQueueMtx};
+        m_ReleaseQueue.emplace_back(FenceValue, std::move(pHolder));
+    }
+
+    void DiscardStaleResources(Uint64 SubmittedCmdBuffNumber, Uint64 FenceValue)
+    {
+        std::lock_guard<std::mutex> StaleLock{m_StaleResourcesMtx};
+        std::lock_guard<std::mutex> ReleaseLock{m_ReleaseQueueMtx};
+        while (!m_StaleResources.empty() && m_StaleResources.front().first <= SubmittedCmdBuffNumber)
+        {
+            m_ReleaseQueue.emplace_back(FenceValue, std::move(m_StaleResources.front().second));
+            m_StaleResources.pop_front();
+        }
+    }
+
+    void Purge(Uint64 CompletedFenceValue)
+    {
+        std::lock_guard<std::mutex> Lock{m_ReleaseQueueMtx};
+        while (!m_ReleaseQueue.empty() && m_ReleaseQueue.front().first <= CompletedFenceValue)
+            m_ReleaseQueue.pop_front();
+    }
+
+    size_t GetStaleResourceCount() const
+    {
+        return m_StaleResources.size();
+    }
+
+    size_t GetPendingReleaseResourceCount() const
+    {
+        return m_ReleaseQueue.size();
+    }
+
+private:
+    struct ResourceHolderBase
+    {
+        virtual ~ResourceHolderBase() {}
+    };
+
+    template <typename ResourceType>
+    struct ResourceHolder final : ResourceHolderBase
+    {
+        ResourceHolder(ResourceType&& _Resource) :
+            Resource{std::move(_Resource)}
+        {}
+        ResourceType Resource;
+    };
+
+    using QueueElemType = std::pair<Uint64, std::unique_ptr<ResourceHolderBase>>;
+
+    std::mutex                m_StaleResourcesMtx;
+    std::deque<QueueElemType> m_StaleResources;
+
+    std::mutex                m_ReleaseQueueMtx;
+    std::deque<QueueElemType> m_ReleaseQueue;
+};
+
+// Releases resources from NumThreads threads while the calling thread submits command
+// lists and purges the queue. Every other resource is discarded directly if DiscardResources is true.
+// Returns the time it took to release all resources.
+template <typename QueueType>
+double ReleaseResourcesMultithreaded(QueueType& Queue, ReleaseTracker& Tracker, Uint32 NumThreads, Uint32 NumResourcesPerThread, bool DiscardResources)
+{
+    std::atomic<Uint64> NextCmdListNumber{1};
+    std::atomic<Uint32> NumRunningThreads{NumThreads};
+    std::atomic_bool    StartFlag{false};
+
+    std::vector<std::thread> Threads(NumThreads);
+    for (auto& Thread : Threads)
+    {
+        Thread = std::thread{
+            [&]() {
+                while (!StartFlag)
+                    std::this_thread::yield();
+
+                for (Uint32 i = 0; i < NumResourcesPerThread; ++i)
+                {
+                    if (DiscardResources && (i & 0x01) != 0)
+                    {
+                        const auto FenceValue = Tracker.CompletedFenceValue.load() + 1;
+                        Queue.DiscardResource(TrackedResource{Tracker, FenceValue}, FenceValue);
+                    }
+                    else
+                    {
+                        // The fence value of the command list is its number plus one
+                        const auto CmdListNumber = NextCmdListNumber.load();
+                        Queue.SafeReleaseResource(TrackedResource{Tracker, CmdListNumber + 1}, CmdListNumber);
+                    }
+                }
+                NumRunningThreads.fetch_sub(1);
+            }};
+    }
+
+    // Fences are completed with one command list delay
+    auto SubmitCommandList = [&]() {
+        const auto SubmittedCmdListNumber = NextCmdListNumber.fetch_add(1);
+        Queue.DiscardStaleResources(SubmittedCmdListNumber, SubmittedCmdListNumber + 1);
+        Tracker.CompletedFenceValue.store(SubmittedCmdListNumber);
+        Queue.Purge(SubmittedCmdListNumber);
+    };
+
+    Timer T;
+    StartFlag = true;
+    while (NumRunningThreads.load() != 0)
+    {
+        SubmitCommandList();
+        std::this_thread::yield();
+    }
+    for (auto& Thread : Threads)
+        Thread.join();
+
+    SubmitCommandList();
+    SubmitCommandList();
+
+    return T.GetElapsedTime();
+}
+
+TEST(GraphicsAccessories_ResourceReleaseQueue, Multithreaded)
+{
+    constexpr Uint32 NumResourcesPerThread = 4096;
+
+    const auto NumThreads = std::max(std::thread::hardware_concurrency(), 4u);
+
+    for (int Config = 0; Config < 4; ++Config)
+    {
+        const bool DiscardResources  = (Config & 0x01) != 0;
+        const bool BackgroundRelease = (Config & 0x02) != 0;
+
+        ReleaseTracker Tracker;
+        {
+            ResourceReleaseQueue<DynamicStaleResourceWrapper> Queue(DefaultRawMemoryAllocator::GetAllocator());
+            Queue.SetBackgroundRelease(BackgroundRelease);
+            ReleaseResourcesMultithreaded(Queue, Tracker, NumThreads, NumResourcesPerThread, DiscardResources);
+            Queue.WaitForBackgroundRelease();
+            EXPECT_EQ(Queue.GetStaleResourceCount(), size_t{0});
+            EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), size_t{0});
+        }
+        EXPECT_EQ(Tracker.NumDestroyed.load(), NumThreads * NumResourcesPerThread);
+        EXPECT_EQ(Tracker.NumDestroyedEarly.load(), Uint32{0});
+    }
+}
+
+TEST(GraphicsAccessories_ResourceReleaseQueue, PurgeBudget)
+{
+    constexpr Uint32 NumResources = 100;
+
+    ReleaseTracker Tracker;
+
+    ResourceReleaseQueue<DynamicStaleResourceWrapper> Queue(DefaultRawMemoryAllocator::GetAllocator());
+    for (Uint32 i = 0; i < NumResources; ++i)
+        Queue.DiscardResource(TrackedResource{Tracker, 1}, 1);
+    Queue.DiscardResource(TrackedResource{Tracker, 2}, 2);
+
+    ResourcePurgeBudget Budget;
+    Budget.MaxResources = 30;
+
+    // Nothing has completed yet
+    EXPECT_EQ(Queue.Purge(0, Budget), size_t{0});
+
+    Tracker.CompletedFenceValue = 1;
+
+    auto Stats = Queue.GetStats();
+    EXPECT_EQ(Stats.NumPendingResources, size_t{NumResources + 1});
+    EXPECT_EQ(Stats.BacklogSize, size_t{0});
+
+    EXPECT_EQ(Queue.Purge(1, Budget), size_t{30});
+    Stats = Queue.GetStats();
+    EXPECT_EQ(Stats.NumPendingResources, size_t{1});
+    EXPECT_EQ(Stats.BacklogSize, size_t{NumResources - 30});
+
+    EXPECT_EQ(Queue.Purge(1, Budget), size_t{30});
+    EXPECT_EQ(Queue.Purge(1, Budget), size_t{30});
+    EXPECT_EQ(Queue.Purge(1, Budget), size_t{10});
+    EXPECT_EQ(Tracker.NumDestroyed.load(), NumResources);
+    Stats = Queue.GetStats();
+    EXPECT_EQ(Stats.NumPendingResources, size_t{1});
+    EXPECT_EQ(Stats.BacklogSize, size_t{0});
+
+    Tracker.CompletedFenceValue = 2;
+    EXPECT_EQ(Queue.Purge(2, Budget), size_t{1});
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), size_t{0});
+    EXPECT_EQ(Tracker.NumDestroyedEarly.load(), Uint32{0});
+}
+
+TEST(GraphicsAccessories_ResourceReleaseQueue, PurgeTimeBudget)
+{
+    // Resource that takes a while to destroy
+    struct SlowResource
+    {
+        SlowResource() = default;
+        SlowResource(SlowResource&& rhs) noexcept :
+            IsValid{rhs.IsValid}
+        {
+            rhs.IsValid = false;
+        }
+        ~SlowResource()
+        {
+            if (IsValid)
+            {
+                Timer T;
+                while (T.GetElapsedTime() < 50e-6)
+                {}
+            }
+        }
+        bool IsValid = true;
+    };
+
+    constexpr Uint32 NumResources = 200;
+
+    ResourceReleaseQueue<DynamicStaleResourceWrapper> Queue(DefaultRawMemoryAllocator::GetAllocator());
+    for (Uint32 i = 0; i < NumResources; ++i)
+        Queue.DiscardResource(SlowResource{}, 1);
+
+    ResourcePurgeBudget Budget;
+    Budget.MaxMicroseconds = 1000;
+
+    // Destroying all resources takes at least 10 ms
+    const auto NumDestroyed = Queue.Purge(1, Budget);
+    EXPECT_GE(NumDestroyed, size_t{1});
+    EXPECT_LT(NumDestroyed, size_t{NumResources});
+    EXPECT_EQ(Queue.GetStats().BacklogSize, NumResources - NumDestroyed);
+
+    size_t TotalDestroyed = NumDestroyed;
+    while (Queue.GetPendingReleaseResourceCount() != 0)
+        TotalDestroyed += Queue.Purge(1, Budget);
+    EXPECT_EQ(TotalDestroyed, size_t{NumResources});
+}
+
+TEST(GraphicsAccessories_ResourceReleaseQueue, BackgroundRelease)
+{
+    // Resource that counts the number of times it was destroyed in the thread that created it
+    struct ThreadCheckResource
+    {
+        ThreadCheckResource(std::atomic<Uint32>& _NumDestroyedInOwnerThread) :
+            pNumDestroyedInOwnerThread{&_NumDestroyedInOwnerThread},
+            OwnerThreadId{std::this_thread::get_id()}
+        {}
+        ThreadCheckResource(ThreadCheckResource&& rhs) noexcept :
+            pNumDestroyedInOwnerThread{rhs.pNumDestroyedInOwnerThread},
+            OwnerThreadId{rhs.OwnerThreadId}
+        {
+            rhs.pNumDestroyedInOwnerThread = nullptr;
+        }
+        ~ThreadCheckResource()
+        {
+            if (pNumDestroyedInOwnerThread != nullptr && std::this_thread::get_id() == OwnerThreadId)
+                pNumDestroyedInOwnerThread->fetch_add(1);
+        }
+        std::atomic<Uint32>* pNumDestroyedInOwnerThread;
+        std::thread::id      OwnerThreadId;
+    };
+
+    constexpr Uint32 NumResources = 256;
+
+    std::atomic<Uint32> NumDestroyedInOwnerThread{0};
+
+    ResourceReleaseQueue<DynamicStaleResourceWrapper> Queue(DefaultRawMemoryAllocator::GetAllocator());
+    Queue.SetBackgroundRelease(true);
+    EXPECT_TRUE(Queue.IsBackgroundReleaseEnabled());
+
+    for (Uint32 i = 0; i < NumResources; ++i)
+        Queue.SafeReleaseResource(ThreadCheckResource{NumDestroyedInOwnerThread}, 1);
+    Queue.DiscardStaleResources(1, 1);
+
+    // The budget is ignored when background release is enabled
+    ResourcePurgeBudget Budget;
+    Budget.MaxResources = 1;
+    EXPECT_EQ(Queue.Purge(1, Budget), size_t{NumResources});
+
+    Queue.WaitForBackgroundRelease();
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), size_t{0});
+    EXPECT_EQ(Queue.GetStats().BacklogSize, size_t{0});
+    EXPECT_EQ(NumDestroyedInOwnerThread.load(), Uint32{0});
+
+    // Resources handed over to the thread must be destroyed when background release is disabled
+    for (Uint32 i = 0; i < NumResources; ++i)
+        Queue.DiscardResource(ThreadCheckResource{NumDestroyedInOwnerThread}, 2);
+    Queue.Purge(2);
+    Queue.SetBackgroundRelease(false);
+    EXPECT_FALSE(Queue.IsBackgroundReleaseEnabled());
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), size_t{0});
+    EXPECT_EQ(NumDestroyedInOwnerThread.load(), Uint32{0});
+
+    // Resources are destroyed synchronously again
+    Queue.DiscardResource(ThreadCheckResource{NumDestroyedInOwnerThread}, 3);
+    Queue.Purge(3);
+    EXPECT_EQ(NumDestroyedInOwnerThread.load(), Uint32{1});
+}
+
+TEST(GraphicsAccessories_ResourceReleaseQueue, FenceOrder)
+{
+    ReleaseTracker Tracker;
+
+    ResourceReleaseQueue<DynamicStaleResourceWrapper> Queue(DefaultRawMemoryAllocator::GetAllocator());
+
+    Queue.SafeReleaseResource(TrackedResource{Tracker, 2}, 2);
+    Queue.SafeReleaseResource(TrackedResource{Tracker, 1}, 1);
+    Queue.DiscardResource(TrackedResource{Tracker, 1}, 1);
+    EXPECT_EQ(Queue.GetStaleResourceCount(), size_t{2});
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), size_t{1});
+
+    // Command list 1 is submitted. The resource released with command list 2 must stay
+    // in the stale list even though it was released first.
+    Queue.DiscardStaleResources(1, 1);
+    EXPECT_EQ(Queue.GetStaleResourceCount(), size_t{1});
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), size_t{2});
+
+    Queue.DiscardStaleResources(2, 2);
+    EXPECT_EQ(Queue.GetStaleResourceCount(), size_t{0});
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), size_t{3});
+
+    Queue.Purge(0);
+    EXPECT_EQ(Tracker.NumDestroyed.load(), Uint32{0});
+
+    Tracker.CompletedFenceValue = 1;
+    Queue.Purge(1);
+    EXPECT_EQ(Tracker.NumDestroyed.load(), Uint32{2});
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), size_t{1});
+
+    Tracker.CompletedFenceValue = 2;
+    Queue.Purge(2);
+    EXPECT_EQ(Tracker.NumDestroyed.load(), Uint32{3});
+    EXPECT_EQ(Queue.GetPendingReleaseResourceCount(), size_t{0});
+    EXPECT_EQ(Tracker.NumDestroyedEarly.load(), Uint32{0});
+}
+
+TEST(GraphicsAccessories_ResourceReleaseQueue, DISABLED_MultithreadedPerformance)
+{
+#ifdef DILIGENT_DEBUG
+    constexpr Uint32 NumResourcesPerThread = 1 << 14;
+#else
+    constexpr Uint32 NumResourcesPerThread = 1 << 18;
+#endif
+
+    const Uint32 MaxThreads = std::max(std::thread::hardware_concurrency(), 4u);
+    for (Uint32 NumThreads = 1; NumThreads <= MaxThreads; NumThreads *= 2)
+    {
+        const auto NumResources = double{NumResourcesPerThread} * NumThreads;
+
+        double BaselineTime = 0;
+        {
+            ReleaseTracker    Tracker;
+            MutexReleaseQueue Queue;
+            BaselineTime = ReleaseResourcesMultithreaded(Queue, Tracker, NumThreads, NumResourcesPerThread, false);
+            EXPECT_EQ(Tracker.NumDestroyed.load(), NumThreads * NumResourcesPerThread);
+        }
+
+        double LockFreeTime = 0;
+        {
+            ReleaseTracker                                    Tracker;
+            ResourceReleaseQueue<DynamicStaleResourceWrapper> Queue(DefaultRawMemoryAllocator::GetAllocator());
+            LockFreeTime = ReleaseResourcesMultithreaded(Queue, Tracker, NumThreads, NumResourcesPerThread, false);
+            EXPECT_EQ(Tracker.NumDestroyed.load(), NumThreads * NumResourcesPerThread);
+        }
+
+        LOG_INFO_MESSAGE("Threads: ", NumThreads, ". Mutex queue: ", static_cast<Uint64>(NumResources / BaselineTime),
+                         " releases/s, lock-free queue: ", static_cast<Uint64>(NumResources / LockFreeTime), " releases/s");
+    }
+}
+
 } // namespace
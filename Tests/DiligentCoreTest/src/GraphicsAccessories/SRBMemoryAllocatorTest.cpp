@@ -0,0 +1,188 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "SRBMemoryAllocator.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+std::unique_ptr<SRBMemoryAllocator> CreateSRBAllocator(Uint32 Granularity, size_t ShaderVariableDataSize, size_t ResourceCacheDataSize)
+{
+    std::unique_ptr<SRBMemoryAllocator> pAllocator{new SRBMemoryAllocator{DefaultRawMemoryAllocator::GetAllocator()}};
+    pAllocator->Initialize(Granularity, 1, &ShaderVariableDataSize, 1, &ResourceCacheDataSize);
+    return pAllocator;
+}
+
+TEST(GraphicsAccessories_SRBMemoryAllocator, SizeClasses)
+{
+    // clang-format off
+    EXPECT_EQ(SRBMemoryAllocator::GetSizeClass(0),      16u);
+    EXPECT_EQ(SRBMemoryAllocator::GetSizeClass(1),      16u);
+    EXPECT_EQ(SRBMemoryAllocator::GetSizeClass(16),     16u);
+    EXPECT_EQ(SRBMemoryAllocator::GetSizeClass(17),     32u);
+    EXPECT_EQ(SRBMemoryAllocator::GetSizeClass(127),   128u);
+    EXPECT_EQ(SRBMemoryAllocator::GetSizeClass(128),   128u);
+    EXPECT_EQ(SRBMemoryAllocator::GetSizeClass(129),   160u);
+    EXPECT_EQ(SRBMemoryAllocator::GetSizeClass(160),   160u);
+    EXPECT_EQ(SRBMemoryAllocator::GetSizeClass(161),   192u);
+    EXPECT_EQ(SRBMemoryAllocator::GetSizeClass(255),   256u);
+    EXPECT_EQ(SRBMemoryAllocator::GetSizeClass(256),   256u);
+    EXPECT_EQ(SRBMemoryAllocator::GetSizeClass(257),   320u);
+    EXPECT_EQ(SRBMemoryAllocator::GetSizeClass(1000), 1024u);
+    EXPECT_EQ(SRBMemoryAllocator::GetSizeClass(1025), 1280u);
+    // clang-format on
+
+    size_t PrevSizeClass = 0;
+    for (size_t Size = 1; Size <= 8192; ++Size)
+    {
+        const auto SizeClass = SRBMemoryAllocator::GetSizeClass(Size);
+        EXPECT_GE(SizeClass, Size);
+        EXPECT_GE(SizeClass, PrevSizeClass);
+        EXPECT_EQ(SizeClass % 16, 0u);
+        EXPECT_EQ(SRBMemoryAllocator::GetSizeClass(SizeClass), SizeClass);
+        if (Size > 128)
+        {
+            // Less than 25% of a block is wasted
+            EXPECT_LT((SizeClass - Size) * 4, SizeClass);
+        }
+        PrevSizeClass = SizeClass;
+    }
+}
+
+TEST(GraphicsAccessories_SRBMemoryAllocator, SharedPools)
+{
+    ASSERT_EQ(SRBMemoryAllocator::GetPoolStats().NumPools, 0u);
+
+    auto pAllocator0 = CreateSRBAllocator(8, 100, 200);
+    EXPECT_EQ(SRBMemoryAllocator::GetPoolStats().NumPools, 2u);
+
+    // Different sizes that fall into the same size classes
+    auto pAllocator1 = CreateSRBAllocator(8, 112, 193);
+    EXPECT_EQ(SRBMemoryAllocator::GetPoolStats().NumPools, 2u);
+
+    // Both allocators take blocks from the first page of the same pools
+    std::vector<void*> Data;
+    for (Uint32 i = 0; i < 4; ++i)
+    {
+        Data.push_back(pAllocator0->GetShaderVariableDataAllocator(0).Allocate(100, "Test", __FILE__, __LINE__));
+        Data.push_back(pAllocator1->GetShaderVariableDataAllocator(0).Allocate(112, "Test", __FILE__, __LINE__));
+    }
+    EXPECT_EQ(SRBMemoryAllocator::GetPoolStats().NumPages, 2u);
+
+    for (size_t i = 0; i < Data.size(); ++i)
+        (i % 2 == 0 ? pAllocator0 : pAllocator1)->GetShaderVariableDataAllocator(0).Free(Data[i]);
+
+    // A different size class creates a new pool
+    auto pAllocator2 = CreateSRBAllocator(8, 100, 1000);
+    EXPECT_EQ(SRBMemoryAllocator::GetPoolStats().NumPools, 3u);
+}
+
+TEST(GraphicsAccessories_SRBMemoryAllocator, ReleasePools)
+{
+    ASSERT_EQ(SRBMemoryAllocator::GetPoolStats().NumPools, 0u);
+
+    auto pAllocator0 = CreateSRBAllocator(8, 64, 256);
+    auto pAllocator1 = CreateSRBAllocator(8, 64, 512);
+    EXPECT_EQ(SRBMemoryAllocator::GetPoolStats().NumPools, 3u);
+
+    void* pData = pAllocator0->GetResourceCacheDataAllocator(0).Allocate(256, "Test", __FILE__, __LINE__);
+    pAllocator0->GetResourceCacheDataAllocator(0).Free(pData);
+
+    // The pool of the 64-byte class is still used by the second allocator
+    pAllocator0.reset();
+    EXPECT_EQ(SRBMemoryAllocator::GetPoolStats().NumPools, 2u);
+
+    pAllocator1.reset();
+    const auto Stats = SRBMemoryAllocator::GetPoolStats();
+    EXPECT_EQ(Stats.NumPools, 0u);
+    EXPECT_EQ(Stats.NumPages, 0u);
+    EXPECT_EQ(Stats.ReservedSize, 0u);
+    EXPECT_EQ(Stats.AllocatedSize, 0u);
+}
+
+TEST(GraphicsAccessories_SRBMemoryAllocator, Stats)
+{
+    ASSERT_EQ(SRBMemoryAllocator::GetPoolStats().NumPools, 0u);
+
+    constexpr size_t ShaderVariableDataSize = 40;
+    constexpr size_t ResourceCacheDataSize  = 300;
+
+    auto  pAllocator         = CreateSRBAllocator(4, ShaderVariableDataSize, ResourceCacheDataSize);
+    auto& VarDataAllocator   = pAllocator->GetShaderVariableDataAllocator(0);
+    auto& CacheDataAllocator = pAllocator->GetResourceCacheDataAllocator(0);
+
+    auto Stats = pAllocator->GetStats();
+    EXPECT_EQ(Stats.NumAllocations, 0u);
+    EXPECT_EQ(Stats.RequestedSize, 0u);
+    EXPECT_EQ(Stats.AllocatedSize, 0u);
+
+    constexpr Uint32   NumSRBs = 10;
+    std::vector<void*> VarData, CacheData;
+    for (Uint32 i = 0; i < NumSRBs; ++i)
+    {
+        VarData.push_back(VarDataAllocator.Allocate(ShaderVariableDataSize, "Test", __FILE__, __LINE__));
+        CacheData.push_back(CacheDataAllocator.Allocate(ResourceCacheDataSize, "Test", __FILE__, __LINE__));
+    }
+
+    Stats = pAllocator->GetStats();
+    EXPECT_EQ(Stats.NumAllocations, NumSRBs * 2);
+    EXPECT_EQ(Stats.RequestedSize, NumSRBs * (ShaderVariableDataSize + ResourceCacheDataSize));
+    EXPECT_EQ(Stats.AllocatedSize, NumSRBs * (SRBMemoryAllocator::GetSizeClass(ShaderVariableDataSize) + SRBMemoryAllocator::GetSizeClass(ResourceCacheDataSize)));
+
+    // The pools also count the blocks kept in the thread caches
+    auto PoolStats = SRBMemoryAllocator::GetPoolStats();
+    EXPECT_EQ(PoolStats.NumPools, 2u);
+    EXPECT_GE(PoolStats.AllocatedSize, Stats.AllocatedSize);
+    EXPECT_GE(PoolStats.ReservedSize, PoolStats.AllocatedSize);
+    // Every pool has a page of 4 blocks and a page of 8 blocks
+    EXPECT_EQ(PoolStats.NumPages, 4u);
+
+    for (Uint32 i = 0; i < NumSRBs; ++i)
+    {
+        VarDataAllocator.Free(VarData[i]);
+        CacheDataAllocator.Free(CacheData[i]);
+    }
+
+    Stats = pAllocator->GetStats();
+    EXPECT_EQ(Stats.NumAllocations, 0u);
+    EXPECT_EQ(Stats.RequestedSize, 0u);
+    EXPECT_EQ(Stats.AllocatedSize, 0u);
+
+    // Pages are not released until the pool is destroyed
+    PoolStats = SRBMemoryAllocator::GetPoolStats();
+    EXPECT_EQ(PoolStats.NumPages, 4u);
+}
+
+} // namespace
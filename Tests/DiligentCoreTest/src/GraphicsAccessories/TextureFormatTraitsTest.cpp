@@ -0,0 +1,293 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "TextureFormatTraits.hpp"
+#include "GraphicsAccessories.hpp"
+#include "Align.hpp"
+#include "Timer.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+// clang-format off
+static_assert(TextureFormatTraits<TEX_FORMAT_RGBA8_UNORM>::ElementSize == 4,                       "Unexpected element size");
+static_assert(TextureFormatTraits<TEX_FORMAT_BC1_UNORM>::IsCompressed,                             "BC1 is a compressed format");
+static_assert(TextureFormatTraits<TEX_FORMAT_BC1_UNORM>::ElementSize == 8,                         "Unexpected block size");
+static_assert(TextureFormatTraits<TEX_FORMAT_RGBA32_TYPELESS>::IsTypeless,                         "RGBA32_TYPELESS is a typeless format");
+static_assert(TextureFormatTraits<TEX_FORMAT_D32_FLOAT>::DSVFormat == TEX_FORMAT_D32_FLOAT,        "Unexpected DSV format");
+static_assert(TextureFormatTraits<TEX_FORMAT_RGBA8_TYPELESS>::SRVFormat == TEX_FORMAT_RGBA8_UNORM_SRGB, "Unexpected SRV format");
+static_assert(GetTextureFormatAttribs(TEX_FORMAT_BC7_UNORM).BlockWidth == 4,                       "Unexpected block width");
+// clang-format on
+
+template <TEXTURE_FORMAT Format>
+void CheckTextureFormatTraits()
+{
+    using Traits = TextureFormatTraits<Format>;
+
+    const auto& Attribs = GetTextureFormatAttribs(Format);
+    EXPECT_EQ(&Traits::GetAttribs(), &Attribs);
+    EXPECT_STREQ(Traits::Name, Attribs.Name);
+    EXPECT_EQ(Traits::ComponentSize, Attribs.ComponentSize);
+    EXPECT_EQ(Traits::NumComponents, Attribs.NumComponents);
+    EXPECT_EQ(Traits::ComponentType, Attribs.ComponentType);
+    EXPECT_EQ(Traits::IsTypeless, Attribs.IsTypeless);
+    EXPECT_EQ(Traits::BlockWidth, Attribs.BlockWidth);
+    EXPECT_EQ(Traits::BlockHeight, Attribs.BlockHeight);
+    EXPECT_EQ(Traits::IsCompressed, Attribs.ComponentType == COMPONENT_TYPE_COMPRESSED);
+    EXPECT_EQ(Traits::ElementSize, Attribs.GetElementSize());
+    EXPECT_EQ(Traits::SRVFormat, GetDefaultTextureViewFormat(Format, TEXTURE_VIEW_SHADER_RESOURCE, BIND_SHADER_RESOURCE));
+    EXPECT_EQ(Traits::RTVFormat, GetDefaultTextureViewFormat(Format, TEXTURE_VIEW_RENDER_TARGET, BIND_RENDER_TARGET));
+    EXPECT_EQ(Traits::DSVFormat, GetDefaultTextureViewFormat(Format, TEXTURE_VIEW_DEPTH_STENCIL, BIND_DEPTH_STENCIL));
+    EXPECT_EQ(Traits::UAVFormat, GetDefaultTextureViewFormat(Format, TEXTURE_VIEW_UNORDERED_ACCESS, BIND_UNORDERED_ACCESS));
+}
+
+TEST(GraphicsAccessories_TextureFormatTraits, Traits)
+{
+    CheckTextureFormatTraits<TEX_FORMAT_UNKNOWN>();
+    CheckTextureFormatTraits<TEX_FORMAT_RGBA32_FLOAT>();
+    CheckTextureFormatTraits<TEX_FORMAT_RGBA8_TYPELESS>();
+    CheckTextureFormatTraits<TEX_FORMAT_RGBA8_UNORM_SRGB>();
+    CheckTextureFormatTraits<TEX_FORMAT_D24_UNORM_S8_UINT>();
+    CheckTextureFormatTraits<TEX_FORMAT_R11G11B10_FLOAT>();
+    CheckTextureFormatTraits<TEX_FORMAT_BC1_UNORM>();
+    CheckTextureFormatTraits<TEX_FORMAT_BC7_UNORM_SRGB>();
+}
+
+TEST(GraphicsAccessories_TextureFormatTraits, FormatTable)
+{
+    for (Uint32 Fmt = TEX_FORMAT_UNKNOWN; Fmt < TEX_FORMAT_NUM_FORMATS; ++Fmt)
+    {
+        const auto& Attribs = GetTextureFormatAttribs(static_cast<TEXTURE_FORMAT>(Fmt));
+        EXPECT_EQ(Attribs.Format, static_cast<TEXTURE_FORMAT>(Fmt));
+        ASSERT_NE(Attribs.Name, nullptr);
+        EXPECT_EQ(strncmp(Attribs.Name, "TEX_FORMAT_", 11), 0) << Attribs.Name;
+        if (Fmt != TEX_FORMAT_UNKNOWN)
+        {
+            EXPECT_GT(Attribs.ComponentSize, 0) << Attribs.Name;
+            EXPECT_GT(Attribs.NumComponents, 0) << Attribs.Name;
+            EXPECT_GT(Attribs.BlockWidth, 0) << Attribs.Name;
+            EXPECT_GT(Attribs.BlockHeight, 0) << Attribs.Name;
+        }
+    }
+
+    // R16_TYPELESS is translated to D16 formats when depth-stencil binding is requested
+    EXPECT_EQ(GetDefaultTextureViewFormat(TEX_FORMAT_R16_TYPELESS, TEXTURE_VIEW_SHADER_RESOURCE, BIND_SHADER_RESOURCE), TEX_FORMAT_R16_FLOAT);
+    EXPECT_EQ(GetDefaultTextureViewFormat(TEX_FORMAT_R16_TYPELESS, TEXTURE_VIEW_SHADER_RESOURCE, BIND_DEPTH_STENCIL), TEX_FORMAT_R16_UNORM);
+    EXPECT_EQ(GetDefaultTextureViewFormat(TEX_FORMAT_R16_TYPELESS, TEXTURE_VIEW_DEPTH_STENCIL, BIND_DEPTH_STENCIL), TEX_FORMAT_D16_UNORM);
+}
+
+
+// Reproduces the previous implementation of GetTextureFormatAttribs(): an out-of-line
+// call that checks if the function-local table has been initialized.
+const TextureFormatAttribs& GetTextureFormatAttribsRuntime(TEXTURE_FORMAT Format)
+{
+    static TextureFormatAttribs FmtAttribs[TEX_FORMAT_NUM_FORMATS];
+    static bool                 bIsInit = false;
+    if (!bIsInit)
+    {
+        for (Uint32 Fmt = TEX_FORMAT_UNKNOWN; Fmt < TEX_FORMAT_NUM_FORMATS; ++Fmt)
+            FmtAttribs[Fmt] = GetTextureFormatAttribs(static_cast<TEXTURE_FORMAT>(Fmt));
+        bIsInit = true;
+    }
+    return Format < TEX_FORMAT_NUM_FORMATS ? FmtAttribs[Format] : FmtAttribs[0];
+}
+
+// Calls through the volatile pointer are never inlined, like calls into another translation unit
+const TextureFormatAttribs& (*volatile pGetTextureFormatAttribsRuntime)(TEXTURE_FORMAT) = GetTextureFormatAttribsRuntime;
+
+struct RuntimeAttribs
+{
+    const TextureFormatAttribs& operator()(TEXTURE_FORMAT Format) const
+    {
+        return pGetTextureFormatAttribsRuntime(Format);
+    }
+};
+
+struct TableAttribs
+{
+    const TextureFormatAttribs& operator()(TEXTURE_FORMAT Format) const
+    {
+        return GetTextureFormatAttribs(Format);
+    }
+};
+
+template <TEXTURE_FORMAT Format>
+struct TraitsAttribs
+{
+    const TextureFormatAttribs& operator()(TEXTURE_FORMAT) const
+    {
+        return TextureFormatTraits<Format>::GetAttribs();
+    }
+};
+
+// Same as GetMipLevelProperties()
+template <typename AttribsGetterType>
+MipLevelProperties ComputeMipLevelProperties(const TextureDesc& TexDesc, Uint32 MipLevel, AttribsGetterType GetAttribs)
+{
+    MipLevelProperties MipProps;
+    const auto&        FmtAttribs = GetAttribs(TexDesc.Format);
+
+    MipProps.LogicalWidth  = std::max(TexDesc.Width >> MipLevel, 1u);
+    MipProps.LogicalHeight = std::max(TexDesc.Height >> MipLevel, 1u);
+    MipProps.Depth         = (TexDesc.Type == RESOURCE_DIM_TEX_3D) ? std::max(TexDesc.Depth >> MipLevel, 1u) : 1u;
+    if (FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED)
+    {
+        MipProps.StorageWidth   = Align(MipProps.LogicalWidth, Uint32{FmtAttribs.BlockWidth});
+        MipProps.StorageHeight  = Align(MipProps.LogicalHeight, Uint32{FmtAttribs.BlockHeight});
+        MipProps.RowSize        = MipProps.StorageWidth / Uint32{FmtAttribs.BlockWidth} * Uint32{FmtAttribs.ComponentSize};
+        MipProps.DepthSliceSize = MipProps.StorageHeight / Uint32{FmtAttribs.BlockHeight} * MipProps.RowSize;
+    }
+    else
+    {
+        MipProps.StorageWidth   = MipProps.LogicalWidth;
+        MipProps.StorageHeight  = MipProps.LogicalHeight;
+        MipProps.RowSize        = MipProps.StorageWidth * Uint32{FmtAttribs.ComponentSize} * Uint32{FmtAttribs.NumComponents};
+        MipProps.DepthSliceSize = MipProps.RowSize * MipProps.StorageHeight;
+    }
+    MipProps.MipSize = MipProps.DepthSliceSize * MipProps.Depth;
+
+    return MipProps;
+}
+
+// Computes the size of the staging memory required to copy the region from a buffer
+// to a texture, similar to the Vulkan backend.
+template <typename AttribsGetterType>
+Uint32 ComputeBufferToTextureCopySize(TEXTURE_FORMAT Format, const Box& Region, Uint32 RowPitchAlignment, AttribsGetterType GetAttribs)
+{
+    const auto& FmtAttribs = GetAttribs(Format);
+
+    const auto RegionWidth  = Region.MaxX - Region.MinX;
+    const auto RegionHeight = Region.MaxY - Region.MinY;
+    const auto RegionDepth  = Region.MaxZ - Region.MinZ;
+
+    Uint32 RowSize  = 0;
+    Uint32 RowCount = 0;
+    if (FmtAttribs.ComponentType == COMPONENT_TYPE_COMPRESSED)
+    {
+        RowSize  = Align(RegionWidth, Uint32{FmtAttribs.BlockWidth}) / Uint32{FmtAttribs.BlockWidth} * Uint32{FmtAttribs.ComponentSize};
+        RowCount = Align(RegionHeight, Uint32{FmtAttribs.BlockHeight}) / Uint32{FmtAttribs.BlockHeight};
+    }
+    else
+    {
+        RowSize  = RegionWidth * Uint32{FmtAttribs.ComponentSize} * Uint32{FmtAttribs.NumComponents};
+        RowCount = RegionHeight;
+    }
+
+    const auto Stride = Align(RowSize, RowPitchAlignment);
+    return Stride * RowCount * RegionDepth;
+}
+
+#ifdef DILIGENT_DEBUG
+constexpr Uint32 NumBenchmarkIterations = 1 << 14;
+#else
+constexpr Uint32 NumBenchmarkIterations = 1 << 20;
+#endif
+
+template <typename AttribsGetterType>
+double BenchmarkMipLevelProperties(const std::vector<TextureDesc>& Descs, AttribsGetterType GetAttribs, Uint64& Checksum)
+{
+    Timer T;
+    for (Uint32 i = 0; i < NumBenchmarkIterations; ++i)
+    {
+        const auto& Desc = Descs[i % Descs.size()];
+        Checksum += ComputeMipLevelProperties(Desc, i % Desc.MipLevels, GetAttribs).MipSize;
+    }
+    return T.GetElapsedTime();
+}
+
+template <typename AttribsGetterType>
+double BenchmarkCopySize(TEXTURE_FORMAT Format, AttribsGetterType GetAttribs, Uint64& Checksum)
+{
+    Timer T;
+    for (Uint32 i = 0; i < NumBenchmarkIterations; ++i)
+    {
+        const Uint32 Size = 1 + (i & 1023);
+        Box          Region{0, Size, 0, Size};
+        Checksum += ComputeBufferToTextureCopySize(Format, Region, 256, GetAttribs);
+    }
+    return T.GetElapsedTime();
+}
+
+TEST(GraphicsAccessories_TextureFormatTraits, DISABLED_Benchmark)
+{
+    std::vector<TextureDesc> Descs;
+    for (auto Format : {TEX_FORMAT_RGBA8_UNORM, TEX_FORMAT_BC1_UNORM, TEX_FORMAT_RGBA16_FLOAT, TEX_FORMAT_BC7_UNORM_SRGB, TEX_FORMAT_R32_FLOAT, TEX_FORMAT_D24_UNORM_S8_UINT})
+    {
+        TextureDesc Desc;
+        Desc.Type      = RESOURCE_DIM_TEX_2D;
+        Desc.Width     = 1024;
+        Desc.Height    = 512;
+        Desc.MipLevels = 11;
+        Desc.Format    = Format;
+        Descs.emplace_back(Desc);
+
+        for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+        {
+            const auto RefProps = GetMipLevelProperties(Desc, Mip);
+            const auto MipProps = ComputeMipLevelProperties(Desc, Mip, TableAttribs{});
+            EXPECT_EQ(MipProps.RowSize, RefProps.RowSize);
+            EXPECT_EQ(MipProps.MipSize, RefProps.MipSize);
+        }
+    }
+
+    {
+        Uint64 RuntimeChecksum = 0;
+        Uint64 TableChecksum   = 0;
+
+        const auto RuntimeTime = BenchmarkMipLevelProperties(Descs, RuntimeAttribs{}, RuntimeChecksum);
+        const auto TableTime   = BenchmarkMipLevelProperties(Descs, TableAttribs{}, TableChecksum);
+        EXPECT_EQ(RuntimeChecksum, TableChecksum);
+
+        LOG_INFO_MESSAGE("Mip level properties: runtime-initialized table: ", RuntimeTime * 1e9 / NumBenchmarkIterations, " ns/call",
+                         ", constexpr table: ", TableTime * 1e9 / NumBenchmarkIterations, " ns/call");
+    }
+
+    {
+        Uint64 RuntimeChecksum = 0;
+        Uint64 TableChecksum   = 0;
+        Uint64 TraitsChecksum  = 0;
+
+        const auto RuntimeTime = BenchmarkCopySize(TEX_FORMAT_BC7_UNORM, RuntimeAttribs{}, RuntimeChecksum);
+        const auto TableTime   = BenchmarkCopySize(TEX_FORMAT_BC7_UNORM, TableAttribs{}, TableChecksum);
+        const auto TraitsTime  = BenchmarkCopySize(TEX_FORMAT_BC7_UNORM, TraitsAttribs<TEX_FORMAT_BC7_UNORM>{}, TraitsChecksum);
+        EXPECT_EQ(RuntimeChecksum, TableChecksum);
+        EXPECT_EQ(RuntimeChecksum, TraitsChecksum);
+
+        LOG_INFO_MESSAGE("Buffer-to-texture copy size: runtime-initialized table: ", RuntimeTime * 1e9 / NumBenchmarkIterations, " ns/call",
+                         ", constexpr table: ", TableTime * 1e9 / NumBenchmarkIterations, " ns/call",
+                         ", TextureFormatTraits: ", TraitsTime * 1e9 / NumBenchmarkIterations, " ns/call");
+    }
+}
+
+} // namespace
@@ -0,0 +1,497 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "PlatformDefinitions.h"
+#include "TextureMipGenerator.hpp"
+#include "GraphicsAccessories.hpp"
+#include "ColorConversion.h"
+#include "BasicMath.hpp"
+#include "FastRand.hpp"
+#include "Errors.hpp"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+// Level data of every slice and mip, ordered by slice, then by mip
+struct MipChain
+{
+    TextureDesc                     Desc;
+    std::vector<std::vector<Uint8>> Levels;
+
+    MipChain(const TextureDesc& _Desc) :
+        Desc{_Desc}
+    {
+        const Uint32 NumSlices = GetNumSlices();
+        for (Uint32 Slice = 0; Slice < NumSlices; ++Slice)
+        {
+            for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+                Levels.emplace_back(GetMipLevelProperties(Desc, Mip).MipSize);
+        }
+    }
+
+    Uint32 GetNumSlices() const
+    {
+        return Desc.Type == RESOURCE_DIM_TEX_3D ? 1 : Desc.ArraySize;
+    }
+
+    std::vector<Uint8>& GetLevel(Uint32 Slice, Uint32 Mip)
+    {
+        return Levels[Slice * Desc.MipLevels + Mip];
+    }
+
+    bool Generate(const MipGenerationAttribs& Attribs = MipGenerationAttribs{})
+    {
+        std::vector<TextureSubResData> SrcLevels;
+        std::vector<MipLevelData>      DstLevels;
+        for (Uint32 Slice = 0; Slice < GetNumSlices(); ++Slice)
+        {
+            for (Uint32 Mip = 0; Mip < Desc.MipLevels; ++Mip)
+            {
+                const auto MipProps = GetMipLevelProperties(Desc, Mip);
+                if (Mip == 0)
+                {
+                    SrcLevels.emplace_back(GetLevel(Slice, Mip).data(), MipProps.RowSize, MipProps.DepthSliceSize);
+                }
+                else
+                {
+                    MipLevelData DstLevel;
+                    DstLevel.pData       = GetLevel(Slice, Mip).data();
+                    DstLevel.Stride      = MipProps.RowSize;
+                    DstLevel.DepthStride = MipProps.DepthSliceSize;
+                    DstLevels.push_back(DstLevel);
+                }
+            }
+        }
+        return GenerateMipLevels(Desc, SrcLevels.data(), DstLevels.data(), Attribs);
+    }
+
+    template <typename T>
+    const T* GetData(Uint32 Slice, Uint32 Mip)
+    {
+        return reinterpret_cast<const T*>(GetLevel(Slice, Mip).data());
+    }
+
+    template <typename T>
+    T* GetLevel0(Uint32 Slice = 0)
+    {
+        return reinterpret_cast<T*>(GetLevel(Slice, 0).data());
+    }
+};
+
+TextureDesc MakeTexDesc(RESOURCE_DIMENSION Type, TEXTURE_FORMAT Format, Uint32 Width, Uint32 Height, Uint32 ArraySizeOrDepth = 1)
+{
+    TextureDesc Desc;
+    Desc.Type      = Type;
+    Desc.Format    = Format;
+    Desc.Width     = Width;
+    Desc.Height    = Height;
+    Desc.ArraySize = ArraySizeOrDepth;
+    Desc.MipLevels = Type == RESOURCE_DIM_TEX_3D ?
+        ComputeMipLevelsCount(Width, Height, ArraySizeOrDepth) :
+        ComputeMipLevelsCount(Width, Height);
+    return Desc;
+}
+
+TEST(GraphicsAccessories_TextureMipGenerator, BoxFilter)
+{
+    MipChain Chain{MakeTexDesc(RESOURCE_DIM_TEX_2D, TEX_FORMAT_RGBA8_UNORM, 4, 2)};
+    ASSERT_EQ(Chain.Desc.MipLevels, 3u);
+
+    auto* pLevel0 = Chain.GetLevel0<Uint8>();
+    for (Uint32 i = 0; i < 4 * 2 * 4; ++i)
+        pLevel0[i] = static_cast<Uint8>(i * 8);
+    ASSERT_TRUE(Chain.Generate());
+
+    // Every texel is the average of the 2x2 quad
+    const auto* pLevel1 = Chain.GetData<Uint8>(0, 1);
+    for (Uint32 x = 0; x < 2; ++x)
+    {
+        for (Uint32 c = 0; c < 4; ++c)
+        {
+            const float Avg = (pLevel0[(x * 2) * 4 + c] + pLevel0[(x * 2 + 1) * 4 + c] + pLevel0[(4 + x * 2) * 4 + c] + pLevel0[(4 + x * 2 + 1) * 4 + c]) / 4.f;
+            EXPECT_EQ(pLevel1[x * 4 + c], static_cast<Uint8>(Avg + 0.5f));
+        }
+    }
+
+    const auto* pLevel2 = Chain.GetData<Uint8>(0, 2);
+    for (Uint32 c = 0; c < 4; ++c)
+        EXPECT_EQ(pLevel2[c], static_cast<Uint8>((pLevel1[c] + pLevel1[4 + c]) / 2.f + 0.5f));
+}
+
+TEST(GraphicsAccessories_TextureMipGenerator, NonPowerOfTwo)
+{
+    MipChain Chain{MakeTexDesc(RESOURCE_DIM_TEX_2D, TEX_FORMAT_R32_FLOAT, 5, 3)};
+    ASSERT_EQ(Chain.Desc.MipLevels, 3u);
+
+    auto* pLevel0 = Chain.GetLevel0<float>();
+    for (Uint32 y = 0; y < 3; ++y)
+    {
+        for (Uint32 x = 0; x < 5; ++x)
+            pLevel0[y * 5 + x] = static_cast<float>(x);
+    }
+    ASSERT_TRUE(Chain.Generate());
+
+    // Level 1 is 2x1, and every texel covers 2.5x3 texels of level 0
+    const auto* pLevel1 = Chain.GetData<float>(0, 1);
+    EXPECT_FLOAT_EQ(pLevel1[0], (0.f + 1.f + 2.f * 0.5f) / 2.5f);
+    EXPECT_FLOAT_EQ(pLevel1[1], (2.f * 0.5f + 3.f + 4.f) / 2.5f);
+
+    // The average value is preserved
+    EXPECT_FLOAT_EQ(*Chain.GetData<float>(0, 2), 2.f);
+}
+
+TEST(GraphicsAccessories_TextureMipGenerator, SRGB)
+{
+    // Black and white checkerboard with alpha 0 and 1
+    const Uint8 Texels[] = {0, 0, 0, 0, 255, 255, 255, 255, 255, 255, 255, 255, 0, 0, 0, 0};
+
+    MipChain SRGBChain{MakeTexDesc(RESOURCE_DIM_TEX_2D, TEX_FORMAT_RGBA8_UNORM_SRGB, 2, 2)};
+    memcpy(SRGBChain.GetLevel0<Uint8>(), Texels, sizeof(Texels));
+    ASSERT_TRUE(SRGBChain.Generate());
+
+    MipChain UNormChain{MakeTexDesc(RESOURCE_DIM_TEX_2D, TEX_FORMAT_RGBA8_UNORM, 2, 2)};
+    memcpy(UNormChain.GetLevel0<Uint8>(), Texels, sizeof(Texels));
+    ASSERT_TRUE(UNormChain.Generate());
+
+    // sRGB color is averaged in linear space, alpha is always linear
+    const auto* pSRGB = SRGBChain.GetData<Uint8>(0, 1);
+    const auto  Gray  = static_cast<Uint8>(LinearToSRGB(0.5f) * 255.f + 0.5f);
+    EXPECT_EQ(pSRGB[0], Gray);
+    EXPECT_EQ(pSRGB[1], Gray);
+    EXPECT_EQ(pSRGB[2], Gray);
+    EXPECT_EQ(pSRGB[3], 128);
+
+    const auto* pUNorm = UNormChain.GetData<Uint8>(0, 1);
+    for (Uint32 c = 0; c < 4; ++c)
+        EXPECT_EQ(pUNorm[c], 128);
+}
+
+// Returns the amplitude of the sine wave with the period of 8 texels after the first mip reduction.
+// Texel centers of the reduced level are at odd multiples of pi/4.
+float GetSineAmplitudeAfterReduction(MIP_FILTER_TYPE Filter)
+{
+    constexpr Uint32 Width = 64;
+
+    MipChain Chain{MakeTexDesc(RESOURCE_DIM_TEX_1D, TEX_FORMAT_R32_FLOAT, Width, 1)};
+
+    auto* pLevel0 = Chain.GetLevel0<float>();
+    for (Uint32 x = 0; x < Width; ++x)
+        pLevel0[x] = std::sin((x + 0.5f) * PI_F / 4.f);
+
+    MipGenerationAttribs Attribs;
+    Attribs.Filter      = Filter;
+    Attribs.AddressMode = TEXTURE_ADDRESS_WRAP;
+    EXPECT_TRUE(Chain.Generate(Attribs));
+
+    const auto* pLevel1   = Chain.GetData<float>(0, 1);
+    float       Amplitude = 0;
+    for (Uint32 x = 0; x < Width / 2; ++x)
+        Amplitude = std::max(Amplitude, std::abs(pLevel1[x]));
+    return Amplitude / std::sin(PI_F / 4.f);
+}
+
+TEST(GraphicsAccessories_TextureMipGenerator, KaiserFilter)
+{
+    // Constant texture remains constant with every addressing mode
+    for (auto AddressMode : {TEXTURE_ADDRESS_WRAP, TEXTURE_ADDRESS_MIRROR, TEXTURE_ADDRESS_CLAMP})
+    {
+        MipChain Chain{MakeTexDesc(RESOURCE_DIM_TEX_2D, TEX_FORMAT_RGBA32_FLOAT, 16, 8)};
+
+        auto* pLevel0 = Chain.GetLevel0<float>();
+        for (Uint32 i = 0; i < 16 * 8; ++i)
+        {
+            for (Uint32 c = 0; c < 4; ++c)
+                pLevel0[i * 4 + c] = 0.25f * c;
+        }
+
+        MipGenerationAttribs Attribs;
+        Attribs.Filter      = MIP_FILTER_TYPE_KAISER;
+        Attribs.AddressMode = AddressMode;
+        ASSERT_TRUE(Chain.Generate(Attribs));
+
+        for (Uint32 Mip = 1; Mip < Chain.Desc.MipLevels; ++Mip)
+        {
+            const auto  MipProps = GetMipLevelProperties(Chain.Desc, Mip);
+            const auto* pData    = Chain.GetData<float>(0, Mip);
+            for (Uint32 i = 0; i < MipProps.LogicalWidth * MipProps.LogicalHeight; ++i)
+            {
+                for (Uint32 c = 0; c < 4; ++c)
+                    EXPECT_NEAR(pData[i * 4 + c], 0.25f * c, 1e-5f) << "Mip " << Mip << ", address mode " << AddressMode;
+            }
+        }
+    }
+
+    // Box filter attenuates the frequency that is still representable in the coarser level by cos(pi/8),
+    // while Kaiser filter preserves it
+    const float BoxAmplitude    = GetSineAmplitudeAfterReduction(MIP_FILTER_TYPE_BOX);
+    const float KaiserAmplitude = GetSineAmplitudeAfterReduction(MIP_FILTER_TYPE_KAISER);
+    EXPECT_NEAR(BoxAmplitude, std::cos(PI_F / 8.f), 1e-3f);
+    EXPECT_GT(KaiserAmplitude, 0.97f);
+    EXPECT_LT(KaiserAmplitude, 1.01f);
+}
+
+TEST(GraphicsAccessories_TextureMipGenerator, ArraysAnd3D)
+{
+    {
+        MipChain Chain{MakeTexDesc(RESOURCE_DIM_TEX_2D_ARRAY, TEX_FORMAT_RG16_UNORM, 8, 4, 3)};
+        for (Uint32 Slice = 0; Slice < 3; ++Slice)
+        {
+            auto* pLevel0 = Chain.GetLevel0<Uint16>(Slice);
+            for (Uint32 i = 0; i < 8 * 4 * 2; ++i)
+                pLevel0[i] = static_cast<Uint16>(Slice * 1000 + (i & 1));
+        }
+        ASSERT_TRUE(Chain.Generate());
+
+        for (Uint32 Slice = 0; Slice < 3; ++Slice)
+        {
+            for (Uint32 Mip = 1; Mip < Chain.Desc.MipLevels; ++Mip)
+            {
+                const auto  MipProps = GetMipLevelProperties(Chain.Desc, Mip);
+                const auto* pData    = Chain.GetData<Uint16>(Slice, Mip);
+                for (Uint32 i = 0; i < MipProps.LogicalWidth * MipProps.LogicalHeight * 2; ++i)
+                    EXPECT_EQ(pData[i], Slice * 1000 + (i & 1));
+            }
+        }
+    }
+
+    {
+        MipChain Chain{MakeTexDesc(RESOURCE_DIM_TEX_3D, TEX_FORMAT_R16_FLOAT, 4, 2, 8)};
+        ASSERT_EQ(Chain.Desc.MipLevels, 4u);
+
+        auto* pLevel0 = Chain.GetLevel0<Uint16>();
+        for (Uint32 z = 0; z < 8; ++z)
+        {
+            for (Uint32 i = 0; i < 4 * 2; ++i)
+                pLevel0[z * 8 + i] = FloatToHalf(static_cast<float>(z));
+        }
+        ASSERT_TRUE(Chain.Generate());
+
+        // Depth slices are averaged as well
+        for (Uint32 Mip = 1; Mip < Chain.Desc.MipLevels; ++Mip)
+        {
+            const auto  MipProps = GetMipLevelProperties(Chain.Desc, Mip);
+            const auto* pData    = Chain.GetData<Uint16>(0, Mip);
+            const float Scale    = static_cast<float>(1u << Mip);
+            for (Uint32 z = 0; z < MipProps.Depth; ++z)
+            {
+                const float Expected = (z + 0.5f) * Scale - 0.5f;
+                for (Uint32 i = 0; i < MipProps.LogicalWidth * MipProps.LogicalHeight; ++i)
+                    EXPECT_EQ(HalfToFloat(pData[z * MipProps.LogicalWidth * MipProps.LogicalHeight + i]), Expected);
+            }
+        }
+    }
+}
+
+TEST(GraphicsAccessories_TextureMipGenerator, AllFormats)
+{
+    // Every texel is filled with the repeated pattern that is chosen so that it is exactly
+    // preserved by decoding and encoding in every supported format
+    const Uint8 Pattern[] = {0x40, 0x41, 0x42, 0x03};
+
+    Uint32 NumSupportedFormats = 0;
+    for (Uint32 Fmt = TEX_FORMAT_UNKNOWN + 1; Fmt < TEX_FORMAT_NUM_FORMATS; ++Fmt)
+    {
+        const auto  Format     = static_cast<TEXTURE_FORMAT>(Fmt);
+        const auto& FmtAttribs = GetTextureFormatAttribs(Format);
+
+        const bool ExpectSupported =
+            !FmtAttribs.IsTypeless &&
+            FmtAttribs.ComponentType != COMPONENT_TYPE_COMPRESSED &&
+            FmtAttribs.ComponentType != COMPONENT_TYPE_DEPTH_STENCIL &&
+            Format != TEX_FORMAT_R1_UNORM &&
+            Format != TEX_FORMAT_RG8_B8G8_UNORM &&
+            Format != TEX_FORMAT_G8R8_G8B8_UNORM;
+        EXPECT_EQ(IsMipGenerationSupported(Format), ExpectSupported) << FmtAttribs.Name;
+        if (!ExpectSupported)
+            continue;
+
+        ++NumSupportedFormats;
+
+        MipChain Chain{MakeTexDesc(RESOURCE_DIM_TEX_2D, Format, 4, 4)};
+
+        const size_t ElementSize = FmtAttribs.GetElementSize();
+
+        auto& Level0 = Chain.GetLevel(0, 0);
+        for (size_t i = 0; i < Level0.size(); ++i)
+            Level0[i] = Pattern[i % ElementSize % _countof(Pattern)];
+        ASSERT_TRUE(Chain.Generate()) << FmtAttribs.Name;
+
+        for (Uint32 Mip = 1; Mip < Chain.Desc.MipLevels; ++Mip)
+        {
+            const auto& Level = Chain.GetLevel(0, Mip);
+            for (size_t i = 0; i < Level.size(); ++i)
+                ASSERT_EQ(Level[i], Pattern[i % ElementSize % _countof(Pattern)]) << FmtAttribs.Name << ", mip " << Mip << ", byte " << i;
+        }
+    }
+    EXPECT_GT(NumSupportedFormats, 50u);
+
+    MipChain Chain{MakeTexDesc(RESOURCE_DIM_TEX_2D, TEX_FORMAT_BC1_UNORM, 8, 8)};
+    EXPECT_FALSE(Chain.Generate());
+}
+
+float ComputeAlphaCoverage(const Uint8* pRGBA, size_t NumTexels, Uint8 Cutoff)
+{
+    size_t NumAbove = 0;
+    for (size_t i = 0; i < NumTexels; ++i)
+    {
+        if (pRGBA[i * 4 + 3] > Cutoff)
+            ++NumAbove;
+    }
+    return static_cast<float>(NumAbove) / static_cast<float>(NumTexels);
+}
+
+TEST(GraphicsAccessories_TextureMipGenerator, AlphaCoverage)
+{
+    constexpr Uint32 Size = 256;
+
+    // Noisy alpha with the mean below the cutoff: box filtering reduces the variance, so that
+    // without the correction fewer and fewer texels pass the alpha test in coarser levels
+    std::vector<Uint8> Level0(Size * Size * 4);
+    FastRand           Rnd{0};
+    for (Uint32 i = 0; i < Size * Size; ++i)
+    {
+        Level0[i * 4 + 0] = 64;
+        Level0[i * 4 + 1] = 128;
+        Level0[i * 4 + 2] = 32;
+        Level0[i * 4 + 3] = static_cast<Uint8>(Rnd() % 201);
+    }
+    const float Coverage0 = ComputeAlphaCoverage(Level0.data(), Size * Size, 127);
+
+    for (bool PreserveCoverage : {false, true})
+    {
+        MipChain Chain{MakeTexDesc(RESOURCE_DIM_TEX_2D, TEX_FORMAT_RGBA8_UNORM_SRGB, Size, Size)};
+        Chain.GetLevel(0, 0) = Level0;
+
+        MipGenerationAttribs Attribs;
+        Attribs.AlphaCutoff = PreserveCoverage ? 0.5f : 0.f;
+        Attribs.NumThreads  = 2;
+        ASSERT_TRUE(Chain.Generate(Attribs));
+
+        // Levels down to 8x8
+        for (Uint32 Mip = 1; Mip <= 5; ++Mip)
+        {
+            const auto  MipProps = GetMipLevelProperties(Chain.Desc, Mip);
+            const float Coverage = ComputeAlphaCoverage(Chain.GetData<Uint8>(0, Mip), MipProps.LogicalWidth * MipProps.LogicalHeight, 127);
+            // Alpha values of coarse levels are concentrated around the mean and only take
+            // a few distinct 8-bit values, so the coverage can only be matched approximately
+            if (PreserveCoverage)
+                EXPECT_NEAR(Coverage, Coverage0, Mip <= 3 ? 0.03f : 0.06f) << "Mip " << Mip;
+            else if (Mip >= 3)
+                EXPECT_LT(Coverage, Coverage0 * 0.5f) << "Mip " << Mip;
+
+            // Color is not affected
+            EXPECT_EQ(Chain.GetData<Uint8>(0, Mip)[1], 128);
+        }
+    }
+}
+
+TEST(GraphicsAccessories_TextureMipGenerator, MultiThreaded)
+{
+    for (auto Filter : {MIP_FILTER_TYPE_BOX, MIP_FILTER_TYPE_KAISER})
+    {
+        MipChain Chain1{MakeTexDesc(RESOURCE_DIM_TEX_CUBE, TEX_FORMAT_RGBA16_FLOAT, 160, 160, 6)};
+        MipChain Chain4{Chain1.Desc};
+
+        FastRandReal<float> Rnd{0, 0, 4};
+        for (Uint32 Slice = 0; Slice < 6; ++Slice)
+        {
+            auto& Level0 = Chain1.GetLevel(Slice, 0);
+            for (size_t i = 0; i < Level0.size() / 2; ++i)
+                reinterpret_cast<Uint16*>(Level0.data())[i] = FloatToHalf(Rnd());
+            Chain4.GetLevel(Slice, 0) = Level0;
+        }
+
+        MipGenerationAttribs Attribs;
+        Attribs.Filter      = Filter;
+        Attribs.AlphaCutoff = 0.5f;
+        ASSERT_TRUE(Chain1.Generate(Attribs));
+        Attribs.NumThreads = 4;
+        ASSERT_TRUE(Chain4.Generate(Attribs));
+
+        EXPECT_EQ(Chain1.Levels, Chain4.Levels);
+    }
+}
+
+template <typename OpType>
+double MeasureTime(int NumIterations, OpType Op)
+{
+    const auto StartTime = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < NumIterations; ++i)
+        Op();
+    return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - StartTime).count() / NumIterations;
+}
+
+TEST(GraphicsAccessories_TextureMipGenerator, DISABLED_Performance)
+{
+#ifdef DILIGENT_DEBUG
+    const Uint32 Sizes[] = {512, 1024};
+#else
+    const Uint32 Sizes[] = {4096, 8192};
+#endif
+    const Uint32 NumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    for (auto Size : Sizes)
+    {
+        MipChain Chain{MakeTexDesc(RESOURCE_DIM_TEX_2D, TEX_FORMAT_RGBA8_UNORM_SRGB, Size, Size)};
+
+        auto& Level0 = Chain.GetLevel(0, 0);
+        for (size_t i = 0; i < Level0.size(); ++i)
+            Level0[i] = static_cast<Uint8>(i * 31 + i / 7);
+
+        auto Measure = [&](const char* Name, const MipGenerationAttribs& Attribs) {
+            const double Time = MeasureTime(1, [&]() { Chain.Generate(Attribs); });
+            LOG_INFO_MESSAGE(Size, "x", Size, " RGBA8 sRGB, ", Name, ", ", Attribs.NumThreads, " thread(s): ", Time * 1000, " ms (",
+                             static_cast<double>(Size) * Size / Time * 1e-6, " Mpix/s)");
+        };
+
+        MipGenerationAttribs Attribs;
+        Measure("box   ", Attribs);
+        Attribs.Filter = MIP_FILTER_TYPE_KAISER;
+        Measure("Kaiser", Attribs);
+        if (NumThreads > 1)
+        {
+            Attribs.NumThreads = NumThreads;
+            Attribs.Filter     = MIP_FILTER_TYPE_BOX;
+            Measure("box   ", Attribs);
+            Attribs.Filter = MIP_FILTER_TYPE_KAISER;
+            Measure("Kaiser", Attribs);
+        }
+    }
+}
+
+} // namespace
@@ -25,9 +25,14 @@
  *  of the possibility of such damages.
  */
 
+#include <vector>
+#include <algorithm>
+
 #include "VariableSizeGPUAllocationsManager.hpp"
 #include "DefaultRawMemoryAllocator.hpp"
 #include "PlatformDefinitions.h"
+#include "FastRand.hpp"
+#include "Timer.hpp"
 
 #include "gtest/gtest.h"
 
@@ -242,4 +247,537 @@ TEST(GraphicsAccessories_VariableSizeGPUAllocationsManager, Free)
     }
 }
 
+TEST(GraphicsAccessories_VariableSizeGPUAllocationsManager, TLSFAllocateFree)
+{
+    auto& Allocator  = DefaultRawMemoryAllocator::GetAllocator();
+    using OffsetType = VariableSizeAllocationsManager::OffsetType;
+
+    VariableSizeAllocationsManager ListMgr(128, Allocator, VariableSizeAllocationsManager::STRATEGY_TLSF);
+    EXPECT_EQ(ListMgr.GetNumFreeBlocks(), size_t{1});
+
+    auto a1 = ListMgr.Allocate(17, 4);
+    EXPECT_EQ(a1.UnalignedOffset, OffsetType{0});
+    EXPECT_EQ(a1.Size, OffsetType{20});
+
+    auto a2 = ListMgr.Allocate(17, 8);
+    EXPECT_TRUE(a2.IsValid());
+    EXPECT_EQ(Align(a2.UnalignedOffset, OffsetType{8}) + 24, a2.UnalignedOffset + a2.Size);
+
+    auto a3 = ListMgr.Allocate(128, 1);
+    EXPECT_FALSE(a3.IsValid());
+
+    ListMgr.Free(std::move(a1));
+    EXPECT_EQ(ListMgr.GetNumFreeBlocks(), size_t{2});
+
+    ListMgr.Free(std::move(a2));
+    EXPECT_EQ(ListMgr.GetNumFreeBlocks(), size_t{1});
+    EXPECT_TRUE(ListMgr.IsEmpty());
+
+    a3 = ListMgr.Allocate(128, 1);
+    EXPECT_EQ(a3.UnalignedOffset, OffsetType{0});
+    EXPECT_EQ(a3.Size, OffsetType{128});
+    EXPECT_TRUE(ListMgr.IsFull());
+    EXPECT_EQ(ListMgr.GetNumFreeBlocks(), size_t{0});
+
+    ListMgr.Extend(64);
+    EXPECT_EQ(ListMgr.GetNumFreeBlocks(), size_t{1});
+    auto a4 = ListMgr.Allocate(64, 1);
+    EXPECT_EQ(a4.UnalignedOffset, OffsetType{128});
+    EXPECT_TRUE(ListMgr.IsFull());
+
+    ListMgr.Free(std::move(a3));
+    ListMgr.Extend(32);
+    EXPECT_EQ(ListMgr.GetNumFreeBlocks(), size_t{2});
+    ListMgr.Free(std::move(a4));
+    EXPECT_EQ(ListMgr.GetNumFreeBlocks(), size_t{1});
+    EXPECT_TRUE(ListMgr.IsEmpty());
+    EXPECT_EQ(ListMgr.GetMaxSize(), OffsetType{224});
+}
+
+TEST(GraphicsAccessories_VariableSizeGPUAllocationsManager, TLSFFreeOrder)
+{
+    auto& Allocator  = DefaultRawMemoryAllocator::GetAllocator();
+    using OffsetType = VariableSizeAllocationsManager::OffsetType;
+
+    const auto NumAllocs = 6;
+    size_t     ReleaseOrder[NumAllocs];
+    for (size_t a = 0; a < NumAllocs; ++a)
+        ReleaseOrder[a] = a;
+    do
+    {
+        VariableSizeAllocationsManager ListMgr(NumAllocs * 4, Allocator, VariableSizeAllocationsManager::STRATEGY_TLSF);
+
+        VariableSizeAllocationsManager::Allocation allocs[NumAllocs];
+        for (size_t a = 0; a < NumAllocs; ++a)
+        {
+            allocs[a] = ListMgr.Allocate(4, 1);
+            EXPECT_EQ(allocs[a].UnalignedOffset, a * 4);
+            EXPECT_EQ(allocs[a].Size, OffsetType{4});
+        }
+        EXPECT_TRUE(ListMgr.IsFull());
+        for (size_t a = 0; a < NumAllocs; ++a)
+        {
+            ListMgr.Free(std::move(allocs[ReleaseOrder[a]]));
+        }
+        EXPECT_EQ(ListMgr.GetNumFreeBlocks(), size_t{1});
+    } while (std::next_permutation(std::begin(ReleaseOrder), std::end(ReleaseOrder)));
+}
+
+TEST(GraphicsAccessories_VariableSizeGPUAllocationsManager, TLSFRandomAllocations)
+{
+    auto& Allocator  = DefaultRawMemoryAllocator::GetAllocator();
+    using OffsetType = VariableSizeAllocationsManager::OffsetType;
+    using Allocation = VariableSizeAllocationsManager::Allocation;
+
+    constexpr OffsetType MaxSize = 1 << 16;
+
+    VariableSizeAllocationsManager ListMgr(MaxSize, Allocator, VariableSizeAllocationsManager::STRATEGY_TLSF);
+
+    FastRandInt SizeRnd{0, 1, 1024};
+    FastRandInt AlignRnd{1, 0, 6};
+    FastRandInt ActionRnd{2, 0, 2};
+
+    struct TestAllocation
+    {
+        Allocation Alloc;
+        OffsetType Size;
+        OffsetType Alignment;
+    };
+    std::vector<TestAllocation> Allocations;
+    for (int i = 0; i < 10000; ++i)
+    {
+        if (ActionRnd() > 0 || Allocations.empty())
+        {
+            const auto Size      = static_cast<OffsetType>(SizeRnd());
+            const auto Alignment = OffsetType{1} << AlignRnd();
+
+            auto Alloc = ListMgr.Allocate(Size, Alignment);
+            if (!Alloc.IsValid())
+                continue;
+
+            EXPECT_GE(Alloc.UnalignedOffset + Alloc.Size, Align(Alloc.UnalignedOffset, Alignment) + Size);
+            EXPECT_LE(Alloc.UnalignedOffset + Alloc.Size, MaxSize);
+            Allocations.push_back({Alloc, Size, Alignment});
+        }
+        else
+        {
+            auto Idx = static_cast<size_t>(SizeRnd()) % Allocations.size();
+            ListMgr.Free(std::move(Allocations[Idx].Alloc));
+            Allocations[Idx] = Allocations.back();
+            Allocations.pop_back();
+        }
+    }
+
+    std::sort(Allocations.begin(), Allocations.end(),
+              [](const TestAllocation& lhs, const TestAllocation& rhs) {
+                  return lhs.Alloc.UnalignedOffset < rhs.Alloc.UnalignedOffset;
+              });
+    OffsetType UsedSize = 0;
+    for (size_t i = 0; i < Allocations.size(); ++i)
+    {
+        if (i > 0)
+        {
+            const auto& Prev = Allocations[i - 1].Alloc;
+            EXPECT_LE(Prev.UnalignedOffset + Prev.Size, Allocations[i].Alloc.UnalignedOffset) << "Overlapping allocations";
+        }
+        UsedSize += Allocations[i].Alloc.Size;
+    }
+    EXPECT_EQ(UsedSize, ListMgr.GetUsedSize());
+
+    for (auto& Alloc : Allocations)
+        ListMgr.Free(std::move(Alloc.Alloc));
+    EXPECT_TRUE(ListMgr.IsEmpty());
+    EXPECT_EQ(ListMgr.GetNumFreeBlocks(), size_t{1});
+}
+
+TEST(GraphicsAccessories_VariableSizeGPUAllocationsManager, FreeBlockStatistics)
+{
+    auto& Allocator = DefaultRawMemoryAllocator::GetAllocator();
+
+    using OffsetType = VariableSizeAllocationsManager::OffsetType;
+
+    const VariableSizeAllocationsManager::STRATEGY Strategies[] =
+        {
+            VariableSizeAllocationsManager::STRATEGY_ORDERED_MAPS,
+            VariableSizeAllocationsManager::STRATEGY_TLSF //
+        };
+    for (auto Strategy : Strategies)
+    {
+        VariableSizeGPUAllocationsManager GPUMgr{1024, Allocator, Strategy};
+
+        auto Stats = GPUMgr.GetFreeBlockStatistics();
+        EXPECT_EQ(Stats.TotalFreeSize, OffsetType{1024});
+        EXPECT_EQ(Stats.LargestFreeBlockSize, OffsetType{1024});
+        EXPECT_EQ(Stats.NumFreeBlocks, size_t{1});
+        EXPECT_EQ(Stats.SizeHistogram[10], size_t{1});
+        EXPECT_EQ(Stats.GetFragmentation(), 0.0);
+
+        VariableSizeAllocationsManager::Allocation Allocs[8];
+        for (auto& Alloc : Allocs)
+        {
+            Alloc = GPUMgr.Allocate(128, 1);
+            EXPECT_TRUE(Alloc.IsValid());
+        }
+
+        Stats = GPUMgr.GetFreeBlockStatistics();
+        EXPECT_EQ(Stats.TotalFreeSize, OffsetType{0});
+        EXPECT_EQ(Stats.LargestFreeBlockSize, OffsetType{0});
+        EXPECT_EQ(Stats.NumFreeBlocks, size_t{0});
+        EXPECT_EQ(Stats.GetFragmentation(), 0.0);
+
+        // |  0  |  1  |  2  |  3  |  4  |  5  |  6  |  7  |
+        // |     |xxxxx|     |xxxxx xxxxx|     |xxxxx|     |
+        GPUMgr.Free(std::move(Allocs[1]), 1);
+        GPUMgr.Free(std::move(Allocs[3]), 1);
+        GPUMgr.Free(std::move(Allocs[4]), 1);
+        GPUMgr.Free(std::move(Allocs[6]), 2);
+
+        // Stale allocations are not free yet
+        EXPECT_EQ(GPUMgr.GetFreeBlockStatistics().NumFreeBlocks, size_t{0});
+
+        GPUMgr.ReleaseStaleAllocations(2);
+        Stats = GPUMgr.GetFreeBlockStatistics();
+        EXPECT_EQ(Stats.TotalFreeSize, OffsetType{512});
+        EXPECT_EQ(Stats.LargestFreeBlockSize, OffsetType{256});
+        EXPECT_EQ(Stats.NumFreeBlocks, size_t{3});
+        EXPECT_EQ(Stats.SizeHistogram[7], size_t{2});
+        EXPECT_EQ(Stats.SizeHistogram[8], size_t{1});
+        EXPECT_EQ(Stats.GetFragmentation(), 0.5);
+
+        auto TotalStats = Stats;
+        TotalStats += VariableSizeAllocationsManager::FreeBlockStatistics{};
+        TotalStats += Stats;
+        EXPECT_EQ(TotalStats.TotalFreeSize, OffsetType{1024});
+        EXPECT_EQ(TotalStats.LargestFreeBlockSize, OffsetType{256});
+        EXPECT_EQ(TotalStats.NumFreeBlocks, size_t{6});
+        EXPECT_EQ(TotalStats.SizeHistogram[7], size_t{4});
+        EXPECT_EQ(TotalStats.SizeHistogram[8], size_t{2});
+        EXPECT_EQ(TotalStats.GetFragmentation(), 0.75);
+
+        for (auto& Alloc : Allocs)
+        {
+            if (Alloc.IsValid())
+                GPUMgr.Free(std::move(Alloc), 3);
+        }
+        GPUMgr.ReleaseStaleAllocations(3);
+
+        Stats = GPUMgr.GetFreeBlockStatistics();
+        EXPECT_EQ(Stats.TotalFreeSize, OffsetType{1024});
+        EXPECT_EQ(Stats.LargestFreeBlockSize, OffsetType{1024});
+        EXPECT_EQ(Stats.NumFreeBlocks, size_t{1});
+        EXPECT_EQ(Stats.GetFragmentation(), 0.0);
+    }
+}
+
+TEST(GraphicsAccessories_VariableSizeGPUAllocationsManager, Defragmentation)
+{
+    auto& Allocator = DefaultRawMemoryAllocator::GetAllocator();
+
+    using OffsetType = VariableSizeAllocationsManager::OffsetType;
+    using Allocation = VariableSizeAllocationsManager::Allocation;
+
+    const VariableSizeAllocationsManager::STRATEGY Strategies[] =
+        {
+            VariableSizeAllocationsManager::STRATEGY_ORDERED_MAPS,
+            VariableSizeAllocationsManager::STRATEGY_TLSF //
+        };
+    for (auto Strategy : Strategies)
+    {
+        for (OffsetType MoveBudget : {OffsetType{1024}, OffsetType{128}})
+        {
+            VariableSizeAllocationsManager Mgr{1024, Allocator, Strategy};
+
+            Allocation Allocs[8];
+            for (auto& Alloc : Allocs)
+                Alloc = Mgr.Allocate(128, 1);
+
+            // |  0  |  1  |  2  |  3  |  4  |  5  |  6  |  7  |
+            // |xxxxx|     |xxxxx|     |xxxxx|     |xxxxx|xxxxx|
+            Mgr.Free(std::move(Allocs[1]));
+            Mgr.Free(std::move(Allocs[3]));
+            Mgr.Free(std::move(Allocs[5]));
+
+            std::vector<Allocation> LiveAllocs;
+            for (const auto& Alloc : Allocs)
+            {
+                if (Alloc.IsValid())
+                    LiveAllocs.push_back(Alloc);
+            }
+
+            auto Moves = Mgr.PlanDefragmentation(LiveAllocs.data(), LiveAllocs.size(), 1, MoveBudget);
+            if (MoveBudget == 128)
+            {
+                ASSERT_EQ(Moves.size(), size_t{1});
+            }
+            else
+            {
+                // Allocation 4 can't move down without overlapping itself
+                ASSERT_EQ(Moves.size(), size_t{2});
+                EXPECT_EQ(Moves[1].SrcOffset, OffsetType{768});
+                EXPECT_EQ(Moves[1].DstOffset, OffsetType{384});
+            }
+            EXPECT_EQ(Moves[0].SrcOffset, OffsetType{896});
+            EXPECT_EQ(Moves[0].DstOffset, OffsetType{128});
+            EXPECT_EQ(Moves[0].Size, OffsetType{128});
+
+            Mgr.CommitDefragmentation(Moves.data(), Moves.size());
+            EXPECT_EQ(Mgr.GetFreeSize(), OffsetType{384});
+
+            auto Stats = Mgr.GetFreeBlockStatistics();
+            if (MoveBudget == 128)
+            {
+                // |  0  |  1  |  2  |  3  |  4  |  5  |  6  |  7  |
+                // |xxxxx|xxxxx|xxxxx|     |xxxxx|     |xxxxx|     |
+                EXPECT_EQ(Stats.NumFreeBlocks, size_t{3});
+                EXPECT_EQ(Stats.LargestFreeBlockSize, OffsetType{128});
+            }
+            else
+            {
+                // |  0  |  1  |  2  |  3  |  4  |  5  |  6  |  7  |
+                // |xxxxx|xxxxx|xxxxx|xxxxx|xxxxx|     |     |     |
+                EXPECT_EQ(Stats.NumFreeBlocks, size_t{1});
+                EXPECT_EQ(Stats.LargestFreeBlockSize, OffsetType{384});
+            }
+
+            for (auto& Alloc : LiveAllocs)
+            {
+                for (const auto& Move : Moves)
+                {
+                    if (Move.SrcOffset == Alloc.UnalignedOffset)
+                    {
+                        Alloc.UnalignedOffset = Move.DstOffset;
+                        break;
+                    }
+                }
+                Mgr.Free(std::move(Alloc));
+            }
+            EXPECT_TRUE(Mgr.IsEmpty());
+            EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+        }
+    }
+}
+
+TEST(GraphicsAccessories_VariableSizeGPUAllocationsManager, RandomDefragmentation)
+{
+    auto& Allocator = DefaultRawMemoryAllocator::GetAllocator();
+
+    using OffsetType = VariableSizeAllocationsManager::OffsetType;
+    using Allocation = VariableSizeAllocationsManager::Allocation;
+
+    constexpr OffsetType MaxSize       = 1 << 20;
+    constexpr OffsetType MaxAlignment  = 256;
+    constexpr int        NumAllocs     = 1000;
+    constexpr OffsetType MoveBudget    = MaxSize / 8;
+    const OffsetType     Alignments[]  = {1, 4, 16, 64, 256};
+    const OffsetType     AllocSizes[]  = {24, 100, 256, 1000, 1024, 3000};
+    const auto           NumAlignments = static_cast<int>(_countof(Alignments));
+    const auto           NumSizes      = static_cast<int>(_countof(AllocSizes));
+
+    const VariableSizeAllocationsManager::STRATEGY Strategies[] =
+        {
+            VariableSizeAllocationsManager::STRATEGY_ORDERED_MAPS,
+            VariableSizeAllocationsManager::STRATEGY_TLSF //
+        };
+    for (auto Strategy : Strategies)
+    {
+        VariableSizeAllocationsManager Mgr{MaxSize, Allocator, Strategy};
+
+        FastRand Rnd{0};
+
+        // Allocation and its requested size and alignment
+        struct AllocInfo
+        {
+            Allocation Alloc;
+            OffsetType Size;
+            OffsetType Alignment;
+        };
+        std::vector<AllocInfo> Allocs;
+        for (int i = 0; i < NumAllocs; ++i)
+        {
+            AllocInfo Info;
+            Info.Size      = AllocSizes[Rnd() % NumSizes];
+            Info.Alignment = Alignments[Rnd() % NumAlignments];
+            Info.Alloc     = Mgr.Allocate(Info.Size, Info.Alignment);
+            ASSERT_TRUE(Info.Alloc.IsValid());
+            Allocs.push_back(Info);
+        }
+        // Release about half of the allocations to fragment the free space
+        for (size_t i = 0; i < Allocs.size();)
+        {
+            if ((Rnd() & 0x01) != 0)
+            {
+                Mgr.Free(std::move(Allocs[i].Alloc));
+                Allocs[i] = Allocs.back();
+                Allocs.pop_back();
+            }
+            else
+                ++i;
+        }
+
+        const auto FreeSize       = Mgr.GetFreeSize();
+        const auto InitialLargest = Mgr.GetFreeBlockStatistics().LargestFreeBlockSize;
+        size_t     TotalMoves     = 0;
+        for (int Pass = 0; Pass < 64; ++Pass)
+        {
+            std::vector<Allocation> LiveAllocs;
+            for (const auto& Info : Allocs)
+                LiveAllocs.push_back(Info.Alloc);
+
+            auto Moves = Mgr.PlanDefragmentation(LiveAllocs.data(), LiveAllocs.size(), MaxAlignment, MoveBudget);
+            if (Moves.empty())
+                break;
+            TotalMoves += Moves.size();
+
+            OffsetType MovedSize = 0;
+            for (const auto& Move : Moves)
+            {
+                MovedSize += Move.Size;
+                EXPECT_LT(Move.DstOffset, Move.SrcOffset);
+                EXPECT_EQ((Move.SrcOffset - Move.DstOffset) % MaxAlignment, OffsetType{0});
+
+                // Destination must not overlap any live allocation or other destination
+                for (const auto& Info : Allocs)
+                {
+                    EXPECT_TRUE(Move.DstOffset + Move.Size <= Info.Alloc.UnalignedOffset ||
+                                Move.DstOffset >= Info.Alloc.UnalignedOffset + Info.Alloc.Size);
+                }
+                for (const auto& OtherMove : Moves)
+                {
+                    EXPECT_TRUE(&OtherMove == &Move ||
+                                Move.DstOffset + Move.Size <= OtherMove.DstOffset ||
+                                Move.DstOffset >= OtherMove.DstOffset + OtherMove.Size);
+                }
+            }
+            EXPECT_LE(MovedSize, MoveBudget);
+
+            Mgr.CommitDefragmentation(Moves.data(), Moves.size());
+            EXPECT_EQ(Mgr.GetFreeSize(), FreeSize);
+
+            for (auto& Info : Allocs)
+            {
+                for (const auto& Move : Moves)
+                {
+                    if (Move.SrcOffset == Info.Alloc.UnalignedOffset)
+                    {
+                        Info.Alloc.UnalignedOffset = Move.DstOffset;
+                        break;
+                    }
+                }
+                // The allocation must still be able to hold aligned data
+                EXPECT_LE(Align(Info.Alloc.UnalignedOffset, Info.Alignment) + Info.Size, Info.Alloc.UnalignedOffset + Info.Alloc.Size);
+            }
+        }
+        EXPECT_GT(TotalMoves, size_t{0});
+
+        const auto Stats = Mgr.GetFreeBlockStatistics();
+        EXPECT_GT(Stats.LargestFreeBlockSize, InitialLargest);
+        EXPECT_LT(Stats.GetFragmentation(), 0.1);
+
+        for (auto& Info : Allocs)
+            Mgr.Free(std::move(Info.Alloc));
+        EXPECT_TRUE(Mgr.IsEmpty());
+        EXPECT_EQ(Mgr.GetNumFreeBlocks(), size_t{1});
+    }
+}
+
+TEST(GraphicsAccessories_VariableSizeGPUAllocationsManager, DISABLED_StrategyPerformance)
+{
+    auto& Allocator  = DefaultRawMemoryAllocator::GetAllocator();
+    using OffsetType = VariableSizeAllocationsManager::OffsetType;
+
+    // Size distribution that resembles GPU memory page suballocations: mostly small
+    // constant and vertex buffers with occasional large textures
+    struct SizeClass
+    {
+        OffsetType MinSize;
+        OffsetType MaxSize;
+        OffsetType Alignment;
+        int        Weight;
+    };
+    const SizeClass SizeClasses[] =
+        {
+            {256, 4 << 10, 256, 60},
+            {4 << 10, 64 << 10, 256, 25},
+            {64 << 10, 1 << 20, 4 << 10, 12},
+            {1 << 20, 8 << 20, 64 << 10, 3} //
+        };
+
+#ifdef DILIGENT_DEBUG
+    // Both managers verify their internal state after every operation in debug builds
+    constexpr int NumOperations = 2000;
+#else
+    constexpr int NumOperations = 50000;
+#endif
+
+    constexpr size_t     MaxLiveAllocs  = 2048;
+    constexpr OffsetType MemoryPageSize = OffsetType{1} << 32;
+
+    // Pre-generate the sequence of requests so that both strategies get identical input
+    struct Request
+    {
+        OffsetType Size;
+        OffsetType Alignment;
+        size_t     FreeIndex;
+    };
+    std::vector<Request> Requests(NumOperations);
+    {
+        FastRandInt Rnd{0, 0, 99};
+        FastRandInt FractRnd{1, 0, 1 << 14};
+        for (auto& Req : Requests)
+        {
+            int Weight = Rnd();
+            for (const auto& Class : SizeClasses)
+            {
+                if (Weight < Class.Weight)
+                {
+                    Req.Size      = Class.MinSize + (Class.MaxSize - Class.MinSize) * static_cast<OffsetType>(FractRnd()) / (1 << 14);
+                    Req.Alignment = Class.Alignment;
+                    break;
+                }
+                Weight -= Class.Weight;
+            }
+            Req.FreeIndex = static_cast<size_t>(FractRnd());
+        }
+    }
+
+    for (auto Strategy : {VariableSizeAllocationsManager::STRATEGY_ORDERED_MAPS, VariableSizeAllocationsManager::STRATEGY_TLSF})
+    {
+        VariableSizeAllocationsManager ListMgr(MemoryPageSize, Allocator, Strategy);
+
+        std::vector<VariableSizeAllocationsManager::Allocation> Allocations;
+        Allocations.reserve(MaxLiveAllocs);
+
+        size_t NumFailed     = 0;
+        size_t MaxFreeBlocks = 0;
+
+        Timer T;
+        for (const auto& Req : Requests)
+        {
+            if (Allocations.size() == MaxLiveAllocs)
+            {
+                // Free a random allocation
+                auto Idx = Req.FreeIndex % Allocations.size();
+                ListMgr.Free(std::move(Allocations[Idx]));
+                Allocations[Idx] = Allocations.back();
+                Allocations.pop_back();
+            }
+
+            auto Alloc = ListMgr.Allocate(Req.Size, Req.Alignment);
+            if (Alloc.IsValid())
+                Allocations.push_back(Alloc);
+            else
+                ++NumFailed;
+            MaxFreeBlocks = std::max(MaxFreeBlocks, ListMgr.GetNumFreeBlocks());
+        }
+        for (auto& Alloc : Allocations)
+            ListMgr.Free(std::move(Alloc));
+        auto ElapsedTime = T.GetElapsedTime();
+
+        EXPECT_TRUE(ListMgr.IsEmpty());
+        LOG_INFO_MESSAGE((Strategy == VariableSizeAllocationsManager::STRATEGY_TLSF ? "TLSF:         " : "Ordered maps: "),
+                         static_cast<Uint64>(NumOperations * 2 / ElapsedTime), " allocs+frees/s, max free blocks: ", MaxFreeBlocks,
+                         ", failed allocations: ", NumFailed);
+    }
+}
+
 } // namespace
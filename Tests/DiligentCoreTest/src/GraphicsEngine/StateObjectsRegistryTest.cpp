@@ -0,0 +1,203 @@
+/*
+ *  Copyright 2019-2020 Diligent Graphics LLC
+ *  Copyright 2015-2019 Egor Yusov
+ *  
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *  
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *  
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  In no event and under no legal theory, whether in tort (including negligence), 
+ *  contract, or otherwise, unless required by applicable law (such as deliberate 
+ *  and grossly negligent acts) or agreed to in writing, shall any Contributor be
+ *  liable for any damages, including any direct, indirect, special, incidental, 
+ *  or consequential damages of any character arising as a result of this License or 
+ *  out of the use or inability to use the software (including but not limited to damages 
+ *  for loss of goodwill, work stoppage, computer failure or malfunction, or any and 
+ *  all other commercial damages or losses), even if such Contributor has been advised 
+ *  of the possibility of such damages.
+ */
+
+#include "StateObjectsRegistry.hpp"
+#include "ObjectBase.hpp"
+#include "DefaultRawMemoryAllocator.hpp"
+#include "DebugOutput.h"
+
+#include "gtest/gtest.h"
+
+using namespace Diligent;
+
+namespace
+{
+
+struct TestObjectDesc
+{
+    const Char* Name  = nullptr;
+    Uint32      Value = 0;
+
+    bool operator==(const TestObjectDesc& rhs) const
+    {
+        return Value == rhs.Value;
+    }
+};
+
+} // namespace
+
+namespace std
+{
+template <>
+struct hash<TestObjectDesc>
+{
+    size_t operator()(const TestObjectDesc& Desc) const
+    {
+        return std::hash<Uint32>{}(Desc.Value);
+    }
+};
+} // namespace std
+
+namespace
+{
+
+using TestRegistry = StateObjectsRegistry<TestObjectDesc>;
+
+class TestObject : public ObjectBase<IDeviceObject>
+{
+public:
+    TestObject(IReferenceCounters* pRefCounters, TestRegistry& Registry, const Char* Name) :
+        ObjectBase<IDeviceObject>{pRefCounters},
+        m_Registry{Registry}
+    {
+        m_Desc.Name = Name;
+    }
+
+    ~TestObject()
+    {
+        m_Registry.ReportDeletedObject();
+    }
+
+    virtual const DeviceObjectAttribs& DILIGENT_CALL_TYPE GetDesc() const override final
+    {
+        return m_Desc;
+    }
+
+    virtual Int32 DILIGENT_CALL_TYPE GetUniqueID() const override final
+    {
+        return 1;
+    }
+
+private:
+    TestRegistry&       m_Registry;
+    DeviceObjectAttribs m_Desc;
+};
+
+class WarningCounter
+{
+public:
+    WarningCounter() :
+        m_PrevCallback{DebugMessageCallback}
+    {
+        NumWarnings = 0;
+        SetDebugMessageCallback(MessageCallback);
+    }
+
+    ~WarningCounter()
+    {
+        SetDebugMessageCallback(m_PrevCallback);
+    }
+
+    static int NumWarnings;
+
+private:
+    static void MessageCallback(DEBUG_MESSAGE_SEVERITY Severity, const Char* Message, const Char* Function, const Char* File, int Line)
+    {
+        if (Severity == DEBUG_MESSAGE_SEVERITY_WARNING)
+            ++NumWarnings;
+    }
+
+    const DebugMessageCallbackType m_PrevCallback;
+};
+
+int WarningCounter::NumWarnings = 0;
+
+RefCntAutoPtr<IDeviceObject> CreateObject(TestRegistry& Registry, const TestObjectDesc& Desc)
+{
+    RefCntAutoPtr<IDeviceObject> pObject;
+    Registry.Find(Desc, &pObject);
+    if (!pObject)
+    {
+        pObject = MakeNewRCObj<TestObject>{}(Registry, Desc.Name);
+        Registry.Add(Desc, pObject);
+    }
+    return pObject;
+}
+
+TEST(GraphicsEngine_StateObjectsRegistry, FindExisting)
+{
+    TestRegistry Registry{DefaultRawMemoryAllocator::GetAllocator(), "Test"};
+
+    TestObjectDesc Desc;
+    Desc.Name  = "Object";
+    Desc.Value = 1;
+
+    auto pObject0 = CreateObject(Registry, Desc);
+    auto pObject1 = CreateObject(Registry, Desc);
+    EXPECT_EQ(pObject0, pObject1);
+
+    Desc.Value = 2;
+    auto pObject2 = CreateObject(Registry, Desc);
+    EXPECT_NE(pObject0, pObject2);
+}
+
+TEST(GraphicsEngine_StateObjectsRegistry, RecreateDestroyedObject)
+{
+    TestRegistry Registry{DefaultRawMemoryAllocator::GetAllocator(), "Test"};
+
+    WarningCounter Warnings;
+
+    TestObjectDesc Desc;
+    Desc.Name  = "Object";
+    Desc.Value = 1;
+
+    for (int i = 0; i < TestRegistry::DeletedObjectsToPurge * 2; ++i)
+    {
+        auto pObject = CreateObject(Registry, Desc);
+        ASSERT_NE(pObject, nullptr);
+        pObject.Release();
+        EXPECT_EQ(Registry.GetNumDeletedObjects(), 1);
+    }
+
+    // Replacing the expired reference of the previous object counts it as purged
+    auto pObject = CreateObject(Registry, Desc);
+    EXPECT_EQ(Registry.GetNumDeletedObjects(), 0);
+    EXPECT_EQ(WarningCounter::NumWarnings, 0);
+}
+
+TEST(GraphicsEngine_StateObjectsRegistry, ReplaceLiveObject)
+{
+    TestRegistry Registry{DefaultRawMemoryAllocator::GetAllocator(), "Test"};
+
+    WarningCounter Warnings;
+
+    TestObjectDesc Desc;
+    Desc.Name  = "Object";
+    Desc.Value = 1;
+
+    // Two threads may create the same object simultaneously
+    auto pObject0 = CreateObject(Registry, Desc);
+    auto pObject1 = RefCntAutoPtr<IDeviceObject>{MakeNewRCObj<TestObject>{}(Registry, Desc.Name)};
+    Registry.Add(Desc, pObject1);
+    EXPECT_EQ(WarningCounter::NumWarnings, 1);
+
+    RefCntAutoPtr<IDeviceObject> pFound;
+    Registry.Find(Desc, &pFound);
+    EXPECT_EQ(pFound, pObject1);
+}
+
+} // namespace